@@ -6,14 +6,55 @@
 in vec2 vScreenPos;
 
 uniform sampler2D currentVertices;
+
+// Filtered depth (x) and its error variance (y) per pixel, variance 0 = no history:
 uniform sampler2D previousVertices;
+uniform bool hasHistory = false;
+
+// Standard deviation of the sensor noise at 1 m (grows quadratically with the depth):
+uniform float measurementNoise = 0.002;
+
+// Standard deviation of the expected change of a static surface per frame:
+uniform float processNoise = 0.0005;
 
-uniform float smoothing = 0.99;
+// Deviations (in standard deviations) above which the pixel is considered as moved:
+uniform float resetThreshold = 3.0;
 
 layout (location = 0) out vec4 FragPosition;
+layout (location = 1) out vec2 FragHistory;
 
 void main()
-{	
-	vec4 current = texture(currentVertices, vScreenPos);
-	FragPosition = current;
+{
+    vec4 current = texture(currentVertices, vScreenPos);
+
+    // Invalid pixels pass through and reset the history:
+    if(isnan(current.x) || current.z < 0.01){
+        FragPosition = current;
+        FragHistory = vec2(0.0, 0.0);
+        return;
+    }
+
+    float z = current.z;
+    float noise = measurementNoise * z * z;
+    float measurementVariance = noise * noise;
+
+    vec2 previous = texture(previousVertices, vScreenPos).xy;
+
+    float estimate = z;
+    float variance = measurementVariance;
+
+    // Kalman filter of the depth along the ray (reset if the surface moved):
+    if(hasHistory && previous.y > 0.0){
+        float predictedVariance = previous.y + processNoise * processNoise;
+        float innovation = z - previous.x;
+
+        if(innovation * innovation <= resetThreshold * resetThreshold * (predictedVariance + measurementVariance)){
+            float gain = predictedVariance / (predictedVariance + measurementVariance);
+            estimate = previous.x + gain * innovation;
+            variance = (1.0 - gain) * predictedVariance;
+        }
+    }
+
+    FragPosition = vec4(current.xyz * (estimate / z), 1.0);
+    FragHistory = vec2(estimate, variance);
 }
@@ -7,6 +7,10 @@ in vec2 texCoord;
 
 uniform sampler2D pointCloud;
 uniform sampler2D colorTexture;
+
+/** If false (e.g. depth-only streams), pixels are not rejected by their color */
+uniform bool hasColors = true;
+
 uniform mat4 model;
 
 uniform bool shouldClip;
@@ -23,7 +27,7 @@ void main()
     vec3 point = texture(pointCloud, texCoord).xyz;
     vec3 rgb = texture(colorTexture, texCoord).xyz;
 
-    if(rgb.r < 0.01 && rgb.g < 0.01 && rgb.b < 0.01){
+    if(hasColors && rgb.r < 0.01 && rgb.g < 0.01 && rgb.b < 0.01){
         FragColor = vec4(1.0, 1.0, 1.0, 1.0);
         return;
     }
@@ -2,17 +2,21 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #version 330 core
 
+// Injected by BlendPCR (number of cameras):
+#ifndef CAMERA_NUM
 #define CAMERA_NUM 7
+#endif
 
 in vec2 vScreenPos;
 
-uniform sampler2D color[CAMERA_NUM];
-uniform sampler2D vertices[CAMERA_NUM];
-uniform sampler2D normals[CAMERA_NUM];
-uniform sampler2D depth[CAMERA_NUM];
+// Screen buffers of all cameras (one layer per camera):
+uniform sampler2DArray color;
+uniform sampler2DArray vertices;
+uniform sampler2DArray normals;
+uniform sampler2DArray depth;
 
-uniform sampler2D miniWeightsA;
-uniform sampler2D miniWeightsB;
+// Weights of four cameras per layer:
+uniform sampler2DArray miniWeights;
 
 uniform bool isCameraActive[CAMERA_NUM];
 
@@ -87,25 +91,15 @@ void main()
 
     float lastDistToCam = 10000;
 
-    float smoothBlend[8];
-    vec4 miniWValueA = texture(miniWeightsA, vScreenPos).rgba;
-    vec4 miniWValueB = texture(miniWeightsB, vScreenPos).rgba;
-
-    smoothBlend[0] = miniWValueA.x;
-    smoothBlend[1] = miniWValueA.y;
-    smoothBlend[2] = miniWValueA.z;
-    smoothBlend[3] = miniWValueA.a;
-    smoothBlend[4] = miniWValueB.x;
-    smoothBlend[5] = miniWValueB.y;
-    smoothBlend[6] = miniWValueB.z;
-    smoothBlend[7] = miniWValueB.a;
-
     for(int i=0; i < CAMERA_NUM; ++i){
         if(isCameraActive[i]){
-            vec4 currentVertex = vec4(texture(vertices[i], vScreenPos).xyz, 1.0);
-            vec2 blendFactors = vec2(texture(vertices[i], vScreenPos).a, texture(normals[i], vScreenPos).a);
+            vec3 layerPos = vec3(vScreenPos, i);
+            float smoothBlend = texture(miniWeights, vec3(vScreenPos, i / 4))[i % 4];
+
+            vec4 currentVertex = vec4(texture(vertices, layerPos).xyz, 1.0);
+            vec2 blendFactors = vec2(texture(vertices, layerPos).a, texture(normals, layerPos).a);
 
-            float currentAlpha = smoothBlend[i] * (blendFactors.y);
+            float currentAlpha = smoothBlend * (blendFactors.y);
 
             float distToCam = length(currentVertex.xyz);
 
@@ -122,9 +116,9 @@ void main()
                 continue;
             }
 
-            vec3 currentNormal = texture(normals[i], vScreenPos).xyz;
-            vec3 currentColor = texture(color[i], vScreenPos).rgb;
-            float currentDepth = texture(depth[i], vScreenPos).r;
+            vec3 currentNormal = texture(normals, layerPos).xyz;
+            vec3 currentColor = texture(color, layerPos).rgb;
+            float currentDepth = texture(depth, layerPos).r;
 
             sumColor += currentColor * currentAlpha;
             sumNormal += currentNormal * currentAlpha;
@@ -2,7 +2,13 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #version 330 core
 
+// Injected by BlendPCR (number of cameras):
+#ifndef CAMERA_NUM
 #define CAMERA_NUM 7
+#endif
+
+// The weights of four cameras are stored per layer:
+#define WEIGHT_LAYERS ((CAMERA_NUM + 3) / 4)
 
 in vec2 vScreenPos;
 
@@ -10,28 +16,14 @@ uniform usampler2D dominanceTexture;
 
 uniform bool isCameraActive[CAMERA_NUM];
 
-layout(location = 0) out vec4 FragColor1;
-layout(location = 1) out vec4 FragColor2;
-
-
-
-uvec4 encode8Bytes(float inpt[8]) {
-    uvec4 result;
-
-    result.x = (uint(inpt[0] * 255.0) & 0xFFu) | ((uint(inpt[1] * 255.0) & 0xFFu) << 8);
-    result.y = (uint(inpt[2] * 255.0) & 0xFFu) | ((uint(inpt[3] * 255.0) & 0xFFu) << 8);
-    result.z = (uint(inpt[4] * 255.0) & 0xFFu) | ((uint(inpt[5] * 255.0) & 0xFFu) << 8);
-    result.w = (uint(inpt[6] * 255.0) & 0xFFu) | ((uint(inpt[7] * 255.0) & 0xFFu) << 8);
-
-    return result;
-}
+layout(location = 0) out vec4 FragWeights[WEIGHT_LAYERS];
 
 void main()
 {		
     float distanceTreshold = 0.05;
 
-    float result[8];
-    for(int i=0; i < 8; ++i){
+    float result[WEIGHT_LAYERS * 4];
+    for(int i=0; i < WEIGHT_LAYERS * 4; ++i){
         result[i] = 0;
     }
 
@@ -44,13 +36,14 @@ void main()
             vec2 currentScreenPos = vScreenPos + halfTexelSize * vec2(x,y);
             uint dominantCam = texture(dominanceTexture, currentScreenPos).r;
 
-            for(int i=0; i < 8; ++i){
+            for(int i=0; i < CAMERA_NUM; ++i){
                 result[i] += dominantCam == uint(i) ? 1.0 : 0.0;
             }
             ++count;
         }
     }
 
-    FragColor1 = vec4(result[0] / count, result[1] / count, result[2] / count, result[3] / count);
-    FragColor2 = vec4(result[4] / count, result[5] / count, result[6] / count, result[7] / count);
+    for(int l=0; l < WEIGHT_LAYERS; ++l){
+        FragWeights[l] = vec4(result[l * 4], result[l * 4 + 1], result[l * 4 + 2], result[l * 4 + 3]) / count;
+    }
 }
@@ -2,14 +2,18 @@
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
 #version 330 core
 
+// Injected by BlendPCR (number of cameras):
+#ifndef CAMERA_NUM
 #define CAMERA_NUM 7
+#endif
 
 in vec2 vScreenPos;
 
-uniform sampler2D color[CAMERA_NUM];
-uniform sampler2D vertices[CAMERA_NUM];
-uniform sampler2D normals[CAMERA_NUM];
-uniform sampler2D depth[CAMERA_NUM];
+// Screen buffers of all cameras (one layer per camera):
+uniform sampler2DArray color;
+uniform sampler2DArray vertices;
+uniform sampler2DArray normals;
+uniform sampler2DArray depth;
 
 uniform bool isCameraActive[CAMERA_NUM];
 
@@ -23,12 +27,12 @@ void main()
 {		
     float distanceTreshold = 0.05;
 
-    vec2 halfTexelSize = 2.0 / textureSize(vertices[0], 0);
+    vec2 halfTexelSize = 2.0 / textureSize(vertices, 0).xy;
 
     float mainDistToCam = 9999.0;
     for(int i=0; i < CAMERA_NUM; ++i){
         if(isCameraActive[i]){
-            vec4 tVertex = vec4(texture(vertices[i], vScreenPos).xyz, 1.0);
+            vec4 tVertex = vec4(texture(vertices, vec3(vScreenPos, i)).xyz, 1.0);
             float tDistToCam = length(tVertex.xyz);
 
             if(tDistToCam >= 0.01 && tDistToCam < mainDistToCam){
@@ -44,7 +48,7 @@ void main()
 
     for(int i=0; i < CAMERA_NUM; ++i){
         if(isCameraActive[i]){
-            vec4 vtxTexValue = texture(vertices[i], vScreenPos);
+            vec4 vtxTexValue = texture(vertices, vec3(vScreenPos, i));
             vec4 currentVertex = vec4(vtxTexValue.xyz, 1.0);
 
             float currentAlpha = vtxTexValue.a;
@@ -17,6 +17,9 @@ uniform mat4 view;
 uniform mat4 model;
 uniform bool useColorIndices = false;
 
+/** If false (e.g. depth-only streams), the surface is shaded by its normals */
+uniform bool hasColors = true;
+
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec4 FragPosition;
 layout (location = 2) out vec4 FragNormal;
@@ -56,7 +59,11 @@ vec2 decodeTexCoords(float r, float g, int b){
 
 void main()
 {
-    if(useColorIndices){
+    if(!hasColors){
+        vec3 normal = mat3(view * model) * vNormal;
+        float shade = length(normal) > 0.0 ? 0.2 + 0.8 * abs(dot(normalize(normal), normalize(vPos.xyz))) : 1.0;
+        FragColor = vec4(vec3(0.8 * shade), 1.0);
+    } else if(useColorIndices){
         vec2 tex0 = texture(texture2D_colors, vTexCoord - vec2(0.0, 0.0028)).ra;
         vec2 tex1 = texture(texture2D_colors, vTexCoord - vec2(0.0, 0.0021)).ra;
         vec2 tex2 = texture(texture2D_colors, vTexCoord - vec2(0.0, 0.0014)).ra;
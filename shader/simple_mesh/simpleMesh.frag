@@ -9,8 +9,19 @@ in vec4 fColor;
  */
 out vec4 fragment_color;
 
+uniform mat4 view;
+
+/** If false (e.g. depth-only streams), the mesh is shaded by its normals */
+uniform bool hasColors = true;
 
 void main()
 {
-    fragment_color = fColor.bgra;
+    if(hasColors){
+        fragment_color = fColor.bgra;
+    } else {
+        vec3 viewPosition = (view * fWorldPosition).xyz;
+        vec3 normal = normalize(cross(dFdx(viewPosition), dFdy(viewPosition)));
+        float shade = 0.2 + 0.8 * abs(dot(normal, normalize(viewPosition)));
+        fragment_color = vec4(vec3(0.8 * shade), 1.0);
+    }
 }
@@ -26,8 +26,8 @@
 // Thread
 #include <thread>
 
-// Semaphore
-#include "src/util/Semaphore.h"
+#include "src/util/TripleBuffer.h"
+#include "src/util/Pipeline.h"
 
 // Include Mat4f class:
 #include "src/util/math/Mat4.h"
@@ -38,7 +38,14 @@
 // PC Streamer:
 #include "src/pcstreamer/Streamer.h"
 
+#ifdef USE_KINECT
 #include "src/pcstreamer/AzureKinectMKVStreamer.h"
+#endif
+
+#include "src/pcstreamer/OPCRecordingStreamer.h"
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcstreamer/NetworkStreamer.h"
+#include "src/pcstreamer/SharedMemoryStreamer.h"
 
 // PC Fusion:
 #include "src/pcrenderer/Renderer.h"
@@ -48,12 +55,11 @@
 
 // PC Filter:
 #include "src/pcfilter/Filter.h"
-
-#ifdef USE_CUDA
+#include "src/pcfilter/FilterExecutor.h"
 #include "src/pcfilter/ErosionFilter.h"
 #include "src/pcfilter/SpatialHoleFiller.h"
 #include "src/pcfilter/ClippingFilter.h"
-#endif
+#include "src/pcfilter/TemporalDenoisingFilter.h"
 
 
 #include <imfilebrowser.h>
@@ -165,12 +171,6 @@ int main(int argc, char** argv)
     // Rendering timer
     float worldCPUTime = 0.f;
 
-    // Time which is required for apply the filters:
-    float filterTime = 0.f;
-
-    // Time which is required for integrate the point cloud:
-    float integrationTime = 0.f;
-
     // Streamer:
     int pcStreamerItemIdx = 0;
     int pcStreamerLoadedIdx = -1;
@@ -183,7 +183,6 @@ int main(int argc, char** argv)
     int pcTechniqueLoadedIdx = -1;
     std::shared_ptr<Renderer> pcRenderer;
 
-    bool shouldClose = false;
     bool vSyncActive = false;
 
     int absoluteFPS = 0;
@@ -196,10 +195,8 @@ int main(int argc, char** argv)
 
     float fov = 75;
 
-    Semaphore integratePCSemaphore(1);
-
-    // Last point clouds:
-    std::vector<std::shared_ptr<OrganizedPointCloud>> lastProcessedPointClouds;
+    // Newest filtered point clouds (filter thread -> render loop):
+    TripleBuffer<std::vector<std::shared_ptr<OrganizedPointCloud>>> processedPointCloudsMailbox;
 
     // Filters:
     std::vector<std::shared_ptr<Filter>> pcFilters;
@@ -209,75 +206,48 @@ int main(int argc, char** argv)
      */
 
     /*
-    #ifdef USE_CUDA
-        std::shared_ptr<ClippingFilter> clippingFilter = std::make_shared<ClippingFilter>();
-        pcFilters.push_back(clippingFilter);
-        std::shared_ptr<SpatialHoleFiller> holeFiller = std::make_shared<SpatialHoleFiller>();
-        pcFilters.push_back(holeFiller);
-        std::shared_ptr<ErosionFilter> erosionFilter = std::make_shared<ErosionFilter>();
-        pcFilters.push_back(erosionFilter);
-    #endif*/
-
-    Semaphore pointCloudsAvailableSemaphore;
-    Semaphore pointCloudsProcessedSemaphore(1);
-    std::vector<std::shared_ptr<OrganizedPointCloud>> lastStreamedPointClouds;
+    std::shared_ptr<ClippingFilter> clippingFilter = std::make_shared<ClippingFilter>();
+    pcFilters.push_back(clippingFilter);
+    std::shared_ptr<SpatialHoleFiller> holeFiller = std::make_shared<SpatialHoleFiller>();
+    pcFilters.push_back(holeFiller);
+    std::shared_ptr<ErosionFilter> erosionFilter = std::make_shared<ErosionFilter>();
+    pcFilters.push_back(erosionFilter);
+    */
+
+    // Applies the filters (camera independent ones for all cameras concurrently):
+    FilterExecutor filterExecutor;
+
+    // Stages between the streamer and the render loop. Each stage has its own thread,
+    // so the next frame is filtered while the previous one is integrated. If a stage
+    // is too slow, the oldest queued frames are dropped (the streamer never waits).
+    // The filters and the renderer are only changed while their stage is idle (see
+    // Pipeline::runExclusive):
+    Pipeline<std::vector<std::shared_ptr<OrganizedPointCloud>>> framePipeline;
+
+    framePipeline.addStage("Filter", [&pcFilters, &filterExecutor](std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds){
+        filterExecutor.apply(pcFilters, pointClouds);
+        return true;
+    }, StageThread::Dedicated, 1, OverflowPolicy::DropOldest);
+
+    framePipeline.addStage("Integrate", [&pcRenderer, &processedPointCloudsMailbox](std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds){
+        // Integrate into fusion structure (if there is no renderer yet, it integrates
+        // the newest point clouds of the mailbox when it is created):
+        if(pcRenderer != nullptr)
+            pcRenderer->integratePointClouds(pointClouds);
+        processedPointCloudsMailbox.write(pointClouds);
+        return true;
+    }, StageThread::Dedicated, 1, OverflowPolicy::DropOldest);
+
+    framePipeline.start();
 
     // Process callback when a tuple of new images is received from the pc streamer.
     // (This is assumed to be called from the streamer thread):
     std::function<void(std::vector<std::shared_ptr<OrganizedPointCloud>>)> streamerCallback =
-        [&lastStreamedPointClouds, &pointCloudsAvailableSemaphore, &pointCloudsProcessedSemaphore](std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds)
+        [&framePipeline](std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds)
     {
-        pointCloudsProcessedSemaphore.acquireAll();
-        lastStreamedPointClouds = pointClouds;
-        pointCloudsAvailableSemaphore.release();
+        framePipeline.push(std::move(pointClouds));
     };
 
-    Semaphore lockFilterChangesSemaphore(1);
-
-    std::thread filterAndIntegrateThread([&integratePCSemaphore, &pcRenderer, &pcFilters, &lastProcessedPointClouds, &filterTime, &integrationTime, &shouldClose, &lastStreamedPointClouds, &pointCloudsAvailableSemaphore, &pointCloudsProcessedSemaphore, &lockFilterChangesSemaphore](){
-        while(!shouldClose){
-            // Wait with processing until pcRenderer is available (we don't want to skip
-            // initial point clouds, e.g. for recording):
-            if(pcRenderer != nullptr){
-                pointCloudsAvailableSemaphore.acquireAll();
-                if(shouldClose)
-                    return;
-
-                std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = lastStreamedPointClouds;
-
-                auto filterStartTime = high_resolution_clock::now();
-
-                // Apply filters:
-                {
-                    lockFilterChangesSemaphore.acquire();
-                    for(std::shared_ptr<Filter>& filter : pcFilters){
-                        if(filter->isActive){
-                            filter->applyFilter(pointClouds);
-                        }
-                    }
-                    lockFilterChangesSemaphore.release();
-                }
-
-                long long filterDuration = duration_cast<microseconds>(high_resolution_clock::now() - filterStartTime).count();
-                filterTime = (filterDuration *0.001f) * 0.1f + filterTime * 0.9f;
-
-
-                auto integrationStartTime = high_resolution_clock::now();
-                // Integrate into fusion structure:
-                {
-                    integratePCSemaphore.acquire();
-                    pcRenderer->integratePointClouds(pointClouds);
-                    integratePCSemaphore.release();
-                }
-                long long integrationDuration = duration_cast<microseconds>(high_resolution_clock::now() - integrationStartTime).count();
-                integrationTime = (integrationDuration *0.001f);// * 0.1f + integrationTime * 0.9f;
-
-                lastProcessedPointClouds = pointClouds;
-                pointCloudsProcessedSemaphore.release();
-            }
-        }
-    });
-
     // Debug Cube:
     GLMesh cameraMesh = GLMesh(CMAKE_SOURCE_DIR "/data/model/camera.obj");
 
@@ -291,8 +261,8 @@ int main(int argc, char** argv)
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     ImGui::FileBrowser fileDialog;
-    fileDialog.SetTitle("Select 'cameraconfig.json' of CWIPC-SXR dataset:");
-    fileDialog.SetTypeFilters({ ".json" });
+    fileDialog.SetTitle("Select 'cameraconfig.json' of CWIPC-SXR dataset or *.opcr recording:");
+    fileDialog.SetTypeFilters({ ".json", ".opcr" });
     fileDialog.SetWindowSize(1060,620);
 
     int loopCounter = 0;
@@ -343,19 +313,74 @@ int main(int argc, char** argv)
                 std::shared_ptr<FileStreamer> pcFileStreamer = std::dynamic_pointer_cast<FileStreamer>(pcStreamer);
                 if(pcFileStreamer != nullptr){
                     ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-                    if(ImGui::Button("Load new Scene")){
-                        fileDialog.Open();
-                        pcFileStreamer->isPlaying = false;
+                    if(Streamer::requiresPath(pcStreamerLoadedIdx)){
+                        if(ImGui::Button("Load new Scene")){
+                            fileDialog.Open();
+                            pcFileStreamer->setPlaying(false);
+                        }
+                    } else {
+                        if(ImGui::Button("Restart Streamer")){
+                            pcStreamer = nullptr;
+                            pcStreamer = Streamer::constructStreamerInstance(pcStreamerLoadedIdx);
+                            if(pcStreamer != nullptr)
+                                pcStreamer->setCallback(streamerCallback);
+                            pcFileStreamer = std::dynamic_pointer_cast<FileStreamer>(pcStreamer);
+                        }
                     }
                     ImGui::Separator();
                 }
 
+                ImGui::Text("");
+                ImGui::Separator();
+                ImGui::Text("CWIPC-SXR Load Settings:");
+                ImGui::Checkbox("Depth Only (no color decoding)", &Streamer::MKVDepthOnly);
+                ImGui::Separator();
                 ImGui::Text("");
                 ImGui::Separator();
                 ImGui::Text("CWIPC-SXR (Buffered) Load Settings:");
-                ImGui::SliderInt("Start Frame", &Streamer::BufferedStartFrameOffset, 0, 1000);
-                ImGui::SliderInt("Max Frames", &Streamer::BufferedMaxFrameCount, 0, 1000);
-                ImGui::Text(("Approx. required RAM: " + std::to_string(int(std::ceil(0.058 * Streamer::BufferedMaxFrameCount))) + " GB").c_str());
+                if(ImGui::SliderInt("Cache Budget (MB)", &Streamer::BufferedCacheBudgetMB, 256, 32768)){
+#ifdef USE_KINECT
+                    std::shared_ptr<AzureKinectMKVStreamer> bufferedStreamer = std::dynamic_pointer_cast<AzureKinectMKVStreamer>(pcStreamer);
+                    if(bufferedStreamer != nullptr)
+                        bufferedStreamer->setCacheBudget(size_t(Streamer::BufferedCacheBudgetMB) * 1024 * 1024);
+#endif
+                }
+                {
+                    // Frames which are actually resident in the caches of the loaded recording:
+                    std::string cachedFrames = "Cached frames: - (no buffered recording loaded)";
+#ifdef USE_KINECT
+                    std::shared_ptr<AzureKinectMKVStreamer> bufferedStreamer = std::dynamic_pointer_cast<AzureKinectMKVStreamer>(pcStreamer);
+                    if(bufferedStreamer != nullptr && pcStreamerLoadedIdx == 2){
+                        size_t residentBytes;
+                        unsigned int residentFrames;
+                        float hitRate, compressionRatio, decodeTime;
+                        unsigned long long evictions;
+                        bufferedStreamer->getCacheStatistics(residentBytes, residentFrames, hitRate, evictions, compressionRatio, decodeTime);
+                        cachedFrames = "Cached frames: " + std::to_string(residentFrames) + " (" + std::to_string(int(residentBytes / (1024 * 1024))) + " MB)";
+                    }
+#endif
+                    ImGui::Text("%s", cachedFrames.c_str());
+                }
+                ImGui::Separator();
+                ImGui::Text("");
+                ImGui::Separator();
+                ImGui::Text("Synthetic Scene Load Settings:");
+                ImGui::SliderInt("Cameras", &Streamer::SyntheticCameraCount, 1, 32);
+                ImGui::Separator();
+                ImGui::Text("");
+                ImGui::Separator();
+                ImGui::Text("Network Receiver Load Settings:");
+                ImGui::InputInt("Port", &Streamer::NetworkPort);
+                ImGui::Separator();
+                ImGui::Text("");
+                ImGui::Separator();
+                ImGui::Text("Shared Memory Receiver Load Settings:");
+                {
+                    char sharedMemoryName[64];
+                    std::snprintf(sharedMemoryName, sizeof(sharedMemoryName), "%s", Streamer::SharedMemoryName.c_str());
+                    if(ImGui::InputText("Name", sharedMemoryName, sizeof(sharedMemoryName)))
+                        Streamer::SharedMemoryName = sharedMemoryName;
+                }
                 ImGui::Separator();
                 ImGui::Text("");
                 ImGui::Separator();
@@ -364,7 +389,9 @@ int main(int argc, char** argv)
 
                 if(pcFileStreamer != nullptr){
                     ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-                    ImGui::SliderFloat("##123", &pcFileStreamer->currentTime, 0.0f, pcFileStreamer->getTotalTime());
+                    float currentTime = pcFileStreamer->currentTime;
+                    if(ImGui::SliderFloat("##123", &currentTime, 0.0f, pcFileStreamer->getTotalTime()))
+                        pcFileStreamer->seek(currentTime);
 
                     if(ImGui::Button("   <   "))
                         pcFileStreamer->step(-1);
@@ -372,10 +399,10 @@ int main(int argc, char** argv)
                     ImGui::SameLine();
                     if(pcFileStreamer->isPlaying){
                         if(ImGui::Button("Pause"))
-                            pcFileStreamer->isPlaying = false;
+                            pcFileStreamer->setPlaying(false);
                     } else {
                         if(ImGui::Button(" Play "))
-                            pcFileStreamer->isPlaying = true;
+                            pcFileStreamer->setPlaying(true);
                     }
                     ImGui::SameLine();
 
@@ -384,18 +411,112 @@ int main(int argc, char** argv)
 
                     ImGui::Separator();
 
-                    if(pcStreamerLoadedIdx == 1)
+                    if(pcStreamerLoadedIdx == 1 || pcStreamerLoadedIdx == 3)
                         ImGui::Checkbox("Realtime (Skip Frames)", &pcFileStreamer->allowFrameSkipping);
                     ImGui::Checkbox("Loop", &pcFileStreamer->loop);
+
+                    float playbackRate = pcFileStreamer->playbackRate;
+                    if(ImGui::SliderFloat("Playback Rate", &playbackRate, 0.1f, 4.f, "%.2fx"))
+                        pcFileStreamer->setPlaybackRate(playbackRate);
+
+                    float averageJitter, maximumJitter;
+                    unsigned long long deliveredFrames;
+                    pcFileStreamer->getPlaybackClock().getJitterStatistics(averageJitter, maximumJitter, deliveredFrames);
+                    if(deliveredFrames > 0){
+                        ImGui::Text("Delivery Jitter: %.2f ms | Max: %.2f ms", averageJitter, maximumJitter);
+                        ImGui::SameLine();
+                        if(ImGui::SmallButton("Reset"))
+                            pcFileStreamer->getPlaybackClock().resetJitterStatistics();
+                    }
                     ImGui::Separator();
                 }
 
+                std::shared_ptr<NetworkStreamer> pcNetworkStreamer = std::dynamic_pointer_cast<NetworkStreamer>(pcStreamer);
+                if(pcNetworkStreamer != nullptr){
+                    if(!pcNetworkStreamer->isListening()){
+                        ImGui::TextWrapped("Failed to listen on port %d.", pcNetworkStreamer->getPort());
+                    } else {
+                        unsigned long long completedFrames, droppedFrames, receivedBytes;
+                        pcNetworkStreamer->getStatistics(completedFrames, droppedFrames, receivedBytes);
+                        ImGui::Text("Port: %d | Senders: %d", pcNetworkStreamer->getPort(), pcNetworkStreamer->getConnectionCount());
+                        ImGui::Text("Frames: %llu | Dropped: %llu", completedFrames, droppedFrames);
+                        ImGui::Text("%.1f fps | Latency: %.2f ms", pcNetworkStreamer->getFrameRate(), pcNetworkStreamer->getLatency());
+                    }
+                    ImGui::Separator();
+                }
+
+                std::shared_ptr<SharedMemoryStreamer> pcSharedMemoryStreamer = std::dynamic_pointer_cast<SharedMemoryStreamer>(pcStreamer);
+                if(pcSharedMemoryStreamer != nullptr){
+                    if(!pcSharedMemoryStreamer->isConnected()){
+                        ImGui::TextWrapped("Waiting for shared memory ring '%s'...", pcSharedMemoryStreamer->getName().c_str());
+                    } else {
+                        unsigned long long receivedFrames, skippedFrames, droppedFrames;
+                        pcSharedMemoryStreamer->getStatistics(receivedFrames, skippedFrames, droppedFrames);
+                        ImGui::Text("Frames: %llu | Skipped: %llu | Dropped: %llu", receivedFrames, skippedFrames, droppedFrames);
+                        ImGui::Text("%.1f fps | Handoff: %.1f us", pcSharedMemoryStreamer->getFrameRate(), pcSharedMemoryStreamer->getLatency() * 1000.f);
+                    }
+                    ImGui::Separator();
+                }
+
+                std::shared_ptr<SyntheticStreamer> pcSyntheticStreamer = std::dynamic_pointer_cast<SyntheticStreamer>(pcStreamer);
+                if(pcSyntheticStreamer != nullptr){
+                    float frameRate = pcSyntheticStreamer->frameRate;
+                    if(ImGui::SliderFloat("Frame Rate (0 = max)", &frameRate, 0.f, 120.f, "%.0f"))
+                        pcSyntheticStreamer->frameRate = frameRate;
+                    ImGui::Text("Cameras: %u | Output: %.1f fps", pcSyntheticStreamer->getConfig().cameraCount, pcSyntheticStreamer->getOutputFrameRate());
+                    ImGui::Separator();
+                }
+
+#ifdef USE_KINECT
                 std::shared_ptr<AzureKinectMKVStreamer> pcAzureKinectMKVStreamer = std::dynamic_pointer_cast<AzureKinectMKVStreamer>(pcStreamer);
                 if(pcAzureKinectMKVStreamer != nullptr){
-                    if(pcStreamerLoadedIdx == 1)
+                    if(pcStreamerLoadedIdx == 2){
+                        size_t residentBytes;
+                        unsigned int residentFrames;
+                        float hitRate, compressionRatio, decodeTime;
+                        unsigned long long evictions;
+                        pcAzureKinectMKVStreamer->getCacheStatistics(residentBytes, residentFrames, hitRate, evictions, compressionRatio, decodeTime);
+                        ImGui::Text("Cached: %u frames, %.0f MB | Compression: %.1fx", residentFrames, residentBytes / (1024.0 * 1024.0), compressionRatio);
+                        ImGui::Text("Cache Hit Rate: %.1f %% | Evictions: %llu", hitRate * 100.f, evictions);
+                        ImGui::Text("Decode: %.2f ms / frame", decodeTime);
+                    }
+
+                    if(pcStreamerLoadedIdx == 1 || pcStreamerLoadedIdx == 2){
                         ImGui::Checkbox("High Resolution Encoding", &pcAzureKinectMKVStreamer->useColorIndices);
 
-                } else {
+                        int prefetchDepth = pcAzureKinectMKVStreamer->prefetchDepth;
+                        if(ImGui::SliderInt("Prefetch Frames", &prefetchDepth, 0, 30))
+                            pcAzureKinectMKVStreamer->setPrefetchDepth(prefetchDepth);
+
+                        unsigned long long hits, misses;
+                        pcAzureKinectMKVStreamer->getPrefetchStatistics(hits, misses);
+                        ImGui::Text("Prefetch Hits: %llu | Misses: %llu", hits, misses);
+
+                        unsigned long long poolMisses;
+                        size_t poolBytes;
+                        pcAzureKinectMKVStreamer->getBufferPoolStatistics(poolMisses, poolBytes);
+                        ImGui::Text("Buffer Pool: %.0f MB | Misses: %llu", poolBytes / (1024.0 * 1024.0), poolMisses);
+
+                        float tolerance = float(pcAzureKinectMKVStreamer->assembler->getTolerance() * 1000.0);
+                        if(ImGui::SliderFloat("Sync Tolerance (ms)", &tolerance, 1.f, 50.f, "%.1f"))
+                            pcAzureKinectMKVStreamer->assembler->setTolerance(tolerance * 0.001);
+
+                        ImGui::SliderFloat("Frame Deadline (ms)", &pcAzureKinectMKVStreamer->frameDeadline, 10.f, 1000.f, "%.0f");
+
+                        const char* latePolicyNames[] = { "Reuse Last Frame", "Mark Inactive" };
+                        int latePolicy = int(pcAzureKinectMKVStreamer->assembler->getPolicy());
+                        if(ImGui::Combo("Late Cameras", &latePolicy, latePolicyNames, 2))
+                            pcAzureKinectMKVStreamer->assembler->setPolicy(LateCameraPolicy(latePolicy));
+
+                        unsigned long long completeFrames, partialFrames, lateFrames, droppedFrames, reusedFrames;
+                        pcAzureKinectMKVStreamer->getAssemblyStatistics(completeFrames, partialFrames, lateFrames, droppedFrames, reusedFrames);
+                        ImGui::Text("Frames: %llu complete | %llu partial", completeFrames, partialFrames);
+                        ImGui::Text("Camera Frames: %llu late | %llu dropped | %llu reused", lateFrames, droppedFrames, reusedFrames);
+                    }
+                }
+#endif
+
+                if(pcStreamer == nullptr){
                     ImGui::TextWrapped("Please select \"Source\" to load a scene.");
                 }
                 ImGui::Separator();
@@ -405,7 +526,13 @@ int main(int argc, char** argv)
             {
                 // Update streamer if changed:
                 if(pcStreamerItemIdx != pcStreamerLoadedIdx){
-                    if(pcStreamerItemIdx > 0){
+                    if(pcStreamerItemIdx > 0 && !Streamer::requiresPath(pcStreamerItemIdx)){
+                        pcStreamer = nullptr;
+                        pcStreamer = Streamer::constructStreamerInstance(pcStreamerItemIdx);
+                        if(pcStreamer != nullptr)
+                            pcStreamer->setCallback(streamerCallback);
+                        pcStreamerLoadedIdx = pcStreamerItemIdx;
+                    } else if(pcStreamerItemIdx > 0){
                         pcStreamerOfCurrentFileDialog = pcStreamerItemIdx;
                         pcStreamerItemIdx = pcStreamerLoadedIdx;
                         fileDialog.Open();
@@ -469,7 +596,7 @@ int main(int argc, char** argv)
                     ImGui::Text("Settings:");
                     ImGui::Separator();
                     ImGui::SliderFloat("Gauss H", &pcBlendPCRenderer->implicitH, 0.001f, 0.08f);
-                    ImGui::SliderFloat("Kernel Radius", &pcBlendPCRenderer->kernelRadius, 3, 15);
+                    ImGui::SliderFloat("Kernel Radius", &pcBlendPCRenderer->kernelRadius, 2, 15);
                     ImGui::SliderFloat("Kernel Spread", &pcBlendPCRenderer->kernelSpread, 1.f, 5.f);
                     ImGui::Separator();
                     ImGui::Checkbox("High Resolution Encoding##2", &pcBlendPCRenderer->useColorIndices);
@@ -482,12 +609,28 @@ int main(int argc, char** argv)
                     ImGui::DragFloat3("Clip Min", &pcBlendPCRenderer->clipMin.x, 0.02f, -2.f, 0.5f);
                     ImGui::DragFloat3("Clip Max", &pcBlendPCRenderer->clipMax.x, 0.02f, -0.5f, 2.f);
                     ImGui::Separator();
+                    ImGui::Checkbox("Temporal Denoising", &pcBlendPCRenderer->useTemporalFilter);
+                    if(pcBlendPCRenderer->useTemporalFilter){
+                        ImGui::SliderFloat("Sensor Noise at 1 m", &pcBlendPCRenderer->temporalMeasurementNoise, 0.0005f, 0.01f, "%.4f m");
+                        ImGui::SliderFloat("Process Noise", &pcBlendPCRenderer->temporalProcessNoise, 0.0001f, 0.005f, "%.4f m");
+                        ImGui::SliderFloat("Reset Threshold", &pcBlendPCRenderer->temporalResetThreshold, 1.f, 10.f, "%.1f sigma");
+
+                        std::vector<float> temporalFilterTimes = pcBlendPCRenderer->getTemporalFilterTimes();
+                        for(size_t cameraID = 0; cameraID < temporalFilterTimes.size(); ++cameraID)
+                            ImGui::Text("Camera %i: %.3f ms (GPU)", int(cameraID), temporalFilterTimes[cameraID]);
+                    }
+                    ImGui::Separator();
                     ImGui::Text("");
                     ImGui::Separator();
                     ImGui::Text("Optimization Settings:");
                     ImGui::Separator();
                     ImGui::SliderInt("Mesh Stride", &pcBlendPCRenderer->stride, 1, 3);
                     ImGui::Separator();
+                    ImGui::Checkbox("Partial Updates (changed tiles only)", &pcBlendPCRenderer->usePartialUpdates);
+                    std::vector<float> dirtyTileFractions = pcBlendPCRenderer->getDirtyTileFractions();
+                    for(size_t cameraID = 0; cameraID < dirtyTileFractions.size(); ++cameraID)
+                        ImGui::Text("Camera %i: %.1f %% of tiles processed", int(cameraID), dirtyTileFractions[cameraID] * 100.f);
+                    ImGui::Separator();
                     ImGui::Text("Framebuffer: %i x %i", pcBlendPCRenderer->result_width, pcBlendPCRenderer->result_height);
                 }
 
@@ -500,32 +643,42 @@ int main(int argc, char** argv)
             // Change Point Cloud Renderer if another renderer was selected:
             {
                 if(pcTechniqueItemIdx != pcTechniqueLoadedIdx){
-                    integratePCSemaphore.acquire();
-                    pcRenderer = Renderer::constructAlgorithmInstance(pcTechniqueItemIdx);
-                    std::shared_ptr<BlendPCR> pcBlendPCRenderer = std::dynamic_pointer_cast<BlendPCR>(pcRenderer);
-                    if(pcBlendPCRenderer != nullptr){
-                        pcBlendPCRenderer->result_width = resultWidth;
-                        pcBlendPCRenderer->result_height = resultHeight;
-                        pcBlendPCRenderer->stride = 1;
-                        pcBlendPCRenderer->screensNumber = 1;
-                        pcBlendPCRenderer->shouldClip = false;
-                    }
-                    if(lastProcessedPointClouds.size() > 0)
-                        pcRenderer->integratePointClouds(lastProcessedPointClouds);
-                    pcTechniqueLoadedIdx = pcTechniqueItemIdx;
-
-
-
-                    integratePCSemaphore.release();
+                    framePipeline.runExclusive("Integrate", [&](){
+                        pcRenderer = Renderer::constructAlgorithmInstance(pcTechniqueItemIdx);
+                        std::shared_ptr<BlendPCR> pcBlendPCRenderer = std::dynamic_pointer_cast<BlendPCR>(pcRenderer);
+                        if(pcBlendPCRenderer != nullptr){
+                            pcBlendPCRenderer->result_width = resultWidth;
+                            pcBlendPCRenderer->result_height = resultHeight;
+                            pcBlendPCRenderer->stride = 1;
+                            pcBlendPCRenderer->screensNumber = 1;
+                            pcBlendPCRenderer->shouldClip = false;
+                        }
+                        const std::vector<std::shared_ptr<OrganizedPointCloud>>& lastProcessedPointClouds = processedPointCloudsMailbox.readLatest();
+                        if(lastProcessedPointClouds.size() > 0)
+                            pcRenderer->integratePointClouds(lastProcessedPointClouds);
+                        pcTechniqueLoadedIdx = pcTechniqueItemIdx;
+                    });
                 }
             }
 
             if(ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen)){
                 ImGui::Text("Streaming: %.3f ms", pcStreamer != nullptr ? pcStreamer->getProcessingTime() : 0.f);
+                if(pcStreamer != nullptr){
+                    std::vector<float> cameraTimes = pcStreamer->getCameraProcessingTimes();
+                    for(unsigned int i = 0; i < cameraTimes.size(); ++i)
+                        ImGui::Text("  Camera %i: %.3f ms", i, cameraTimes[i]);
+                }
                 ImGui::Separator();
-                ImGui::Text("Filter: %.3f ms", filterTime);
-                ImGui::Separator();
-                ImGui::Text("Integration: %.3f ms", integrationTime);
+                for(const StageStatistics& stage : framePipeline.getStatistics()){
+                    ImGui::Text("%s: %.3f ms", stage.name.c_str(), stage.serviceTime);
+                    ImGui::Text("  Queue: %i / %i, dropped: %llu", int(stage.queueDepth), int(stage.queueCapacity), stage.dropped);
+
+                    if(stage.name == "Filter"){
+                        for(const FilterTiming& timing : filterExecutor.getTimings())
+                            ImGui::Text("  %s: %.3f ms", timing.name.c_str(), timing.frameTime);
+                    }
+                }
+                ImGui::Text("Dropped before rendering: %llu / %llu", processedPointCloudsMailbox.getDroppedCount(), processedPointCloudsMailbox.getPublishedCount());
                 ImGui::Separator();
                 ImGui::Text("Render Loop (synced)*: %.3f ms", worldCPUTime);
                 ImGui::Separator();
@@ -570,7 +723,9 @@ int main(int argc, char** argv)
                     for(FilterFactory* factory : FilterFactory::availableFilterFactories){
                         if (ImGui::Selectable(factory->getDisplayName().c_str()))
                         {
-                            pcFilters.emplace_back(factory->createInstance());
+                            framePipeline.runExclusive("Filter", [&](){
+                                pcFilters.emplace_back(factory->createInstance());
+                            });
                         }
 
                         ++i;
@@ -589,41 +744,84 @@ int main(int argc, char** argv)
 
                 std::shared_ptr<std::function<void(void)>> delayedChangeFilterCall = nullptr;
 
+                std::vector<FilterTiming> filterTimings = filterExecutor.getTimings();
+
                 // Show all filters:
                 for(int i=0; i < int(pcFilters.size()); ++i){
                     std::shared_ptr<Filter>& filter = pcFilters[i];
 
-                    std::string name = "Unknown";
+                    std::string name = filter->getName();
 
                     name += "##" + std::to_string(filter->instanceID);
 
                     ImGui::PushFont(fontSmall);
                     if(ImGui::ArrowButton(("Up##" + std::to_string(i)).c_str(), ImGuiDir_Up)){
-                        delayedChangeFilterCall = std::make_shared<std::function<void(void)>>([i, &lockFilterChangesSemaphore, &pcFilters](){
+                        delayedChangeFilterCall = std::make_shared<std::function<void(void)>>([i, &framePipeline, &pcFilters](){
                             if(i > 0){
-                                lockFilterChangesSemaphore.wait();
-                                std::swap(pcFilters[i], pcFilters[i-1]);
+                                framePipeline.runExclusive("Filter", [&](){
+                                    std::swap(pcFilters[i], pcFilters[i-1]);
+                                });
                             }
                         });
                     }
                     ImGui::SameLine();
                     if(ImGui::ArrowButton(("Down##" + std::to_string(i)).c_str(), ImGuiDir_Down)){
-                        delayedChangeFilterCall = std::make_shared<std::function<void(void)>>([i, &lockFilterChangesSemaphore, &pcFilters](){
+                        delayedChangeFilterCall = std::make_shared<std::function<void(void)>>([i, &framePipeline, &pcFilters](){
                             if(i + 1 < int(pcFilters.size())){
-                                lockFilterChangesSemaphore.wait();
-                                std::swap(pcFilters[i], pcFilters[i+1]);
+                                framePipeline.runExclusive("Filter", [&](){
+                                    std::swap(pcFilters[i], pcFilters[i+1]);
+                                });
                             }
                         });
                     }
                     ImGui::SameLine();
                     if(ImGui::Button(("X##" + std::to_string(i)).c_str())){
-                        delayedChangeFilterCall = std::make_shared<std::function<void(void)>>([i, &lockFilterChangesSemaphore, &pcFilters](){
-                            lockFilterChangesSemaphore.wait();
-                            pcFilters.erase(pcFilters.begin() + i);
+                        delayedChangeFilterCall = std::make_shared<std::function<void(void)>>([i, &framePipeline, &pcFilters](){
+                            framePipeline.runExclusive("Filter", [&](){
+                                pcFilters.erase(pcFilters.begin() + i);
+                            });
                         });
                     }
                     ImGui::PopFont();
                     bool headerOpened = ImGui::CollapsingHeader(name.c_str());
+                    if(headerOpened){
+                        ImGui::Checkbox(("Active##" + std::to_string(filter->instanceID)).c_str(), &filter->isActive);
+
+                        std::string id = "##" + std::to_string(filter->instanceID);
+
+                        if(std::shared_ptr<ClippingFilter> clippingFilter = std::dynamic_pointer_cast<ClippingFilter>(filter)){
+                            ImGui::DragFloat3(("Clip Min" + id).c_str(), &clippingFilter->clipMin.x, 0.01f);
+                            ImGui::DragFloat3(("Clip Max" + id).c_str(), &clippingFilter->clipMax.x, 0.01f);
+                        }
+
+                        if(std::shared_ptr<SpatialHoleFiller> holeFiller = std::dynamic_pointer_cast<SpatialHoleFiller>(filter)){
+                            ImGui::SliderInt(("Intensity" + id).c_str(), &holeFiller->intensity, 1, 5);
+                            ImGui::SliderFloat(("Valid Neighbors" + id).c_str(), &holeFiller->requiredValidNeighborRatio, 0.f, 1.f);
+                        }
+
+                        if(std::shared_ptr<ErosionFilter> erosionFilter = std::dynamic_pointer_cast<ErosionFilter>(filter)){
+                            ImGui::SliderInt(("Intensity" + id).c_str(), &erosionFilter->intensity, 1, 5);
+                            ImGui::SliderFloat(("Threshold per Meter" + id).c_str(), &erosionFilter->distanceThresholdPerMeter, 0.f, 0.1f);
+                        }
+
+                        if(std::shared_ptr<TemporalDenoisingFilter> temporalFilter = std::dynamic_pointer_cast<TemporalDenoisingFilter>(filter)){
+                            ImGui::SliderFloat(("Sensor Noise at 1 m" + id).c_str(), &temporalFilter->measurementNoise, 0.0005f, 0.01f, "%.4f m");
+                            ImGui::SliderFloat(("Process Noise" + id).c_str(), &temporalFilter->processNoise, 0.0001f, 0.005f, "%.4f m");
+                            ImGui::SliderFloat(("Reset Threshold" + id).c_str(), &temporalFilter->resetThreshold, 1.f, 10.f, "%.1f sigma");
+
+                            for(const std::pair<const unsigned int, TemporalDenoisingStatistics>& entry : temporalFilter->getStatistics())
+                                ImGui::Text("  Camera %i: jitter %.2f -> %.2f mm, %.1f %% reset", int(entry.first), entry.second.inputJitter, entry.second.outputJitter, entry.second.resetFraction * 100.f);
+                        }
+
+                        for(const FilterTiming& timing : filterTimings){
+                            if(timing.instanceID != filter->instanceID)
+                                continue;
+
+                            ImGui::Text("Time: %.3f ms%s", timing.frameTime, timing.perCamera ? " (slowest camera)" : "");
+                            for(size_t cameraID = 0; cameraID < timing.cameraTimes.size(); ++cameraID)
+                                ImGui::Text("  Camera %i: %.3f ms", int(cameraID), timing.cameraTimes[cameraID]);
+                        }
+                    }
 
 
                     ImGui::Text("");
@@ -710,11 +908,14 @@ int main(int argc, char** argv)
 
 
 
-        // Copy to avoid memory issues in the following for loop (when new processed point cloud is set
-        // by another thread):
-        std::vector<std::shared_ptr<OrganizedPointCloud>> tmpPCs = lastProcessedPointClouds;
+        // Newest processed point clouds (the slot stays valid until the next read in this thread):
+        const std::vector<std::shared_ptr<OrganizedPointCloud>>& tmpPCs = processedPointCloudsMailbox.readLatest();
 
         for(std::shared_ptr<OrganizedPointCloud> pc : tmpPCs){
+             // Cameras which are late or inactive in this frame are nullptr (see FrameAssembler):
+             if(pc == nullptr)
+                 continue;
+
              // Camera:
              singleColorShader.bind();
              singleColorShader.setUniform("projection", projection);
@@ -760,14 +961,12 @@ int main(int argc, char** argv)
     // Cleanup (so that the callback don't access deleted memory):
     pcStreamer = nullptr;
 
+    // Stop the stages (so that they don't access the renderer anymore):
+    framePipeline.stop();
+
     // Cleanup (so that the callback don't access deleted memory):
     pcRenderer = nullptr;
 
-    shouldClose = true;
-    pointCloudsAvailableSemaphore.release();
-    filterAndIntegrateThread.join();
-    pointCloudsProcessedSemaphore.release();
-
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -0,0 +1,156 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include "src/pcfilter/StencilFilter.h"
+#include "src/util/simd/SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Removes all points (depth = 0) which are outside of an axis-aligned box in
+ * world space (i.e. after transforming them by the modelMatrix), like the
+ * clipping of the rejection pass of BlendPCR.
+ *
+ * The points of a pixel lie on its ray, which intersects the box in one
+ * interval of depths. These intervals are computed once (and again if the
+ * rays, the model matrix or the box change), so the filter only compares the
+ * depth with them. A pointwise stencil filter (see StencilFilter), vectorized
+ * (see SIMD.h).
+ */
+class ClippingFilter : public StencilFilter {
+    struct CameraState {
+        DepthRays rays;
+        Mat4f modelMatrix;
+        Vec4f clipMin;
+        Vec4f clipMax;
+
+        /** Per pixel: the depths (in mm) of the points inside of the box (empty if nearest > farthest) */
+        std::vector<uint16_t> nearest;
+        std::vector<uint16_t> farthest;
+    };
+
+    PerCameraData<CameraState> cameraStates;
+
+    /** Updates the depth intervals if the rays, the model matrix or the box changed */
+    void updateIntervals(CameraState& state, const OrganizedPointCloud& pc){
+        bool raysChanged = state.rays.update(pc.lookupImageTo3D, pc.width, pc.height);
+        Vec4f boxMin = clipMin;
+        Vec4f boxMax = clipMax;
+
+        bool isUpToDate = !raysChanged
+            && state.nearest.size() == size_t(pc.width) * pc.height
+            && std::equal(pc.modelMatrix.data, pc.modelMatrix.data + 16, state.modelMatrix.data)
+            && boxMin.x == state.clipMin.x && boxMin.y == state.clipMin.y && boxMin.z == state.clipMin.z
+            && boxMax.x == state.clipMax.x && boxMax.y == state.clipMax.y && boxMax.z == state.clipMax.z;
+
+        if(isUpToDate)
+            return;
+
+        state.modelMatrix = pc.modelMatrix;
+        state.clipMin = boxMin;
+        state.clipMax = boxMax;
+
+        // Camera space is in millimeters, world space in meters:
+        const float* m = pc.modelMatrix.data;
+        const double minimum[3] = {boxMin.x, boxMin.y, boxMin.z};
+        const double maximum[3] = {boxMax.x, boxMax.y, boxMax.z};
+        const DepthRays& rays = state.rays;
+        size_t pixelCount = size_t(pc.width) * pc.height;
+
+        state.nearest.resize(pixelCount);
+        state.farthest.resize(pixelCount);
+
+        for(size_t i = 0; i < pixelCount; ++i){
+            // Points with a depth of 0 are invalid:
+            double nearest = 1.0;
+            double farthest = 65535.0;
+
+            for(int r = 0; r < 3 && rays.rayLength[i] > 0.f; ++r){
+                // The world coordinate is depth * coefficient + translation:
+                double coefficient = (double(m[r]) * rays.rayX[i] + double(m[4 + r]) * rays.rayY[i] + m[8 + r]) * 0.001;
+                double translation = m[12 + r];
+
+                if(coefficient == 0.0){
+                    if(translation < minimum[r] || translation > maximum[r])
+                        farthest = 0.0;
+                    continue;
+                }
+
+                double first = (minimum[r] - translation) / coefficient;
+                double last = (maximum[r] - translation) / coefficient;
+                nearest = std::max(nearest, std::min(first, last));
+                farthest = std::min(farthest, std::max(first, last));
+            }
+
+            if(rays.rayLength[i] <= 0.f || nearest > farthest){
+                state.nearest[i] = 1;
+                state.farthest[i] = 0;
+            } else {
+                state.nearest[i] = uint16_t(std::ceil(nearest));
+                state.farthest[i] = uint16_t(std::floor(farthest));
+            }
+        }
+    }
+
+public:
+    /** Corners of the box in world space (in meters) */
+    Vec4f clipMin = Vec4f(-1.0f, 0.05f, -1.0, 0.0);
+    Vec4f clipMax = Vec4f(1.0f, 2.0f, 1.0, 0.0);
+
+    virtual std::string getName() override {
+        return "Clipping Filter";
+    }
+
+    virtual int getStencilRadius() override {
+        return 0;
+    }
+
+    virtual bool prepareCamera(const OrganizedPointCloud& pc, unsigned int cameraID) override {
+        if(pc.lookupImageTo3D == nullptr)
+            return false;
+
+        updateIntervals(cameraStates.get(cameraID), pc);
+        return true;
+    }
+
+    virtual void applyKernel(const OrganizedPointCloud& pc, unsigned int cameraID, int, const StencilImage& input, const StencilImage& output, const TileRect& region) override {
+        CameraState& state = cameraStates.get(cameraID);
+
+        for(int y = int(region.y); y < int(region.y + region.height); ++y){
+            size_t rowOffset = size_t(y) * pc.width + region.x;
+            const uint16_t* inputRow = &input.depth.at(region.x, y);
+            const uint16_t* nearestRow = state.nearest.data() + rowOffset;
+            const uint16_t* farthestRow = state.farthest.data() + rowOffset;
+            uint16_t* outputRow = &output.depth.at(region.x, y);
+
+            int x = 0;
+            for(; x + int(simd::Width) <= int(region.width); x += simd::Width){
+                simd::Float z = simd::loadDepth(inputRow + x);
+                simd::Mask inside = (z >= simd::loadDepth(nearestRow + x)) & (z <= simd::loadDepth(farthestRow + x));
+
+                float depths[simd::Width];
+                simd::store(depths, simd::select(inside, z, simd::Float(0.f)));
+                for(unsigned int lane = 0; lane < simd::Width; ++lane)
+                    outputRow[x + lane] = uint16_t(depths[lane]);
+            }
+
+            for(; x < int(region.width); ++x){
+                uint16_t z = inputRow[x];
+                outputRow[x] = z >= nearestRow[x] && z <= farthestRow[x] ? z : 0;
+            }
+        }
+    }
+};
+
+class ClippingFilterFactory : public FilterFactory {
+public:
+    virtual std::shared_ptr<Filter> createInstance() override {
+        return std::make_shared<ClippingFilter>();
+    }
+
+    virtual std::string getDisplayName() override {
+        return "Clipping Filter (CPU)";
+    }
+};
@@ -0,0 +1,137 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "src/util/Hash.h"
+
+/** Depth values (in mm) below this are invalid (like the 0.01 m of the GLSL filters) */
+#define DEPTH_FILTER_MIN_DEPTH 10
+
+/**
+ * State of a CPU filter which is kept per camera (e.g. scratch buffers), so that
+ * the filter can be applied to different cameras concurrently (see
+ * FilterExecutor). The same camera is never filtered concurrently.
+ */
+template<typename T>
+class PerCameraData {
+    std::mutex mutex;
+    std::map<unsigned int, std::unique_ptr<T>> data;
+
+public:
+    T& get(unsigned int cameraID){
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<T>& entry = data[cameraID];
+        if(entry == nullptr)
+            entry = std::make_unique<T>();
+        return *entry;
+    }
+};
+
+/**
+ * De-interleaved rays of the depth pixels derived from the lookupImageTo3D
+ * table of a point cloud, so that the CPU filters can load them with vector
+ * instructions. A point is (rayX * depth, rayY * depth, depth).
+ *
+ * Invalid rays (NaN in the table) are zero with a rayLength of zero.
+ *
+ * The rays are keyed by the address and size of the table, so update() doesn't
+ * hash the table every frame. Since the streamers own the tables, a table may
+ * also be overwritten in place as a whole (e.g. by a new calibration of a
+ * network sender), which a spot check of a few entries detects, or be freed
+ * and its address reused. Only then the table is fingerprinted (see
+ * hashBufferFingerprint), so the same table at another address (e.g. a
+ * restarted streamer) doesn't recompute the rays.
+ */
+struct DepthRays {
+    const float* lookup = nullptr;
+    uint64_t lookupSample = 0;
+    uint64_t lookupFingerprint = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    std::vector<float> rayX;
+    std::vector<float> rayY;
+
+    /** Length of the ray for a depth of 1 (sqrt(rayX² + rayY² + 1)) */
+    std::vector<float> rayLength;
+
+    /**
+     * Maximal change of rayX (rayY) between horizontally plus between vertically
+     * adjacent valid rays, so that the rays of two pixels which are connected by
+     * valid rays differ by at most rayStepX * max(|dx|, |dy|) in x.
+     */
+    float rayStepX = 0.f;
+    float rayStepY = 0.f;
+
+    /** Updates the rays if the table or the image size changed. Returns true if the rays changed. */
+    bool update(const float* lookupImageTo3D, unsigned int imageWidth, unsigned int imageHeight){
+        size_t pixelCount = size_t(imageWidth) * imageHeight;
+        size_t tableSize = pixelCount * 2 * sizeof(float);
+        bool isSameSize = imageWidth == width && imageHeight == height && rayX.size() == pixelCount;
+        uint64_t sample = lookupImageTo3D != nullptr ? hashBufferFingerprint(lookupImageTo3D, tableSize, 8) : 0;
+
+        if(lookupImageTo3D == lookup && isSameSize && sample == lookupSample)
+            return false;
+
+        uint64_t fingerprint = lookupImageTo3D != nullptr ? hashBufferFingerprint(lookupImageTo3D, tableSize) : 0;
+        lookup = lookupImageTo3D;
+        lookupSample = sample;
+
+        if(fingerprint == lookupFingerprint && isSameSize)
+            return false;
+
+        lookupFingerprint = fingerprint;
+        width = imageWidth;
+        height = imageHeight;
+
+        rayX.assign(pixelCount, 0.f);
+        rayY.assign(pixelCount, 0.f);
+        rayLength.assign(pixelCount, 0.f);
+        rayStepX = 0.f;
+        rayStepY = 0.f;
+
+        if(lookupImageTo3D == nullptr)
+            return true;
+
+        for(size_t i = 0; i < pixelCount; ++i){
+            float x = lookupImageTo3D[i * 2];
+            float y = lookupImageTo3D[i * 2 + 1];
+            if(std::isnan(x) || std::isnan(y))
+                continue;
+
+            rayX[i] = x;
+            rayY[i] = y;
+            rayLength[i] = std::sqrt(x * x + y * y + 1.f);
+        }
+
+        float horizontalStep[2] = {0.f, 0.f};
+        float verticalStep[2] = {0.f, 0.f};
+        for(size_t i = 0; i < pixelCount; ++i){
+            if(rayLength[i] <= 0.f)
+                continue;
+
+            size_t right = i + 1;
+            if(right % imageWidth != 0 && rayLength[right] > 0.f){
+                horizontalStep[0] = std::max(horizontalStep[0], std::abs(rayX[right] - rayX[i]));
+                horizontalStep[1] = std::max(horizontalStep[1], std::abs(rayY[right] - rayY[i]));
+            }
+
+            size_t below = i + imageWidth;
+            if(below < pixelCount && rayLength[below] > 0.f){
+                verticalStep[0] = std::max(verticalStep[0], std::abs(rayX[below] - rayX[i]));
+                verticalStep[1] = std::max(verticalStep[1], std::abs(rayY[below] - rayY[i]));
+            }
+        }
+
+        rayStepX = horizontalStep[0] + verticalStep[0];
+        rayStepY = horizontalStep[1] + verticalStep[1];
+        return true;
+    }
+};
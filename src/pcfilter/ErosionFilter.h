@@ -0,0 +1,329 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include "src/pcfilter/StencilFilter.h"
+#include "src/util/simd/SIMD.h"
+
+#include <algorithm>
+
+/**
+ * Removes points (depth = 0) of which the majority of the neighbors (square with
+ * the radius 'intensity') are invalid or farther away than
+ * distanceThresholdPerMeter * depth, like the erosion pass of BlendPCR
+ * (erosion.frag). This removes the flying pixels at the silhouettes.
+ *
+ * A stencil filter (see StencilFilter), vectorized (see SIMD.h).
+ */
+class ErosionFilter : public StencilFilter {
+    static constexpr float INVALID_POINT = 1e18f;
+
+    /** Below this fraction of the threshold, the neighbors are close despite rounding errors (see mayHaveDistantNeighbors) */
+    static constexpr float CERTAIN_DISTANCE_FACTOR = 0.9f;
+
+    PerCameraData<DepthRays> cameraRays;
+
+    /**
+     * Points of the input around the region which is filtered in camera space
+     * (in millimeters, per thread). Invalid points and the points outside of
+     * the image (the neighborhood always extends the region by the radius) are
+     * far away (INVALID_POINT), so they are never close to another point.
+     */
+    struct Neighborhood {
+        int x, y, width, height;
+        std::vector<float> points[3];
+
+        /** Per row of the neighborhood: the minimal (maximal) z within the radius in the row around each pixel of the region */
+        std::vector<float> minZ;
+        std::vector<float> maxZ;
+
+        size_t indexOf(int pX, int pY) const {
+            return size_t(pY - y) * width + (pX - x);
+        }
+    };
+
+    /**
+     * Returns the lanes in which a neighbor of the point may be farther away
+     * than CERTAIN_DISTANCE_FACTOR times the threshold, given the minimal and
+     * maximal z of the points in the neighborhood (which is INVALID_POINT if
+     * any is invalid). In the other lanes all neighbors are close, since for
+     * a neighbor q of the point p:
+     *
+     *   |q.z - p.z| <= max - min
+     *   |q.x - p.x| = |rayX(q) * (q.z - p.z) + (rayX(q) - rayX(p)) * p.z|
+     *              <= (|rayX(p)| + rayStepX) * (max - min) + rayStepX * max
+     *
+     * where rayStepX bounds the difference of the rays within the radius (see
+     * DepthRays::rayStepX, the rays between p and q are valid).
+     */
+    static simd::Mask mayHaveDistantNeighbors(simd::Float rayXOfPixel, simd::Float rayYOfPixel, simd::Float minimum, simd::Float maximum,
+                                              simd::Float rayStepX, simd::Float rayStepY, simd::Float certainDistancePerMeter){
+        simd::Float range = maximum - minimum;
+        simd::Float distanceX = (simd::abs(rayXOfPixel) + rayStepX) * range + rayStepX * maximum;
+        simd::Float distanceY = (simd::abs(rayYOfPixel) + rayStepY) * range + rayStepY * maximum;
+        simd::Float certainDistance = certainDistancePerMeter * minimum;
+
+        return distanceX * distanceX + distanceY * distanceY + range * range > certainDistance * certainDistance;
+    }
+
+    /** Returns whether the point should be kept (scalar version, used for the pixels at the end of a row which don't fill a vector) */
+    bool keepPixel(const OrganizedPointCloud& pc, const DepthRays& rays, const Neighborhood& neighborhood, int radius, float pZ, int x, int y){
+        int width = int(pc.width);
+        int height = int(pc.height);
+        size_t p = size_t(y) * width + x;
+        float pX = rays.rayX[p] * pZ;
+        float pY = rays.rayY[p] * pZ;
+        float maxDistance = distanceThresholdPerMeter * pZ;
+
+        int indicator = 0;
+        for(int dY = -radius; dY <= radius; ++dY){
+            for(int dX = -radius; dX <= radius; ++dX){
+                int qX = x + dX;
+                int qY = y + dY;
+                if(qX < 0 || qX >= width || qY < 0 || qY >= height)
+                    continue;
+
+                size_t q = neighborhood.indexOf(qX, qY);
+                float diffX = neighborhood.points[0][q] - pX;
+                float diffY = neighborhood.points[1][q] - pY;
+                float diffZ = neighborhood.points[2][q] - pZ;
+
+                if(diffX * diffX + diffY * diffY + diffZ * diffZ <= maxDistance * maxDistance)
+                    ++indicator;
+                else
+                    --indicator;
+            }
+        }
+
+        return indicator >= 0;
+    }
+
+public:
+    /** Radius of the neighborhood (square) in pixels */
+    int intensity = 2;
+
+    /** Maximal distance of a "good" neighbor, relative to the depth of the point */
+    float distanceThresholdPerMeter = 0.03f;
+
+    virtual std::string getName() override {
+        return "Erosion Filter";
+    }
+
+    virtual int getStencilRadius() override {
+        return intensity;
+    }
+
+    virtual bool prepareCamera(const OrganizedPointCloud& pc, unsigned int cameraID) override {
+        if(pc.lookupImageTo3D == nullptr)
+            return false;
+
+        cameraRays.get(cameraID).update(pc.lookupImageTo3D, pc.width, pc.height);
+        return true;
+    }
+
+    virtual void applyKernel(const OrganizedPointCloud& pc, unsigned int cameraID, int radius, const StencilImage& input, const StencilImage& output, const TileRect& region) override {
+        const DepthRays& rays = cameraRays.get(cameraID);
+        const float* rayX = rays.rayX.data();
+        const float* rayY = rays.rayY.data();
+        const float* rayLength = rays.rayLength.data();
+
+        int width = int(pc.width);
+        int height = int(pc.height);
+        int regionEndX = int(region.x + region.width);
+
+        // Points of the pixels which are read (the region enlarged by the radius):
+        static thread_local Neighborhood neighborhood;
+        neighborhood.x = int(region.x) - radius;
+        neighborhood.y = int(region.y) - radius;
+        neighborhood.width = int(region.width) + 2 * radius;
+        neighborhood.height = int(region.height) + 2 * radius;
+        for(std::vector<float>& coordinates : neighborhood.points)
+            coordinates.resize(size_t(neighborhood.width) * neighborhood.height);
+
+        float* pointsX = neighborhood.points[0].data();
+        float* pointsY = neighborhood.points[1].data();
+        float* pointsZ = neighborhood.points[2].data();
+
+        int startX = std::max(neighborhood.x, 0);
+        int endX = std::min(neighborhood.x + neighborhood.width, width);
+
+        for(int y = neighborhood.y; y < neighborhood.y + neighborhood.height; ++y){
+            size_t rowOffset = neighborhood.indexOf(neighborhood.x, y);
+
+            if(y < 0 || y >= height){
+                for(std::vector<float>& coordinates : neighborhood.points)
+                    std::fill_n(coordinates.data() + rowOffset, neighborhood.width, INVALID_POINT);
+                continue;
+            }
+
+            for(std::vector<float>& coordinates : neighborhood.points){
+                std::fill_n(coordinates.data() + rowOffset, startX - neighborhood.x, INVALID_POINT);
+                std::fill_n(coordinates.data() + neighborhood.indexOf(endX, y), neighborhood.x + neighborhood.width - endX, INVALID_POINT);
+            }
+
+            const uint16_t* depthRow = &input.depth.at(startX, y);
+            size_t rayOffset = size_t(y) * width + startX;
+            size_t pointOffset = neighborhood.indexOf(startX, y);
+
+            int x = 0;
+            for(; x + int(simd::Width) <= endX - startX; x += simd::Width){
+                size_t i = rayOffset + x;
+                size_t j = pointOffset + x;
+                simd::Float z = simd::loadDepth(depthRow + x);
+                simd::Mask valid = (z >= simd::Float(DEPTH_FILTER_MIN_DEPTH)) & (simd::load(rayLength + i) > simd::Float(0.f));
+
+                simd::store(pointsX + j, simd::select(valid, simd::load(rayX + i) * z, simd::Float(INVALID_POINT)));
+                simd::store(pointsY + j, simd::select(valid, simd::load(rayY + i) * z, simd::Float(INVALID_POINT)));
+                simd::store(pointsZ + j, simd::select(valid, z, simd::Float(INVALID_POINT)));
+            }
+
+            for(; x < endX - startX; ++x){
+                size_t i = rayOffset + x;
+                size_t j = pointOffset + x;
+                float z = depthRow[x];
+                bool valid = z >= DEPTH_FILTER_MIN_DEPTH && rayLength[i] > 0.f;
+
+                pointsX[j] = valid ? rayX[i] * z : INVALID_POINT;
+                pointsY[j] = valid ? rayY[i] * z : INVALID_POINT;
+                pointsZ[j] = valid ? z : INVALID_POINT;
+            }
+        }
+
+        // Minimal and maximal z of the rows (separable, the columns follow per pixel):
+        neighborhood.minZ.resize(size_t(region.width) * neighborhood.height);
+        neighborhood.maxZ.resize(size_t(region.width) * neighborhood.height);
+
+        for(int row = 0; row < neighborhood.height; ++row){
+            const float* z = pointsZ + size_t(row) * neighborhood.width;
+            float* minRow = neighborhood.minZ.data() + size_t(row) * region.width;
+            float* maxRow = neighborhood.maxZ.data() + size_t(row) * region.width;
+
+            int x = 0;
+            for(; x + int(simd::Width) <= int(region.width); x += simd::Width){
+                simd::Float minimum = simd::load(z + x);
+                simd::Float maximum = minimum;
+                for(int dX = 1; dX <= 2 * radius; ++dX){
+                    simd::Float neighbor = simd::load(z + x + dX);
+                    minimum = simd::min(minimum, neighbor);
+                    maximum = simd::max(maximum, neighbor);
+                }
+                simd::store(minRow + x, minimum);
+                simd::store(maxRow + x, maximum);
+            }
+
+            for(; x < int(region.width); ++x){
+                minRow[x] = *std::min_element(z + x, z + x + 2 * radius + 1);
+                maxRow[x] = *std::max_element(z + x, z + x + 2 * radius + 1);
+            }
+        }
+
+        // See mayHaveDistantNeighbors:
+        simd::Float rayStepX(radius * rays.rayStepX);
+        simd::Float rayStepY(radius * rays.rayStepY);
+        simd::Float certainDistancePerMeter(CERTAIN_DISTANCE_FACTOR * distanceThresholdPerMeter);
+
+        // A point is kept, if at least half of its neighbors (inside of the image) are close:
+        int diameter = 2 * radius + 1;
+        simd::Float neighborCount = simd::Float(float(diameter * diameter));
+        simd::Float rowNeighbors = simd::Float(float(diameter));
+
+        for(int y = int(region.y); y < int(region.y + region.height); ++y){
+            int rowsInImage = std::min(y + radius, height - 1) - std::max(y - radius, 0) + 1;
+
+            int x = int(region.x);
+            for(; x + int(simd::Width) <= regionEndX; x += simd::Width){
+                const uint16_t* inputDepth = &input.depth.at(x, y);
+                uint16_t* outputDepth = &output.depth.at(x, y);
+
+                simd::Float z = simd::loadDepth(inputDepth);
+                simd::Mask isValid = z > simd::Float(0.f);
+                if(!simd::any(isValid)){
+                    if(outputDepth != inputDepth)
+                        std::copy(inputDepth, inputDepth + simd::Width, outputDepth);
+                    continue;
+                }
+
+                // If all neighbors are certainly close, the points are kept (the points at the
+                // borders of the image are not, since the neighbors outside of it are invalid):
+                const float* minRow = neighborhood.minZ.data() + size_t(y - radius - neighborhood.y) * region.width + (x - int(region.x));
+                const float* maxRow = neighborhood.maxZ.data() + size_t(y - radius - neighborhood.y) * region.width + (x - int(region.x));
+                simd::Float minimum = simd::load(minRow);
+                simd::Float maximum = simd::load(maxRow);
+                for(int row = 1; row <= 2 * radius; ++row){
+                    minimum = simd::min(minimum, simd::load(minRow + size_t(row) * region.width));
+                    maximum = simd::max(maximum, simd::load(maxRow + size_t(row) * region.width));
+                }
+
+                size_t rayOffset = size_t(y) * width + x;
+                simd::Float rayXOfPixel = simd::load(rayX + rayOffset);
+                simd::Float rayYOfPixel = simd::load(rayY + rayOffset);
+
+                if(!simd::any(isValid & mayHaveDistantNeighbors(rayXOfPixel, rayYOfPixel, minimum, maximum, rayStepX, rayStepY, certainDistancePerMeter))){
+                    if(outputDepth != inputDepth)
+                        std::copy(inputDepth, inputDepth + simd::Width, outputDepth);
+                    continue;
+                }
+
+                simd::Float requiredCloseNeighbors(0.5f * diameter * diameter);
+                if(rowsInImage < diameter || x < radius || x + int(simd::Width) + radius > width){
+                    float required[simd::Width];
+                    for(int lane = 0; lane < int(simd::Width); ++lane){
+                        int columnsInImage = std::min(x + lane + radius, width - 1) - std::max(x + lane - radius, 0) + 1;
+                        required[lane] = 0.5f * columnsInImage * rowsInImage;
+                    }
+                    requiredCloseNeighbors = simd::load(required);
+                }
+
+                simd::Float pX = rayXOfPixel * z;
+                simd::Float pY = rayYOfPixel * z;
+                simd::Float maxDistance = simd::Float(distanceThresholdPerMeter) * z;
+                simd::Float maxSquaredDistance = maxDistance * maxDistance;
+
+                // Stops after a row of neighbors once it's decided for all lanes whether they are kept:
+                simd::Float closeNeighbors(0.f);
+                simd::Float remainingNeighbors = neighborCount;
+
+                for(int dY = -radius; dY <= radius; ++dY){
+                    size_t neighborOffset = neighborhood.indexOf(x, y + dY);
+
+                    for(int dX = -radius; dX <= radius; ++dX){
+                        simd::Float diffX = simd::load(pointsX + neighborOffset + dX) - pX;
+                        simd::Float diffY = simd::load(pointsY + neighborOffset + dX) - pY;
+                        simd::Float diffZ = simd::load(pointsZ + neighborOffset + dX) - z;
+
+                        simd::Mask close = diffX * diffX + diffY * diffY + diffZ * diffZ <= maxSquaredDistance;
+                        closeNeighbors = closeNeighbors + simd::select(close, simd::Float(1.f), simd::Float(0.f));
+                    }
+
+                    remainingNeighbors = remainingNeighbors - rowNeighbors;
+                    simd::Mask isUndecided = isValid & (closeNeighbors < requiredCloseNeighbors)
+                        & (closeNeighbors + remainingNeighbors >= requiredCloseNeighbors);
+                    if(!simd::any(isUndecided))
+                        break;
+                }
+
+                float depths[simd::Width];
+                simd::store(depths, simd::select(closeNeighbors >= requiredCloseNeighbors, z, simd::Float(0.f)));
+                for(unsigned int lane = 0; lane < simd::Width; ++lane)
+                    outputDepth[lane] = uint16_t(depths[lane]);
+            }
+
+            // The remaining pixels of the row (less than a vector):
+            for(; x < regionEndX; ++x){
+                uint16_t depth = input.depth.at(x, y);
+                output.depth.at(x, y) = depth != 0 && !keepPixel(pc, rays, neighborhood, radius, depth, x, y) ? 0 : depth;
+            }
+        }
+    }
+};
+
+class ErosionFilterFactory : public FilterFactory {
+public:
+    virtual std::shared_ptr<Filter> createInstance() override {
+        return std::make_shared<ErosionFilter>();
+    }
+
+    virtual std::string getDisplayName() override {
+        return "Erosion Filter (CPU)";
+    }
+};
@@ -1,6 +1,15 @@
 // © 2023, CGVR (https://cgvr.informatik.uni-bremen.de/),
 // Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)#pragma once
 #include "src/pcfilter/Filter.h"
+#include "src/pcfilter/ClippingFilter.h"
+#include "src/pcfilter/SpatialHoleFiller.h"
+#include "src/pcfilter/ErosionFilter.h"
+#include "src/pcfilter/TemporalDenoisingFilter.h"
 
 int Filter::instanceCounter = 0;
-std::vector<FilterFactory*> FilterFactory::availableFilterFactories = std::vector<FilterFactory*>();
+std::vector<FilterFactory*> FilterFactory::availableFilterFactories = {
+    new ClippingFilterFactory(),
+    new SpatialHoleFillerFactory(),
+    new ErosionFilterFactory(),
+    new TemporalDenoisingFilterFactory()
+};
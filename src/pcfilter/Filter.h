@@ -5,6 +5,8 @@
 #include "util/OrganizedPointCloud.h"
 
 #include <vector>
+#include <memory>
+#include <string>
 
 class FilterFactory;
 
@@ -31,9 +33,56 @@ public:
     Filter() : instanceID(instanceCounter++){}
 
     /**
-     * Applies the filter to the point cloud.
+     * Name of the filter (shown in the GUI and in the timings).
      */
-    virtual void applyFilter(std::vector<std::shared_ptr<OrganizedPointCloud>>& images) = 0;
+    virtual std::string getName(){
+        return "Unknown";
+    }
+
+    /**
+     * Should return true if the filter processes the point cloud of every camera
+     * independently of the others. The FilterExecutor then calls
+     * applyFilterToCamera(...) for all cameras concurrently instead of
+     * applyFilter(...).
+     */
+    virtual bool isCameraIndependent(){
+        return false;
+    }
+
+    /**
+     * Should return true if the result depends on the previous frames (e.g. a
+     * temporal filter). The FilterExecutor doesn't apply such filters to a point
+     * cloud which the streamer hands out again (e.g. while paused), so that their
+     * state only advances once per frame.
+     */
+    virtual bool isStateful(){
+        return false;
+    }
+
+    /**
+     * Applies the filter to the point cloud of one camera (only used if the
+     * filter is camera independent). May be called concurrently for different
+     * cameras. By default, applyFilter(...) is applied to a frame which only
+     * consists of this point cloud, so a filter has to override at least one
+     * of both.
+     */
+    virtual void applyFilterToCamera(std::shared_ptr<OrganizedPointCloud>& image, unsigned int){
+        std::vector<std::shared_ptr<OrganizedPointCloud>> images = {image};
+        applyFilter(images);
+        image = images[0];
+    }
+
+    /**
+     * Applies the filter to the point clouds of all cameras (e.g. if it needs
+     * data of multiple cameras). By default, the point clouds are filtered one
+     * after another by applyFilterToCamera(...).
+     */
+    virtual void applyFilter(std::vector<std::shared_ptr<OrganizedPointCloud>>& images){
+        for(unsigned int cameraID = 0; cameraID < images.size(); ++cameraID){
+            if(images[cameraID] != nullptr)
+                applyFilterToCamera(images[cameraID], cameraID);
+        }
+    }
 };
 
 /**
@@ -0,0 +1,273 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include "src/pcfilter/Filter.h"
+#include "src/pcfilter/StencilFilter.h"
+#include "src/util/WorkerGroup.h"
+#include "src/util/BufferPool.h"
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Timings of one filter of the chain (see FilterExecutor::getTimings) */
+struct FilterTiming {
+    int instanceID = -1;
+    std::string name;
+
+    /** Whether the filter was applied per camera (see Filter::isCameraIndependent) */
+    bool perCamera = false;
+
+    /**
+     * Moving average of the time the filter adds to a frame in milliseconds
+     * (the slowest camera, if applied per camera)
+     */
+    float frameTime = 0.f;
+
+    /** Moving average of the time per camera in milliseconds (only if applied per camera) */
+    std::vector<float> cameraTimes;
+};
+
+/**
+ * Applies a chain of filters to multi-camera frames using a pool of worker
+ * threads.
+ *
+ * Consecutive camera independent filters form a segment, which is applied to
+ * all cameras concurrently: every worker takes the next camera and runs all
+ * filters of the segment on it in the order of the chain. Filters which need
+ * the whole frame are applied on the calling thread between the segments. So
+ * the latency of the camera independent filters scales down with the number of
+ * cores (up to the number of cameras).
+ *
+ * Stencil filters (see StencilFilter) are applied strip by strip, one filter
+ * after another (see StencilChain).
+ *
+ * Point clouds which must not be modified (see OrganizedPointCloud::isWritable)
+ * are replaced by a copy in pooled buffers before the first filter is applied.
+ * If the first filter is a stencil filter, it reads the original and writes
+ * the copy, so the images aren't copied beforehand.
+ * If the streamer hands out the same point cloud of a camera again, stateful
+ * filters (see Filter::isStateful) are not applied to it.
+ */
+class FilterExecutor {
+    WorkerGroup workers;
+
+    std::mutex timingsMutex;
+    std::vector<FilterTiming> timings;
+
+    /** Applies the stencil filters */
+    StencilChain stencilChain;
+
+    /** Buffers of the copies of the point clouds which are not writable */
+    std::shared_ptr<BufferPool> bufferPool = std::make_shared<BufferPool>();
+
+    /** Input point cloud of the previous frame per camera (to detect frames which are handed out again) */
+    std::vector<std::weak_ptr<OrganizedPointCloud>> previousInputs;
+
+    /**
+     * Replaces the point cloud by a copy which can be modified, if it's not
+     * writable. The copy keeps the original alive, since it shares its high
+     * resolution colors and lookup tables. If copiesImages is false, the depth
+     * and colors of the copy are not initialized (the caller writes them).
+     */
+    void makeWritable(std::shared_ptr<OrganizedPointCloud>& pc, bool copiesImages = true){
+        if(pc == nullptr || pc->isWritable)
+            return;
+
+        size_t pixelCount = size_t(pc->width) * pc->height;
+
+        std::shared_ptr<OrganizedPointCloud> copy = std::make_shared<OrganizedPointCloud>(pc->width, pc->height);
+        copy->bufferPool = bufferPool;
+        copy->source = pc;
+
+        if(pc->depth != nullptr){
+            copy->depth = bufferPool->acquire<uint16_t>(pixelCount);
+            if(copiesImages)
+                std::memcpy(copy->depth, pc->depth, pixelCount * sizeof(uint16_t));
+        }
+
+        if(pc->colors != nullptr){
+            copy->colors = bufferPool->acquire<Vec4b>(pixelCount);
+            if(copiesImages)
+                std::memcpy(copy->colors, pc->colors, pixelCount * sizeof(Vec4b));
+        }
+
+        copy->frameID = pc->frameID;
+        copy->lookup3DToImage = pc->lookup3DToImage;
+        copy->lookupImageTo3D = pc->lookupImageTo3D;
+        copy->lookup3DToImageSize = pc->lookup3DToImageSize;
+        copy->highResWidth = pc->highResWidth;
+        copy->highResHeight = pc->highResHeight;
+        copy->highResColors = pc->highResColors;
+        copy->modelMatrix = pc->modelMatrix;
+        copy->timestamp = pc->timestamp;
+        copy->attachments = pc->attachments;
+        copy->dirtyTiles = pc->dirtyTiles;
+
+        pc = copy;
+    }
+
+    /** Returns the timing of the filter (created if it's new in the chain) */
+    FilterTiming& timingOf(std::vector<FilterTiming>& previousTimings, const std::shared_ptr<Filter>& filter){
+        FilterTiming timing;
+        for(FilterTiming& previous : previousTimings){
+            if(previous.instanceID == filter->instanceID){
+                timing = previous;
+                break;
+            }
+        }
+
+        timing.instanceID = filter->instanceID;
+        timing.name = filter->getName();
+        timing.perCamera = filter->isCameraIndependent();
+        if(!timing.perCamera)
+            timing.cameraTimes.clear();
+
+        timings.push_back(timing);
+        return timings.back();
+    }
+
+    static float average(float previous, float current, bool isFirst){
+        return isFirst ? current : current * 0.1f + previous * 0.9f;
+    }
+
+public:
+    FilterExecutor(unsigned int workerCount = std::max(std::thread::hardware_concurrency(), 1u))
+        : workers(workerCount){}
+
+    /**
+     * Applies all active filters of the chain to the point clouds (index =
+     * camera ID, nullptr for inactive cameras).
+     */
+    void apply(std::vector<std::shared_ptr<Filter>>& filters, std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds){
+        if(pointClouds.empty())
+            return;
+
+        // Point clouds which the streamer handed out already in the previous frame:
+        std::vector<bool> isRepeated(pointClouds.size(), false);
+        bool isRepeatedFrame = true;
+        previousInputs.resize(pointClouds.size());
+        for(size_t cameraID = 0; cameraID < pointClouds.size(); ++cameraID){
+            isRepeated[cameraID] = pointClouds[cameraID] != nullptr && previousInputs[cameraID].lock() == pointClouds[cameraID];
+            isRepeatedFrame = isRepeatedFrame && (isRepeated[cameraID] || pointClouds[cameraID] == nullptr);
+            previousInputs[cameraID] = pointClouds[cameraID];
+        }
+
+        std::vector<std::shared_ptr<Filter>> activeFilters;
+        for(std::shared_ptr<Filter>& filter : filters){
+            if(filter->isActive)
+                activeFilters.push_back(filter);
+        }
+
+        // Times of the filters (rows) per camera (columns) of this frame:
+        std::vector<std::vector<float>> frameTimes(activeFilters.size(), std::vector<float>(pointClouds.size(), 0.f));
+
+        size_t segmentStart = 0;
+        while(segmentStart < activeFilters.size()){
+            if(!activeFilters[segmentStart]->isCameraIndependent()){
+                auto startTime = std::chrono::high_resolution_clock::now();
+                if(!isRepeatedFrame || !activeFilters[segmentStart]->isStateful()){
+                    for(std::shared_ptr<OrganizedPointCloud>& pc : pointClouds)
+                        makeWritable(pc);
+
+                    activeFilters[segmentStart]->applyFilter(pointClouds);
+                }
+                frameTimes[segmentStart].assign(1, std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+
+                ++segmentStart;
+                continue;
+            }
+
+            size_t segmentEnd = segmentStart;
+            while(segmentEnd < activeFilters.size() && activeFilters[segmentEnd]->isCameraIndependent())
+                ++segmentEnd;
+
+            // The filters parallelize over the rows themselves (OpenMP), so the cores
+            // are split between the workers which process a camera:
+            unsigned int concurrentCameras = std::max(1u, std::min(workers.size(), (unsigned int) pointClouds.size()));
+            int threadsPerCamera = std::max(1, int(std::max(std::thread::hardware_concurrency(), 1u) / concurrentCameras));
+
+            std::atomic<unsigned int> nextCamera(0);
+            workers.run([&](int){
+                #ifdef _OPENMP
+                omp_set_num_threads(threadsPerCamera);
+                #else
+                (void) threadsPerCamera;
+                #endif
+
+                for(unsigned int cameraID = nextCamera++; cameraID < pointClouds.size(); cameraID = nextCamera++){
+                    if(pointClouds[cameraID] == nullptr)
+                        continue;
+
+                    for(size_t f = segmentStart; f < segmentEnd; ++f){
+                        if(isRepeated[cameraID] && activeFilters[f]->isStateful())
+                            continue;
+
+                        auto startTime = std::chrono::high_resolution_clock::now();
+
+                        // Stencil filters write all pixels, so they can fill the copy from the original:
+                        std::shared_ptr<OrganizedPointCloud> original = pointClouds[cameraID];
+                        StencilFilter* stencilFilter = dynamic_cast<StencilFilter*>(activeFilters[f].get());
+                        makeWritable(pointClouds[cameraID], stencilFilter == nullptr);
+
+                        if(stencilFilter != nullptr){
+                            stencilChain.apply({stencilFilter}, *original, *pointClouds[cameraID], cameraID);
+                        } else {
+                            activeFilters[f]->applyFilterToCamera(pointClouds[cameraID], cameraID);
+                        }
+
+                        frameTimes[f][cameraID] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+                    }
+                }
+            });
+
+            segmentStart = segmentEnd;
+        }
+
+        std::lock_guard<std::mutex> lock(timingsMutex);
+        std::vector<FilterTiming> previousTimings;
+        previousTimings.swap(timings);
+
+        for(size_t f = 0; f < activeFilters.size(); ++f){
+            bool isFirst = std::none_of(previousTimings.begin(), previousTimings.end(), [&](const FilterTiming& previous){
+                return previous.instanceID == activeFilters[f]->instanceID;
+            });
+
+            FilterTiming& timing = timingOf(previousTimings, activeFilters[f]);
+            if(timing.perCamera){
+                if(timing.cameraTimes.size() != pointClouds.size()){
+                    timing.cameraTimes.assign(pointClouds.size(), 0.f);
+                    isFirst = true;
+                }
+
+                for(size_t cameraID = 0; cameraID < pointClouds.size(); ++cameraID)
+                    timing.cameraTimes[cameraID] = average(timing.cameraTimes[cameraID], frameTimes[f][cameraID], isFirst);
+            }
+
+            float frameTime = *std::max_element(frameTimes[f].begin(), frameTimes[f].end());
+            timing.frameTime = average(timing.frameTime, frameTime, isFirst);
+        }
+    }
+
+    /** Number of worker threads which apply the camera independent filters */
+    unsigned int getWorkerCount(){
+        return workers.size();
+    }
+
+    /** Returns the timings of the active filters in the order of the chain */
+    std::vector<FilterTiming> getTimings(){
+        std::lock_guard<std::mutex> lock(timingsMutex);
+        return timings;
+    }
+};
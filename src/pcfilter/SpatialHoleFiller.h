@@ -0,0 +1,350 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include "src/pcfilter/StencilFilter.h"
+#include "src/util/simd/SIMD.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * Fills invalid pixels whose neighborhood (diamond with the radius 'intensity')
+ * is mostly valid, like the hole filling pass of BlendPCR
+ * (holeFilling.frag): the distance to the camera of the filled point is the
+ * average distance of the valid neighbors, and its color is their average
+ * color.
+ *
+ * A stencil filter (see StencilFilter), vectorized (see SIMD.h).
+ */
+class SpatialHoleFiller : public StencilFilter {
+    PerCameraData<DepthRays> cameraRays;
+
+    /**
+     * Per pixel values of the input around the region which is filtered (per
+     * thread). The neighborhood always extends the region by the radius, the
+     * pixels outside of the image are invalid.
+     */
+    struct Neighborhood {
+        int x, y, width, height;
+
+        /** Distance to the camera (depth * rayLength) of valid pixels, else 0 */
+        std::vector<float> distances;
+
+        /** 1 for valid pixels, else 0 */
+        std::vector<float> validity;
+
+        /**
+         * Per row of the neighborhood and pixel of the region: the number of
+         * valid pixels within k pixels in the row (k in [1, radius]), of which
+         * the rows of the diamond consist.
+         */
+        std::vector<std::vector<float>> validInRow;
+
+        size_t indexOf(int pX, int pY) const {
+            return size_t(pY - y) * width + (pX - x);
+        }
+    };
+
+    /**
+     * Writes the pixel into the output, filled if it's invalid and enough
+     * neighbors are valid (scalar version, used for the pixels at the end of a
+     * row which don't fill a vector).
+     */
+    void filterPixel(const OrganizedPointCloud& pc, const DepthRays& rays, const Neighborhood& neighborhood, int radius,
+                     const StencilImage& input, const StencilImage& output, int x, int y){
+        int width = int(pc.width);
+        int height = int(pc.height);
+        size_t p = size_t(y) * width + x;
+        bool hasColors = input.colors.data != nullptr && output.colors.data != nullptr;
+
+        output.depth.at(x, y) = input.depth.at(x, y);
+        if(hasColors)
+            output.colors.at(x, y) = input.colors.at(x, y);
+
+        if(input.depth.at(x, y) >= DEPTH_FILTER_MIN_DEPTH)
+            return;
+
+        float sumLength = 0.f;
+        int sumColor[3] = {0, 0, 0};
+        float validNeighbors = 0.f;
+        int totalNeighbors = 0;
+
+        for(int dY = -radius; dY <= radius; ++dY){
+            int rowRadius = radius - std::abs(dY);
+
+            for(int dX = -rowRadius; dX <= rowRadius; ++dX){
+                int qX = x + dX;
+                int qY = y + dY;
+                if(qX < 0 || qX >= width || qY < 0 || qY >= height)
+                    continue;
+
+                ++totalNeighbors;
+
+                size_t q = neighborhood.indexOf(qX, qY);
+                if(neighborhood.validity[q] == 0.f)
+                    continue;
+
+                sumLength += neighborhood.distances[q];
+                if(hasColors){
+                    const Vec4b& color = input.colors.at(qX, qY);
+                    sumColor[0] += color.x;
+                    sumColor[1] += color.y;
+                    sumColor[2] += color.z;
+                }
+                validNeighbors += 1.f;
+            }
+        }
+
+        if(validNeighbors < std::max(requiredValidNeighborRatio * totalNeighbors, 1.f) || rays.rayLength[p] <= 0.f)
+            return;
+
+        output.depth.at(x, y) = uint16_t(std::min(sumLength / (validNeighbors * rays.rayLength[p]) + 0.5f, 65535.f));
+
+        if(hasColors){
+            int validCount = int(validNeighbors);
+            output.colors.at(x, y) = Vec4b(sumColor[0] / validCount, sumColor[1] / validCount, sumColor[2] / validCount, 255);
+        }
+    }
+
+public:
+    /** Radius of the neighborhood (diamond) in pixels */
+    int intensity = 2;
+
+    /** Fraction of the neighbors which have to be valid to fill a pixel */
+    float requiredValidNeighborRatio = 0.5f;
+
+    virtual std::string getName() override {
+        return "Spatial Hole Filler";
+    }
+
+    virtual int getStencilRadius() override {
+        return intensity;
+    }
+
+    virtual bool modifiesColors() override {
+        return true;
+    }
+
+    virtual bool prepareCamera(const OrganizedPointCloud& pc, unsigned int cameraID) override {
+        if(pc.lookupImageTo3D == nullptr)
+            return false;
+
+        cameraRays.get(cameraID).update(pc.lookupImageTo3D, pc.width, pc.height);
+        return true;
+    }
+
+    virtual void applyKernel(const OrganizedPointCloud& pc, unsigned int cameraID, int radius, const StencilImage& input, const StencilImage& output, const TileRect& region) override {
+        const DepthRays& rays = cameraRays.get(cameraID);
+        const float* rayLength = rays.rayLength.data();
+
+        int width = int(pc.width);
+        int height = int(pc.height);
+        int regionEndX = int(region.x + region.width);
+        bool hasColors = input.colors.data != nullptr && output.colors.data != nullptr;
+
+        // Distances and validity of the pixels which are read (the region enlarged by the radius):
+        static thread_local Neighborhood neighborhood;
+        neighborhood.x = int(region.x) - radius;
+        neighborhood.y = int(region.y) - radius;
+        neighborhood.width = int(region.width) + 2 * radius;
+        neighborhood.height = int(region.height) + 2 * radius;
+        size_t neighborhoodSize = size_t(neighborhood.width) * neighborhood.height;
+        neighborhood.distances.resize(neighborhoodSize);
+        neighborhood.validity.resize(neighborhoodSize);
+
+        float* distances = neighborhood.distances.data();
+        float* validity = neighborhood.validity.data();
+
+        int startX = std::max(neighborhood.x, 0);
+        int endX = std::min(neighborhood.x + neighborhood.width, width);
+
+        for(int y = neighborhood.y; y < neighborhood.y + neighborhood.height; ++y){
+            size_t rowOffset = neighborhood.indexOf(neighborhood.x, y);
+
+            if(y < 0 || y >= height){
+                std::fill_n(distances + rowOffset, neighborhood.width, 0.f);
+                std::fill_n(validity + rowOffset, neighborhood.width, 0.f);
+                continue;
+            }
+
+            for(float* values : {distances, validity}){
+                std::fill_n(values + rowOffset, startX - neighborhood.x, 0.f);
+                std::fill_n(values + neighborhood.indexOf(endX, y), neighborhood.x + neighborhood.width - endX, 0.f);
+            }
+
+            const uint16_t* depthRow = &input.depth.at(startX, y);
+            const float* rayLengthRow = rayLength + size_t(y) * width + startX;
+            float* distanceRow = distances + neighborhood.indexOf(startX, y);
+            float* validityRow = validity + neighborhood.indexOf(startX, y);
+
+            int x = 0;
+            for(; x + int(simd::Width) <= endX - startX; x += simd::Width){
+                simd::Float z = simd::loadDepth(depthRow + x);
+                simd::Float pRayLength = simd::load(rayLengthRow + x);
+                simd::Mask valid = (z >= simd::Float(DEPTH_FILTER_MIN_DEPTH)) & (pRayLength > simd::Float(0.f));
+
+                simd::store(distanceRow + x, simd::select(valid, z * pRayLength, simd::Float(0.f)));
+                simd::store(validityRow + x, simd::select(valid, simd::Float(1.f), simd::Float(0.f)));
+            }
+
+            for(; x < endX - startX; ++x){
+                bool valid = depthRow[x] >= DEPTH_FILTER_MIN_DEPTH && rayLengthRow[x] > 0.f;
+                distanceRow[x] = valid ? depthRow[x] * rayLengthRow[x] : 0.f;
+                validityRow[x] = valid ? 1.f : 0.f;
+            }
+        }
+
+        // Valid pixels within k pixels in the rows (the sums are exact, so their order doesn't matter):
+        neighborhood.validInRow.resize(std::max(radius + 1, int(neighborhood.validInRow.size())));
+        for(int k = 1; k <= radius; ++k)
+            neighborhood.validInRow[k].resize(size_t(region.width) * neighborhood.height);
+
+        for(int row = 0; row < neighborhood.height; ++row){
+            const float* validityRow = validity + size_t(row) * neighborhood.width + radius;
+            size_t rowOffset = size_t(row) * region.width;
+
+            int x = 0;
+            for(; x + int(simd::Width) <= int(region.width); x += simd::Width){
+                simd::Float count = simd::load(validityRow + x);
+                for(int k = 1; k <= radius; ++k){
+                    count = count + (simd::load(validityRow + x - k) + simd::load(validityRow + x + k));
+                    simd::store(neighborhood.validInRow[k].data() + rowOffset + x, count);
+                }
+            }
+
+            for(; x < int(region.width); ++x){
+                float count = validityRow[x];
+                for(int k = 1; k <= radius; ++k){
+                    count += validityRow[x - k] + validityRow[x + k];
+                    neighborhood.validInRow[k][rowOffset + x] = count;
+                }
+            }
+        }
+
+        int totalNeighbors = 2 * radius * (radius + 1) + 1;
+
+        // Per row of the diamond: the valid pixels of the row within its radius around the pixels of the region
+        // (pointers instead of the vectors, which would be reloaded after every store of a color):
+        std::vector<const float*> validInDiamondRows(2 * radius + 1);
+
+        for(int y = int(region.y); y < int(region.y + region.height); ++y){
+            for(int dY = -radius; dY <= radius; ++dY){
+                int rowRadius = radius - std::abs(dY);
+                if(rowRadius == 0)
+                    validInDiamondRows[dY + radius] = validity + neighborhood.indexOf(int(region.x), y + dY);
+                else
+                    validInDiamondRows[dY + radius] = neighborhood.validInRow[rowRadius].data() + size_t(y + dY - neighborhood.y) * region.width;
+            }
+
+            const uint16_t* inputRow = &input.depth.at(0, y);
+            uint16_t* outputRow = &output.depth.at(0, y);
+            const Vec4b* inputColorRow = hasColors ? &input.colors.at(0, y) : nullptr;
+            Vec4b* outputColorRow = hasColors ? &output.colors.at(0, y) : nullptr;
+
+            int x = int(region.x);
+            for(; x + int(simd::Width) <= regionEndX; x += simd::Width){
+                const uint16_t* inputDepth = inputRow + x;
+                uint16_t* outputDepth = outputRow + x;
+
+                if(outputDepth != inputDepth)
+                    std::copy(inputDepth, inputDepth + simd::Width, outputDepth);
+                if(outputColorRow != inputColorRow)
+                    std::copy(inputColorRow + x, inputColorRow + x + simd::Width, outputColorRow + x);
+
+                simd::Float z = simd::loadDepth(inputDepth);
+                simd::Mask invalid = z < simd::Float(DEPTH_FILTER_MIN_DEPTH);
+                if(!simd::any(invalid))
+                    continue;
+
+                // Valid neighbors (the rows of the diamond):
+                simd::Float validNeighbors(0.f);
+                for(const float* validInDiamondRow : validInDiamondRows)
+                    validNeighbors = validNeighbors + simd::load(validInDiamondRow + (x - int(region.x)));
+
+                // Only the neighbors inside of the image count (at the borders of the image):
+                simd::Float requiredValidNeighbors(std::max(requiredValidNeighborRatio * totalNeighbors, 1.f));
+                if(y < radius || y + radius >= height || x < radius || x + int(simd::Width) + radius > width){
+                    float required[simd::Width];
+                    for(int lane = 0; lane < int(simd::Width); ++lane){
+                        int neighborsInImage = 0;
+                        for(int dY = -radius; dY <= radius; ++dY){
+                            int rowRadius = radius - std::abs(dY);
+                            if(y + dY >= 0 && y + dY < height)
+                                neighborsInImage += std::min(x + lane + rowRadius, width - 1) - std::max(x + lane - rowRadius, 0) + 1;
+                        }
+                        required[lane] = std::max(requiredValidNeighborRatio * neighborsInImage, 1.f);
+                    }
+                    requiredValidNeighbors = simd::load(required);
+                }
+
+                simd::Float pRayLength = simd::load(rayLength + size_t(y) * width + x);
+                simd::Mask fill = invalid & (pRayLength > simd::Float(0.f)) & (validNeighbors >= requiredValidNeighbors);
+                if(!simd::any(fill))
+                    continue;
+
+                simd::Float sumDistance(0.f);
+                for(int dY = -radius; dY <= radius; ++dY){
+                    int rowRadius = radius - std::abs(dY);
+                    size_t neighborOffset = neighborhood.indexOf(x, y + dY);
+
+                    for(int dX = -rowRadius; dX <= rowRadius; ++dX)
+                        sumDistance = sumDistance + simd::load(distances + neighborOffset + dX);
+                }
+
+                simd::Float divisor = simd::select(fill, validNeighbors * pRayLength, simd::Float(1.f));
+                simd::Float filledDepth = simd::select(fill, sumDistance / divisor + simd::Float(0.5f), z);
+
+                float depths[simd::Width];
+                simd::store(depths, filledDepth);
+                for(unsigned int lane = 0; lane < simd::Width; ++lane)
+                    outputDepth[lane] = uint16_t(std::min(depths[lane], 65535.f));
+
+                if(!hasColors)
+                    continue;
+
+                // Average color of the valid neighbors (only for the filled pixels):
+                float filled[simd::Width];
+                simd::store(filled, simd::select(fill, validNeighbors, simd::Float(0.f)));
+                for(unsigned int lane = 0; lane < simd::Width; ++lane){
+                    if(filled[lane] == 0.f)
+                        continue;
+
+                    int sumColor[3] = {0, 0, 0};
+                    for(int dY = -radius; dY <= radius; ++dY){
+                        int rowRadius = radius - std::abs(dY);
+
+                        for(int dX = -rowRadius; dX <= rowRadius; ++dX){
+                            int qX = x + int(lane) + dX;
+                            if(validity[neighborhood.indexOf(qX, y + dY)] == 0.f)
+                                continue;
+
+                            const Vec4b& color = input.colors.at(qX, y + dY);
+                            sumColor[0] += color.x;
+                            sumColor[1] += color.y;
+                            sumColor[2] += color.z;
+                        }
+                    }
+
+                    int validCount = int(filled[lane]);
+                    output.colors.at(x + int(lane), y) = Vec4b(sumColor[0] / validCount, sumColor[1] / validCount, sumColor[2] / validCount, 255);
+                }
+            }
+
+            // The remaining pixels of the row (less than a vector):
+            for(; x < regionEndX; ++x)
+                filterPixel(pc, rays, neighborhood, radius, input, output, x, y);
+        }
+    }
+};
+
+class SpatialHoleFillerFactory : public FilterFactory {
+public:
+    virtual std::shared_ptr<Filter> createInstance() override {
+        return std::make_shared<SpatialHoleFiller>();
+    }
+
+    virtual std::string getDisplayName() override {
+        return "Spatial Hole Filler (CPU)";
+    }
+};
@@ -0,0 +1,413 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include "src/pcfilter/Filter.h"
+#include "src/pcfilter/DepthFilterUtils.h"
+#include "src/util/DirtyTileMask.h"
+#include "src/util/simd/SIMD.h"
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+class StencilFilter;
+
+/**
+ * A rectangle of an image in memory (row major, the stride is rect.width).
+ * Pixels are addressed by their coordinates in the whole image.
+ */
+template<typename T>
+struct ImageView {
+    T* data = nullptr;
+    TileRect rect = {0, 0, 0, 0};
+
+    size_t indexOf(int x, int y) const {
+        return size_t(y - int(rect.y)) * rect.width + (x - int(rect.x));
+    }
+
+    T& at(int x, int y) const {
+        return data[indexOf(x, y)];
+    }
+};
+
+/** Depth and colors (data = nullptr if the point cloud has none) of a stencil filter */
+struct StencilImage {
+    ImageView<uint16_t> depth;
+    ImageView<Vec4b> colors;
+};
+
+/**
+ * Applies a sequence of stencil filters to the point cloud of a camera strip by
+ * strip (whole rows, top to bottom).
+ *
+ * The filters of the sequence are fused: every filter runs ahead of the next
+ * one by the radius of the following filters, and keeps only the rows its
+ * successor still reads in a small per thread buffer (see RowBuffer) which
+ * stays in the cache. So every filter processes every row exactly once and the
+ * images are only read and written once, instead of once per filter.
+ * FilterExecutor applies the filters one by one nevertheless: as long as the
+ * images of a camera fit into the cache, the filters are bound by computation
+ * and the fused sequence was slightly slower (see BlendPCR-filterbench).
+ *
+ * The input is read strip by strip as well (copied into a row buffer if the
+ * output is the same point cloud), so there's no copy of the whole image. With
+ * OpenMP, the image is split into horizontal bands which are filtered
+ * concurrently (only the rows at the borders of the bands are filtered twice).
+ */
+class StencilChain {
+    /** Consecutive whole rows of an image (row major), of which the first rows are dropped when they aren't needed anymore */
+    template<typename T>
+    struct RowBuffer {
+        std::vector<T> data;
+        TileRect rect = {0, 0, 0, 0};
+
+        /** Empties the buffer, the next appended row is the row y */
+        void reset(unsigned int width, int y){
+            rect = {0, unsigned(y), width, 0};
+        }
+
+        /** Drops the rows above the row y (the remaining rows are moved to the front) */
+        void dropBefore(int y){
+            int end = int(rect.y + rect.height);
+            y = std::min(std::max(y, int(rect.y)), end);
+
+            size_t offset = size_t(y - int(rect.y)) * rect.width;
+            if(offset > 0 && y < end)
+                std::memmove(data.data(), data.data() + offset, size_t(end - y) * rect.width * sizeof(T));
+
+            rect.y = unsigned(y);
+            rect.height = unsigned(end - y);
+        }
+
+        /** Extends the buffer to the row end (exclusive), the new rows have to be written by the caller */
+        void extendTo(int end){
+            rect.height = unsigned(std::max(end - int(rect.y), int(rect.height)));
+
+            // Only grows, so the elements aren't initialized again every frame:
+            size_t size = size_t(rect.width) * rect.height;
+            if(data.size() < size)
+                data.resize(size);
+        }
+
+        ImageView<T> view(){
+            return {data.data(), rect};
+        }
+    };
+
+    /** Buffers of a thread (one per filter of the chain, the input has the index 0) */
+    struct StripBuffers {
+        std::vector<RowBuffer<uint16_t>> depth;
+        std::vector<RowBuffer<Vec4b>> colors;
+
+        /** Input rows below the band, copied before the next band overwrites them */
+        std::vector<uint16_t> depthBelow;
+        std::vector<Vec4b> colorsBelow;
+    };
+
+    /** Returns the number of threads of a parallel region (1 without OpenMP) */
+    static int threadCount(){
+        #ifdef _OPENMP
+        return omp_get_num_threads();
+        #else
+        return 1;
+        #endif
+    }
+
+    static int threadIndex(){
+        #ifdef _OPENMP
+        return omp_get_thread_num();
+        #else
+        return 0;
+        #endif
+    }
+
+    /** Filters the rows [bandStart, bandEnd) of the output (see apply) */
+    void applyToBand(const std::vector<StencilFilter*>& filters, const std::vector<int>& radii, bool writesColors,
+                     const OrganizedPointCloud& input, OrganizedPointCloud& output, unsigned int cameraID, int bandStart, int bandEnd);
+
+public:
+    /** Number of rows of a strip, i.e. the rows the last filter processes at once */
+    unsigned int stripHeight = 32;
+
+    /** Returns the rectangle enlarged by the radius and clipped to the image */
+    static TileRect dilate(const TileRect& rect, int radius, unsigned int width, unsigned int height){
+        int minX = std::max(int(rect.x) - radius, 0);
+        int minY = std::max(int(rect.y) - radius, 0);
+        int maxX = std::min(int(rect.x + rect.width) + radius, int(width));
+        int maxY = std::min(int(rect.y + rect.height) + radius, int(height));
+
+        return {unsigned(minX), unsigned(minY), unsigned(maxX - minX), unsigned(maxY - minY)};
+    }
+
+    /**
+     * Applies the filters (in this order) to the input and writes the result
+     * into the output, which has the same size (and lookup tables) and may be
+     * the input itself. All pixels of the output are written, also if none of
+     * the filters can be applied.
+     */
+    void apply(const std::vector<StencilFilter*>& chain, const OrganizedPointCloud& input, OrganizedPointCloud& output, unsigned int cameraID);
+
+    /** Applies the filters (in this order) to the point cloud of the camera */
+    void apply(const std::vector<StencilFilter*>& chain, OrganizedPointCloud& pc, unsigned int cameraID){
+        apply(chain, pc, pc, cameraID);
+    }
+};
+
+/**
+ * A camera independent filter whose output pixel only depends on the input
+ * pixels within a square of getStencilRadius() around it (a stencil). Such
+ * filters are applied strip by strip (see StencilChain), which reads the
+ * input and writes the output without a copy of the whole image.
+ */
+class StencilFilter : public Filter {
+    /** Applies the filter alone (see applyFilterToCamera) */
+    StencilChain chain;
+
+public:
+    /** Radius of the neighborhood which is read by applyKernel(...) */
+    virtual int getStencilRadius() = 0;
+
+    /** Whether applyKernel(...) writes the colors (otherwise they are passed through) */
+    virtual bool modifiesColors(){
+        return false;
+    }
+
+    /**
+     * Updates the per camera data of the current frame (e.g. the rays) before
+     * the strips are filtered. Returns false if the filter can't be applied to
+     * the point cloud (then it's skipped).
+     */
+    virtual bool prepareCamera(const OrganizedPointCloud&, unsigned int){
+        return true;
+    }
+
+    /**
+     * Filters the pixels of the region: writes the depth (and the colors, if
+     * modifiesColors()) of every pixel of the region into the output, reading
+     * only the pixels of the input within the region enlarged by the radius
+     * (clipped to the image). May be called concurrently for different regions.
+     *
+     * The region consists of whole rows, so the kernels can decide on the
+     * (image) coordinates alone whether a pixel is filtered by the vectorized or
+     * the scalar code. That's why a fused chain results in exactly the same
+     * output as the filters applied one after another.
+     *
+     * If the radius is 0, input and output may be the same images.
+     */
+    virtual void applyKernel(const OrganizedPointCloud& pc, unsigned int cameraID, int radius, const StencilImage& input, const StencilImage& output, const TileRect& region) = 0;
+
+    virtual bool isCameraIndependent() override {
+        return true;
+    }
+
+    virtual void applyFilterToCamera(std::shared_ptr<OrganizedPointCloud>& image, unsigned int cameraID) override {
+        chain.apply({this}, *image, cameraID);
+    }
+};
+
+
+inline void StencilChain::apply(const std::vector<StencilFilter*>& chain, const OrganizedPointCloud& input, OrganizedPointCloud& output, unsigned int cameraID){
+    if(input.depth == nullptr || output.depth == nullptr || input.width == 0 || input.height == 0)
+        return;
+
+    // The parameters must not change while the strips are filtered:
+    std::vector<StencilFilter*> filters;
+    std::vector<int> radii;
+    bool writesColors = false;
+    for(StencilFilter* filter : chain){
+        if(!filter->prepareCamera(input, cameraID))
+            continue;
+
+        filters.push_back(filter);
+        radii.push_back(std::max(filter->getStencilRadius(), 0));
+        writesColors = writesColors || (filter->modifiesColors() && input.colors != nullptr && output.colors != nullptr);
+    }
+
+    if(filters.empty()){
+        size_t pixelCount = size_t(input.width) * input.height;
+        if(output.depth != input.depth)
+            std::memcpy(output.depth, input.depth, pixelCount * sizeof(uint16_t));
+        if(output.colors != nullptr && input.colors != nullptr && output.colors != input.colors)
+            std::memcpy(output.colors, input.colors, pixelCount * sizeof(Vec4b));
+        return;
+    }
+
+    // Bands of at least a few strips, so that the rows filtered twice at their borders don't matter:
+    int bandCount = 1;
+    #ifdef _OPENMP
+    bandCount = std::max(1, std::min(omp_get_max_threads(), int(input.height / (4 * std::max(stripHeight, 1u)))));
+    #endif
+
+    #pragma omp parallel num_threads(bandCount)
+    {
+        int bands = threadCount();
+        int band = threadIndex();
+        int bandStart = int(size_t(input.height) * band / bands);
+        int bandEnd = int(size_t(input.height) * (band + 1) / bands);
+
+        applyToBand(filters, radii, writesColors, input, output, cameraID, bandStart, bandEnd);
+    }
+}
+
+inline void StencilChain::applyToBand(const std::vector<StencilFilter*>& filters, const std::vector<int>& radii, bool writesColors,
+                                      const OrganizedPointCloud& input, OrganizedPointCloud& output, unsigned int cameraID, int bandStart, int bandEnd){
+    static thread_local StripBuffers buffers;
+
+    const int width = int(input.width);
+    const int height = int(input.height);
+    const int filterCount = int(filters.size());
+    const int rowsPerStrip = int(std::max(stripHeight, 1u));
+    const TileRect imageRect = {0, 0, input.width, input.height};
+
+    // Rows every filter runs ahead of the last one (the radii of the following filters):
+    std::vector<int> lead(filterCount, 0);
+    for(int f = filterCount - 2; f >= 0; --f)
+        lead[f] = lead[f + 1] + radii[f + 1];
+
+    // Pointwise filters are applied in-place on the output:
+    bool isPointwise = lead[0] == 0 && radii[0] == 0;
+
+    // First row every filter hasn't processed yet:
+    std::vector<int> next(filterCount);
+    for(int f = 0; f < filterCount; ++f)
+        next[f] = std::max(bandStart - lead[f], 0);
+
+    // Images the filters read and write: the input has the index 0, the output
+    // of the filter f the index f + 1 (in row buffers with the same indices,
+    // except for the output of the last filter, which is the point cloud):
+    std::vector<StencilImage> images(filterCount + 1);
+    images[0].depth = {input.depth, imageRect};
+    images[0].colors = {input.colors, imageRect};
+
+    // Index of the image whose colors the image carries (they are passed through by filters which don't write them):
+    std::vector<int> colorSource(filterCount + 1, 0);
+    for(int f = 0; f < filterCount; ++f)
+        colorSource[f + 1] = writesColors && filters[f]->modifiesColors() ? f + 1 : colorSource[f];
+
+    buffers.depth.resize(filterCount);
+    buffers.colors.resize(filterCount);
+    for(int i = 1; i < filterCount; ++i){
+        buffers.depth[i].reset(input.width, next[i - 1]);
+        buffers.colors[i].reset(input.width, next[i - 1]);
+    }
+
+    // The input is copied row by row if the output overwrites it:
+    bool copiesInput = input.depth == output.depth && !isPointwise;
+    bool copiesColors = copiesInput && writesColors;
+    int inputStart = std::max(next[0] - radii[0], 0);
+    int inputEnd = std::min(bandEnd + lead[0] + radii[0], height);
+
+    // Copies the input rows up to the row end (the rows below the band were saved before):
+    auto copyInputRows = [&](int end){
+        RowBuffer<uint16_t>& depth = buffers.depth[0];
+        RowBuffer<Vec4b>& colors = buffers.colors[0];
+        int first = int(depth.rect.y + depth.rect.height);
+
+        depth.extendTo(end);
+        if(copiesColors)
+            colors.extendTo(end);
+
+        for(int y = first; y < end; ++y){
+            size_t belowOffset = size_t(y - bandEnd) * width;
+            std::memcpy(&depth.view().at(0, y), y >= bandEnd ? &buffers.depthBelow[belowOffset] : input.depth + size_t(y) * width, width * sizeof(uint16_t));
+            if(copiesColors)
+                std::memcpy(&colors.view().at(0, y), y >= bandEnd ? &buffers.colorsBelow[belowOffset] : input.colors + size_t(y) * width, width * sizeof(Vec4b));
+        }
+
+        images[0].depth = depth.view();
+        if(copiesColors)
+            images[0].colors = colors.view();
+    };
+
+    if(copiesInput){
+        buffers.depth[0].reset(input.width, inputStart);
+        buffers.colors[0].reset(input.width, inputStart);
+
+        // The rows of the neighboring bands, before they overwrite them:
+        size_t belowSize = size_t(std::max(inputEnd - bandEnd, 0)) * width;
+        if(buffers.depthBelow.size() < belowSize)
+            buffers.depthBelow.resize(belowSize);
+        if(copiesColors && buffers.colorsBelow.size() < belowSize)
+            buffers.colorsBelow.resize(belowSize);
+
+        if(belowSize > 0){
+            std::memcpy(buffers.depthBelow.data(), input.depth + size_t(bandEnd) * width, belowSize * sizeof(uint16_t));
+            if(copiesColors)
+                std::memcpy(buffers.colorsBelow.data(), input.colors + size_t(bandEnd) * width, belowSize * sizeof(Vec4b));
+        }
+
+        copyInputRows(bandStart);
+    }
+
+    #pragma omp barrier
+
+    // First row of the image which is still read (by a following filter or by the final copy of the colors):
+    auto firstNeededRow = [&](int image, bool isColors){
+        int row = height;
+        for(int f = image; f < filterCount; ++f){
+            if((isColors ? colorSource[f] : f) == image)
+                row = std::min(row, next[f] - radii[f]);
+        }
+        if(isColors && colorSource[filterCount] == image)
+            row = std::min(row, next[filterCount - 1]);
+        return row;
+    };
+
+    for(int stripStart = bandStart; stripStart < bandEnd; stripStart += rowsPerStrip){
+        int stripEnd = std::min(stripStart + rowsPerStrip, bandEnd);
+
+        for(int f = 0; f < filterCount; ++f){
+            int start = next[f];
+            int end = std::min(stripEnd + lead[f], height);
+            if(start >= end)
+                continue;
+
+            if(f == 0 && copiesInput){
+                buffers.depth[0].dropBefore(firstNeededRow(0, false));
+                if(copiesColors)
+                    buffers.colors[0].dropBefore(firstNeededRow(0, true));
+                copyInputRows(std::min(end + radii[0], height));
+            }
+
+            bool isLast = f + 1 == filterCount;
+            StencilImage& target = images[f + 1];
+
+            if(isLast || isPointwise){
+                target.depth = {output.depth, imageRect};
+            } else {
+                RowBuffer<uint16_t>& depth = buffers.depth[f + 1];
+                depth.dropBefore(firstNeededRow(f + 1, false));
+                depth.extendTo(end);
+                target.depth = depth.view();
+            }
+
+            if(colorSource[f + 1] != f + 1){
+                target.colors = images[colorSource[f + 1]].colors;
+            } else if(isLast || isPointwise){
+                target.colors = {output.colors, imageRect};
+            } else {
+                RowBuffer<Vec4b>& colors = buffers.colors[f + 1];
+                colors.dropBefore(firstNeededRow(f + 1, true));
+                colors.extendTo(end);
+                target.colors = colors.view();
+            }
+
+            TileRect region = {0, unsigned(start), input.width, unsigned(end - start)};
+            filters[f]->applyKernel(output, cameraID, radii[f], images[f], target, region);
+            next[f] = end;
+        }
+
+        // Colors which the last filters passed through:
+        const ImageView<Vec4b>& colors = images[colorSource[filterCount]].colors;
+        if(colors.data != nullptr && output.colors != nullptr && colors.data != output.colors){
+            for(int y = stripStart; y < stripEnd; ++y)
+                std::memcpy(output.colors + size_t(y) * width, &colors.at(0, y), width * sizeof(Vec4b));
+        }
+    }
+}
@@ -0,0 +1,256 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include "src/pcfilter/Filter.h"
+#include "src/pcfilter/DepthFilterUtils.h"
+#include "src/util/simd/SIMD.h"
+
+#include <map>
+#include <mutex>
+#include <algorithm>
+
+/** Statistics of the temporal denoising of one camera (moving averages) */
+struct TemporalDenoisingStatistics {
+    /** Mean absolute depth change of static pixels between frames before filtering (in mm) */
+    float inputJitter = 0.f;
+
+    /** Mean absolute depth change of static pixels between frames after filtering (in mm) */
+    float outputJitter = 0.f;
+
+    /** Fraction of the valid pixels which were reset because the surface moved */
+    float resetFraction = 0.f;
+};
+
+/**
+ * Filters the depth of every pixel over time with a Kalman filter, like the
+ * temporal denoising pass of BlendPCR (noiseRemoval.frag). The filter of a
+ * pixel is reset if the measured depth deviates more than resetThreshold
+ * standard deviations from the prediction (i.e. the surface moved), so moving
+ * objects don't leave trails.
+ *
+ * The noise of the sensor is modelled to grow quadratically with the depth.
+ * Vectorized (see SIMD.h) and parallelized over the image rows (OpenMP).
+ */
+class TemporalDenoisingFilter : public Filter {
+    struct CameraState {
+        unsigned int width = 0;
+        unsigned int height = 0;
+
+        /** Filtered depth (in mm) and its error variance per pixel (0 = no history) */
+        std::vector<float> estimates;
+        std::vector<float> variances;
+
+        /** Unfiltered depth of the previous frame (for the statistics) */
+        std::vector<uint16_t> previousDepth;
+
+        bool hasStatistics = false;
+    };
+
+    PerCameraData<CameraState> cameraStates;
+
+    std::mutex statisticsMutex;
+    std::map<unsigned int, TemporalDenoisingStatistics> statistics;
+
+public:
+    /** Standard deviation of the sensor noise at 1 m in meters (grows quadratically with the depth) */
+    float measurementNoise = 0.002f;
+
+    /** Standard deviation of the expected depth change of a static surface per frame in meters */
+    float processNoise = 0.0005f;
+
+    /** Depth changes above this number of standard deviations reset the filter of a pixel */
+    float resetThreshold = 3.f;
+
+    virtual std::string getName() override {
+        return "Temporal Denoising Filter";
+    }
+
+    virtual bool isCameraIndependent() override {
+        return true;
+    }
+
+    virtual bool isStateful() override {
+        return true;
+    }
+
+    virtual void applyFilterToCamera(std::shared_ptr<OrganizedPointCloud>& image, unsigned int cameraID) override {
+        OrganizedPointCloud& pc = *image;
+        if(pc.depth == nullptr)
+            return;
+
+        CameraState& state = cameraStates.get(cameraID);
+        size_t pixelCount = size_t(pc.width) * pc.height;
+
+        // Another image size (e.g. a new source) resets the history:
+        if(state.width != pc.width || state.height != pc.height){
+            state.width = pc.width;
+            state.height = pc.height;
+            state.estimates.assign(pixelCount, 0.f);
+            state.variances.assign(pixelCount, 0.f);
+            state.previousDepth.assign(pc.depth, pc.depth + pixelCount);
+            state.hasStatistics = false;
+        }
+
+        // In millimeters (the noise at depth z is measurementNoise * z² / 1000):
+        float noisePerSquaredMillimeter = measurementNoise / 1000.f;
+        float processVariance = processNoise * 1000.f * processNoise * 1000.f;
+        float squaredThreshold = resetThreshold * resetThreshold;
+
+        int width = int(pc.width);
+        int height = int(pc.height);
+
+        double inputChange = 0.0;
+        double outputChange = 0.0;
+        double staticPixels = 0.0;
+        double resetPixels = 0.0;
+        double validPixels = 0.0;
+
+        #pragma omp parallel for schedule(static) reduction(+:inputChange, outputChange, staticPixels, resetPixels, validPixels)
+        for(int y = 0; y < height; ++y){
+            size_t rowOffset = size_t(y) * width;
+            uint16_t* depthRow = pc.depth + rowOffset;
+            float* estimateRow = state.estimates.data() + rowOffset;
+            float* varianceRow = state.variances.data() + rowOffset;
+            uint16_t* previousDepthRow = state.previousDepth.data() + rowOffset;
+
+            simd::Float rowInputChange(0.f);
+            simd::Float rowOutputChange(0.f);
+            simd::Float rowStaticPixels(0.f);
+            simd::Float rowResetPixels(0.f);
+            simd::Float rowValidPixels(0.f);
+
+            int x = 0;
+            for(; x + int(simd::Width) <= width; x += simd::Width){
+                simd::Float z = simd::loadDepth(depthRow + x);
+                simd::Float previousZ = simd::loadDepth(previousDepthRow + x);
+                simd::Float previousEstimate = simd::load(estimateRow + x);
+                simd::Float previousVariance = simd::load(varianceRow + x);
+
+                simd::Mask valid = z >= simd::Float(DEPTH_FILTER_MIN_DEPTH);
+                simd::Mask hasHistory = valid & (previousVariance > simd::Float(0.f));
+
+                simd::Float noise = simd::Float(noisePerSquaredMillimeter) * z * z;
+                simd::Float measurementVariance = noise * noise;
+                simd::Float predictedVariance = previousVariance + simd::Float(processVariance);
+                simd::Float innovation = z - previousEstimate;
+                simd::Float totalVariance = predictedVariance + measurementVariance;
+
+                simd::Mask isStatic = hasHistory & (innovation * innovation <= simd::Float(squaredThreshold) * totalVariance);
+                simd::Float gain = predictedVariance / simd::select(hasHistory, totalVariance, simd::Float(1.f));
+
+                simd::Float estimate = simd::select(isStatic, previousEstimate + gain * innovation, z);
+                simd::Float variance = simd::select(isStatic, (simd::Float(1.f) - gain) * predictedVariance, measurementVariance);
+
+                simd::store(estimateRow + x, simd::select(valid, estimate, simd::Float(0.f)));
+                simd::store(varianceRow + x, simd::select(valid, variance, simd::Float(0.f)));
+
+                float depths[simd::Width];
+                simd::store(depths, simd::select(valid, estimate + simd::Float(0.5f), z));
+                for(unsigned int lane = 0; lane < simd::Width; ++lane){
+                    previousDepthRow[x + lane] = depthRow[x + lane];
+                    depthRow[x + lane] = uint16_t(std::min(depths[lane], 65535.f));
+                }
+
+                simd::Float zero(0.f), one(1.f);
+                rowInputChange = rowInputChange + simd::select(isStatic & (previousZ >= simd::Float(DEPTH_FILTER_MIN_DEPTH)), simd::abs(z - previousZ), zero);
+                rowOutputChange = rowOutputChange + simd::select(isStatic, simd::abs(estimate - previousEstimate), zero);
+                rowStaticPixels = rowStaticPixels + simd::select(isStatic, one, zero);
+                rowResetPixels = rowResetPixels + simd::select(hasHistory, one, zero) - simd::select(isStatic, one, zero);
+                rowValidPixels = rowValidPixels + simd::select(valid, one, zero);
+            }
+
+            float lanes[5][simd::Width];
+            simd::store(lanes[0], rowInputChange);
+            simd::store(lanes[1], rowOutputChange);
+            simd::store(lanes[2], rowStaticPixels);
+            simd::store(lanes[3], rowResetPixels);
+            simd::store(lanes[4], rowValidPixels);
+            for(unsigned int lane = 0; lane < simd::Width; ++lane){
+                inputChange += lanes[0][lane];
+                outputChange += lanes[1][lane];
+                staticPixels += lanes[2][lane];
+                resetPixels += lanes[3][lane];
+                validPixels += lanes[4][lane];
+            }
+
+            for(; x < width; ++x){
+                float z = depthRow[x];
+                float previousZ = previousDepthRow[x];
+                float previousEstimate = estimateRow[x];
+                float previousVariance = varianceRow[x];
+                previousDepthRow[x] = depthRow[x];
+
+                if(z < DEPTH_FILTER_MIN_DEPTH){
+                    estimateRow[x] = 0.f;
+                    varianceRow[x] = 0.f;
+                    continue;
+                }
+
+                bool hasHistory = previousVariance > 0.f;
+                float noise = noisePerSquaredMillimeter * z * z;
+                float measurementVariance = noise * noise;
+                float predictedVariance = previousVariance + processVariance;
+                float innovation = z - previousEstimate;
+                float totalVariance = predictedVariance + measurementVariance;
+
+                float estimate = z;
+                float variance = measurementVariance;
+                if(hasHistory && innovation * innovation <= squaredThreshold * totalVariance){
+                    float gain = predictedVariance / totalVariance;
+                    estimate = previousEstimate + gain * innovation;
+                    variance = (1.f - gain) * predictedVariance;
+
+                    if(previousZ >= DEPTH_FILTER_MIN_DEPTH)
+                        inputChange += std::abs(z - previousZ);
+                    outputChange += std::abs(estimate - previousEstimate);
+                    staticPixels += 1.0;
+                } else if(hasHistory){
+                    resetPixels += 1.0;
+                }
+
+                estimateRow[x] = estimate;
+                varianceRow[x] = variance;
+                depthRow[x] = uint16_t(std::min(estimate + 0.5f, 65535.f));
+                validPixels += 1.0;
+            }
+        }
+
+        // Update the statistics (once the filter has a history):
+        if(!state.hasStatistics && staticPixels == 0.0)
+            return;
+
+        TemporalDenoisingStatistics current;
+        current.inputJitter = staticPixels > 0.0 ? float(inputChange / staticPixels) : 0.f;
+        current.outputJitter = staticPixels > 0.0 ? float(outputChange / staticPixels) : 0.f;
+        current.resetFraction = validPixels > 0.0 ? float(resetPixels / validPixels) : 0.f;
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        TemporalDenoisingStatistics& average = statistics[cameraID];
+        if(!state.hasStatistics){
+            average = current;
+            state.hasStatistics = true;
+        } else {
+            average.inputJitter = current.inputJitter * 0.1f + average.inputJitter * 0.9f;
+            average.outputJitter = current.outputJitter * 0.1f + average.outputJitter * 0.9f;
+            average.resetFraction = current.resetFraction * 0.1f + average.resetFraction * 0.9f;
+        }
+    }
+
+    /** Returns the statistics per camera ID */
+    std::map<unsigned int, TemporalDenoisingStatistics> getStatistics(){
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        return statistics;
+    }
+};
+
+class TemporalDenoisingFilterFactory : public FilterFactory {
+public:
+    virtual std::shared_ptr<Filter> createInstance() override {
+        return std::make_shared<TemporalDenoisingFilter>();
+    }
+
+    virtual std::string getDisplayName() override {
+        return "Temporal Denoising Filter (CPU)";
+    }
+};
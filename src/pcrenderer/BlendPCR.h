@@ -5,13 +5,21 @@
 #include "src/pcrenderer/Renderer.h"
 
 #include "src/util/gl/Shader.h"
+#include "src/util/gl/GLPassTimer.h"
+#include "src/util/TileChangeDetector.h"
+#include "src/util/Hash.h"
+
+#include <memory>
+#include <mutex>
+#include <cmath>
 
 using namespace std::chrono;
 
 // Uncomment if you want to print timings:
 //#define PRINT_TIMINGS
 
-#define CAMERA_COUNT 7
+// Limited by 8 draw buffers for the camera weights (4 cameras each):
+#define MAX_CAMERA_COUNT 32
 #define CAMERA_IMAGE_WIDTH 640
 #define CAMERA_IMAGE_HEIGHT 576
 #define LOOKUP_IMAGE_SIZE 1024
@@ -25,69 +33,118 @@ public:
     int screenshotID = 0;
 
 private:
+    /** Point clouds which are rendered (only used by the GL thread) */
     std::vector<std::shared_ptr<OrganizedPointCloud>> currentPointClouds;
 
+    /**
+     * Guards the state which integratePointClouds (e.g. on a pipeline thread)
+     * shares with render(): integratedPointClouds, newPointCloudsAvailable,
+     * pendingDirtyTiles and changeDetector.
+     */
+    std::mutex integrationMutex;
+
+    /** Newest integrated point clouds (taken by the next render()) */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> integratedPointClouds;
+    bool newPointCloudsAvailable = false;
+
     bool isInitialized = false;
 
     /**
-     * Declares all FBOs and textures which we need.
+     * Number of cameras the resources and screen shaders are currently created
+     * for (see init(...)).
      */
-    unsigned int highres_colors[CAMERA_COUNT];
+    unsigned int cameraCount = 0;
+
+    /**
+     * Declares all FBOs and textures which we need (one per camera).
+     */
+    std::vector<unsigned int> highres_colors;
 
     // Reimplemented point cloud filter (Hole Filling):
-    unsigned int fbo_pcf_holeFilling[CAMERA_COUNT];
-    unsigned int texture2D_pcf_holeFilledVertices[CAMERA_COUNT];
-    unsigned int texture2D_pcf_holeFilledRGB[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_pcf_holeFilling;
+    std::vector<unsigned int> texture2D_pcf_holeFilledVertices;
+    std::vector<unsigned int> texture2D_pcf_holeFilledRGB;
 
     // Reimplemented point cloud filter (Erosion):
-    unsigned int fbo_pcf_erosion[CAMERA_COUNT];
-    unsigned int texture2D_pcf_erosion[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_pcf_erosion;
+    std::vector<unsigned int> texture2D_pcf_erosion;
+
+    // Temporal denoising filter (the history is ping-ponged, the fbo with the
+    // index i writes the denoised vertices and the history i):
+    std::vector<unsigned int> fbo_pcf_temporal[2];
+    std::vector<unsigned int> texture2D_pcf_temporalHistory[2];
+    std::vector<unsigned int> texture2D_pcf_temporalVertices;
+
+    /** Index of the history which was written last (per camera) */
+    std::vector<int> temporalHistoryIndex;
+
+    /** Whether the last written history is up to date (per camera) */
+    std::vector<bool> temporalHistoryValid;
+
+    /**
+     * Regions the temporal pass processed for the previous frame. Since only one
+     * of the two histories is written per frame, these are copied to the other
+     * history in the next frame, so that both histories are equal outside of the
+     * regions which were processed last.
+     */
+    std::vector<std::vector<TileRect>> previousTemporalRegions;
+
+    /**
+     * GPU timer queries of the temporal pass per camera, read when their result
+     * is available (in a later frame, to not stall the pipeline).
+     */
+    std::vector<unsigned int> temporalTimeQueries;
+    std::vector<bool> temporalTimeQueryPending;
+
+    /** GPU time of the temporal pass per camera in milliseconds (moving average) */
+    std::vector<float> temporalFilterTimes;
 
     // FBO for generating 3D vertices from depth image:
-    unsigned int fbo_genVertices[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_genVertices;
 
     // The textures for the input point clouds:
-    unsigned int texture2D_inputGenVertices[CAMERA_COUNT];
-    unsigned int texture2D_inputDepth[CAMERA_COUNT];
-    unsigned int texture2D_inputRGB[CAMERA_COUNT];
-    unsigned int texture2D_inputLookupImageTo3D[CAMERA_COUNT];
-    unsigned int texture2D_inputLookup3DToImage[CAMERA_COUNT];
+    std::vector<unsigned int> texture2D_inputGenVertices;
+    std::vector<unsigned int> texture2D_inputDepth;
+    std::vector<unsigned int> texture2D_inputRGB;
+    std::vector<unsigned int> texture2D_inputLookupImageTo3D;
+    std::vector<unsigned int> texture2D_inputLookup3DToImage;
 
     // The fbo and texture for the rejection pass:
-    unsigned int fbo_rejection[CAMERA_COUNT];
-    unsigned int texture2D_rejection[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_rejection;
+    std::vector<unsigned int> texture2D_rejection;
 
     // The fbo and texture for the edge proximity pass:
-    unsigned int fbo_edgeProximity[CAMERA_COUNT];
-    unsigned int texture2D_edgeProximity[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_edgeProximity;
+    std::vector<unsigned int> texture2D_edgeProximity;
 
     // The fbo and texture for the mls pass:
-    unsigned int fbo_mls[CAMERA_COUNT];
-    unsigned int texture2D_mlsVertices[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_mls;
+    std::vector<unsigned int> texture2D_mlsVertices;
 
     // The fbo and texture for the normal estimation pass:
-    unsigned int fbo_normals[CAMERA_COUNT];
-    unsigned int texture2D_normals[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_normals;
+    std::vector<unsigned int> texture2D_normals;
 
     // The fbo and texture for the quality estimation pass:
-    unsigned int fbo_qualityEstimate[CAMERA_COUNT];
-    unsigned int texture2D_qualityEstimate[CAMERA_COUNT];
-
-    // The fbo and textures for the separate screen rendering passes:
-    unsigned int fbo_screen[CAMERA_COUNT];
-    unsigned int texture2D_screenColor[CAMERA_COUNT];
-    unsigned int texture2D_screenVertices[CAMERA_COUNT];
-    unsigned int texture2D_screenNormals[CAMERA_COUNT];
-    unsigned int texture2D_screenDepth[CAMERA_COUNT];
+    std::vector<unsigned int> fbo_qualityEstimate;
+    std::vector<unsigned int> texture2D_qualityEstimate;
+
+    // The fbos for the separate screen rendering passes, which render into one
+    // layer (= camera) of the array textures each, so the merging passes only
+    // need four samplers independent of the number of cameras:
+    std::vector<unsigned int> fbo_screen;
+    unsigned int texture2DArray_screenColor;
+    unsigned int texture2DArray_screenVertices;
+    unsigned int texture2DArray_screenNormals;
+    unsigned int texture2DArray_screenDepth;
 
     // The fbo and texture for the major cam pass:
     unsigned int fbo_majorCam;
     unsigned int texture2D_majorCam;
 
-    // The fbo and texture for the camera weights:
+    // The fbo and texture for the camera weights (4 cameras per layer):
     unsigned int fbo_cameraWeights;
-    unsigned int texture2D_cameraWeightsA; // Camera 0-3
-    unsigned int texture2D_cameraWeightsB; // Camera 4-7
+    unsigned int texture2DArray_cameraWeights;
 
     unsigned int fbo_result[10];
     unsigned int texture2D_resultColor[10];
@@ -100,7 +157,23 @@ private:
     int fbo_mini_screen_width = -1;
     int fbo_mini_screen_height = -1;
 
-    bool lookupTablesUploaded = false;
+    std::vector<bool> lookupTablesUploaded;
+
+    /** Detects the changed tiles of the integrated point clouds */
+    TileChangeDetector changeDetector;
+
+    /**
+     * Tiles per camera which changed since the point cloud passes of the camera
+     * were processed the last time (collected over all integrated frames, since
+     * not every integrated frame is rendered).
+     */
+    std::vector<DirtyTileMask> pendingDirtyTiles;
+
+    /** Parameter hash (see getPassParameterHash) with which each camera was processed */
+    std::vector<uint64_t> processedParameterHashes;
+
+    /** Fraction of the tiles per camera which were processed for the last new frame */
+    std::vector<float> dirtyTileFractions;
 
     std::vector<unsigned int> usedCameraIDs;
 
@@ -110,6 +183,7 @@ private:
      */
     Shader pcfHoleFillingShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/filter/holeFilling.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/filter/holeFilling.frag");
     Shader pcfErosionShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/filter/erosion.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/filter/erosion.frag");
+    Shader pcfNoiseRemovalShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/filter/noiseRemoval.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/filter/noiseRemoval.frag");
 
     /** Generates 3D vertices (in m) from depth image (in mm) */
     Shader vertexGenShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/vertexGenerator.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/pointcloud/vertexGenerator.frag");
@@ -127,17 +201,19 @@ private:
      * Define all the shaders for the screen passes:
      */
     Shader renderShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/separateRendering.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/separateRendering.frag");
-    Shader majorCamShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.frag");
-    Shader cameraWeightsShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.frag");
-    Shader blendingShader = Shader(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.frag");
+
+    // Compiled for the current number of cameras (CAMERA_NUM), see createScreenShaders():
+    std::unique_ptr<Shader> majorCamShader;
+    std::unique_ptr<Shader> cameraWeightsShader;
+    std::unique_ptr<Shader> blendingShader;
 
     /**
      * Defines the mesh
      */
     unsigned int indicesSize;
-    unsigned int* indices;
+    unsigned int* indices = nullptr;
 
-    float* gridData;
+    float* gridData = nullptr;
 
     unsigned int VBO_pc;
     unsigned int VBO_indices;
@@ -152,44 +228,15 @@ private:
     float* quadData = new float[12]{1.f,-1.f, -1.f,-1.f, -1.f,1.f, -1.f,1.f, 1.f,1.f, 1.f,-1.f};
 
 
-    std::map<std::string, high_resolution_clock::time_point> startTimeMeasureMap;
-    std::map<std::string, float> timeMeasureMap;
-    std::map<std::string, GLuint> timeQueries;
+    /** Measures the passes (if enabled, see setPassProfiling) */
+    GLPassTimer passTimer;
 
     void startTimeMeasure(std::string str, bool gpu = false){
-#ifdef PRINT_TIMINGS
-        auto time = high_resolution_clock::now();
-        startTimeMeasureMap[str] = time;
-
-        if(gpu){
-            GLuint query;
-            glGenQueries(1, &query);
-            timeQueries[str] = query;
-            glBeginQuery(GL_TIME_ELAPSED, timeQueries[str]);
-        }
-#endif
+        passTimer.begin(str, gpu);
     }
 
     void endTimeMeasure(std::string str, bool gpu = false){
-#ifdef PRINT_TIMINGS
-        auto time = high_resolution_clock::now();
-
-        if(gpu){
-            glEndQuery(GL_TIME_ELAPSED);
-
-            GLint done = 0;
-            while (!done) {
-                glGetQueryObjectiv(timeQueries[str], GL_QUERY_RESULT_AVAILABLE, &done);
-            }
-            GLuint64 timeElapsed;
-            glGetQueryObjectui64v(timeQueries[str], GL_QUERY_RESULT, &timeElapsed);
-            timeMeasureMap[str] = timeElapsed * 1.0e-6;
-            glDeleteQueries(1, &timeQueries[str]);
-        } else {
-            float duration = duration_cast<microseconds>(time - startTimeMeasureMap[str]).count() / 1000.f;
-            timeMeasureMap[str] = duration;
-        }
-#endif
+        passTimer.end(str, gpu);
     }
 
     void initQuadBuffer(){
@@ -231,116 +278,83 @@ private:
     };
 
 
-    void initMesh(){
-        glGenVertexArrays(1, &VAO);
-    }
-
-    void init(){
-        int mainViewport[4];
-        glGetIntegerv(GL_VIEWPORT, mainViewport);
-
-        // If screen size changed:
-        if(result_width != fbo_screen_width || result_height != fbo_screen_height){
-            for(unsigned int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
-                // Delete old frame buffer + texture:
-                if(fbo_screen_width != -1){
-                    glDeleteFramebuffers(1, &fbo_screen[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenColor[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenVertices[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenNormals[cameraID]);
-                    glDeleteTextures(1, &texture2D_screenDepth[cameraID]);
-                }
-
-                // Generate resources for SCREEN SPACE PASS:
-                {
-                    std::cout << "Generate FBO Screen" << std::endl;
-
-                    glGenFramebuffers(1, &fbo_screen[cameraID]);
-                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_screen[cameraID]);
-
-                    generateAndBind2DTexture(texture2D_screenColor[cameraID], result_width, result_height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_screenColor[cameraID], 0);
-
-                    generateAndBind2DTexture(texture2D_screenVertices[cameraID], result_width, result_height, GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texture2D_screenVertices[cameraID], 0);
-
-                    generateAndBind2DTexture(texture2D_screenNormals[cameraID], result_width, result_height, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, texture2D_screenNormals[cameraID], 0);
-
-                    generateAndBind2DTexture(texture2D_screenDepth[cameraID], result_width, result_height, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture2D_screenDepth[cameraID], 0);
-                }
-            }
-
-            for(unsigned int screenID = 0; screenID < screensNumber; ++screenID){
-                glGenFramebuffers(1, &fbo_result[screenID]);
-                glBindFramebuffer(GL_FRAMEBUFFER, fbo_result[screenID]);
-
-                generateAndBind2DTexture(texture2D_resultColor[screenID], result_width, result_height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_resultColor[screenID], 0);
-
-                generateAndBind2DTexture(texture2D_resultDepth[screenID], result_width, result_height, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
-                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture2D_resultDepth[screenID], 0);
-            }
-
-            fbo_screen_width = result_width;
-            fbo_screen_height = result_height;
-
-            // Delete old frame buffer + texture:
-            if(fbo_mini_screen_width != -1){
-                glDeleteFramebuffers(1, &fbo_majorCam);
-                glDeleteTextures(1, &texture2D_majorCam);
-
-                glDeleteFramebuffers(1, &fbo_cameraWeights);
-                glDeleteTextures(1, &texture2D_cameraWeightsA);
-                glDeleteTextures(1, &texture2D_cameraWeightsB);
-            }
-
-            int requestedMiniScreenWidth = result_width / 4;
-            int requestedMiniScreenHeight =result_height / 4;
-
-
-            glGenFramebuffers(1, &fbo_majorCam);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_majorCam);
-
-            generateAndBind2DTexture(texture2D_majorCam, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, GL_NEAREST);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_majorCam, 0);
-
-            glGenFramebuffers(1, &fbo_cameraWeights);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo_cameraWeights);
-
-            generateAndBind2DTexture(texture2D_cameraWeightsA, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_cameraWeightsA, 0);
-
-            generateAndBind2DTexture(texture2D_cameraWeightsB, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texture2D_cameraWeightsB, 0);
+    void generateAndBind2DArrayTexture(
+        unsigned int& texture,
+        unsigned int width,
+        unsigned int height,
+        unsigned int layers,
+        unsigned int internalFormat,
+        unsigned int format,
+        unsigned int type,
+        unsigned int filter
+        ){
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layers, 0, format, type, NULL);
 
-            fbo_mini_screen_width = requestedMiniScreenWidth;
-            fbo_mini_screen_height = requestedMiniScreenHeight;
+        if(filter != GL_NONE){
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+        }
 
-            std::cout << "Reinitialized Screen FBOS!" << std::endl;
+        if(format == GL_DEPTH_COMPONENT){
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_NONE);
         }
+    };
 
 
-        // If already initialized, don't to it again and simply return:
-        if(isInitialized)
-            return;
+    void initMesh(){
+        glGenVertexArrays(1, &VAO);
+    }
 
-        // Init the quadbuffer:
-        initQuadBuffer();
+    /**
+     * Compiles the screen shaders which loop over all cameras for the current
+     * number of cameras.
+     */
+    void createScreenShaders(){
+        std::map<std::string, std::string> defines = {{"CAMERA_NUM", std::to_string(cameraCount)}};
 
-        // Init mesh (grid):
-        initMesh();
+        majorCamShader = std::make_unique<Shader>(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/majorCam.frag", "", defines);
+        cameraWeightsShader = std::make_unique<Shader>(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/cameraWeights.frag", "", defines);
+        blendingShader = std::make_unique<Shader>(CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.vert", CMAKE_SOURCE_DIR "/shader/blendpcr/screen/blending.frag", "", defines);
+    }
+
+    /**
+     * Generates the resources of the point cloud passes for all cameras.
+     */
+    void createCameraResources(){
+        for(std::vector<unsigned int>* handles : {
+                &highres_colors, &fbo_pcf_holeFilling, &texture2D_pcf_holeFilledVertices, &texture2D_pcf_holeFilledRGB,
+                &fbo_pcf_erosion, &texture2D_pcf_erosion, &fbo_genVertices, &texture2D_inputGenVertices, &texture2D_inputDepth,
+                &texture2D_inputRGB, &texture2D_inputLookupImageTo3D, &texture2D_inputLookup3DToImage, &fbo_rejection,
+                &texture2D_rejection, &fbo_edgeProximity, &texture2D_edgeProximity, &fbo_mls, &texture2D_mlsVertices,
+                &fbo_normals, &texture2D_normals, &fbo_qualityEstimate, &texture2D_qualityEstimate,
+                &fbo_pcf_temporal[0], &fbo_pcf_temporal[1], &texture2D_pcf_temporalHistory[0], &texture2D_pcf_temporalHistory[1],
+                &texture2D_pcf_temporalVertices})
+            handles->assign(cameraCount, 0);
+
+        temporalHistoryIndex.assign(cameraCount, 0);
+        temporalHistoryValid.assign(cameraCount, false);
+        previousTemporalRegions.assign(cameraCount, std::vector<TileRect>());
+
+        temporalTimeQueries.assign(cameraCount, 0);
+        glGenQueries(GLsizei(cameraCount), temporalTimeQueries.data());
+        temporalTimeQueryPending.assign(cameraCount, false);
+        temporalFilterTimes.assign(cameraCount, 0.f);
+
+        lookupTablesUploaded.assign(cameraCount, false);
+        processedParameterHashes.assign(cameraCount, 0);
+        dirtyTileFractions.assign(cameraCount, 1.f);
 
         unsigned int imageWidth = CAMERA_IMAGE_WIDTH;
         unsigned int imageHeight = CAMERA_IMAGE_HEIGHT;
 
         // Generate highres color textures:
-        for(unsigned int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
+        for(unsigned int cameraID = 0; cameraID < cameraCount; ++cameraID){
             generateAndBind2DTexture(highres_colors[cameraID], 2048, 1536, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_LINEAR);
         }
 
-        for(unsigned int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
+        for(unsigned int cameraID = 0; cameraID < cameraCount; ++cameraID){
             // Generate resources for INPUT
             {
                 // Input point cloud texture
@@ -371,6 +385,25 @@ private:
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_pcf_erosion[cameraID], 0);
             }
 
+            /**
+             * Generate resources for the TEMPORAL DENOISING FILTER.
+             *
+             * The denoised vertices are written into one texture, the filter
+             * state (depth, variance) alternately into one of two histories.
+             */
+            {
+                generateAndBind2DTexture(texture2D_pcf_temporalVertices[cameraID], imageWidth, imageHeight, GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+
+                for(int i = 0; i < 2; ++i){
+                    glGenFramebuffers(1, &fbo_pcf_temporal[i][cameraID]);
+                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_pcf_temporal[i][cameraID]);
+
+                    generateAndBind2DTexture(texture2D_pcf_temporalHistory[i][cameraID], imageWidth, imageHeight, GL_RG32F, GL_RG, GL_FLOAT, GL_NEAREST);
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_pcf_temporalVertices[cameraID], 0);
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texture2D_pcf_temporalHistory[i][cameraID], 0);
+                }
+            }
+
             /**
              * Generate resources for reimplemented HOLE FILLING FILTER (orig. CUDA implemented).
              */
@@ -467,76 +500,96 @@ private:
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
         }
 
-        std::cout << "Initialized FrameBuffers for BlendPCR" << std::endl;
-        isInitialized = true;
+        std::cout << "Initialized FrameBuffers for " << cameraCount << " cameras for BlendPCR" << std::endl;
     }
 
-public:
-    bool useReimplementedFilters = true;
-    bool shouldClip = true;
-
-    Vec4f clipMin = Vec4f(-1.0f, 0.05f, -1.0, 0.0);
-    Vec4f clipMax = Vec4f(1.0f, 2.0f, 1.0, 0.0);
-
-    int stride = 1;
+    void deleteCameraResources(){
+        if(cameraCount == 0)
+            return;
 
-    float implicitH = 0.08f;
-    float kernelRadius = 4.f;
-    float kernelSpread = 1.f;
+        for(std::vector<unsigned int>* framebuffers : {&fbo_pcf_holeFilling, &fbo_pcf_erosion, &fbo_pcf_temporal[0], &fbo_pcf_temporal[1], &fbo_genVertices, &fbo_rejection, &fbo_edgeProximity, &fbo_mls, &fbo_normals, &fbo_qualityEstimate})
+            glDeleteFramebuffers(GLsizei(framebuffers->size()), framebuffers->data());
 
-    bool useColorIndices = false;
+        for(std::vector<unsigned int>* textures : {
+                &highres_colors, &texture2D_pcf_holeFilledVertices, &texture2D_pcf_holeFilledRGB, &texture2D_pcf_erosion,
+                &texture2D_inputGenVertices, &texture2D_inputDepth, &texture2D_inputRGB, &texture2D_inputLookupImageTo3D,
+                &texture2D_inputLookup3DToImage, &texture2D_rejection, &texture2D_edgeProximity, &texture2D_mlsVertices,
+                &texture2D_normals, &texture2D_qualityEstimate, &texture2D_pcf_temporalHistory[0], &texture2D_pcf_temporalHistory[1],
+                &texture2D_pcf_temporalVertices})
+            glDeleteTextures(GLsizei(textures->size()), textures->data());
 
-    float uploadTime = 0;
+        glDeleteQueries(GLsizei(temporalTimeQueries.size()), temporalTimeQueries.data());
+    }
 
-    bool newPointCloudsAvailable = false;
+    /**
+     * Generates the screen sized resources (for all cameras and screens).
+     */
+    void createScreenResources(){
+        std::cout << "Generate FBO Screen" << std::endl;
+
+        generateAndBind2DArrayTexture(texture2DArray_screenColor, result_width, result_height, cameraCount, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
+        generateAndBind2DArrayTexture(texture2DArray_screenVertices, result_width, result_height, cameraCount, GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        generateAndBind2DArrayTexture(texture2DArray_screenNormals, result_width, result_height, cameraCount, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        generateAndBind2DArrayTexture(texture2DArray_screenDepth, result_width, result_height, cameraCount, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+
+        fbo_screen.assign(cameraCount, 0);
+        glGenFramebuffers(GLsizei(cameraCount), fbo_screen.data());
+
+        for(unsigned int cameraID = 0; cameraID < cameraCount; ++cameraID){
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_screen[cameraID]);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture2DArray_screenColor, 0, cameraID);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, texture2DArray_screenVertices, 0, cameraID);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, texture2DArray_screenNormals, 0, cameraID);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture2DArray_screenDepth, 0, cameraID);
+        }
 
+        for(int screenID = 0; screenID < screensNumber; ++screenID){
+            glGenFramebuffers(1, &fbo_result[screenID]);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_result[screenID]);
 
-    ~BlendPCR(){
-        if(fbo_mini_screen_width != -1){
-            glDeleteFramebuffers(1, &fbo_majorCam);
-            glDeleteTextures(1, &texture2D_majorCam);
+            generateAndBind2DTexture(texture2D_resultColor[screenID], result_width, result_height, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_resultColor[screenID], 0);
 
-            glDeleteFramebuffers(1, &fbo_cameraWeights);
-            glDeleteTextures(1, &texture2D_cameraWeightsA);
-            glDeleteTextures(1, &texture2D_cameraWeightsB);
+            generateAndBind2DTexture(texture2D_resultDepth[screenID], result_width, result_height, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture2D_resultDepth[screenID], 0);
         }
 
-        for(int cameraID = 0; cameraID < CAMERA_COUNT; ++cameraID){
-            if(fbo_screen_width != -1){
-                glDeleteFramebuffers(1, &fbo_screen[cameraID]);
-                glDeleteTextures(1, &texture2D_screenColor[cameraID]);
-                glDeleteTextures(1, &texture2D_screenVertices[cameraID]);
-                glDeleteTextures(1, &texture2D_screenDepth[cameraID]);
-            }
+        fbo_screen_width = result_width;
+        fbo_screen_height = result_height;
 
+        int requestedMiniScreenWidth = result_width / 4;
+        int requestedMiniScreenHeight =result_height / 4;
 
-            glDeleteFramebuffers(1, &fbo_pcf_holeFilling[cameraID]);
-            glDeleteTextures(1, &texture2D_pcf_holeFilledVertices[cameraID]);
-            glDeleteTextures(1, &texture2D_pcf_holeFilledRGB[cameraID]);
+        glGenFramebuffers(1, &fbo_majorCam);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_majorCam);
 
-            glDeleteFramebuffers(1, &fbo_pcf_erosion[cameraID]);
-            glDeleteTextures(1, &texture2D_pcf_erosion[cameraID]);
+        generateAndBind2DTexture(texture2D_majorCam, requestedMiniScreenWidth, requestedMiniScreenHeight, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture2D_majorCam, 0);
 
-            glDeleteTextures(1, &texture2D_inputDepth[cameraID]);
-            glDeleteTextures(1, &texture2D_inputRGB[cameraID]);
-            glDeleteTextures(1, &texture2D_inputLookupImageTo3D[cameraID]);
-            glDeleteTextures(1, &highres_colors[cameraID]);
+        glGenFramebuffers(1, &fbo_cameraWeights);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_cameraWeights);
 
-            glDeleteFramebuffers(1, &fbo_rejection[cameraID]);
-            glDeleteTextures(1, &texture2D_rejection[cameraID]);
+        unsigned int weightLayers = getCameraWeightLayers();
+        generateAndBind2DArrayTexture(texture2DArray_cameraWeights, requestedMiniScreenWidth, requestedMiniScreenHeight, weightLayers, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST);
+        for(unsigned int layer = 0; layer < weightLayers; ++layer)
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + layer, texture2DArray_cameraWeights, 0, layer);
 
-            glDeleteFramebuffers(1, &fbo_edgeProximity[cameraID]);
-            glDeleteTextures(1, &texture2D_edgeProximity[cameraID]);
+        fbo_mini_screen_width = requestedMiniScreenWidth;
+        fbo_mini_screen_height = requestedMiniScreenHeight;
 
-            glDeleteFramebuffers(1, &fbo_mls[cameraID]);
-            glDeleteTextures(1, &texture2D_mlsVertices[cameraID]);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        std::cout << "Reinitialized Screen FBOS!" << std::endl;
+    }
 
-            glDeleteFramebuffers(1, &fbo_normals[cameraID]);
-            glDeleteTextures(1, &texture2D_normals[cameraID]);
+    void deleteScreenResources(){
+        if(fbo_screen_width == -1)
+            return;
 
-            glDeleteFramebuffers(1, &fbo_qualityEstimate[cameraID]);
-            glDeleteTextures(1, &texture2D_qualityEstimate[cameraID]);
-        }
+        glDeleteFramebuffers(GLsizei(fbo_screen.size()), fbo_screen.data());
+        glDeleteTextures(1, &texture2DArray_screenColor);
+        glDeleteTextures(1, &texture2DArray_screenVertices);
+        glDeleteTextures(1, &texture2DArray_screenNormals);
+        glDeleteTextures(1, &texture2DArray_screenDepth);
 
         for(int screenID = 0; screenID < screensNumber; ++screenID){
             glDeleteFramebuffers(1, &fbo_result[screenID]);
@@ -544,6 +597,153 @@ public:
             glDeleteTextures(1, &texture2D_resultDepth[screenID]);
         }
 
+        glDeleteFramebuffers(1, &fbo_majorCam);
+        glDeleteTextures(1, &texture2D_majorCam);
+
+        glDeleteFramebuffers(1, &fbo_cameraWeights);
+        glDeleteTextures(1, &texture2DArray_cameraWeights);
+
+        fbo_screen_width = fbo_screen_height = -1;
+        fbo_mini_screen_width = fbo_mini_screen_height = -1;
+    }
+
+    /**
+     * Number of pixels around a changed pixel whose results of the point cloud
+     * passes can change (the sum of the sampling radii of all passes).
+     */
+    unsigned int getPointCloudPassHalo(){
+        float halo = (useReimplementedFilters ? 2.f : 0.f)    // Hole filling
+            + 1.f                                             // Rejection
+            + 5.f + 1.f                                       // Edge proximity (linearly filtered)
+            + std::max(kernelRadius, 2.f) * kernelSpread + 1.f  // MLS
+            + 2.f * kernelSpread + 1.f;                       // Normals
+
+        return (unsigned int) std::ceil(halo);
+    }
+
+    /**
+     * Hash of everything besides the input images on which the results of the
+     * point cloud passes of the given camera depend. If it changes, the whole
+     * image has to be processed again.
+     */
+    uint64_t getPassParameterHash(const OrganizedPointCloud& pc){
+        float parameters[17] = {
+            float(useReimplementedFilters), float(shouldClip), float(useColorIndices), float(pc.colors != nullptr),
+            implicitH, kernelRadius, kernelSpread,
+            clipMin.x, clipMin.y, clipMin.z, clipMax.x, clipMax.y, clipMax.z,
+            float(useTemporalFilter), temporalMeasurementNoise, temporalProcessNoise, temporalResetThreshold
+        };
+
+        return hashFNV1a(pc.modelMatrix.data, sizeof(pc.modelMatrix.data), hashFNV1a(parameters, sizeof(parameters)));
+    }
+
+    /**
+     * Uploads the given regions of an image with CAMERA_IMAGE_WIDTH columns into
+     * the bound texture.
+     */
+    void uploadRegions(const std::vector<TileRect>& regions, unsigned int format, unsigned int type, const void* data, size_t bytesPerPixel){
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, CAMERA_IMAGE_WIDTH);
+        for(const TileRect& region : regions){
+            const uint8_t* start = (const uint8_t*) data + (size_t(region.y) * CAMERA_IMAGE_WIDTH + region.x) * bytesPerPixel;
+            glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height, format, type, start);
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    /** Draws the quad restricted to the given regions of the bound framebuffer */
+    void drawQuad(const std::vector<TileRect>& regions){
+        glBindVertexArray(VAO_quad);
+        glEnable(GL_SCISSOR_TEST);
+        for(const TileRect& region : regions){
+            glScissor(region.x, region.y, region.width, region.height);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
+
+    /** Number of layers of the camera weights texture (4 cameras per layer) */
+    unsigned int getCameraWeightLayers(){
+        return (cameraCount + 3) / 4;
+    }
+
+    /**
+     * Creates the resources for the given number of cameras and the current
+     * screen size (or recreates them, if one of them changed).
+     */
+    void init(unsigned int requestedCameraCount){
+        // If the number of cameras changed, everything per camera is recreated:
+        if(requestedCameraCount != cameraCount){
+            deleteScreenResources();
+            deleteCameraResources();
+
+            cameraCount = requestedCameraCount;
+            createScreenShaders();
+            createCameraResources();
+        }
+
+        // If screen size changed:
+        if(result_width != fbo_screen_width || result_height != fbo_screen_height){
+            deleteScreenResources();
+            createScreenResources();
+        }
+
+        // If already initialized, don't to it again and simply return:
+        if(isInitialized)
+            return;
+
+        // Init the quadbuffer:
+        initQuadBuffer();
+
+        // Init mesh (grid):
+        initMesh();
+
+        isInitialized = true;
+    }
+
+public:
+    bool useReimplementedFilters = true;
+    bool shouldClip = true;
+
+    Vec4f clipMin = Vec4f(-1.0f, 0.05f, -1.0, 0.0);
+    Vec4f clipMax = Vec4f(1.0f, 2.0f, 1.0, 0.0);
+
+    int stride = 1;
+
+    float implicitH = 0.08f;
+    float kernelRadius = 4.f;
+    float kernelSpread = 1.f;
+
+    bool useColorIndices = false;
+
+    /**
+     * If set, the depth of every pixel is filtered over time (Kalman filter along
+     * the ray, reset where the surface moved) before the other passes, which
+     * reduces the shimmering of static surfaces caused by the sensor noise.
+     */
+    bool useTemporalFilter = false;
+
+    /** Standard deviation of the sensor noise at 1 m in meters (grows quadratically with the depth) */
+    float temporalMeasurementNoise = 0.002f;
+
+    /** Standard deviation of the expected depth change of a static surface per frame in meters */
+    float temporalProcessNoise = 0.0005f;
+
+    /** Depth changes above this number of standard deviations reset the filter of a pixel */
+    float temporalResetThreshold = 3.f;
+
+    /**
+     * If set, only the tiles of the camera images which changed since the last
+     * frame (plus the neighborhood the passes sample) are uploaded and processed.
+     */
+    bool usePartialUpdates = true;
+
+    float uploadTime = 0;
+
+
+    ~BlendPCR(){
+        deleteScreenResources();
+        deleteCameraResources();
+
         delete[] indices;
 
         delete[] gridData;
@@ -561,22 +761,92 @@ public:
      * Integrate new RGB XYZ images.
      */
     virtual void integratePointClouds(std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds) override {
-        currentPointClouds = pointClouds;
+        std::lock_guard<std::mutex> lock(integrationMutex);
+
+        if(usePartialUpdates){
+            changeDetector.detect(pointClouds);
+        } else {
+            // The references would be outdated when partial updates are enabled again:
+            changeDetector.reset();
+        }
+
+        if(pendingDirtyTiles.size() < pointClouds.size())
+            pendingDirtyTiles.resize(pointClouds.size());
+
+        for(size_t i = 0; i < pointClouds.size(); ++i){
+            if(pointClouds[i] == nullptr)
+                continue;
+
+            if(usePartialUpdates)
+                pendingDirtyTiles[i].merge(pointClouds[i]->dirtyTiles);
+            else
+                pendingDirtyTiles[i].setAllDirty();
+        }
+
+        integratedPointClouds = std::move(pointClouds);
         newPointCloudsAvailable = true;
     };
 
+    virtual void setPassProfiling(bool enabled) override {
+        passTimer.enabled = enabled;
+    }
+
+    virtual std::vector<PassTime> collectPassTimes(bool wait = false) override {
+        return passTimer.collect(wait);
+    }
+
+    /**
+     * Returns the GPU time of the temporal denoising pass per camera in
+     * milliseconds (see useTemporalFilter).
+     */
+    std::vector<float> getTemporalFilterTimes(){
+        return temporalFilterTimes;
+    }
+
+    /**
+     * Returns the fraction of the tiles per camera which were uploaded and
+     * processed for the last new frame (see usePartialUpdates).
+     */
+    std::vector<float> getDirtyTileFractions(){
+        return dirtyTileFractions;
+    }
+
     /**
      * Renders the point cloud
      */
     virtual void render(Mat4f projection, Mat4f view) override {
+        // Take the newest integrated point clouds and the tiles which changed since
+        // their cameras were processed the last time:
+        bool hasNewPointClouds = false;
+        std::vector<DirtyTileMask> dirtyTiles;
+        {
+            std::lock_guard<std::mutex> lock(integrationMutex);
+            if(newPointCloudsAvailable){
+                newPointCloudsAvailable = false;
+                hasNewPointClouds = true;
+                currentPointClouds = integratedPointClouds;
+                dirtyTiles = pendingDirtyTiles;
+
+                // Inactive cameras keep collecting their changes:
+                for(size_t i = 0; i < pendingDirtyTiles.size() && i < currentPointClouds.size() && i < MAX_CAMERA_COUNT; ++i){
+                    if(currentPointClouds[i] != nullptr)
+                        pendingDirtyTiles[i].reset(CAMERA_IMAGE_WIDTH, CAMERA_IMAGE_HEIGHT, changeDetector.tileSize);
+                }
+            }
+        }
+
         if(currentPointClouds.size() < 1)
             return;
 
+#ifdef PRINT_TIMINGS
+        passTimer.enabled = true;
+#endif
+
         startTimeMeasure("0) Init");
 
         glDisable(GL_BLEND);
-        // If opengl resources are not initialized yet, do it:
-        init();
+        // If opengl resources are not initialized yet (or the number of cameras changed), do it:
+        init((unsigned int) std::min(currentPointClouds.size(), size_t(MAX_CAMERA_COUNT)));
 
         // Settings:
         bool useFusion = true;
@@ -585,13 +855,15 @@ public:
         std::vector<unsigned int> cameraIDsThatCanBeRendered;
 
         // Stores if the camera with the respective ID is active:
-        bool isCameraActive[CAMERA_COUNT];
-        std::fill_n(isCameraActive, CAMERA_COUNT, false);
+        std::vector<int> isCameraActive(cameraCount, 0);
+
+        // Iterate over all cameras (inactive cameras of partial frames are nullptr):
+        for(unsigned int i = 0; i < cameraCount; ++i){
+            if(currentPointClouds[i] == nullptr)
+                continue;
 
-        // Iterate over all cameras:
-        for(unsigned int i = 0; i < currentPointClouds.size(); ++i){
             cameraIDsThatCanBeRendered.push_back(i);
-            isCameraActive[i] = true;
+            isCameraActive[i] = 1;
         }
 
         // Used camera ids:
@@ -617,8 +889,24 @@ public:
 
         auto time = high_resolution_clock::now();
 
-        if(newPointCloudsAvailable){
-            newPointCloudsAvailable = false;
+        if(hasNewPointClouds){
+            // Regions of every camera which have to be uploaded and processed:
+            std::vector<std::vector<TileRect>> uploadRegionsOf(cameraCount), passRegionsOf(cameraCount);
+            unsigned int halo = getPointCloudPassHalo();
+            for(unsigned int cameraID : cameraIDsThatCanBeRendered){
+                // Cameras without a mask yet are completely dirty:
+                DirtyTileMask pending = cameraID < dirtyTiles.size() ? dirtyTiles[cameraID] : DirtyTileMask();
+
+                uint64_t parameterHash = getPassParameterHash(*currentPointClouds[cameraID]);
+                if(!usePartialUpdates || parameterHash != processedParameterHashes[cameraID] || !lookupTablesUploaded[cameraID])
+                    pending.setAllDirty();
+                processedParameterHashes[cameraID] = parameterHash;
+
+                uploadRegionsOf[cameraID] = pending.getDirtyRects(CAMERA_IMAGE_WIDTH, CAMERA_IMAGE_HEIGHT);
+                passRegionsOf[cameraID] = pending.getDirtyRects(CAMERA_IMAGE_WIDTH, CAMERA_IMAGE_HEIGHT, halo);
+                dirtyTileFractions[cameraID] = pending.getDirtyFraction();
+            }
+
             startTimeMeasure("1a) Highres");
             for(unsigned int cameraID : cameraIDsThatCanBeRendered){
                 if(currentPointClouds[cameraID]->width != CAMERA_IMAGE_WIDTH || currentPointClouds[cameraID]->height != CAMERA_IMAGE_HEIGHT){
@@ -644,7 +932,7 @@ public:
     
                 if(currentPC->depth != nullptr){
                     glBindTexture(GL_TEXTURE_2D, texture2D_inputDepth[cameraID]);
-                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, CAMERA_IMAGE_WIDTH, CAMERA_IMAGE_HEIGHT, GL_RED_INTEGER, GL_UNSIGNED_SHORT, currentPC->depth);
+                    uploadRegions(uploadRegionsOf[cameraID], GL_RED_INTEGER, GL_UNSIGNED_SHORT, currentPC->depth, sizeof(uint16_t));
                 }
             }
             endTimeMeasure("1b) Positions");
@@ -659,25 +947,26 @@ public:
                 std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
                 if(currentPC->colors != nullptr){
                     glBindTexture(GL_TEXTURE_2D, texture2D_inputRGB[cameraID]);
-                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, CAMERA_IMAGE_WIDTH, CAMERA_IMAGE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, currentPC->colors);
+                    uploadRegions(uploadRegionsOf[cameraID], GL_RGBA, GL_UNSIGNED_BYTE, currentPC->colors, sizeof(Vec4b));
                 }
             }
             endTimeMeasure("1c) Colors");
     
             startTimeMeasure("1d) Lookup");
-            if(!lookupTablesUploaded){
-                for(unsigned int cameraID : cameraIDsThatCanBeRendered){
-                    if(currentPointClouds[cameraID]->width != CAMERA_IMAGE_WIDTH || currentPointClouds[cameraID]->height != CAMERA_IMAGE_HEIGHT){
-                        std::cout << "SIZE ERROR! " << currentPointClouds[cameraID]->width << " x " << currentPointClouds[cameraID]->height << std::endl;
-                        continue;
-                    }
-    
-                    std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
-                    if(currentPC->lookupImageTo3D != nullptr){
-                        glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
-                        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, currentPointClouds[cameraID]->width, currentPointClouds[cameraID]->height, GL_RG, GL_FLOAT, currentPC->lookupImageTo3D);
-                        lookupTablesUploaded = true;
-                    }
+            for(unsigned int cameraID : cameraIDsThatCanBeRendered){
+                if(lookupTablesUploaded[cameraID])
+                    continue;
+
+                if(currentPointClouds[cameraID]->width != CAMERA_IMAGE_WIDTH || currentPointClouds[cameraID]->height != CAMERA_IMAGE_HEIGHT){
+                    std::cout << "SIZE ERROR! " << currentPointClouds[cameraID]->width << " x " << currentPointClouds[cameraID]->height << std::endl;
+                    continue;
+                }
+
+                std::shared_ptr<OrganizedPointCloud> currentPC = currentPointClouds[cameraID];
+                if(currentPC->lookupImageTo3D != nullptr){
+                    glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, currentPointClouds[cameraID]->width, currentPointClouds[cameraID]->height, GL_RG, GL_FLOAT, currentPC->lookupImageTo3D);
+                    lookupTablesUploaded[cameraID] = true;
                 }
             }
             endTimeMeasure("1d) Lookup");
@@ -699,11 +988,92 @@ public:
                     glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
                     vertexGenShader.setUniform("lookupTexture", 2);
 
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawQuad(passRegionsOf[cameraID]);
                 }
                 endTimeMeasure("1e) Vertex Generation", true);
             }
+
+            // (Measured per camera, see getTemporalFilterTimes()):
+            if(useTemporalFilter){
+                for(unsigned int cameraID : cameraIDsThatCanBeRendered){
+                    int previousIndex = temporalHistoryIndex[cameraID];
+                    int nextIndex = 1 - previousIndex;
+
+                    std::vector<TileRect> regions = passRegionsOf[cameraID];
+                    if(!temporalHistoryValid[cameraID])
+                        regions = {TileRect{0, 0, CAMERA_IMAGE_WIDTH, CAMERA_IMAGE_HEIGHT}};
+
+                    // Measure the time, if the query of a previous frame is finished:
+                    unsigned int query = temporalTimeQueries[cameraID];
+                    if(temporalTimeQueryPending[cameraID]){
+                        GLint isAvailable = 0;
+                        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+                        if(isAvailable){
+                            GLuint64 timeElapsed;
+                            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &timeElapsed);
+                            float elapsedTime = timeElapsed * 1.0e-6f;
+                            float& average = temporalFilterTimes[cameraID];
+                            average = average == 0.f ? elapsedTime : elapsedTime * 0.1f + average * 0.9f;
+                            temporalTimeQueryPending[cameraID] = false;
+                        }
+                    }
+
+                    bool isMeasured = !temporalTimeQueryPending[cameraID];
+                    if(isMeasured)
+                        glBeginQuery(GL_TIME_ELAPSED, query);
+
+                    // The regions of the previous frame are copied from the other history
+                    // instead of being filtered again, since the vertices there are the
+                    // same measurement (the pass overwrites the overlapping parts):
+                    if(temporalHistoryValid[cameraID]){
+                        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_pcf_temporal[previousIndex][cameraID]);
+                        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_pcf_temporal[nextIndex][cameraID]);
+                        glReadBuffer(GL_COLOR_ATTACHMENT1);
+                        glDrawBuffer(GL_COLOR_ATTACHMENT1);
+
+                        for(const TileRect& r : previousTemporalRegions[cameraID])
+                            glBlitFramebuffer(r.x, r.y, r.x + r.width, r.y + r.height, r.x, r.y, r.x + r.width, r.y + r.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+                        glReadBuffer(GL_COLOR_ATTACHMENT0);
+                    }
+
+                    glBindFramebuffer(GL_FRAMEBUFFER, fbo_pcf_temporal[nextIndex][cameraID]);
+                    pcfNoiseRemovalShader.bind();
+
+                    unsigned int attachments[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+                    glDrawBuffers(2, attachments);
+
+                    glActiveTexture(GL_TEXTURE1);
+                    glBindTexture(GL_TEXTURE_2D, texture2D_inputGenVertices[cameraID]);
+                    pcfNoiseRemovalShader.setUniform("currentVertices", 1);
+
+                    glActiveTexture(GL_TEXTURE2);
+                    glBindTexture(GL_TEXTURE_2D, texture2D_pcf_temporalHistory[previousIndex][cameraID]);
+                    pcfNoiseRemovalShader.setUniform("previousVertices", 2);
+
+                    pcfNoiseRemovalShader.setUniform("hasHistory", bool(temporalHistoryValid[cameraID]));
+                    pcfNoiseRemovalShader.setUniform("measurementNoise", temporalMeasurementNoise);
+                    pcfNoiseRemovalShader.setUniform("processNoise", temporalProcessNoise);
+                    pcfNoiseRemovalShader.setUniform("resetThreshold", temporalResetThreshold);
+
+                    drawQuad(regions);
+
+                    if(isMeasured){
+                        glEndQuery(GL_TIME_ELAPSED);
+                        temporalTimeQueryPending[cameraID] = true;
+                    }
+
+                    temporalHistoryIndex[cameraID] = nextIndex;
+                    temporalHistoryValid[cameraID] = true;
+                    previousTemporalRegions[cameraID] = passRegionsOf[cameraID];
+                }
+            } else {
+                // The history is outdated when the filter is enabled again:
+                temporalHistoryValid.assign(cameraCount, false);
+            }
+
+            // The vertices the following passes work on:
+            std::vector<unsigned int>& texture2D_vertices = useTemporalFilter ? texture2D_pcf_temporalVertices : texture2D_inputGenVertices;
     
             if(useReimplementedFilters){
                 startTimeMeasure("2a) Hole Filling Pass", true);
@@ -717,7 +1087,7 @@ public:
                         glDrawBuffers(2, hfattachments);
     
                         glActiveTexture(GL_TEXTURE1);
-                        glBindTexture(GL_TEXTURE_2D, texture2D_inputGenVertices[cameraID]);
+                        glBindTexture(GL_TEXTURE_2D, texture2D_vertices[cameraID]);
                         pcfHoleFillingShader.setUniform("inputVertices", 1);
     
                         glActiveTexture(GL_TEXTURE2);
@@ -728,8 +1098,7 @@ public:
                         glBindTexture(GL_TEXTURE_2D, texture2D_inputLookupImageTo3D[cameraID]);
                         pcfHoleFillingShader.setUniform("lookupImageTo3D", 3);
     
-                        glBindVertexArray(VAO_quad);
-                        glDrawArrays(GL_TRIANGLES, 0, 6);
+                        drawQuad(passRegionsOf[cameraID]);
                     }
                 }
                 endTimeMeasure("2a) Hole Filling Pass", true);
@@ -743,7 +1112,7 @@ public:
                     rejectionShader.bind();
     
                     glActiveTexture(GL_TEXTURE1);
-                    glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ? texture2D_pcf_holeFilledVertices[cameraID] : texture2D_inputGenVertices[cameraID]);
+                    glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ? texture2D_pcf_holeFilledVertices[cameraID] : texture2D_vertices[cameraID]);
                     rejectionShader.setUniform("pointCloud", 1);
     
                     glActiveTexture(GL_TEXTURE2);
@@ -751,12 +1120,12 @@ public:
                     rejectionShader.setUniform("colorTexture", 2);
     
                     rejectionShader.setUniform("model", currentPointClouds[cameraID]->modelMatrix);
+                    rejectionShader.setUniform("hasColors", currentPointClouds[cameraID]->colors != nullptr);
                     rejectionShader.setUniform("shouldClip", shouldClip);
                     rejectionShader.setUniform("clipMin", clipMin);
                     rejectionShader.setUniform("clipMax", clipMax);
     
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawQuad(passRegionsOf[cameraID]);
                 }
             }
             endTimeMeasure("3a) RejectedPass", true);
@@ -773,8 +1142,7 @@ public:
                     edgeProximityShader.setUniform("rejectedTexture", 1);
                     edgeProximityShader.setUniform("kernelRadius", 10);
     
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawQuad(passRegionsOf[cameraID]);
                 }
             }
             endTimeMeasure("3b) EdgeProximity", true);
@@ -791,15 +1159,14 @@ public:
                     mlsShader.setUniform("p_h", implicitH);
     
                     glActiveTexture(GL_TEXTURE1);
-                    glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ?  texture2D_pcf_holeFilledVertices[cameraID] : texture2D_inputGenVertices[cameraID]);
+                    glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ?  texture2D_pcf_holeFilledVertices[cameraID] : texture2D_vertices[cameraID]);
                     mlsShader.setUniform("pointCloud", 1);
     
                     glActiveTexture(GL_TEXTURE2);
                     glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
                     mlsShader.setUniform("edgeProximity", 2);
     
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawQuad(passRegionsOf[cameraID]);
                 }
             }
             endTimeMeasure("3c) MLS", true);
@@ -812,7 +1179,7 @@ public:
                     //gl.glDisable(GL_DEPTH_TEST);
                     normalsShader.bind();
     
-                    normalsShader.setUniform("kernelRadius", kernelRadius);
+                    normalsShader.setUniform("kernelRadius", int(kernelRadius));
                     normalsShader.setUniform("kernelSpread", kernelSpread);
     
                     glActiveTexture(GL_TEXTURE1);
@@ -824,11 +1191,10 @@ public:
                     normalsShader.setUniform("texture2D_edgeProximity", 2);
     
                     glActiveTexture(GL_TEXTURE3);
-                    glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ?  texture2D_pcf_holeFilledVertices[cameraID] : texture2D_inputGenVertices[cameraID]);
+                    glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ?  texture2D_pcf_holeFilledVertices[cameraID] : texture2D_vertices[cameraID]);
                     normalsShader.setUniform("texture2D_inputVertices", 3);
     
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawQuad(passRegionsOf[cameraID]);
                 }
             }
             endTimeMeasure("3d) Normal", true);
@@ -852,8 +1218,7 @@ public:
                     glBindTexture(GL_TEXTURE_2D, texture2D_edgeProximity[cameraID]);
                     qualityEstimateShader.setUniform("edgeDistances", 2);
     
-                    glBindVertexArray(VAO_quad);
-                    glDrawArrays(GL_TRIANGLES, 0, 6);
+                    drawQuad(passRegionsOf[cameraID]);
                 }
             }
             endTimeMeasure("3e) Influence", true);
@@ -865,6 +1230,8 @@ public:
 
 
         for(int screenID = 0; screenID < screensNumber; ++screenID){
+            startTimeMeasure("4a) RenderMesh", true);
+
             // Restore viewport for screen rendering:
             glViewport(0, 0, result_width, result_height);
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -898,6 +1265,7 @@ public:
                 }
                 renderShader.setUniform("projection", projection);
                 renderShader.setUniform("useColorIndices", useColorIndices);
+                renderShader.setUniform("hasColors", currentPointClouds[cameraID]->colors != nullptr);
 
                 glActiveTexture(GL_TEXTURE2);
                 glBindTexture(GL_TEXTURE_2D, useReimplementedFilters ?  texture2D_pcf_holeFilledRGB[cameraID] : texture2D_inputRGB[cameraID]);
@@ -964,39 +1332,33 @@ public:
             {
                 glViewport(0, 0, fbo_mini_screen_width, fbo_mini_screen_height);
                 glBindFramebuffer(GL_FRAMEBUFFER, fbo_majorCam);
-                majorCamShader.bind();
-
-                unsigned int currentTexture = 1;
-                for(unsigned int cameraIDOfTexture : cameraIDsThatCanBeRendered){
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenColor[cameraIDOfTexture]);
-                    majorCamShader.setUniform("color["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenVertices[cameraIDOfTexture]);
-                    majorCamShader.setUniform("vertices["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenNormals[cameraIDOfTexture]);
-                    majorCamShader.setUniform("normals["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenDepth[cameraIDOfTexture]);
-                    majorCamShader.setUniform("depth["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-                }
+                majorCamShader->bind();
 
-                for(int i=0; i < CAMERA_COUNT; ++i){
-                    majorCamShader.setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
+                // The screen images of all cameras are layers of the array textures:
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenColor);
+                majorCamShader->setUniform("color", 1);
+
+                glActiveTexture(GL_TEXTURE2);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenVertices);
+                majorCamShader->setUniform("vertices", 2);
+
+                glActiveTexture(GL_TEXTURE3);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenNormals);
+                majorCamShader->setUniform("normals", 3);
+
+                glActiveTexture(GL_TEXTURE4);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenDepth);
+                majorCamShader->setUniform("depth", 4);
+
+                for(unsigned int i = 0; i < cameraCount; ++i){
+                    majorCamShader->setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
                 }
 
-                majorCamShader.setUniform("view", view);
+                majorCamShader->setUniform("view", view);
 
-                majorCamShader.setUniform("useFusion", useFusion);
-                majorCamShader.setUniform("cameraVector", view.inverse() * Vec4f(0.0, 0.0, 1.0, 0.0));
+                majorCamShader->setUniform("useFusion", useFusion);
+                majorCamShader->setUniform("cameraVector", view.inverse() * Vec4f(0.0, 0.0, 1.0, 0.0));
 
                 glBindVertexArray(VAO_quad);
                 glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -1007,17 +1369,20 @@ public:
             {
                 glViewport(0, 0, fbo_mini_screen_width, fbo_mini_screen_height);
                 glBindFramebuffer(GL_FRAMEBUFFER, fbo_cameraWeights);
-                cameraWeightsShader.bind();
+                cameraWeightsShader->bind();
 
-                unsigned int attachments[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
-                glDrawBuffers(2, attachments);
+                // One layer with the weights of four cameras per attachment:
+                unsigned int attachments[(MAX_CAMERA_COUNT + 3) / 4];
+                for(unsigned int layer = 0; layer < getCameraWeightLayers(); ++layer)
+                    attachments[layer] = GL_COLOR_ATTACHMENT0 + layer;
+                glDrawBuffers(getCameraWeightLayers(), attachments);
 
                 glActiveTexture(GL_TEXTURE1);
                 glBindTexture(GL_TEXTURE_2D, texture2D_majorCam);
-                cameraWeightsShader.setUniform("dominanceTexture", 1);
+                cameraWeightsShader->setUniform("dominanceTexture", 1);
 
-                for(int i=0; i < CAMERA_COUNT; ++i){
-                    cameraWeightsShader.setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
+                for(unsigned int i = 0; i < cameraCount; ++i){
+                    cameraWeightsShader->setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
                 }
 
                 glBindVertexArray(VAO_quad);
@@ -1037,49 +1402,38 @@ public:
                 unsigned int attachments[1] = { GL_COLOR_ATTACHMENT0};
                 glDrawBuffers(1, attachments);
 
-                blendingShader.bind();
-
-                unsigned int currentTexture = 1;
-                for(unsigned int cameraIDOfTexture : cameraIDsThatCanBeRendered){
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenColor[cameraIDOfTexture]);
-                    blendingShader.setUniform("color["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenVertices[cameraIDOfTexture]);
-                    blendingShader.setUniform("vertices["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenNormals[cameraIDOfTexture]);
-                    blendingShader.setUniform("normals["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-
-                    glActiveTexture(GL_TEXTURE0 + currentTexture);
-                    glBindTexture(GL_TEXTURE_2D, texture2D_screenDepth[cameraIDOfTexture]);
-                    blendingShader.setUniform("depth["+std::to_string(cameraIDOfTexture)+"]", int(currentTexture));
-                    ++currentTexture;
-                }
+                blendingShader->bind();
 
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_cameraWeightsA);
-                blendingShader.setUniform("miniWeightsA", int(currentTexture));
-                ++currentTexture;
+                // The screen images of all cameras are layers of the array textures:
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenColor);
+                blendingShader->setUniform("color", 1);
+
+                glActiveTexture(GL_TEXTURE2);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenVertices);
+                blendingShader->setUniform("vertices", 2);
+
+                glActiveTexture(GL_TEXTURE3);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenNormals);
+                blendingShader->setUniform("normals", 3);
 
-                glActiveTexture(GL_TEXTURE0 + currentTexture);
-                glBindTexture(GL_TEXTURE_2D, texture2D_cameraWeightsB);
-                blendingShader.setUniform("miniWeightsB", int(currentTexture));
-                ++currentTexture;
+                glActiveTexture(GL_TEXTURE4);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_screenDepth);
+                blendingShader->setUniform("depth", 4);
+
+
+                glActiveTexture(GL_TEXTURE5);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, texture2DArray_cameraWeights);
+                blendingShader->setUniform("miniWeights", 5);
 
-                for(int i=0; i < CAMERA_COUNT; ++i){
-                    blendingShader.setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
+                for(unsigned int i = 0; i < cameraCount; ++i){
+                    blendingShader->setUniform("isCameraActive["+std::to_string(i)+"]", isCameraActive[i]);
                 }
 
-                blendingShader.setUniform("view", view);
+                blendingShader->setUniform("view", view);
 
-                blendingShader.setUniform("useFusion", useFusion);
-                blendingShader.setUniform("cameraVector", view.inverse() * Vec4f(0.0, 0.0, 1.0, 0.0));
+                blendingShader->setUniform("useFusion", useFusion);
+                blendingShader->setUniform("cameraVector", view.inverse() * Vec4f(0.0, 0.0, 1.0, 0.0));
 
                 glBindVertexArray(VAO_quad);
                 glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -1114,8 +1468,9 @@ public:
         glEnable(GL_BLEND);
 
 #ifdef PRINT_TIMINGS
-        for(auto pair : timeMeasureMap){
-            std::cout << pair.first << ": " << pair.second << std::endl;
+        // The GPU times are printed when available (usually a frame later):
+        for(const PassTime& pass : passTimer.collect()){
+            std::cout << pass.name << ": " << (pass.gpuTime < 0.f ? pass.cpuTime : pass.gpuTime) << std::endl;
         }
         std::cout << std::endl;
 #endif
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "src/util/OrganizedPointCloud.h"
+#include "src/util/gl/GLPassTimer.h"
 
 #include <memory>
 #include <vector>
@@ -23,6 +24,21 @@ public:
      */
     virtual void render(Mat4f projection, Mat4f view) = 0;
 
+    /**
+     * Enables or disables measuring the time of the render passes (if the
+     * renderer supports it, see collectPassTimes).
+     */
+    virtual void setPassProfiling(bool enabled){}
+
+    /**
+     * Returns the times of the render passes which were measured completely
+     * since the last call. The GPU times are available a frame or two later,
+     * unless wait is true (then it waits for the GPU).
+     */
+    virtual std::vector<PassTime> collectPassTimes(bool wait = false){
+        return {};
+    }
+
     /**
      * Stores the names of available pc fusion algorithms.
      */
@@ -155,12 +155,14 @@ public:
             glBindTexture(GL_TEXTURE_2D, texture_depth);
             glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RED_INTEGER, GL_UNSIGNED_SHORT, &pc->depth[0]);
 
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, texture_colors);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RGBA, GL_UNSIGNED_BYTE, &pc->colors[0]);
+            if(pc->colors != nullptr){
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, texture_colors);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RGBA, GL_UNSIGNED_BYTE, &pc->colors[0]);
+            }
 
             glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER);
+            glBindTexture(GL_TEXTURE_2D, texture_lookup);
             glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RG, GL_FLOAT, &pc->lookupImageTo3D[0]);
 
             glFlush();
@@ -174,7 +176,8 @@ public:
             simpleMeshShader.setUniform("view", view);
             simpleMeshShader.setUniform("model", pc->modelMatrix);
             simpleMeshShader.setUniform("maxEdgeLength", maxEdgeLength);
-            simpleMeshShader.setUniform("discardBlackPixels", discardBlackPixels);
+            simpleMeshShader.setUniform("discardBlackPixels", discardBlackPixels && pc->colors != nullptr);
+            simpleMeshShader.setUniform("hasColors", pc->colors != nullptr);
             simpleMeshShader.setUniform("depthTexture", 0);
             simpleMeshShader.setUniform("colorTexture", 1);
             simpleMeshShader.setUniform("lookupTexture", 2);
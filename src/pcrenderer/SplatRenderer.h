@@ -119,7 +119,10 @@ public:
             splatShader.setUniform("projection", projection);
             splatShader.setUniform("view", view);
             splatShader.setUniform("model", pc->modelMatrix);
-            splatShader.setUniform("discardBlackPixels", discardBlackPixels);
+            splatShader.setUniform("discardBlackPixels", discardBlackPixels && pc->colors != nullptr);
+
+            // Point clouds without colors (e.g. depth-only streams) are rendered in a constant color:
+            splatShader.setUniform("overrideColor", pc->colors != nullptr ? Vec4f(0.f, 0.f, 0.f, 0.f) : Vec4f(0.8f, 0.8f, 0.8f, 1.f));
             splatShader.setUniform("depthTexture", 0);
             splatShader.setUniform("colorTexture", 1);
             splatShader.setUniform("lookupTexture", 2);
@@ -130,12 +133,14 @@ public:
             glBindTexture(GL_TEXTURE_2D, texture_depth);
             glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RED_INTEGER, GL_UNSIGNED_SHORT, &pc->depth[0]);
 
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, texture_colors);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RGBA, GL_UNSIGNED_BYTE, &pc->colors[0]);
+            if(pc->colors != nullptr){
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, texture_colors);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RGBA, GL_UNSIGNED_BYTE, &pc->colors[0]);
+            }
 
             glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER);
+            glBindTexture(GL_TEXTURE_2D, texture_lookup);
             glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pc->width, pc->height, GL_RG, GL_FLOAT, &pc->lookupImageTo3D[0]);
 
 
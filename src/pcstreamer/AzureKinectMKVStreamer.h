@@ -5,15 +5,16 @@
 #pragma once
 
 #include <thread>
-#include <fstream>
-#include <nlohmann/json.hpp>
-using json = nlohmann::json;
+#include <algorithm>
 
 #include <chrono>
 using namespace std::chrono;
 
 #include "src/pcstreamer/Streamer.h"
+#include "src/pcstreamer/FrameAssembler.h"
 #include "src/pcstreamer/azure_mkv/AzureKinectMKVStream.h"
+#include "src/pcstreamer/azure_mkv/CWIPCCameraConfig.h"
+#include "src/util/WorkerGroup.h"
 
 /**
  * A streamer when using a single or multiple Azure Kinect devices:
@@ -26,7 +27,20 @@ public:
     std::thread readingThread;
     bool shouldStop = false;
 
+    /** Forms the multi-camera frames from the frames the workers deliver */
+    std::unique_ptr<FrameAssembler> assembler;
+
+    /** One persistent worker per stream, which reads & decodes the frames of its camera */
+    std::unique_ptr<WorkerGroup> workers;
+
+    /**
+     * Time in milliseconds the frames of all cameras are waited for, before a
+     * partial frame is emitted.
+     */
+    float frameDeadline = 100.f;
+
     float processingTime = 0.f;
+    std::vector<float> cameraProcessingTimes;
     float lastTimeWhileStopped = -1.f;
 
     float debugOffsetX = 0.f;
@@ -35,38 +49,20 @@ public:
 
     bool useColorIndices = false;
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> lastFrameTime;
+    /** Number of frames which are decoded ahead of the playhead per camera */
+    int prefetchDepth = 8;
 
-    AzureKinectMKVStreamer(std::string cameraConfigPath, bool useBuffer = true){
+    AzureKinectMKVStreamer(std::string cameraConfigPath, bool useBuffer = true, bool depthOnly = false){
         allowFrameSkipping = useBuffer;
 
-        std::string rootPath = std::filesystem::path(cameraConfigPath).parent_path().string() + "/";
-
-        std::ifstream f(cameraConfigPath);
-        json jfile = json::parse(f);
+        std::vector<CWIPCCamera> cameras = loadCWIPCCameraConfig(cameraConfigPath);
 
-        int numCameras = int(jfile["camera"].size());
-        numCameras = 7;
+        int numCameras = int(cameras.size());
 
         streams = std::vector<std::shared_ptr<AzureKinectMKVStream>>(numCameras);
 
         for(int i = 0; i < numCameras; ++i){
-            json jcamera = jfile["camera"][i];
-            std::string filename = jcamera["filename"].get<std::string>();
-
-            float rawMat[16];
-            int index = 0;
-            for (const auto& row : jcamera["trafo"]) {
-                for (float value : row) {
-                    int rowMajorIdx = index++;
-                    int colMajorIdx = (rowMajorIdx % 4) * 4 + (rowMajorIdx / 4);
-                    rawMat[colMajorIdx] = value;
-                }
-            }
-
-            Mat4f matrix(rawMat);
-
-            streams[i] = std::make_shared<AzureKinectMKVStream>(rootPath + filename, matrix, useColorIndices, useBuffer, BufferedMaxFrameCount, BufferedStartFrameOffset);
+            streams[i] = std::make_shared<AzureKinectMKVStream>(cameras[i].recordingPath, cameras[i].transformation, useColorIndices, useBuffer, size_t(BufferedCacheBudgetMB) * 1024 * 1024 / numCameras, depthOnly);
         }
 
         #pragma omp parallel for
@@ -74,24 +70,29 @@ public:
             streams[i]->init();
         }
 
+        setPrefetchDepth(prefetchDepth);
+
+        assembler = std::make_unique<FrameAssembler>(numCameras);
+        workers = std::make_unique<WorkerGroup>(numCameras);
+        cameraProcessingTimes = std::vector<float>(numCameras, 0.f);
+
         readingThread = std::thread([this](){
-            lastFrameTime = high_resolution_clock::now();
+            const std::vector<double>& timestamps = streams[0]->getAllTimestamps();
+            int frameCount = int(timestamps.size());
+
+            // Frame which is delivered next while playing (of sensor 0):
+            int nextFrame = 0;
+            bool isScheduled = false;
+
             while(!shouldStop){
-                if(!isPlaying){
-                    std::this_thread::sleep_for(50ms);
+                if(playbackChanged.exchange(false))
+                    isScheduled = false;
 
+                if(!isPlaying){
                     // If currentTime was changed manually, update the point cloud even when paused:
                     if(lastTimeWhileStopped != currentTime){
-                        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
-
-                        double searchedTimestamp = currentTime + streams[0]->getTimeStampAtFrame(0);
-
-                        for(int i = 0; i < int(streams.size()); ++i){
-                            std::shared_ptr<OrganizedPointCloud> pc = streams[i]->syncImage(searchedTimestamp);
-                            if(pc != nullptr){
-                                pointClouds.push_back(pc);
-                            }
-                        }
+                        bool complete;
+                        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = syncImages(currentTime + timestamps[0], complete);
 
                         if(callback)
                             callback(pointClouds);
@@ -99,67 +100,111 @@ public:
                         lastTimeWhileStopped = currentTime;
                     }
 
-                    lastFrameTime = high_resolution_clock::now();
+                    // Sleep until play / seek / step:
+                    isScheduled = false;
+                    playbackClock.wait();
                     continue;
                 }
 
-                auto startTime = high_resolution_clock::now();
-
-                // Point Clouds of this frame:
-                std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
-
-                auto now = high_resolution_clock::now();
-                if(allowFrameSkipping){
-                    currentTime += float(duration_cast<nanoseconds>(now - lastFrameTime).count() * 0.000000001);
-                } else {
-                    currentTime += float(streams[0]->getTimeDeltaToNextFrame()) + 0.000001f;
+                // Schedule from the frame at currentTime (or the one after it, if it was already delivered):
+                if(!isScheduled){
+                    double searchedTimestamp = currentTime + timestamps[0] + (lastTimeWhileStopped == currentTime ? 0.0001 : -0.0001);
+                    nextFrame = int(std::lower_bound(timestamps.begin(), timestamps.end(), searchedTimestamp) - timestamps.begin());
+                    playbackClock.start(currentTime, playbackRate);
+                    isScheduled = true;
                 }
-                lastFrameTime = now;
 
                 // If playtime exceeds the total time:
-                if(currentTime + 0.1f >= streams[0]->getTotalTime()){
+                if(nextFrame >= frameCount){
                     currentTime = 0;
-                    streams[0]->readImage(0);
 
                     if(!loop){
                         isPlaying = false;
                         continue;
                     }
+
+                    nextFrame = 0;
+                    playbackClock.start(0.0, playbackRate);
                 }
-                lastTimeWhileStopped = currentTime;
 
-                double searchedTimestamp = currentTime + streams[0]->getTimeStampAtFrame(0);
+                auto scheduledTime = playbackClock.getScheduledTime(timestamps[nextFrame] - timestamps[0]);
 
-                bool noUpdate = false;
-                for(unsigned int i = 0; i < streams.size(); ++i){
-                    std::shared_ptr<OrganizedPointCloud> pc = streams[i]->syncImage(searchedTimestamp);
+                // Woken up before, since the playback was changed:
+                if(!playbackClock.waitUntil(scheduledTime))
+                    continue;
 
-                    if(pc != nullptr){
-                        pointClouds.push_back(pc);
-                    } else {
-                        noUpdate = true;
-                    }
+                // Skip the frames which are already overdue, if the playback can't keep up:
+                if(allowFrameSkipping){
+                    double playbackTime = playbackClock.getPlaybackTime(steady_clock::now());
+                    while(nextFrame + 1 < frameCount && timestamps[nextFrame + 1] - timestamps[0] <= playbackTime)
+                        ++nextFrame;
+
+                    scheduledTime = playbackClock.getScheduledTime(timestamps[nextFrame] - timestamps[0]);
                 }
 
-                processingTime = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + processingTime * 0.9f;
+                auto startTime = high_resolution_clock::now();
 
-                if(callback && !noUpdate)
+                currentTime = float(timestamps[nextFrame] - timestamps[0]);
+                lastTimeWhileStopped = currentTime;
+
+                // Point Clouds of this frame:
+                bool complete;
+                std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = syncImages(timestamps[nextFrame], complete);
+
+                if(callback)
                     callback(pointClouds);
 
-                // Just relax a little bit (especially for buffer reader):
-                if(allowFrameSkipping)
-                    std::this_thread::sleep_for(25ms);
-                else
-                    std::this_thread::sleep_for(1ms);
+                playbackClock.recordDelivery(scheduledTime);
+                processingTime = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + processingTime * 0.9f;
+
+                // Without frame skipping, the schedule is shifted instead of catching up:
+                if(!allowFrameSkipping && steady_clock::now() > scheduledTime)
+                    playbackClock.start(timestamps[nextFrame] - timestamps[0], playbackRate);
+
+                ++nextFrame;
             }
         });
     }
 
+    /**
+     * Requests the frames of all cameras nearest to the given timestamp (one
+     * worker per camera) and assembles them, so the time per frame is the time of
+     * the slowest camera instead of the sum of all cameras.
+     *
+     * Cameras which don't deliver a frame within the frame deadline don't stall
+     * the others: a partial frame is emitted ('complete' is false), in which late
+     * cameras are handled according to the policy of the assembler. Their worker
+     * continues with the newest request when it is done.
+     */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> syncImages(double searchedTimestamp, bool& complete){
+        auto deadline = steady_clock::now() + microseconds(int64_t(frameDeadline * 1000.f));
+        double tolerance = assembler->getTolerance();
+
+        workers->post([this, searchedTimestamp, tolerance](int i){
+            auto startTime = high_resolution_clock::now();
+            std::shared_ptr<OrganizedPointCloud> pc = streams[i]->syncImage(searchedTimestamp, tolerance);
+            cameraProcessingTimes[i] = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + cameraProcessingTimes[i] * 0.9f;
+
+            if(pc != nullptr)
+                assembler->push(i, streams[i]->getTimeStampAtFrame(pc->frameID), pc);
+        });
+
+        return assembler->assemble(searchedTimestamp, deadline, complete);
+    }
+
+    /**
+     * Returns the statistics of the frame assembly (see FrameAssembler::getStatistics).
+     */
+    void getAssemblyStatistics(unsigned long long& complete, unsigned long long& partial, unsigned long long& late, unsigned long long& dropped, unsigned long long& reused){
+        assembler->getStatistics(complete, partial, late, dropped, reused);
+    }
+
     /**
      * Join and destroy reading thread on deconstruction.
      */
     ~AzureKinectMKVStreamer(){
         shouldStop = true;
+        playbackClock.notify();
         if(readingThread.joinable())
             readingThread.join();
     }
@@ -171,10 +216,97 @@ public:
     virtual void step(int frameDelta = 1) override {
         int newFrameID = streams[0]->getCurrentFrame() + frameDelta;
 
-        if(newFrameID >= 0 && newFrameID < int(streams[0]->getTotalFrameCount()))
+        if(newFrameID >= 0 && newFrameID < int(streams[0]->getTotalFrameCount())){
             currentTime = float(streams[0]->getAllTimestamps()[newFrameID] - streams[0]->getAllTimestamps()[0]);
+
+            for(std::shared_ptr<AzureKinectMKVStream>& stream : streams)
+                stream->invalidatePrefetch(streams[0]->getAllTimestamps()[newFrameID]);
+
+            onPlaybackChanged();
+        }
     };
 
+    /**
+     * Sets the number of frames which are decoded ahead of the playhead for
+     * every camera (0 disables prefetching).
+     */
+    void setPrefetchDepth(int depth){
+        prefetchDepth = depth;
+        for(std::shared_ptr<AzureKinectMKVStream>& stream : streams)
+            stream->setPrefetchDepth(depth);
+    }
+
+    /**
+     * Returns the number of frames which were (not) already prefetched when
+     * requested, summed over all cameras.
+     */
+    void getPrefetchStatistics(unsigned long long& hits, unsigned long long& misses){
+        hits = misses = 0;
+        for(std::shared_ptr<AzureKinectMKVStream>& stream : streams){
+            hits += stream->getPrefetchHits();
+            misses += stream->getPrefetchMisses();
+        }
+    }
+
+    /**
+     * Sets the RAM budget for the frame caches of all cameras (buffered mode).
+     */
+    void setCacheBudget(size_t bytes){
+        for(std::shared_ptr<AzureKinectMKVStream>& stream : streams)
+            stream->setCacheBudget(bytes / streams.size());
+    }
+
+    /**
+     * Returns the statistics of the frame caches (buffered mode) summed over all
+     * cameras, the number of frames which are cached for all cameras (the
+     * fewest frames of a camera), the average compression ratio and the decode
+     * time per frame of the slowest camera.
+     */
+    void getCacheStatistics(size_t& residentBytes, unsigned int& residentFrames, float& hitRate, unsigned long long& evictions, float& compressionRatio, float& decodeTime){
+        residentBytes = 0;
+        residentFrames = 0;
+        evictions = 0;
+        compressionRatio = 0.f;
+        decodeTime = 0.f;
+
+        unsigned long long hits = 0, misses = 0;
+        bool isFirstCache = true;
+        for(std::shared_ptr<AzureKinectMKVStream>& stream : streams){
+            CompressedFrameCache* cache = stream->getFrameCache();
+            if(cache != nullptr){
+                unsigned int frameCount = cache->getResidentFrameCount();
+                residentFrames = isFirstCache ? frameCount : std::min(residentFrames, frameCount);
+                isFirstCache = false;
+
+                unsigned long long cacheHits, cacheMisses, cacheEvictions;
+                cache->getStatistics(cacheHits, cacheMisses, cacheEvictions);
+                hits += cacheHits;
+                misses += cacheMisses;
+                evictions += cacheEvictions;
+                residentBytes += cache->getResidentBytes();
+            }
+
+            compressionRatio += stream->getCompressionRatio() / streams.size();
+            decodeTime = std::max(decodeTime, stream->getDecodeTime());
+        }
+
+        hitRate = hits + misses > 0 ? float(double(hits) / (hits + misses)) : 0.f;
+    }
+
+    /**
+     * Returns the number of point cloud buffers which had to be allocated since
+     * the pools had no free buffer, and the total size of the pools, summed over
+     * all cameras.
+     */
+    void getBufferPoolStatistics(unsigned long long& misses, size_t& allocatedBytes){
+        misses = 0;
+        allocatedBytes = 0;
+        for(std::shared_ptr<AzureKinectMKVStream>& stream : streams){
+            misses += stream->getBufferPool().getMissCount();
+            allocatedBytes += stream->getBufferPool().getAllocatedBytes();
+        }
+    }
+
     /**
      * Returns the number of frames of the point cloud recording for the
      * master depth sensor (idx 0).
@@ -190,4 +322,12 @@ public:
     virtual float getProcessingTime() override {
         return processingTime;
     };
+
+    /**
+     * Returns the time in milliseconds which each camera requires to read and
+     * decode its frame.
+     */
+    virtual std::vector<float> getCameraProcessingTimes() override {
+        return cameraProcessingTimes;
+    };
 };
@@ -0,0 +1,261 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <algorithm>
+
+#include "src/util/OrganizedPointCloud.h"
+
+/**
+ * Returns the first frame of [begin, end) (sorted by timestamp) which is newer
+ * than the given timestamp minus the tolerance, i.e. the frame of a camera
+ * which belongs to the timestamp. The streams (e.g.
+ * AzureKinectMKVStream::syncImage) and the FrameAssembler use this rule, so the
+ * assembler accepts exactly the frames the streams deliver. That's also the
+ * case if the next frame of a camera is more than the tolerance after the
+ * timestamp (e.g. due to an offset of its clock or a dropped frame).
+ */
+template<typename Iterator, typename GetTimestamp>
+Iterator findSynchronizedFrame(Iterator begin, Iterator end, double timestamp, double tolerance, GetTimestamp getTimestamp){
+    return std::upper_bound(begin, end, timestamp - tolerance, [&](double limit, const typename std::iterator_traits<Iterator>::value_type& frame){
+        return limit < getTimestamp(frame);
+    });
+}
+
+/** Returns the index of the synchronized frame (see above) in the sorted timestamps (size if there is none) */
+inline int findSynchronizedFrame(const std::vector<double>& timestamps, double timestamp, double tolerance){
+    return int(findSynchronizedFrame(timestamps.begin(), timestamps.end(), timestamp, tolerance, [](double frameTimestamp){ return frameTimestamp; }) - timestamps.begin());
+}
+
+/**
+ * What happens with a camera which has no frame within the tolerance when the
+ * deadline of a multi-camera frame has passed.
+ */
+enum class LateCameraPolicy {
+    /** The last emitted frame of the camera is used again */
+    ReuseLastFrame = 0,
+
+    /** The camera is inactive in this frame (nullptr at its index) */
+    MarkInactive = 1
+};
+
+/**
+ * Forms multi-camera frames from frames which arrive independently per camera
+ * (e.g. decoded by one worker per camera).
+ *
+ * Every camera has a queue of frames sorted by device timestamp. A frame for a
+ * requested timestamp consists of the first frame of every camera which is not
+ * older than the tolerance before the timestamp (see findSynchronizedFrame),
+ * like the streams select them. If not all cameras have such a frame when
+ * the deadline passes, a partial frame is emitted in which the late cameras are
+ * handled according to the LateCameraPolicy, so that a slow or missing camera
+ * doesn't stall the others.
+ *
+ * The emitted vector always has one entry per camera, so the index of a point
+ * cloud is its camera ID. Only with LateCameraPolicy::MarkInactive (or if a
+ * camera never delivered a frame) entries can be nullptr.
+ */
+class FrameAssembler {
+    struct QueuedFrame {
+        double timestamp;
+        std::shared_ptr<OrganizedPointCloud> pointCloud;
+        bool emitted;
+    };
+
+    struct CameraQueue {
+        std::deque<QueuedFrame> frames;
+        std::shared_ptr<OrganizedPointCloud> lastEmitted;
+    };
+
+    std::mutex mutex;
+    std::condition_variable frameArrived;
+
+    std::vector<CameraQueue> cameras;
+
+    /** Frames per camera which are kept at most (older ones are dropped) */
+    size_t maxQueueLength;
+
+    double tolerance;
+    LateCameraPolicy policy;
+
+    /** Timestamp of the last assembled frame (to detect seeking backwards) */
+    double lastTimestamp = -INFINITY;
+
+    unsigned long long completeFrames = 0;
+    unsigned long long partialFrames = 0;
+    unsigned long long lateCameraFrames = 0;
+    unsigned long long droppedCameraFrames = 0;
+    unsigned long long reusedCameraFrames = 0;
+
+    /** Removes the oldest queued frame of the camera */
+    void dropFront(CameraQueue& camera){
+        if(!camera.frames.front().emitted)
+            ++droppedCameraFrames;
+        camera.frames.pop_front();
+    }
+
+    /**
+     * Returns the index of the queued frame of the given camera which belongs to
+     * the timestamp (see findSynchronizedFrame), or -1.
+     */
+    int findMatch(const CameraQueue& camera, double timestamp){
+        auto match = findSynchronizedFrame(camera.frames.begin(), camera.frames.end(), timestamp, tolerance, [](const QueuedFrame& frame){
+            return frame.timestamp;
+        });
+
+        return match != camera.frames.end() ? int(match - camera.frames.begin()) : -1;
+    }
+
+public:
+    FrameAssembler(unsigned int cameraCount, double tolerance = 0.0166, LateCameraPolicy policy = LateCameraPolicy::ReuseLastFrame, size_t maxQueueLength = 8)
+        : cameras(cameraCount)
+        , maxQueueLength(maxQueueLength)
+        , tolerance(tolerance)
+        , policy(policy)
+    {}
+
+    /**
+     * Adds the frame of a camera with the given device timestamp (in seconds).
+     * Pushing a frame with a timestamp which is already queued replaces it.
+     */
+    void push(unsigned int cameraID, double timestamp, std::shared_ptr<OrganizedPointCloud> pointCloud){
+        if(cameraID >= cameras.size() || pointCloud == nullptr)
+            return;
+
+        // Matched frames stay queued and may be emitted again (see LateCameraPolicy):
+        pointCloud->isWritable = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::deque<QueuedFrame>& frames = cameras[cameraID].frames;
+
+            // Usually the frames arrive in order, so search from the back:
+            auto it = frames.end();
+            while(it != frames.begin() && (it - 1)->timestamp >= timestamp)
+                --it;
+
+            if(it != frames.end() && it->timestamp == timestamp){
+                it->pointCloud = pointCloud;
+            } else {
+                frames.insert(it, QueuedFrame{timestamp, pointCloud, false});
+            }
+
+            while(frames.size() > maxQueueLength)
+                dropFront(cameras[cameraID]);
+        }
+
+        frameArrived.notify_all();
+    }
+
+    /**
+     * Forms the frame for the given timestamp. Waits until every camera has a
+     * matching frame or until the deadline has passed. 'complete' is
+     * false if at least one camera was late.
+     *
+     * Queued frames older than the emitted ones are dropped, since they can't be
+     * part of a later frame anymore. Requesting an earlier timestamp than before
+     * (seeking backwards) discards all queued frames.
+     */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> assemble(double timestamp, std::chrono::steady_clock::time_point deadline, bool& complete){
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if(timestamp < lastTimestamp - tolerance){
+            for(CameraQueue& camera : cameras)
+                camera.frames.clear();
+        }
+        lastTimestamp = timestamp;
+
+        std::vector<int> matches(cameras.size(), -1);
+        auto allCamerasMatched = [&](){
+            bool all = true;
+            for(size_t i = 0; i < cameras.size(); ++i){
+                matches[i] = findMatch(cameras[i], timestamp);
+                all = all && matches[i] >= 0;
+            }
+            return all;
+        };
+
+        complete = frameArrived.wait_until(lock, deadline, allCamerasMatched);
+
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds(cameras.size());
+        for(size_t i = 0; i < cameras.size(); ++i){
+            CameraQueue& camera = cameras[i];
+
+            if(matches[i] >= 0){
+                // The matched frame stays queued, since it may be requested again:
+                for(int f = 0; f < matches[i]; ++f)
+                    dropFront(camera);
+
+                camera.frames.front().emitted = true;
+                pointClouds[i] = camera.frames.front().pointCloud;
+                camera.lastEmitted = pointClouds[i];
+                continue;
+            }
+
+            ++lateCameraFrames;
+
+            // Frames before the requested timestamp won't match anymore:
+            while(!camera.frames.empty() && camera.frames.front().timestamp <= timestamp - tolerance)
+                dropFront(camera);
+
+            if(policy == LateCameraPolicy::ReuseLastFrame && camera.lastEmitted != nullptr){
+                pointClouds[i] = camera.lastEmitted;
+                ++reusedCameraFrames;
+            }
+        }
+
+        if(complete)
+            ++completeFrames;
+        else
+            ++partialFrames;
+
+        return pointClouds;
+    }
+
+    unsigned int getCameraCount(){
+        return (unsigned int) cameras.size();
+    }
+
+    /** Maximum time in seconds a frame may be older than the requested timestamp */
+    void setTolerance(double seconds){
+        std::lock_guard<std::mutex> lock(mutex);
+        tolerance = seconds;
+    }
+
+    double getTolerance(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return tolerance;
+    }
+
+    void setPolicy(LateCameraPolicy latePolicy){
+        std::lock_guard<std::mutex> lock(mutex);
+        policy = latePolicy;
+    }
+
+    LateCameraPolicy getPolicy(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return policy;
+    }
+
+    /**
+     * Returns the number of emitted complete and partial frames, and the number
+     * of camera frames which were late (missing at the deadline), dropped (never
+     * emitted) and reused (emitted again instead of a late frame).
+     */
+    void getStatistics(unsigned long long& complete, unsigned long long& partial, unsigned long long& late, unsigned long long& dropped, unsigned long long& reused){
+        std::lock_guard<std::mutex> lock(mutex);
+        complete = completeFrames;
+        partial = partialFrames;
+        late = lateCameraFrames;
+        dropped = droppedCameraFrames;
+        reused = reusedCameraFrames;
+    }
+};
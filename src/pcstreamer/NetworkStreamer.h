@@ -0,0 +1,383 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstring>
+
+#include <chrono>
+using namespace std::chrono;
+
+#include "src/pcstreamer/Streamer.h"
+#include "src/pcstreamer/network/PointCloudStreamProtocol.h"
+#include "src/util/net/TCPSocket.h"
+#include "src/util/BufferPool.h"
+
+// Incomplete frames which are kept while waiting for the missing cameras:
+#define NETWORK_MAX_PENDING_FRAMES 4
+
+// A frame ID this far below the last completed one is from a restarted sender:
+#define NETWORK_FRAME_ID_RESTART_DISTANCE 300
+
+/**
+ * Receives organized point clouds of one or multiple senders (e.g. capture
+ * nodes or BlendPCR-sender) over TCP, see PointCloudStreamProtocol.h.
+ *
+ * The images are received directly into recycled buffers of a BufferPool
+ * which are handed out as point clouds, so no intermediate copy is made. The
+ * point clouds of all cameras with the same frame ID are assembled to one frame,
+ * which is passed to the callback as soon as it is complete. Incomplete frames
+ * which are overtaken by newer complete frames are dropped.
+ */
+class NetworkStreamer : public Streamer {
+    struct Camera {
+        Mat4f modelMatrix;
+        std::vector<float> lookupImageTo3D;
+        std::vector<float> lookup3DToImage;
+    };
+
+    struct PendingFrame {
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
+        unsigned int receivedCount = 0;
+        int64_t firstSendTime = 0;
+        int64_t firstReceiveTime = 0;
+    };
+
+    int port;
+    std::unique_ptr<TCPListener> listener;
+    std::thread acceptingThread;
+    std::atomic<bool> shouldStop{false};
+
+    std::mutex connectionMutex;
+    std::vector<std::shared_ptr<TCPSocket>> connections;
+    std::vector<std::thread> receivingThreads;
+
+    /** Format of the stream (defined by the first sender), protected by setupMutex */
+    std::mutex setupMutex;
+    unsigned int totalCameraCount = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int lookup3DToImageSize = 0;
+    std::vector<Camera> cameras;
+
+    std::mutex assemblyMutex;
+    std::map<int64_t, PendingFrame> pendingFrames;
+    int64_t lastCompletedFrameID = -1;
+
+    /** Serializes the callback, since frames can be completed by any receiving thread */
+    std::mutex callbackMutex;
+    int64_t lastDeliveredFrameID = -1;
+
+    std::shared_ptr<BufferPool> bufferPool = std::make_shared<BufferPool>();
+
+    std::atomic<int> connectionCount{0};
+    std::atomic<unsigned long long> receivedBytes{0};
+    std::atomic<unsigned long long> completedFrames{0};
+    std::atomic<unsigned long long> droppedFrames{0};
+
+    float processingTime = 0.f;
+    float latency = 0.f;
+    float frameRate = 0.f;
+    int64_t lastDeliveryTime = 0;
+
+    /**
+     * Checks the header of a new sender against the stream format (or defines
+     * the format if this is the first sender).
+     */
+    bool acceptSetup(const PointCloudStreamHeader& header){
+        std::lock_guard<std::mutex> lock(setupMutex);
+
+        if(header.width == 0 || header.height == 0 || header.cameraCount == 0 || header.firstCameraID + header.cameraCount > header.totalCameraCount){
+            std::cerr << "Invalid point cloud stream header." << std::endl;
+            return false;
+        }
+
+        if(cameras.empty()){
+            totalCameraCount = header.totalCameraCount;
+            width = header.width;
+            height = header.height;
+            lookup3DToImageSize = header.lookup3DToImageSize;
+
+            cameras = std::vector<Camera>(totalCameraCount);
+            for(Camera& camera : cameras){
+                camera.lookupImageTo3D = std::vector<float>(size_t(width) * height * 2, 0.f);
+                camera.lookup3DToImage = std::vector<float>(size_t(lookup3DToImageSize) * lookup3DToImageSize * 2, -1.f);
+            }
+
+            // Two frames in flight (renderer & filter) plus the one being received:
+            bufferPool->reserve(size_t(width) * height * sizeof(uint16_t), 3 * totalCameraCount);
+            bufferPool->reserve(size_t(width) * height * sizeof(Vec4b), 3 * totalCameraCount);
+            return true;
+        }
+
+        if(header.totalCameraCount != totalCameraCount || header.width != width || header.height != height || header.lookup3DToImageSize != lookup3DToImageSize){
+            std::cerr << "Point cloud stream doesn't match the format of the other senders." << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Forgets the pending frames and the last frame IDs, since a (re)started
+     * sender counts its frame IDs from 0 again.
+     */
+    void resetFrameIDs(){
+        {
+            std::lock_guard<std::mutex> lock(assemblyMutex);
+            pendingFrames.clear();
+            lastCompletedFrameID = -1;
+        }
+
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        lastDeliveredFrameID = -1;
+    }
+
+    /**
+     * Receives the model matrices and lookup tables of the cameras of a sender.
+     * The lookup tables are written in place, since point clouds which are still
+     * in use point to them (a reconnecting sender sends the same values again).
+     */
+    bool receiveCameras(TCPSocket& socket, const PointCloudStreamHeader& header){
+        for(unsigned int i = 0; i < header.cameraCount; ++i){
+            PointCloudStreamCamera cameraHeader;
+            std::vector<float> lookupImageTo3D(size_t(width) * height * 2);
+            std::vector<float> lookup3DToImage(size_t(lookup3DToImageSize) * lookup3DToImageSize * 2);
+
+            if(!socket.receiveAll(&cameraHeader, sizeof(cameraHeader))
+                || !socket.receiveAll(lookupImageTo3D.data(), lookupImageTo3D.size() * sizeof(float))
+                || !socket.receiveAll(lookup3DToImage.data(), lookup3DToImage.size() * sizeof(float)))
+                return false;
+
+            std::lock_guard<std::mutex> lock(setupMutex);
+            Camera& camera = cameras[header.firstCameraID + i];
+            camera.modelMatrix = Mat4f(cameraHeader.modelMatrix);
+            std::memcpy(camera.lookupImageTo3D.data(), lookupImageTo3D.data(), lookupImageTo3D.size() * sizeof(float));
+            std::memcpy(camera.lookup3DToImage.data(), lookup3DToImage.data(), lookup3DToImage.size() * sizeof(float));
+        }
+
+        return true;
+    }
+
+    void receiveLoop(std::shared_ptr<TCPSocket> socket){
+        PointCloudStreamHeader header;
+        if(!socket->receiveAll(&header, sizeof(header)) || std::memcmp(header.magic, POINT_CLOUD_STREAM_MAGIC, 8) != 0){
+            std::cerr << "Not a point cloud stream, closing connection." << std::endl;
+            return;
+        }
+
+        if(!acceptSetup(header) || !receiveCameras(*socket, header))
+            return;
+
+        std::cout << "Sender connected (cameras " << header.firstCameraID << " to " << (header.firstCameraID + header.cameraCount - 1) << ")." << std::endl;
+        resetFrameIDs();
+        ++connectionCount;
+
+        const size_t depthSize = size_t(width) * height * sizeof(uint16_t);
+        const size_t colorSize = size_t(width) * height * sizeof(Vec4b);
+
+        while(!shouldStop){
+            PointCloudStreamFrame frame;
+            if(!socket->receiveAll(&frame, sizeof(frame)))
+                break;
+
+            int64_t receiveTime = getPointCloudStreamTime();
+
+            if(frame.magic != POINT_CLOUD_STREAM_FRAME_MAGIC
+                || frame.cameraID < header.firstCameraID || frame.cameraID >= header.firstCameraID + header.cameraCount
+                || frame.depthSize != depthSize || (frame.colorSize != 0 && frame.colorSize != colorSize)){
+                std::cerr << "Corrupt frame in point cloud stream, closing connection." << std::endl;
+                break;
+            }
+
+            Camera& camera = cameras[frame.cameraID];
+
+            std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
+            pc->bufferPool = bufferPool;
+            pc->depth = bufferPool->acquire<uint16_t>(size_t(width) * height);
+            if(!socket->receiveAll(pc->depth, depthSize))
+                break;
+
+            if(frame.colorSize != 0){
+                pc->colors = bufferPool->acquire<Vec4b>(size_t(width) * height);
+                if(!socket->receiveAll(pc->colors, colorSize))
+                    break;
+            }
+
+            pc->modelMatrix = camera.modelMatrix;
+            pc->lookupImageTo3D = camera.lookupImageTo3D.data();
+            pc->lookup3DToImage = camera.lookup3DToImage.data();
+            pc->lookup3DToImageSize = lookup3DToImageSize;
+            pc->frameID = int(frame.frameID);
+            pc->timestamp = float(frame.timestamp);
+
+            receivedBytes += sizeof(frame) + frame.depthSize + frame.colorSize;
+            addToFrame(frame, pc, receiveTime);
+        }
+
+        --connectionCount;
+        std::cout << "Sender disconnected." << std::endl;
+    }
+
+    /**
+     * Adds the point cloud to its frame and passes the frame to the callback if
+     * it is complete.
+     */
+    void addToFrame(const PointCloudStreamFrame& frame, std::shared_ptr<OrganizedPointCloud> pc, int64_t receiveTime){
+        std::vector<std::shared_ptr<OrganizedPointCloud>> completed;
+        int64_t firstSendTime = 0, firstReceiveTime = 0;
+
+        // The sender was restarted without reconnecting (e.g. behind a relay):
+        bool isRestarted;
+        {
+            std::lock_guard<std::mutex> lock(assemblyMutex);
+            isRestarted = frame.frameID < lastCompletedFrameID - NETWORK_FRAME_ID_RESTART_DISTANCE;
+        }
+        if(isRestarted)
+            resetFrameIDs();
+
+        {
+            std::lock_guard<std::mutex> lock(assemblyMutex);
+
+            // Late camera of a frame which was already dropped:
+            if(frame.frameID <= lastCompletedFrameID)
+                return;
+
+            PendingFrame& pending = pendingFrames[frame.frameID];
+            if(pending.pointClouds.empty()){
+                pending.pointClouds = std::vector<std::shared_ptr<OrganizedPointCloud>>(totalCameraCount);
+                pending.firstSendTime = frame.sendTime;
+                pending.firstReceiveTime = receiveTime;
+            }
+
+            if(pending.pointClouds[frame.cameraID] == nullptr)
+                ++pending.receivedCount;
+            pending.pointClouds[frame.cameraID] = pc;
+            pending.firstSendTime = std::min(pending.firstSendTime, frame.sendTime);
+
+            if(pending.receivedCount == totalCameraCount){
+                completed = std::move(pending.pointClouds);
+                firstSendTime = pending.firstSendTime;
+                firstReceiveTime = pending.firstReceiveTime;
+
+                // All older frames can't be delivered anymore:
+                auto end = pendingFrames.upper_bound(frame.frameID);
+                droppedFrames += std::distance(pendingFrames.begin(), end) - 1;
+                pendingFrames.erase(pendingFrames.begin(), end);
+                lastCompletedFrameID = frame.frameID;
+            } else if(pendingFrames.size() > NETWORK_MAX_PENDING_FRAMES){
+                pendingFrames.erase(pendingFrames.begin());
+                ++droppedFrames;
+            }
+        }
+
+        if(completed.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(callbackMutex);
+
+        // A newer frame was completed by another thread in the meantime:
+        if(frame.frameID <= lastDeliveredFrameID){
+            ++droppedFrames;
+            return;
+        }
+        lastDeliveredFrameID = frame.frameID;
+
+        int64_t now = getPointCloudStreamTime();
+        latency = ((now - firstSendTime) * 0.001f) * 0.1f + latency * 0.9f;
+        processingTime = ((now - firstReceiveTime) * 0.001f) * 0.1f + processingTime * 0.9f;
+        if(lastDeliveryTime != 0 && now > lastDeliveryTime)
+            frameRate = (1000000.f / (now - lastDeliveryTime)) * 0.1f + frameRate * 0.9f;
+        lastDeliveryTime = now;
+        ++completedFrames;
+
+        if(callback)
+            callback(completed);
+    }
+
+public:
+    NetworkStreamer(int port = POINT_CLOUD_STREAM_DEFAULT_PORT)
+        : port(port)
+    {
+        listener = std::make_unique<TCPListener>(port);
+        if(!listener->isValid())
+            return;
+
+        std::cout << "Waiting for point cloud senders on port " << port << "..." << std::endl;
+
+        acceptingThread = std::thread([this](){
+            while(!shouldStop){
+                std::unique_ptr<TCPSocket> socket = listener->accept(100);
+                if(socket == nullptr)
+                    continue;
+
+                socket->configure(32 * 1024 * 1024);
+
+                std::shared_ptr<TCPSocket> connection = std::move(socket);
+                std::lock_guard<std::mutex> lock(connectionMutex);
+                connections.push_back(connection);
+                receivingThreads.emplace_back(&NetworkStreamer::receiveLoop, this, connection);
+            }
+        });
+    }
+
+    /**
+     * Closes all connections and joins all threads on deconstruction.
+     */
+    ~NetworkStreamer(){
+        shouldStop = true;
+        if(acceptingThread.joinable())
+            acceptingThread.join();
+
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        for(std::shared_ptr<TCPSocket>& connection : connections)
+            connection->shutdown();
+
+        for(std::thread& thread : receivingThreads)
+            thread.join();
+    }
+
+    int getPort(){
+        return port;
+    }
+
+    bool isListening(){
+        return listener != nullptr && listener->isValid();
+    }
+
+    int getConnectionCount(){
+        return connectionCount;
+    }
+
+    /**
+     * Returns the time from sending the first camera image of a frame until the
+     * frame was complete in milliseconds (only meaningful if the senders run on
+     * the same host, see getPointCloudStreamTime()).
+     */
+    float getLatency(){
+        return latency;
+    }
+
+    /** Number of complete frames per second */
+    float getFrameRate(){
+        return frameRate;
+    }
+
+    void getStatistics(unsigned long long& completed, unsigned long long& dropped, unsigned long long& bytes){
+        completed = completedFrames;
+        dropped = droppedFrames;
+        bytes = receivedBytes;
+    }
+
+    /**
+     * Returns the time in milliseconds from receiving the first camera image of
+     * a frame until the frame was complete.
+     */
+    virtual float getProcessingTime() override {
+        return processingTime;
+    };
+};
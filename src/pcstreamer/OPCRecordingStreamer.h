@@ -0,0 +1,307 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <thread>
+#include <algorithm>
+#include <cstring>
+
+#include <chrono>
+using namespace std::chrono;
+
+#include "src/pcstreamer/Streamer.h"
+#include "src/pcstreamer/FrameAssembler.h"
+#include "src/pcstreamer/opc_recording/OPCRecordingFormat.h"
+#include "src/util/MappedFile.h"
+
+/**
+ * Streams a native organized point cloud recording (*.opcr, see
+ * OPCRecordingFormat.h), which can be created from a CWIPC-SXR dataset by
+ * the BlendPCR-convert tool.
+ *
+ * The file is memory-mapped and the point clouds are handed out as views into
+ * the mapping (zero-copy), so replaying only costs page faults. No Azure Kinect
+ * SDK is required.
+ */
+class OPCRecordingStreamer : public FileStreamer {
+    struct Camera {
+        const OPCRecordingCameraHeader* header = nullptr;
+        const OPCRecordingFrameEntry* frames = nullptr;
+        float* lookupImageTo3D = nullptr;
+        float* lookup3DToImage = nullptr;
+        Mat4f modelMatrix;
+        std::vector<double> timestamps;
+        int currentFrame = 0;
+    };
+
+    std::shared_ptr<MappedFile> mappedFile;
+    const OPCRecordingFileHeader* header = nullptr;
+    std::vector<Camera> cameras;
+
+    std::thread readingThread;
+    bool shouldStop = false;
+
+    float processingTime = 0.f;
+    float lastTimeWhileStopped = -1.f;
+
+
+    /**
+     * Checks that the given range is inside the mapped file.
+     */
+    bool isInside(uint64_t offset, uint64_t size){
+        return offset + size <= mappedFile->size() && offset + size >= offset;
+    }
+
+    bool open(std::string path){
+        mappedFile = std::make_shared<MappedFile>(path);
+        if(!mappedFile->isValid())
+            return false;
+
+        if(!isInside(0, sizeof(OPCRecordingFileHeader))){
+            std::cerr << "Recording is too small: " << path << std::endl;
+            return false;
+        }
+
+        header = (const OPCRecordingFileHeader*) mappedFile->data();
+        if(std::memcmp(header->magic, OPC_RECORDING_MAGIC, 8) != 0 || header->version != OPC_RECORDING_VERSION){
+            std::cerr << "Not a valid OPC recording (or unsupported version): " << path << std::endl;
+            return false;
+        }
+
+        if(header->cameraCount == 0 || !isInside(header->cameraTableOffset, uint64_t(header->cameraCount) * sizeof(OPCRecordingCameraHeader))){
+            std::cerr << "Corrupt camera table in recording: " << path << std::endl;
+            return false;
+        }
+
+        uint64_t pixelCount = uint64_t(header->width) * header->height;
+        uint64_t lookupSize = uint64_t(header->lookup3DToImageSize) * header->lookup3DToImageSize;
+
+        const OPCRecordingCameraHeader* cameraHeaders = (const OPCRecordingCameraHeader*)(mappedFile->data() + header->cameraTableOffset);
+        cameras = std::vector<Camera>(header->cameraCount);
+
+        for(unsigned int i = 0; i < header->cameraCount; ++i){
+            Camera& camera = cameras[i];
+            camera.header = &cameraHeaders[i];
+
+            if(camera.header->frameCount == 0
+                || !isInside(camera.header->frameTableOffset, uint64_t(camera.header->frameCount) * sizeof(OPCRecordingFrameEntry))
+                || !isInside(camera.header->lookupImageTo3DOffset, pixelCount * 2 * sizeof(float))
+                || !isInside(camera.header->lookup3DToImageOffset, lookupSize * 2 * sizeof(float))){
+                std::cerr << "Corrupt camera " << i << " in recording: " << path << std::endl;
+                return false;
+            }
+
+            camera.frames = (const OPCRecordingFrameEntry*)(mappedFile->data() + camera.header->frameTableOffset);
+            camera.lookupImageTo3D = (float*)(mappedFile->data() + camera.header->lookupImageTo3DOffset);
+            camera.lookup3DToImage = (float*)(mappedFile->data() + camera.header->lookup3DToImageOffset);
+            camera.modelMatrix = Mat4f(camera.header->modelMatrix);
+
+            for(unsigned int f = 0; f < camera.header->frameCount; ++f){
+                const OPCRecordingFrameEntry& entry = camera.frames[f];
+                if(!isInside(entry.depthOffset, pixelCount * sizeof(uint16_t)) || (entry.colorOffset != 0 && !isInside(entry.colorOffset, pixelCount * 4))){
+                    std::cerr << "Corrupt frame " << f << " of camera " << i << " in recording: " << path << std::endl;
+                    return false;
+                }
+                camera.timestamps.push_back(entry.timestamp);
+            }
+        }
+
+        std::cout << "Opened OPC recording with " << cameras.size() << " cameras and " << cameras[0].timestamps.size() << " frames." << std::endl;
+        return true;
+    }
+
+    /**
+     * Returns a zero-copy view of the frame of the given camera which is nearest to
+     * (but not much before) the given timestamp.
+     */
+    std::shared_ptr<OrganizedPointCloud> syncImage(unsigned int cameraID, double timestamp){
+        Camera& camera = cameras[cameraID];
+
+        // Same matching as in AzureKinectMKVStream::syncImage:
+        int frame = findSynchronizedFrame(camera.timestamps, timestamp, 0.0166);
+        if(frame >= int(camera.timestamps.size()))
+            return nullptr;
+
+        camera.currentFrame = frame;
+        const OPCRecordingFrameEntry& entry = camera.frames[camera.currentFrame];
+
+        std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(header->width, header->height);
+        pc->memoryOwner = mappedFile;
+        pc->isWritable = false;
+        pc->depth = (uint16_t*)(mappedFile->data() + entry.depthOffset);
+        pc->colors = entry.colorOffset != 0 ? (Vec4b*)(mappedFile->data() + entry.colorOffset) : nullptr;
+        pc->modelMatrix = camera.modelMatrix;
+        pc->lookupImageTo3D = camera.lookupImageTo3D;
+        pc->lookup3DToImage = camera.lookup3DToImage;
+        pc->lookup3DToImageSize = header->lookup3DToImageSize;
+        pc->frameID = camera.currentFrame;
+
+        // Let the OS read ahead the next frame while this one is processed:
+        if(camera.currentFrame + 1 < int(camera.timestamps.size())){
+            uint64_t pixelCount = uint64_t(header->width) * header->height;
+            const OPCRecordingFrameEntry& next = camera.frames[camera.currentFrame + 1];
+            mappedFile->prefetch(next.depthOffset, pixelCount * sizeof(uint16_t));
+            if(next.colorOffset != 0)
+                mappedFile->prefetch(next.colorOffset, pixelCount * 4);
+        }
+
+        return pc;
+    }
+
+    std::vector<std::shared_ptr<OrganizedPointCloud>> syncImages(double timestamp, bool& complete){
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
+        complete = true;
+
+        for(unsigned int i = 0; i < cameras.size(); ++i){
+            std::shared_ptr<OrganizedPointCloud> pc = syncImage(i, timestamp);
+            if(pc != nullptr){
+                pointClouds.push_back(pc);
+            } else {
+                complete = false;
+            }
+        }
+
+        return pointClouds;
+    }
+
+public:
+    OPCRecordingStreamer(std::string path){
+        if(!open(path)){
+            cameras.clear();
+            return;
+        }
+
+        readingThread = std::thread([this](){
+            const std::vector<double>& timestamps = cameras[0].timestamps;
+            int frameCount = int(timestamps.size());
+
+            // Frame which is delivered next while playing (of camera 0):
+            int nextFrame = 0;
+            bool isScheduled = false;
+
+            while(!shouldStop){
+                if(playbackChanged.exchange(false))
+                    isScheduled = false;
+
+                if(!isPlaying){
+                    // If currentTime was changed manually, update the point cloud even when paused:
+                    if(lastTimeWhileStopped != currentTime){
+                        bool complete;
+                        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = syncImages(currentTime + timestamps[0], complete);
+
+                        if(callback)
+                            callback(pointClouds);
+
+                        lastTimeWhileStopped = currentTime;
+                    }
+
+                    // Sleep until play / seek / step:
+                    isScheduled = false;
+                    playbackClock.wait();
+                    continue;
+                }
+
+                // Schedule from the frame at currentTime (or the one after it, if it was already delivered):
+                if(!isScheduled){
+                    double searchedTimestamp = currentTime + timestamps[0] + (lastTimeWhileStopped == currentTime ? 0.0001 : -0.0001);
+                    nextFrame = int(std::lower_bound(timestamps.begin(), timestamps.end(), searchedTimestamp) - timestamps.begin());
+                    playbackClock.start(currentTime, playbackRate);
+                    isScheduled = true;
+                }
+
+                // If playtime exceeds the total time:
+                if(nextFrame >= frameCount){
+                    currentTime = 0;
+
+                    if(!loop){
+                        isPlaying = false;
+                        continue;
+                    }
+
+                    nextFrame = 0;
+                    playbackClock.start(0.0, playbackRate);
+                }
+
+                auto scheduledTime = playbackClock.getScheduledTime(timestamps[nextFrame] - timestamps[0]);
+
+                // Woken up before, since the playback was changed:
+                if(!playbackClock.waitUntil(scheduledTime))
+                    continue;
+
+                // Skip the frames which are already overdue, if the playback can't keep up:
+                if(allowFrameSkipping){
+                    double playbackTime = playbackClock.getPlaybackTime(steady_clock::now());
+                    while(nextFrame + 1 < frameCount && timestamps[nextFrame + 1] - timestamps[0] <= playbackTime)
+                        ++nextFrame;
+
+                    scheduledTime = playbackClock.getScheduledTime(timestamps[nextFrame] - timestamps[0]);
+                }
+
+                auto startTime = high_resolution_clock::now();
+
+                currentTime = float(timestamps[nextFrame] - timestamps[0]);
+                lastTimeWhileStopped = currentTime;
+
+                bool complete;
+                std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = syncImages(timestamps[nextFrame], complete);
+
+                if(callback && complete)
+                    callback(pointClouds);
+
+                playbackClock.recordDelivery(scheduledTime);
+                processingTime = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + processingTime * 0.9f;
+
+                // Without frame skipping, the schedule is shifted instead of catching up:
+                if(!allowFrameSkipping && steady_clock::now() > scheduledTime)
+                    playbackClock.start(timestamps[nextFrame] - timestamps[0], playbackRate);
+
+                ++nextFrame;
+            }
+        });
+    }
+
+    /**
+     * Join and destroy reading thread on deconstruction.
+     */
+    ~OPCRecordingStreamer(){
+        shouldStop = true;
+        playbackClock.notify();
+        if(readingThread.joinable())
+            readingThread.join();
+    }
+
+    /**
+     * Steps a frame forward. If the parameter 'frameDelta' is given, it steps
+     * the number of frames forward (or backward, when negative).
+     */
+    virtual void step(int frameDelta = 1) override {
+        if(cameras.empty())
+            return;
+
+        int newFrameID = cameras[0].currentFrame + frameDelta;
+
+        if(newFrameID >= 0 && newFrameID < int(cameras[0].timestamps.size())){
+            currentTime = float(cameras[0].timestamps[newFrameID] - cameras[0].timestamps[0]);
+            onPlaybackChanged();
+        }
+    };
+
+    /**
+     * Returns the total time of the point cloud recording for the master depth
+     * sensor (idx 0).
+     */
+    virtual float getTotalTime() override {
+        if(cameras.empty())
+            return 0.f;
+
+        return float(cameras[0].timestamps.back() - cameras[0].timestamps[0]);
+    };
+
+    /**
+     * Returns the CPU processing time in milliseconds per read frame of
+     * sensor 0).
+     */
+    virtual float getProcessingTime() override {
+        return processingTime;
+    };
+};
@@ -0,0 +1,132 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * Schedules the frames of a recording in wall-clock time for the reading thread
+ * of a file streamer.
+ *
+ * The clock maps playback time (seconds in the recording) to wall-clock time
+ * from an anchor, which is set by start(...) whenever the playback starts or
+ * changes (seek, step, rate). The reading thread sleeps until the scheduled time
+ * of the next frame, but is woken immediately by notify(), so it neither polls
+ * nor delays changes of the playback.
+ *
+ * The jitter statistics tell how far after their scheduled time the frames were
+ * delivered.
+ */
+class PlaybackClock {
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+
+    /** Set by notify(), reset by the next wait */
+    bool notified = false;
+
+    std::chrono::steady_clock::time_point anchorTime;
+    double anchorPlaybackTime = 0.0;
+    float rate = 1.f;
+
+    /** Jitter statistics in milliseconds */
+    float averageJitter = 0.f;
+    float maximumJitter = 0.f;
+    unsigned long long deliveredFrames = 0;
+
+public:
+    /**
+     * Anchors the given playback time at the current wall-clock time, so frames
+     * are scheduled from now on with the given rate (1 = realtime).
+     */
+    void start(double playbackTime, float playbackRate){
+        std::lock_guard<std::mutex> lock(mutex);
+        anchorTime = std::chrono::steady_clock::now();
+        anchorPlaybackTime = playbackTime;
+        rate = std::max(playbackRate, 0.01f);
+    }
+
+    /**
+     * Returns the wall-clock time at which the frame with the given playback time
+     * is due.
+     */
+    std::chrono::steady_clock::time_point getScheduledTime(double playbackTime){
+        std::lock_guard<std::mutex> lock(mutex);
+        double seconds = (playbackTime - anchorPlaybackTime) / rate;
+        return anchorTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    /**
+     * Returns the playback time at the given wall-clock time.
+     */
+    double getPlaybackTime(std::chrono::steady_clock::time_point time){
+        std::lock_guard<std::mutex> lock(mutex);
+        return anchorPlaybackTime + std::chrono::duration<double>(time - anchorTime).count() * rate;
+    }
+
+    /**
+     * Wakes the waiting reading thread, e.g. after seeking, stepping, pausing or
+     * changing the rate. If no thread is waiting, the next wait returns
+     * immediately.
+     */
+    void notify(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            notified = true;
+        }
+        wakeCondition.notify_all();
+    }
+
+    /**
+     * Waits until the given time or until notify() is called. Returns true if
+     * the time was reached (and false if woken by notify()).
+     */
+    bool waitUntil(std::chrono::steady_clock::time_point time){
+        std::unique_lock<std::mutex> lock(mutex);
+        bool wasNotified = wakeCondition.wait_until(lock, time, [this](){ return notified; });
+        notified = false;
+        return !wasNotified;
+    }
+
+    /**
+     * Waits until notify() is called (e.g. while paused).
+     */
+    void wait(){
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeCondition.wait(lock, [this](){ return notified; });
+        notified = false;
+    }
+
+    /**
+     * Records that the frame which was due at the given time is delivered now.
+     */
+    void recordDelivery(std::chrono::steady_clock::time_point scheduledTime){
+        float jitter = std::abs(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - scheduledTime).count());
+
+        std::lock_guard<std::mutex> lock(mutex);
+        averageJitter = deliveredFrames == 0 ? jitter : jitter * 0.05f + averageJitter * 0.95f;
+        maximumJitter = std::max(maximumJitter, jitter);
+        ++deliveredFrames;
+    }
+
+    /**
+     * Returns the (moving) average and the maximum time in milliseconds between
+     * the scheduled and the actual delivery of the frames, and the number of
+     * delivered frames.
+     */
+    void getJitterStatistics(float& average, float& maximum, unsigned long long& frames){
+        std::lock_guard<std::mutex> lock(mutex);
+        average = averageJitter;
+        maximum = maximumJitter;
+        frames = deliveredFrames;
+    }
+
+    void resetJitterStatistics(){
+        std::lock_guard<std::mutex> lock(mutex);
+        averageJitter = maximumJitter = 0.f;
+        deliveredFrames = 0;
+    }
+};
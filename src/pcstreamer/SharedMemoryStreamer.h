@@ -0,0 +1,272 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <cstring>
+
+#include <chrono>
+using namespace std::chrono;
+
+#include "src/pcstreamer/Streamer.h"
+#include "src/pcstreamer/shm/SharedMemoryRingFormat.h"
+#include "src/util/SharedMemory.h"
+
+/**
+ * Receives organized point clouds from a capture process on the same host via
+ * the shared memory ring (see SharedMemoryRingFormat.h and
+ * SharedMemoryRingProducer).
+ *
+ * The point clouds point directly into the slots of the ring (no copy). All
+ * point clouds of a frame hold a lease on their slot, so the producer doesn't
+ * overwrite the slot before the last of them is destroyed. Since the images
+ * are shared with other consumers of the same frame, the ring is mapped
+ * read-only (except for the header and slot headers, which are used for
+ * synchronization) and the point clouds are not writable (filters work on a
+ * copy, see OrganizedPointCloud::isWritable).
+ */
+class SharedMemoryStreamer : public Streamer {
+    /**
+     * Holds a slot (and keeps the mapping alive) as long as a point cloud of
+     * the frame exists.
+     */
+    struct SlotLease {
+        std::shared_ptr<SharedMemory> memory;
+        SharedMemoryRingSlot* slot;
+
+        SlotLease(std::shared_ptr<SharedMemory> memory, SharedMemoryRingSlot* slot)
+            : memory(memory)
+            , slot(slot){}
+
+        ~SlotLease(){
+            slot->readerCount.fetch_sub(1);
+        }
+    };
+
+    std::string name;
+
+    std::shared_ptr<SharedMemory> memory;
+    uint64_t lastSequence = 0;
+
+    /** Writable views of the header and the slot headers of the ring */
+    SharedMemoryRingHeader* header = nullptr;
+    std::vector<SharedMemoryRingSlot*> slots;
+
+    std::thread readingThread;
+    std::atomic<bool> shouldStop{false};
+
+    float processingTime = 0.f;
+    float latency = 0.f;
+    float frameRate = 0.f;
+    std::atomic<unsigned long long> receivedFrames{0};
+    std::atomic<unsigned long long> skippedFrames{0};
+    std::atomic<unsigned long long> producerDroppedFrames{0};
+    std::atomic<bool> connected{false};
+
+    /**
+     * Opens the ring (again, if the producer recreated it). Returns whether a
+     * valid ring is mapped.
+     */
+    bool openRing(){
+        std::shared_ptr<SharedMemory> newMemory = SharedMemory::open(name, true);
+        if(newMemory == nullptr || newMemory->size() < SHARED_MEMORY_RING_PAGE_SIZE)
+            return header != nullptr;
+
+        const SharedMemoryRingHeader* newHeader = (const SharedMemoryRingHeader*) newMemory->data();
+        if(std::memcmp(newHeader->magic, SHARED_MEMORY_RING_MAGIC, 8) != 0 || newHeader->version != SHARED_MEMORY_RING_VERSION
+            || newHeader->slotsOffset + uint64_t(newHeader->slotCount) * newHeader->slotSize > newMemory->size()){
+            return header != nullptr;
+        }
+
+        if(header != nullptr && header->sessionID == newHeader->sessionID)
+            return true;
+
+        SharedMemoryRingHeader* newControlHeader = (SharedMemoryRingHeader*) newMemory->mapWritable(0, sizeof(SharedMemoryRingHeader));
+        std::vector<SharedMemoryRingSlot*> newSlots;
+        for(unsigned int i = 0; i < newHeader->slotCount && newControlHeader != nullptr; ++i){
+            SharedMemoryRingSlot* slot = (SharedMemoryRingSlot*) newMemory->mapWritable(newHeader->slotsOffset + i * newHeader->slotSize, sizeof(SharedMemoryRingSlot));
+            if(slot == nullptr)
+                break;
+            newSlots.push_back(slot);
+        }
+
+        if(newControlHeader == nullptr || newSlots.size() != newHeader->slotCount){
+            std::cerr << "Failed to map the slots of shared memory ring '" << name << "'." << std::endl;
+            return header != nullptr;
+        }
+
+        std::cout << "Opened shared memory ring '" << name << "' with " << newHeader->cameraCount << " cameras." << std::endl;
+
+        // Point clouds of the previous ring keep its mapping alive:
+        memory = newMemory;
+        header = newControlHeader;
+        slots = newSlots;
+        lastSequence = 0;
+        connected = true;
+        return true;
+    }
+
+    /** Read-only data of the slot (see getSharedMemoryRingDepthOffset, ...) */
+    const uint8_t* getSlotData(unsigned int slotID){
+        return memory->data() + header->slotsOffset + slotID * header->slotSize;
+    }
+
+    /**
+     * Acquires the newest frame if it wasn't read yet. Returns an empty vector
+     * if there is no new frame.
+     */
+    std::vector<std::shared_ptr<OrganizedPointCloud>> acquireLatestFrame(){
+        uint64_t latest = header->latest.load(std::memory_order_acquire);
+        uint64_t sequence = latest >> 16;
+        unsigned int slotID = (unsigned int)(latest & 0xffff);
+
+        if(sequence == 0 || sequence == lastSequence || slotID >= header->slotCount)
+            return {};
+
+        SharedMemoryRingSlot* slot = slots[slotID];
+        slot->readerCount.fetch_add(1);
+
+        // The producer already reuses the slot for a newer frame:
+        if(slot->state.load() != sequence * 2){
+            slot->readerCount.fetch_sub(1);
+            return {};
+        }
+
+        if(lastSequence != 0 && sequence > lastSequence + 1)
+            skippedFrames += sequence - lastSequence - 1;
+        lastSequence = sequence;
+
+        std::shared_ptr<SlotLease> lease = std::make_shared<SlotLease>(memory, slot);
+
+        const SharedMemoryRingCamera* cameras = (const SharedMemoryRingCamera*)(memory->data() + SHARED_MEMORY_RING_PAGE_SIZE);
+        const uint8_t* slotData = getSlotData(slotID);
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds(header->cameraCount);
+
+        for(unsigned int i = 0; i < header->cameraCount; ++i){
+            std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(header->width, header->height);
+            pc->memoryOwner = lease;
+            pc->isWritable = false;
+            pc->depth = (uint16_t*)(slotData + getSharedMemoryRingDepthOffset(*header, i));
+            pc->colors = slot->cameras[i].hasColors ? (Vec4b*)(slotData + getSharedMemoryRingColorOffset(*header, i)) : nullptr;
+            pc->modelMatrix = Mat4f(cameras[i].modelMatrix);
+            pc->lookupImageTo3D = (float*)(memory->data() + cameras[i].lookupImageTo3DOffset);
+            pc->lookup3DToImage = (float*)(memory->data() + cameras[i].lookup3DToImageOffset);
+            pc->lookup3DToImageSize = header->lookup3DToImageSize;
+            pc->frameID = slot->cameras[i].frameID;
+            pc->timestamp = float(slot->cameras[i].timestamp);
+            pointClouds[i] = pc;
+        }
+
+        int64_t now = getSharedMemoryRingTime();
+        latency = ((now - slot->publishTime) * 0.001f) * 0.1f + latency * 0.9f;
+        producerDroppedFrames = header->droppedFrames.load();
+
+        return pointClouds;
+    }
+
+public:
+    SharedMemoryStreamer(std::string name = SHARED_MEMORY_RING_DEFAULT_NAME)
+        : name(name)
+    {
+        readingThread = std::thread([this](){
+            auto lastFrameTime = high_resolution_clock::now();
+            auto lastOpenAttempt = lastFrameTime;
+            float frameInterval = 1.f / 30.f;
+
+            while(!shouldStop){
+                auto now = high_resolution_clock::now();
+
+                // (Re)open the ring if there is none or no frame arrived for a while:
+                if(header == nullptr || now - lastFrameTime > 1s){
+                    if(now - lastOpenAttempt > 500ms || header == nullptr){
+                        lastOpenAttempt = now;
+                        if(!openRing()){
+                            std::this_thread::sleep_for(100ms);
+                            continue;
+                        }
+                    }
+                }
+
+                auto startTime = high_resolution_clock::now();
+                std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = acquireLatestFrame();
+
+                if(pointClouds.empty()){
+                    // Sleep until shortly before the next frame is expected, then poll
+                    // (spinning), so that frames are picked up with minimal latency:
+                    float sinceLastFrame = duration_cast<microseconds>(now - lastFrameTime).count() * 0.000001f;
+                    float untilNextFrame = frameInterval - sinceLastFrame;
+
+                    if(untilNextFrame > 0.002f){
+                        std::this_thread::sleep_for(microseconds(int64_t(std::min(untilNextFrame - 0.001f, 0.005f) * 1000000)));
+                    } else if(untilNextFrame < -frameInterval){
+                        // Producer is late or paused:
+                        std::this_thread::sleep_for(500us);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+
+                float interval = duration_cast<microseconds>(startTime - lastFrameTime).count() * 0.000001f;
+                frameInterval = std::min(interval, 0.2f) * 0.1f + frameInterval * 0.9f;
+                frameRate = (interval > 0.f ? 1.f / interval : 0.f) * 0.1f + frameRate * 0.9f;
+                lastFrameTime = startTime;
+                ++receivedFrames;
+
+                if(callback)
+                    callback(pointClouds);
+
+                processingTime = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + processingTime * 0.9f;
+            }
+        });
+    }
+
+    /**
+     * Join and destroy reading thread on deconstruction.
+     */
+    ~SharedMemoryStreamer(){
+        shouldStop = true;
+        if(readingThread.joinable())
+            readingThread.join();
+    }
+
+    std::string getName(){
+        return name;
+    }
+
+    bool isConnected(){
+        return connected;
+    }
+
+    /**
+     * Returns the time from publishing a frame by the producer until it was
+     * acquired in milliseconds.
+     */
+    float getLatency(){
+        return latency;
+    }
+
+    float getFrameRate(){
+        return frameRate;
+    }
+
+    /**
+     * Returns the number of received frames, the frames which were published
+     * but overtaken by a newer frame before they were read, and the frames the
+     * producer dropped since all slots were in use.
+     */
+    void getStatistics(unsigned long long& received, unsigned long long& skipped, unsigned long long& dropped){
+        received = receivedFrames;
+        skipped = skippedFrames;
+        dropped = producerDroppedFrames;
+    }
+
+    /**
+     * Returns the time in milliseconds to acquire a frame and pass it to the
+     * callback.
+     */
+    virtual float getProcessingTime() override {
+        return processingTime;
+    };
+};
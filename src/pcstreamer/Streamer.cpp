@@ -3,21 +3,54 @@
 
 #include "src/pcstreamer/Streamer.h"
 
+#ifdef USE_KINECT
 #include "src/pcstreamer/AzureKinectMKVStreamer.h"
+#endif
 
-const char* Streamer::availableStreamerNames[] = { "- No streamer selected -", "CWIPC-SXR (Streamed)", "CWIPC-SXR (Buffered)"};
+#include "src/pcstreamer/OPCRecordingStreamer.h"
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcstreamer/NetworkStreamer.h"
+#include "src/pcstreamer/SharedMemoryStreamer.h"
 
-const unsigned int Streamer::availableStreamerNum = 3;
+const char* Streamer::availableStreamerNames[] = { "- No streamer selected -", "CWIPC-SXR (Streamed)", "CWIPC-SXR (Buffered)", "OPC Recording (Memory-Mapped)", "Synthetic Scene (Benchmark)", "Network Receiver (TCP)", "Shared Memory Receiver"};
+
+const unsigned int Streamer::availableStreamerNum = 7;
 
 std::shared_ptr<Streamer> Streamer::constructStreamerInstance(int type, std::string filepath){
+#ifdef USE_KINECT
     if(type == 1){
-        return std::make_shared<AzureKinectMKVStreamer>(filepath, false);
+        return std::make_shared<AzureKinectMKVStreamer>(filepath, false, MKVDepthOnly);
     } else if(type == 2){
-        return std::make_shared<AzureKinectMKVStreamer>(filepath, true);
+        return std::make_shared<AzureKinectMKVStreamer>(filepath, true, MKVDepthOnly);
+    }
+#else
+    if(type == 1 || type == 2){
+        std::cerr << "BlendPCR was compiled without the Azure Kinect SDK. Convert the dataset with BlendPCR-convert and use the OPC recording streamer instead." << std::endl;
+        return nullptr;
+    }
+#endif
+
+    if(type == 3){
+        return std::make_shared<OPCRecordingStreamer>(filepath);
+    } else if(type == 4){
+        SyntheticCameraConfig config;
+        config.cameraCount = (unsigned int) std::max(1, SyntheticCameraCount);
+        return std::make_shared<SyntheticStreamer>(config);
+    } else if(type == 5){
+        return std::make_shared<NetworkStreamer>(NetworkPort);
+    } else if(type == 6){
+        return std::make_shared<SharedMemoryStreamer>(SharedMemoryName);
     }
 
     return nullptr;
 };
 
-int Streamer::BufferedMaxFrameCount = 360;
-int Streamer::BufferedStartFrameOffset = 200;
+bool Streamer::requiresPath(int type){
+    return type != 4 && type != 5 && type != 6;
+}
+
+int Streamer::BufferedCacheBudgetMB = 4096;
+bool Streamer::MKVDepthOnly = false;
+int Streamer::SyntheticCameraCount = 7;
+int Streamer::NetworkPort = POINT_CLOUD_STREAM_DEFAULT_PORT;
+std::string Streamer::SharedMemoryName = SHARED_MEMORY_RING_DEFAULT_NAME;
@@ -5,8 +5,10 @@
 #include <memory>
 #include <functional>
 #include <vector>
+#include <atomic>
 
 #include "src/util/OrganizedPointCloud.h"
+#include "src/pcstreamer/PlaybackClock.h"
 
 /**
  * Represents a class that streams a pointcloud from file, network or
@@ -14,8 +16,8 @@
  *
  * Note that when using multiple sensors, it is currently assumed that
  * all sensors use the same frame rate and provide new images together/
- * synchronized. So the Callback is only called when all sensors have a
- * new image.
+ * synchronized. So the Callback is usually only called when all sensors
+ * have a new image (see FrameAssembler for partial frames).
  */
 
 class Streamer {
@@ -27,10 +29,22 @@ protected:
     std::function<void(std::vector<std::shared_ptr<OrganizedPointCloud>>)> callback;
 
 public:
-    // Config for buffered loader, should be placed in AzureKinectMKVStreamer:
-    static int BufferedMaxFrameCount;
-    // Config for buffered loader, should be placed in AzureKinectMKVStreamer:
-    static int BufferedStartFrameOffset;
+    // Config for buffered loader (RAM for the frames around the playhead of all
+    // cameras in MB), should be placed in AzureKinectMKVStreamer:
+    static int BufferedCacheBudgetMB;
+
+    // Config for both CWIPC-SXR modes (only the depth images are decoded, the
+    // point clouds have no colors):
+    static bool MKVDepthOnly;
+
+    // Config for the synthetic streamer (number of virtual cameras):
+    static int SyntheticCameraCount;
+
+    // Config for the network receiver (TCP port to listen on):
+    static int NetworkPort;
+
+    // Config for the shared memory receiver (name of the ring):
+    static std::string SharedMemoryName;
 
     /** Registers a callback for new images */
     void setCallback(std::function<void(std::vector<std::shared_ptr<OrganizedPointCloud>>)> cb){
@@ -53,11 +67,25 @@ public:
      */
     static std::shared_ptr<Streamer> constructStreamerInstance(int type, std::string path = "");
 
+    /**
+     * Returns whether the streamer of the given type requires a path (so a
+     * file has to be selected before it can be constructed).
+     */
+    static bool requiresPath(int type);
+
     /**
      * Returns the CPU processing time in milliseconds per read frame of
      * sensor 0).
      */
     virtual float getProcessingTime() = 0;
+
+    /**
+     * Returns the CPU processing time in milliseconds per read frame of
+     * every sensor (empty if not available).
+     */
+    virtual std::vector<float> getCameraProcessingTimes(){
+        return {};
+    }
 };
 
 /**
@@ -91,6 +119,28 @@ public:
      */
     bool allowFrameSkipping = false;
 
+    /**
+     * Playback rate (1 = realtime, 0.5 = half speed, ...).
+     */
+    float playbackRate = 1.f;
+
+    /** Starts or pauses the playback */
+    void setPlaying(bool playing){
+        isPlaying = playing;
+        onPlaybackChanged();
+    }
+
+    /** Jumps to the given time (in seconds) */
+    void seek(float time){
+        currentTime = time;
+        onPlaybackChanged();
+    }
+
+    void setPlaybackRate(float rate){
+        playbackRate = rate;
+        onPlaybackChanged();
+    }
+
     /**
      * Steps a frame forward. If the parameter 'frameDelta' is given, it steps
      * the number of frames forward (or backward, when negative).
@@ -102,4 +152,24 @@ public:
      * master depth sensor (idx 0).
      */
     virtual float getTotalTime() = 0;
+
+    /** Schedules the frames of the reading thread (and measures the jitter) */
+    PlaybackClock& getPlaybackClock(){
+        return playbackClock;
+    }
+
+protected:
+    PlaybackClock playbackClock;
+
+    /** Set when the playback was changed, so the reading thread reschedules */
+    std::atomic<bool> playbackChanged{false};
+
+    /**
+     * Called after the playback was changed from outside of the reading thread
+     * (play / pause, seek, step, rate). Wakes up the reading thread.
+     */
+    void onPlaybackChanged(){
+        playbackChanged = true;
+        playbackClock.notify();
+    }
 };
@@ -0,0 +1,342 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <cmath>
+
+#include <chrono>
+using namespace std::chrono;
+
+#include "src/pcstreamer/Streamer.h"
+#include "src/pcstreamer/synthetic/SyntheticScene.h"
+#include "src/util/BufferPool.h"
+
+// Nominal frame rate of the generated sequence (independent of the output rate):
+#define SYNTHETIC_FRAME_RATE 30.f
+
+// Resolution of the 3D-to-image lookup table (same as for the Azure Kinect):
+#define SYNTHETIC_LOOKUP_TABLE_SIZE 1024
+
+/**
+ * Configuration of the virtual cameras of the SyntheticStreamer.
+ */
+struct SyntheticCameraConfig {
+    unsigned int cameraCount = 7;
+
+    /** Resolution of the depth & color images */
+    unsigned int width = 640;
+    unsigned int height = 576;
+
+    /** Horizontal field of view in degrees (square pixels) */
+    float fieldOfView = 75.f;
+
+    /** The cameras are placed on a circle with this radius around the scene */
+    float distance = 2.5f;
+
+    /** Height of the cameras above the floor */
+    float elevation = 1.4f;
+
+    /** Amplitude of the (deterministic) depth noise in millimeters */
+    float depthNoise = 2.f;
+};
+
+/**
+ * Procedurally generates organized depth & color images of an animated scene
+ * (see SyntheticScene) for a configurable number of virtual cameras. It
+ * requires neither a sensor nor a dataset, so it can be used as reproducible
+ * load source for benchmarking the filters and renderers.
+ *
+ * The cameras are pinhole cameras evenly distributed on a circle around the
+ * scene. The time of the generated sequence advances by 1 / SYNTHETIC_FRAME_RATE
+ * per frame, so every run generates the same frames, regardless of the output
+ * rate (see frameRate).
+ */
+class SyntheticStreamer : public FileStreamer {
+    struct Camera {
+        Mat4f modelMatrix;
+
+        /** Position and axes (camera space to world space) */
+        float position[3];
+        float axes[3][3];
+
+        std::vector<float> lookupImageTo3D;
+        std::vector<float> lookup3DToImage;
+    };
+
+    SyntheticCameraConfig config;
+    std::vector<Camera> cameras;
+    SyntheticScene scene;
+
+    std::shared_ptr<BufferPool> bufferPool = std::make_shared<BufferPool>();
+
+    std::thread generatingThread;
+    std::atomic<bool> shouldStop{false};
+
+    float processingTime = 0.f;
+    std::vector<float> cameraProcessingTimes;
+    float lastTimeWhileStopped = -1.f;
+    float outputFrameRate = 0.f;
+
+    /**
+     * Places the cameras and creates their lookup tables.
+     */
+    void createCameras(){
+        float fx = (config.width * 0.5f) / std::tan(config.fieldOfView * 0.5f * float(M_PI) / 180.f);
+        float cx = config.width * 0.5f;
+        float cy = config.height * 0.5f;
+
+        cameras = std::vector<Camera>(config.cameraCount);
+
+        for(unsigned int i = 0; i < config.cameraCount; ++i){
+            Camera& camera = cameras[i];
+
+            float angle = 2.f * float(M_PI) * i / config.cameraCount;
+            Vec4f position(config.distance * std::cos(angle), config.elevation, config.distance * std::sin(angle), 1.f);
+            Vec4f target(0.f, 0.8f, 0.f, 1.f);
+
+            // Camera space of the Azure Kinect: x right, y down, z forward:
+            Vec4f forward = (target - position).normalized();
+            Vec4f right = forward.cross(Vec4f(0.f, 1.f, 0.f, 0.f)).normalized();
+            Vec4f down = forward.cross(right).normalized();
+
+            camera.modelMatrix = Mat4f(right, down, forward, position);
+            const Vec4f* vectors[3] = {&right, &down, &forward};
+            for(int i = 0; i < 3; ++i){
+                camera.axes[i][0] = vectors[i]->x;
+                camera.axes[i][1] = vectors[i]->y;
+                camera.axes[i][2] = vectors[i]->z;
+            }
+            camera.position[0] = position.x;
+            camera.position[1] = position.y;
+            camera.position[2] = position.z;
+
+            // Ray (x/z, y/z) per pixel:
+            camera.lookupImageTo3D = std::vector<float>(size_t(config.width) * config.height * 2);
+            for(unsigned int y = 0, idx = 0; y < config.height; ++y){
+                for(unsigned int x = 0; x < config.width; ++x, ++idx){
+                    camera.lookupImageTo3D[idx * 2] = (x - cx) / fx;
+                    camera.lookupImageTo3D[idx * 2 + 1] = (y - cy) / fx;
+                }
+            }
+
+            // Relative image position per (x/z, y/z) in [-1, 1]:
+            camera.lookup3DToImage = std::vector<float>(SYNTHETIC_LOOKUP_TABLE_SIZE * SYNTHETIC_LOOKUP_TABLE_SIZE * 2);
+            for(unsigned int y = 0; y < SYNTHETIC_LOOKUP_TABLE_SIZE; ++y){
+                for(unsigned int x = 0; x < SYNTHETIC_LOOKUP_TABLE_SIZE; ++x){
+                    float relImgX = (((x / float(SYNTHETIC_LOOKUP_TABLE_SIZE)) * 2 - 1) * fx + cx) / config.width;
+                    float relImgY = (((y / float(SYNTHETIC_LOOKUP_TABLE_SIZE)) * 2 - 1) * fx + cy) / config.height;
+
+                    bool valid = relImgX >= 0 && relImgX <= 1 && relImgY >= 0 && relImgY <= 1;
+                    camera.lookup3DToImage[(x + y * SYNTHETIC_LOOKUP_TABLE_SIZE) * 2] = valid ? relImgX : -1;
+                    camera.lookup3DToImage[(x + y * SYNTHETIC_LOOKUP_TABLE_SIZE) * 2 + 1] = valid ? relImgY : -1;
+                }
+            }
+        }
+    }
+
+    /**
+     * Deterministic noise in [-1, 1] per pixel, camera and frame.
+     */
+    static float noise(uint32_t x, uint32_t y, uint32_t cameraID, uint32_t frameID){
+        uint32_t h = x * 73856093u ^ y * 19349663u ^ cameraID * 83492791u ^ frameID * 2654435761u;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return (h & 0xffffff) / float(0x7fffff) - 1.f;
+    }
+
+    /**
+     * Raycasts the image of the given camera (parallelized over the rows).
+     */
+    std::shared_ptr<OrganizedPointCloud> generatePointCloud(unsigned int cameraID, int frameID){
+        Camera& camera = cameras[cameraID];
+        const unsigned int width = config.width;
+        const unsigned int height = config.height;
+
+        std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
+        pc->bufferPool = bufferPool;
+        pc->depth = bufferPool->acquire<uint16_t>(size_t(width) * height);
+        pc->colors = bufferPool->acquire<Vec4b>(size_t(width) * height);
+        pc->modelMatrix = camera.modelMatrix;
+        pc->lookupImageTo3D = camera.lookupImageTo3D.data();
+        pc->lookup3DToImage = camera.lookup3DToImage.data();
+        pc->lookup3DToImageSize = SYNTHETIC_LOOKUP_TABLE_SIZE;
+        pc->frameID = frameID;
+        pc->timestamp = frameID / SYNTHETIC_FRAME_RATE;
+
+        #pragma omp parallel for
+        for(int y = 0; y < int(height); ++y){
+            for(unsigned int x = 0; x < width; ++x){
+                unsigned int idx = y * width + x;
+                float rx = camera.lookupImageTo3D[idx * 2];
+                float ry = camera.lookupImageTo3D[idx * 2 + 1];
+
+                // Ray (rx, ry, 1) in world space, so t is the depth in meters:
+                float d[3];
+                for(int axis = 0; axis < 3; ++axis)
+                    d[axis] = camera.axes[0][axis] * rx + camera.axes[1][axis] * ry + camera.axes[2][axis];
+
+                float t;
+                Vec4b color;
+                if(scene.raycast(camera.position, d, t, color)){
+                    float depth = t * 1000.f + noise(x, y, cameraID, frameID) * config.depthNoise;
+                    pc->depth[idx] = depth > 0.f && depth < 65535.f ? uint16_t(depth) : 0;
+                    pc->colors[idx] = color;
+                } else {
+                    pc->depth[idx] = 0;
+                    pc->colors[idx] = Vec4b(0, 0, 0, 255);
+                }
+            }
+        }
+
+        return pc;
+    }
+
+    std::vector<std::shared_ptr<OrganizedPointCloud>> generatePointClouds(float time){
+        int frameID = int(std::round(time * SYNTHETIC_FRAME_RATE));
+        scene.update(frameID / SYNTHETIC_FRAME_RATE);
+
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds(cameras.size());
+        for(unsigned int i = 0; i < cameras.size(); ++i){
+            auto startTime = high_resolution_clock::now();
+            pointClouds[i] = generatePointCloud(i, frameID);
+            cameraProcessingTimes[i] = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + cameraProcessingTimes[i] * 0.9f;
+        }
+
+        return pointClouds;
+    }
+
+public:
+    /**
+     * Rate in which frames are delivered to the callback (frames per second).
+     * If 0, frames are generated as fast as possible.
+     */
+    std::atomic<float> frameRate{SYNTHETIC_FRAME_RATE};
+
+    SyntheticStreamer(SyntheticCameraConfig cameraConfig = SyntheticCameraConfig())
+        : config(cameraConfig)
+    {
+        createCameras();
+        cameraProcessingTimes = std::vector<float>(cameras.size(), 0.f);
+
+        // Two frames in flight (renderer & filter) plus the one being generated:
+        bufferPool->reserve(size_t(config.width) * config.height * sizeof(uint16_t), 3 * config.cameraCount);
+        bufferPool->reserve(size_t(config.width) * config.height * sizeof(Vec4b), 3 * config.cameraCount);
+
+        generatingThread = std::thread([this](){
+            auto nextFrameTime = high_resolution_clock::now();
+            auto lastFrameTime = nextFrameTime;
+
+            while(!shouldStop){
+                if(!isPlaying){
+                    std::this_thread::sleep_for(50ms);
+
+                    // If currentTime was changed manually, update the point cloud even when paused:
+                    if(lastTimeWhileStopped != currentTime){
+                        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = generatePointClouds(currentTime);
+
+                        if(callback)
+                            callback(pointClouds);
+
+                        lastTimeWhileStopped = currentTime;
+                    }
+
+                    nextFrameTime = high_resolution_clock::now();
+                    continue;
+                }
+
+                auto startTime = high_resolution_clock::now();
+
+                std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = generatePointClouds(currentTime);
+
+                processingTime = (duration_cast<microseconds>(high_resolution_clock::now() - startTime).count()*0.001f) * 0.1f + processingTime * 0.9f;
+
+                if(callback)
+                    callback(pointClouds);
+
+                currentTime += 1.f / SYNTHETIC_FRAME_RATE;
+                if(currentTime + 0.5f / SYNTHETIC_FRAME_RATE >= getTotalTime()){
+                    currentTime = 0;
+
+                    if(!loop)
+                        isPlaying = false;
+                }
+                lastTimeWhileStopped = currentTime;
+
+                auto now = high_resolution_clock::now();
+                float frameDuration = duration_cast<microseconds>(now - lastFrameTime).count() * 0.000001f;
+                if(frameDuration > 0.f)
+                    outputFrameRate = (1.f / frameDuration) * 0.1f + outputFrameRate * 0.9f;
+                lastFrameTime = now;
+
+                // Wait until the next frame is due:
+                float rate = frameRate;
+                if(rate > 0.f){
+                    nextFrameTime += microseconds(int64_t(1000000.f / rate));
+                    if(nextFrameTime < now)
+                        nextFrameTime = now;
+                    std::this_thread::sleep_until(nextFrameTime);
+                } else {
+                    nextFrameTime = now;
+                }
+            }
+        });
+    }
+
+    /**
+     * Join and destroy generating thread on deconstruction.
+     */
+    ~SyntheticStreamer(){
+        shouldStop = true;
+        if(generatingThread.joinable())
+            generatingThread.join();
+    }
+
+    /**
+     * Steps a frame forward. If the parameter 'frameDelta' is given, it steps
+     * the number of frames forward (or backward, when negative).
+     */
+    virtual void step(int frameDelta = 1) override {
+        float newTime = currentTime + frameDelta / SYNTHETIC_FRAME_RATE;
+        if(newTime >= 0.f && newTime < getTotalTime())
+            currentTime = newTime;
+    };
+
+    /**
+     * Returns the duration of the animation (after which it repeats).
+     */
+    virtual float getTotalTime() override {
+        return SyntheticScene::PERIOD;
+    };
+
+    /**
+     * Returns the CPU processing time in milliseconds to generate the images
+     * of all cameras.
+     */
+    virtual float getProcessingTime() override {
+        return processingTime;
+    };
+
+    /**
+     * Returns the time in milliseconds to generate the images of each camera.
+     */
+    virtual std::vector<float> getCameraProcessingTimes() override {
+        return cameraProcessingTimes;
+    };
+
+    /**
+     * Returns the number of frames per second actually delivered to the
+     * callback.
+     */
+    float getOutputFrameRate(){
+        return outputFrameRate;
+    }
+
+    const SyntheticCameraConfig& getConfig(){
+        return config;
+    }
+};
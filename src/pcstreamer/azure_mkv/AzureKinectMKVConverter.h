@@ -0,0 +1,101 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <cstring>
+
+#include "src/pcstreamer/azure_mkv/AzureKinectMKVStream.h"
+#include "src/pcstreamer/azure_mkv/CWIPCCameraConfig.h"
+#include "src/pcstreamer/opc_recording/OPCRecordingWriter.h"
+
+/**
+ * Converts a CWIPC-SXR scene ('cameraconfig.json' + .mkv recordings) into a
+ * native organized point cloud recording (*.opcr), which can be replayed by
+ * the OPCRecordingStreamer without decoding and without the Azure Kinect SDK.
+ */
+class AzureKinectMKVConverter {
+    static OPCRecordingCalibration convertCalibration(const k4a_calibration_t& calibration){
+        OPCRecordingCalibration result;
+        std::memset(&result, 0, sizeof(result));
+
+        const k4a_calibration_camera_t& depth = calibration.depth_camera_calibration;
+        const k4a_calibration_camera_t& color = calibration.color_camera_calibration;
+
+        std::memcpy(result.depthIntrinsics, depth.intrinsics.parameters.v, sizeof(result.depthIntrinsics));
+        result.depthWidth = depth.resolution_width;
+        result.depthHeight = depth.resolution_height;
+
+        std::memcpy(result.colorIntrinsics, color.intrinsics.parameters.v, sizeof(result.colorIntrinsics));
+        result.colorWidth = color.resolution_width;
+        result.colorHeight = color.resolution_height;
+
+        const k4a_calibration_extrinsics_t& extrinsics = calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_COLOR];
+        std::memcpy(result.depthToColorRotation, extrinsics.rotation, sizeof(result.depthToColorRotation));
+        std::memcpy(result.depthToColorTranslation, extrinsics.translation, sizeof(result.depthToColorTranslation));
+
+        return result;
+    }
+
+public:
+    /**
+     * Converts the scene described by the given 'cameraconfig.json' into the given
+     * output file. Returns false on failure.
+     */
+    static bool convert(std::string cameraConfigPath, std::string outputPath){
+        std::vector<CWIPCCamera> cameras = loadCWIPCCameraConfig(cameraConfigPath);
+        if(cameras.empty()){
+            std::cerr << "No cameras found in " << cameraConfigPath << std::endl;
+            return false;
+        }
+
+        bool useColorIndices = false;
+
+        std::vector<std::shared_ptr<AzureKinectMKVStream>> streams(cameras.size());
+        for(unsigned int i = 0; i < cameras.size(); ++i){
+            streams[i] = std::make_shared<AzureKinectMKVStream>(cameras[i].recordingPath, cameras[i].transformation, useColorIndices, false, 0);
+        }
+
+        #pragma omp parallel for
+        for(int i = 0; i < int(streams.size()); ++i){
+            streams[i]->init();
+        }
+
+        std::unique_ptr<OPCRecordingWriter> writer;
+
+        for(unsigned int cameraID = 0; cameraID < streams.size(); ++cameraID){
+            std::shared_ptr<AzureKinectMKVStream> stream = streams[cameraID];
+            stream->rewind();
+
+            unsigned int frameCount = 0;
+            double timestamp = 0.0;
+
+            while(std::shared_ptr<OrganizedPointCloud> pc = stream->readNextPointCloud(timestamp)){
+                // The first point cloud defines the resolution of the recording:
+                if(writer == nullptr){
+                    writer = std::make_unique<OPCRecordingWriter>(outputPath, (unsigned int) streams.size(), pc->width, pc->height, pc->lookup3DToImageSize);
+                    if(!writer->isValid())
+                        return false;
+                }
+
+                if(frameCount == 0)
+                    writer->setCamera(cameraID, pc->modelMatrix, convertCalibration(stream->getCalibration()), pc->lookupImageTo3D, pc->lookup3DToImage);
+
+                writer->addFrame(cameraID, timestamp, pc->depth, pc->colors);
+                ++frameCount;
+
+                if(frameCount % 100 == 0)
+                    std::cout << "Camera " << cameraID << ": converted " << frameCount << " / " << stream->getTotalFrameCount() << " frames" << std::endl;
+            }
+
+            std::cout << "Camera " << cameraID << ": converted " << frameCount << " frames" << std::endl;
+        }
+
+        if(writer == nullptr){
+            std::cerr << "No frames could be read from the recordings." << std::endl;
+            return false;
+        }
+
+        writer->finish();
+        return true;
+    }
+};
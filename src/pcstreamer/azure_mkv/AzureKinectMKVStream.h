@@ -5,6 +5,22 @@
 
 #include "src/util/math/Mat4.h"
 #include "src/util/OrganizedPointCloud.h"
+#include "src/pcstreamer/FrameAssembler.h"
+#include "src/pcstreamer/azure_mkv/MKVRecordingIndex.h"
+#include "src/pcstreamer/azure_mkv/CompressedFrameCache.h"
+#include "src/pcstreamer/azure_mkv/DepthColorRegistration.h"
+#include "src/pcstreamer/azure_mkv/CalibrationLookupCache.h"
+#include "src/util/codec/RVLCodec.h"
+#include "src/util/codec/JPEGDecoder.h"
+
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <set>
+#include <atomic>
+#include <chrono>
 
 #include <k4a/k4a.h>
 #include <k4arecord/playback.h>
@@ -14,15 +30,35 @@
 
 #define LOOKUP_TABLE_SIZE 1024
 
+/** Number of point clouds per camera which are alive at the same time in streamed mode (without prefetching) */
+#define POOLED_POINT_CLOUDS 6
+
+/** Number of threads per camera which decode the compressed frames in buffered mode */
+#define BUFFERED_DECODE_THREADS 2
+
+/** Frames behind the playhead which are never evicted from the frame cache */
+#define CACHE_FRAMES_BEHIND_PLAYHEAD 2
+
+/**
+ * MJPEG color images are decoded at 1 / COLOR_DECODE_SCALE of their resolution, if
+ * the high resolution texture isn't used (half of 2048x1536 has about the angular
+ * resolution of the 640x576 depth images).
+ */
+#define COLOR_DECODE_SCALE 2
+
+
 /**
  * A streamer when using a single or multiple Azure Kinect devices:
  */
 
 class AzureKinectMKVStream {
+    std::string recordingPath;
     std::vector<double> allTimestamps;
 
     uint64_t totalFrameCount = 0;
-    int currentFrame = 0;
+
+    /** Frame of the playhead (read by the streamer and the GUI thread) */
+    std::atomic<int> currentFrame{0};
 
     Mat4f transformation;
     Mat4f depthToColorTransform;
@@ -41,18 +77,94 @@ class AzureKinectMKVStream {
     int height = 1536;
     k4a_image_t colorIndexImage = nullptr;
 
+    /** Registers the color images to the depth images (instead of the k4a transformation) */
+    std::unique_ptr<DepthColorRegistration> registration;
+
     bool& useColorIndices;
 
     bool useBuffer;
-    int bufferedMaxFrameCount;
-    int bufferedStartFrameOffset;
+    size_t cacheBudgetBytes;
+
+    /**
+     * If set, the color images are neither decoded nor registered, so the colors
+     * of the point clouds are nullptr (see AzureKinectMKVStreamer).
+     */
+    bool depthOnly;
+
+    /**
+     * Compressed frames of the buffered mode around the playhead, which are loaded by
+     * the loader thread (using its own playback handle):
+     */
+    std::unique_ptr<CompressedFrameCache> frameCache;
+
+    std::thread loaderThread;
+    k4a_playback_t loader_playback_handle = nullptr;
+    std::mutex loaderMutex;
+    std::condition_variable loaderCondition;
+    bool stopLoading = false;
+
+    /** Frame at the playhead, around which the frames are loaded */
+    std::atomic<int> playheadFrame{0};
+
+    /** Protects the main playback handle, when frames which are not cached are loaded directly */
+    std::mutex playbackMutex;
+
+    /** Sizes of all frames loaded so far (to report the compression ratio) */
+    std::atomic<size_t> loadedCompressedBytes{0};
+    std::atomic<size_t> loadedUncompressedBytes{0};
+
+    /** Time in ms to decode a frame of the buffered mode */
+    std::atomic<float> decodeTime{0.f};
+
+    /** Recycles the image buffers of the generated point clouds */
+    std::shared_ptr<BufferPool> bufferPool = std::make_shared<BufferPool>();
+
+    /**
+     * A thread which decodes frames ahead of the playhead. In streamed mode, it uses
+     * its own playback handle, since the k4a handles are not thread-safe. Each thread
+     * has its own transformation handle.
+     */
+    struct PrefetchWorker {
+        std::thread thread;
+        k4a_playback_t playback_handle = nullptr;
+        k4a_transformation_t transformation_handle = nullptr;
+    };
+
+    std::vector<std::unique_ptr<PrefetchWorker>> prefetchWorkers;
+    std::mutex prefetchMutex;
+    std::condition_variable prefetchCondition;
+
+    /** Decoded frames ahead of the playhead (frame index -> point cloud) */
+    std::map<int, std::shared_ptr<OrganizedPointCloud>> prefetchRing;
+
+    /** Frames which are currently decoded by the prefetch workers */
+    std::set<int> prefetchInFlightFrames;
 
-    std::vector<std::shared_ptr<OrganizedPointCloud>> preloadedBuffer;
+    /** Next frame which should be decoded by a prefetch worker */
+    int prefetchNextFrame = 0;
 
-    void createColorIndexImage(){
-        k4a_image_create(K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4, &colorIndexImage);
-        uint8_t* buffer = k4a_image_get_buffer(colorIndexImage);
+    /** Incremented on invalidation, so frames decoded for an old playhead are discarded */
+    unsigned long long prefetchGeneration = 0;
 
+    int prefetchDepth = 0;
+    bool stopPrefetching = false;
+
+    /** Set once the prefetch workers are started (setPrefetchDepth is called from the GUI thread) */
+    std::atomic<bool> prefetchRunning{false};
+
+    /** Last frame returned by syncImage (may be requested repeatedly, the point cloud is guarded by prefetchMutex) */
+    std::atomic<int> lastServedFrame{-1};
+    std::shared_ptr<OrganizedPointCloud> lastServedPointCloud;
+
+    std::atomic<unsigned long long> prefetchHits{0};
+    std::atomic<unsigned long long> prefetchMisses{0};
+
+    static k4a_image_t createColorIndexImage(int width, int height){
+        k4a_image_t image = nullptr;
+        k4a_image_create(K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4, &image);
+        uint8_t* buffer = k4a_image_get_buffer(image);
+
+        #pragma omp parallel for
         for (int y = 0; y < height; y++) {
             for (int x = 0; x < width; x++) {
                 int index = (y * width + x) * 4;
@@ -73,15 +185,35 @@ class AzureKinectMKVStream {
                 buffer[index + 3] = (b >> 8) & 0xFF;
             }
         }
+
+        return image;
+    }
+
+    /**
+     * Returns the color index image, which is the same for all cameras, so it is
+     * created only once per process and shared by all streams. The caller owns a
+     * reference (released by k4a_image_release).
+     */
+    k4a_image_t acquireColorIndexImage(){
+        static std::mutex sharedMutex;
+        static k4a_image_t sharedImage = nullptr;
+
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        if(sharedImage == nullptr)
+            sharedImage = createColorIndexImage(width, height);
+
+        k4a_image_reference(sharedImage);
+        return sharedImage;
     }
 
 public:
-    AzureKinectMKVStream(std::string filepath, Mat4f transformation, bool& useColorIndices, bool useBuffer, int maxFrameCount, int startFrameOffset)
-        : transformation(transformation)
+    AzureKinectMKVStream(std::string filepath, Mat4f transformation, bool& useColorIndices, bool useBuffer, size_t cacheBudgetBytes, bool depthOnly = false)
+        : recordingPath(filepath)
+        , transformation(transformation)
         , useColorIndices(useColorIndices)
         , useBuffer(useBuffer)
-        , bufferedMaxFrameCount(maxFrameCount)
-        , bufferedStartFrameOffset(startFrameOffset)
+        , cacheBudgetBytes(cacheBudgetBytes)
+        , depthOnly(depthOnly)
     {
         if (k4a_playback_open(filepath.c_str(), &playback_handle) != K4A_RESULT_SUCCEEDED)
         {
@@ -104,13 +236,94 @@ public:
         }
     }
 
+    /**
+     * Walks through all captures of the recording and collects the device timestamps
+     * of the depth images. Color conversion must not be enabled yet, otherwise every
+     * MJPEG frame would be decoded.
+     */
+    std::vector<uint64_t> scanTimestamps(){
+        std::vector<uint64_t> timestampsUsec;
+        k4a_capture_t capture = NULL;
+
+        while (k4a_playback_get_next_capture(playback_handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED)
+        {
+            k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+            if (depth_image != NULL) {
+                timestampsUsec.push_back(k4a_image_get_device_timestamp_usec(depth_image));
+                k4a_image_release(depth_image);
+            }
+
+            k4a_capture_release(capture);
+        }
+
+        return timestampsUsec;
+    }
+
+    /**
+     * Returns whether the playback converts the color images to BGRA. Else, MJPEG
+     * frames are decoded by the stream (see getColorDecodeScale): in buffered mode,
+     * where they are kept compressed, and in streamed mode if libjpeg is available.
+     * In depth-only mode, the color images are never converted.
+     */
+    bool usesColorConversion(){
+        if(depthOnly)
+            return false;
+
+        return record_config.color_format != K4A_IMAGE_FORMAT_COLOR_MJPG || (!useBuffer && !isReducedJPEGDecodingFast());
+    }
+
+    /**
+     * Returns the factor by which MJPEG frames are downscaled while decoding. The
+     * full resolution is only required for the high resolution texture (or if the
+     * k4a transformation has to be used).
+     */
+    int getColorDecodeScale(){
+        if(useColorIndices || !registration->isValid())
+            return 1;
+
+        return COLOR_DECODE_SCALE;
+    }
+
+    /**
+     * Preallocates the buffers for the given number of point clouds which are alive
+     * at the same time, so that streaming doesn't require allocations.
+     */
+    void reservePointCloudBuffers(unsigned int count){
+        size_t pixelCount = size_t(calibration.depth_camera_calibration.resolution_width) * calibration.depth_camera_calibration.resolution_height;
+        bufferPool->reserve(pixelCount * sizeof(uint16_t), count);
+
+        if(depthOnly)
+            return;
+
+        bufferPool->reserve(pixelCount * sizeof(Vec4b), count);
+
+        if(useColorIndices)
+            bufferPool->reserve(size_t(width) * height * sizeof(Vec4b), count);
+    }
+
     void init(){
-        // Set automatic color conversion when loading the recordings:
-        k4a_playback_set_color_conversion(playback_handle, K4A_IMAGE_FORMAT_COLOR_BGRA32);
+        // Load the frame index of the recording or create it, if it does not exist:
+        uint64_t recordingHash = hashFileFingerprint(recordingPath);
+
+        MKVRecordingIndex index;
+        if(!index.load(recordingPath, recordingHash)){
+            index.timestampsUsec = scanTimestamps();
+            if(recordingHash != 0 && !index.timestampsUsec.empty())
+                index.save(recordingPath, recordingHash);
+        }
+
+        // Set automatic color conversion when loading the recordings, if the MJPEG
+        // frames aren't decoded by the stream itself:
+        if(usesColorConversion())
+            k4a_playback_set_color_conversion(playback_handle, K4A_IMAGE_FORMAT_COLOR_BGRA32);
 
         // Ensure look up tables are available:
         createLookupTables();
-        createColorIndexImage();
+
+        if(!depthOnly){
+            colorIndexImage = acquireColorIndexImage();
+            registration = std::make_unique<DepthColorRegistration>(calibration, DFToCS);
+        }
 
         // Get depth to color transform:
         {
@@ -129,60 +342,76 @@ public:
         transformation_handle = k4a_transformation_create(&calibration);
 
         std::vector<double> timestamps;
-        k4a_capture_t capture = NULL;
+        for(uint64_t timestamp_usec : index.timestampsUsec)
+            timestamps.push_back(timestamp_usec / 1000000.0);
 
-        int counter = -1;
-        while (k4a_playback_get_next_capture(playback_handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED)
-        {
-            ++counter;
-            if(useBuffer && counter < bufferedStartFrameOffset){
-                k4a_capture_release(capture);
-                continue;
-            }
+        // Point clouds which are alive at the same time (last served one, streamer,
+        // filter & render thread):
+        reservePointCloudBuffers(POOLED_POINT_CLOUDS);
+
+        allTimestamps = timestamps;
+        totalFrameCount = timestamps.size();
 
+        if(totalFrameCount == 0){
+            std::cerr << "No frames found in recording: " << recordingPath << std::endl;
+            return;
+        }
 
-            k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
-            if (depth_image != NULL) {
-                // Erhalte den Timestamp des Tiefenbildes
-                uint64_t timestamp_usec = k4a_image_get_device_timestamp_usec(depth_image);
+        std::cout << "Total Frame Count: " << totalFrameCount << " | Start TS: " << allTimestamps[0] << std::endl;
 
-                timestamps.push_back(timestamp_usec / 1000000.0);
+        successfullyOpened = true;
 
-                // If the buffer should be used, already generate the point cloud:
-                if(useBuffer){
-                    preloadedBuffer.push_back(generatePointCloudFromCapture(capture));
+        // If the buffer should be used, start loading the frames around the playhead:
+        if(useBuffer){
+            frameCache = std::make_unique<CompressedFrameCache>(cacheBudgetBytes);
 
-                    if(preloadedBuffer.size() >= bufferedMaxFrameCount){
-                        break;
-                    }
-                } else {
-                    k4a_image_release(depth_image);
-                }
+            if (k4a_playback_open(recordingPath.c_str(), &loader_playback_handle) == K4A_RESULT_SUCCEEDED)
+            {
+                if(!depthOnly && record_config.color_format != K4A_IMAGE_FORMAT_COLOR_MJPG)
+                    k4a_playback_set_color_conversion(loader_playback_handle, K4A_IMAGE_FORMAT_COLOR_BGRA32);
+
+                loaderThread = std::thread(&AzureKinectMKVStream::loaderLoop, this);
             } else {
-                //std::cerr << "No depth image available in this capture." << std::endl;
+                std::cerr << "Failed to open recording for loading\n";
             }
-
-            k4a_capture_release(capture);
         }
 
-        allTimestamps = timestamps;
-        totalFrameCount = timestamps.size();
-
-        std::cout << "Total Frame Count: " << totalFrameCount << " | Start TS: " << allTimestamps[0] << std::endl;
-
         k4a_result_t seek_result = k4a_playback_seek_timestamp(playback_handle, 0, K4A_PLAYBACK_SEEK_BEGIN);
         if (seek_result != K4A_RESULT_SUCCEEDED)
         {
             std::cerr << "Failed to seek to beginning of the recording\n";
         }
-
-        successfullyOpened = true;
     }
 
     ~AzureKinectMKVStream(){
+        if(loaderThread.joinable()){
+            {
+                std::lock_guard<std::mutex> lock(loaderMutex);
+                stopLoading = true;
+            }
+            loaderCondition.notify_all();
+            loaderThread.join();
+            k4a_playback_close(loader_playback_handle);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex);
+            stopPrefetching = true;
+        }
+        prefetchCondition.notify_all();
+
+        for(std::unique_ptr<PrefetchWorker>& worker : prefetchWorkers){
+            worker->thread.join();
+
+            k4a_transformation_destroy(worker->transformation_handle);
+            if(worker->playback_handle != nullptr)
+                k4a_playback_close(worker->playback_handle);
+        }
+
         k4a_transformation_destroy(transformation_handle);
         k4a_playback_close(playback_handle);
-        k4a_image_release(colorIndexImage);
+        if(colorIndexImage != nullptr)
+            k4a_image_release(colorIndexImage);
 
         delete[] DFToCS;
         delete[] lookupTable3DToImage;
@@ -205,10 +434,11 @@ public:
     }
 
     double getTimeDeltaToNextFrame() {
-        if(currentFrame + 1 >= int(totalFrameCount))
+        int frame = currentFrame;
+        if(frame < 0 || frame + 1 >= int(totalFrameCount))
             return 0.f;
 
-        return allTimestamps[currentFrame + 1] - allTimestamps[currentFrame];
+        return allTimestamps[frame + 1] - allTimestamps[frame];
     }
 
     std::shared_ptr<OrganizedPointCloud> readImage(unsigned int frame){
@@ -222,11 +452,296 @@ public:
         return allTimestamps[frame];
     }
 
+    k4a_calibration_t& getCalibration(){
+        return calibration;
+    }
+
+    /**
+     * Seeks to the beginning of the recording, so that readNextPointCloud() reads
+     * the first frame next.
+     */
+    void rewind(){
+        k4a_playback_seek_timestamp(playback_handle, 0, K4A_PLAYBACK_SEEK_BEGIN);
+        currentFrame = -1;
+    }
+
+    /**
+     * Reads the next frame sequentially (without seeking), which is much faster than
+     * syncImage() when all frames are processed, e.g. for converting the recording.
+     * Returns nullptr at the end of the recording.
+     */
+    std::shared_ptr<OrganizedPointCloud> readNextPointCloud(double& timestamp){
+        k4a_capture_t capture = NULL;
+        while (k4a_playback_get_next_capture(playback_handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED)
+        {
+            k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+            if(depth_image == NULL){
+                k4a_capture_release(capture);
+                continue;
+            }
+
+            timestamp = k4a_image_get_device_timestamp_usec(depth_image) / 1000000.0;
+            k4a_image_release(depth_image);
+
+            int frameID = ++currentFrame;
+            std::shared_ptr<OrganizedPointCloud> pc = generatePointCloudFromCapture(capture, transformation_handle, frameID);
+            k4a_capture_release(capture);
+
+            if(pc != nullptr)
+                return pc;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Reads the given frame using the given handle and compresses it (see
+     * AzureKinectCompressedFrame). If 'seek' is false, the frame is expected to be
+     * the next capture of the playback handle. In depth-only mode, the color image
+     * is not kept.
+     */
+    std::shared_ptr<AzureKinectCompressedFrame> loadCompressedFrame(k4a_playback_t handle, RVLCodec& codec, int frameID, bool seek = true){
+        uint64_t timestampUsec = uint64_t(allTimestamps[frameID] * 1000000 + 0.5);
+
+        if(seek && k4a_playback_seek_timestamp(handle, timestampUsec, K4A_PLAYBACK_SEEK_BEGIN) != K4A_RESULT_SUCCEEDED)
+            return nullptr;
+
+        k4a_capture_t capture = NULL;
+        while (k4a_playback_get_next_capture(handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED)
+        {
+            k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+            k4a_image_t color_image = depthOnly ? NULL : k4a_capture_get_color_image(capture);
+
+            std::shared_ptr<AzureKinectCompressedFrame> frame;
+
+            // Seeking is not frame-accurate, so skip captures before the frame:
+            if(depth_image != NULL && (color_image != NULL || depthOnly) && k4a_image_get_device_timestamp_usec(depth_image) + 100 >= timestampUsec){
+                frame = std::make_shared<AzureKinectCompressedFrame>();
+
+                size_t pixelCount = size_t(k4a_image_get_width_pixels(depth_image)) * k4a_image_get_height_pixels(depth_image);
+                codec.compress((uint16_t*)(void*)k4a_image_get_buffer(depth_image), pixelCount, frame->depth);
+
+                if(color_image != NULL){
+                    uint8_t* colorData = k4a_image_get_buffer(color_image);
+                    frame->color.assign(colorData, colorData + k4a_image_get_size(color_image));
+                    frame->colorFormat = k4a_image_get_format(color_image);
+                    frame->colorWidth = k4a_image_get_width_pixels(color_image);
+                    frame->colorHeight = k4a_image_get_height_pixels(color_image);
+                }
+
+                loadedCompressedBytes += frame->size();
+                loadedUncompressedBytes += pixelCount * (sizeof(uint16_t) + (depthOnly ? 0 : sizeof(Vec4b)));
+            }
+
+            if(depth_image != NULL)
+                k4a_image_release(depth_image);
+            if(color_image != NULL)
+                k4a_image_release(color_image);
+            k4a_capture_release(capture);
+
+            if(frame != nullptr)
+                return frame;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Keeps the frames ahead of the playhead resident in the frame cache: walks from
+     * the playhead forward (wrapping around for looping) and loads the first missing
+     * frame until three quarters of the budget are used by this window. The frames of
+     * the window are protected from eviction.
+     */
+    void loaderLoop(){
+        RVLCodec codec;
+        int lastLoadedFrame = -2;
+        int frameCount = int(totalFrameCount);
+
+        while(true){
+            {
+                std::unique_lock<std::mutex> lock(loaderMutex);
+                if(stopLoading)
+                    return;
+            }
+
+            int playhead = playheadFrame;
+            size_t windowBudget = frameCache->getBudget() / 4 * 3;
+
+            int missingFrame = -1;
+            int windowLength = 0;
+            size_t windowBytes = 0;
+            for(; windowLength < frameCount && windowBytes <= windowBudget; ++windowLength){
+                int frame = (playhead + windowLength) % frameCount;
+                size_t size = frameCache->sizeOf(frame);
+                if(size == 0){
+                    missingFrame = frame;
+                    break;
+                }
+                windowBytes += size;
+            }
+
+            // Window is complete, wait until the playhead moves:
+            if(missingFrame < 0){
+                std::unique_lock<std::mutex> lock(loaderMutex);
+                loaderCondition.wait_for(lock, std::chrono::milliseconds(20), [&](){
+                    return stopLoading || playheadFrame != playhead;
+                });
+                continue;
+            }
+
+            // Consecutive frames are read without seeking:
+            std::shared_ptr<AzureKinectCompressedFrame> frame = loadCompressedFrame(loader_playback_handle, codec, missingFrame, missingFrame != lastLoadedFrame + 1);
+            lastLoadedFrame = frame != nullptr ? missingFrame : -2;
+
+            if(frame == nullptr){
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                continue;
+            }
+
+            auto isProtected = [playhead, windowLength, frameCount](int frameID){
+                int distance = (frameID - playhead + frameCount) % frameCount;
+                return distance <= windowLength || distance >= frameCount - CACHE_FRAMES_BEHIND_PLAYHEAD;
+            };
+
+            if(frameCache->makeRoom(frame->size(), isProtected)){
+                frameCache->put(missingFrame, frame);
+            } else {
+                // Budget is exhausted by the protected window:
+                std::unique_lock<std::mutex> lock(loaderMutex);
+                loaderCondition.wait_for(lock, std::chrono::milliseconds(20), [&](){
+                    return stopLoading || playheadFrame != playhead;
+                });
+            }
+        }
+    }
+
+    /**
+     * Decodes the color image of a frame of the buffered mode and registers it to
+     * the (already decoded) depth image of the given point cloud.
+     */
+    bool decodeCompressedColors(const AzureKinectCompressedFrame& frame, int frameID, k4a_transformation_t trafo_handle, OrganizedPointCloud& pc){
+        int width = pc.width;
+        int height = pc.height;
+
+        pc.colors = bufferPool->acquire<Vec4b>(width * height);
+
+        // Decode the colors (at full resolution only if they are used as high resolution texture):
+        int decodeScale = frame.colorFormat == K4A_IMAGE_FORMAT_COLOR_MJPG ? getColorDecodeScale() : 1;
+        int colorWidth = getScaledJPEGSize(frame.colorWidth, decodeScale);
+        int colorHeight = getScaledJPEGSize(frame.colorHeight, decodeScale);
+        size_t colorSize = size_t(colorWidth) * colorHeight * sizeof(Vec4b);
+        Vec4b* colors = bufferPool->acquire<Vec4b>(size_t(colorWidth) * colorHeight);
+
+        bool decoded;
+        if(frame.colorFormat == K4A_IMAGE_FORMAT_COLOR_MJPG){
+            decoded = decodeJPEGToBGRA(frame.color.data(), frame.color.size(), (uint8_t*) colors, frame.colorWidth, frame.colorHeight, decodeScale);
+        } else {
+            decoded = frame.color.size() == colorSize;
+            if(decoded)
+                std::memcpy(colors, frame.color.data(), colorSize);
+        }
+
+        if(!decoded){
+            std::cerr << "Corrupt color image in frame " << frameID << std::endl;
+            bufferPool->release(colors, colorSize);
+            return false;
+        }
+
+        k4a_image_t depth_image, color_image;
+        k4a_image_create_from_buffer(K4A_IMAGE_FORMAT_DEPTH16, width, height, width * sizeof(uint16_t), (uint8_t*) pc.depth, width * height * sizeof(uint16_t), nullptr, nullptr, &depth_image);
+        k4a_image_create_from_buffer(K4A_IMAGE_FORMAT_COLOR_BGRA32, colorWidth, colorHeight, colorWidth * 4, (uint8_t*) colors, colorSize, nullptr, nullptr, &color_image);
+
+        bool registered = registerColorImage(trafo_handle, depth_image, color_image, pc.colors);
+
+        k4a_image_release(depth_image);
+        k4a_image_release(color_image);
+
+        if(!registered){
+            std::cout << "A color image could not be transformed to the depth image." << std::endl;
+            bufferPool->release(colors, colorSize);
+            return false;
+        }
+
+        // Keep the decoded colors as high resolution texture (instead of copying them):
+        if(colorWidth == 2048 && colorHeight == 1536 && useColorIndices){
+            pc.highResColors = colors;
+            pc.highResWidth = frame.colorWidth;
+            pc.highResHeight = frame.colorHeight;
+        } else {
+            bufferPool->release(colors, colorSize);
+        }
+
+        return true;
+    }
+
+    /**
+     * Decodes a frame of the buffered mode and registers its colors to the depth
+     * image using the given transformation handle (unless in depth-only mode).
+     */
+    std::shared_ptr<OrganizedPointCloud> decodeCompressedFrame(int frameID, k4a_transformation_t trafo_handle){
+        if(frameID < 0 || frameID >= int(totalFrameCount))
+            return nullptr;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        // Load the frame directly, if it is not cached (e.g. right after seeking):
+        std::shared_ptr<const AzureKinectCompressedFrame> cachedFrame = frameCache->get(frameID);
+        if(cachedFrame == nullptr){
+            std::lock_guard<std::mutex> lock(playbackMutex);
+            RVLCodec codec;
+            cachedFrame = loadCompressedFrame(playback_handle, codec, frameID);
+            if(cachedFrame == nullptr)
+                return nullptr;
+        }
+
+        const AzureKinectCompressedFrame& frame = *cachedFrame;
+        int width = calibration.depth_camera_calibration.resolution_width;
+        int height = calibration.depth_camera_calibration.resolution_height;
+
+        std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
+        pc->bufferPool = bufferPool;
+        pc->depth = bufferPool->acquire<uint16_t>(width * height);
+
+        RVLCodec codec;
+        if(!codec.decompress(frame.depth.data(), frame.depth.size(), pc->depth, size_t(width) * height)){
+            std::cerr << "Corrupt depth image in frame " << frameID << std::endl;
+            return nullptr;
+        }
+
+        if(!depthOnly && !decodeCompressedColors(frame, frameID, trafo_handle, *pc))
+            return nullptr;
+
+        pc->modelMatrix = transformation * depthToColorTransform;
+        pc->lookupImageTo3D = DFToCS;
+        pc->lookup3DToImage = lookupTable3DToImage;
+        pc->lookup3DToImageSize = LOOKUP_TABLE_SIZE;
+        pc->frameID = frameID;
+
+        float duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count() * 0.001f;
+        float previousDecodeTime = decodeTime;
+        decodeTime = previousDecodeTime > 0.f ? duration * 0.1f + previousDecodeTime * 0.9f : duration;
+
+        return pc;
+    }
+
+    /**
+     * Creates the lookup tables of the calibration (3D -> depth image and depth
+     * image -> ray), which are loaded from the CalibrationLookupCache if possible.
+     */
     void createLookupTables(){
+        const int depthWidth = 640;
+        const int depthHeight = 576;
+
         lookupTable3DToImage = new float[LOOKUP_TABLE_SIZE * LOOKUP_TABLE_SIZE * 2];
+        DFToCS = new float[depthWidth * depthHeight * 2];
 
-        for(unsigned int y = 0; y < LOOKUP_TABLE_SIZE; ++y){
-            for(unsigned int x = 0; x < LOOKUP_TABLE_SIZE; ++x){
+        uint64_t calibrationHash = CalibrationLookupCache::hashCalibration(calibration);
+        if(CalibrationLookupCache::load(calibrationHash, LOOKUP_TABLE_SIZE, depthWidth, depthHeight, lookupTable3DToImage, DFToCS))
+            return;
+
+        #pragma omp parallel for
+        for(int y = 0; y < LOOKUP_TABLE_SIZE; ++y){
+            for(int x = 0; x < LOOKUP_TABLE_SIZE; ++x){
                 k4a_float3_t p;
                 k4a_float2_t img;
 
@@ -237,8 +752,8 @@ public:
                 int valid;
                 k4a_calibration_3d_to_2d(&calibration, &p, K4A_CALIBRATION_TYPE_DEPTH, K4A_CALIBRATION_TYPE_DEPTH, &img, &valid);
                 if (valid == 1) {
-                    float relImgX = img.xy.x / float(640);
-                    float relImgY = img.xy.y / float(576);
+                    float relImgX = img.xy.x / float(depthWidth);
+                    float relImgY = img.xy.y / float(depthHeight);
 
                     if(relImgX >= 0 && relImgX <= 1 && relImgY >= 0 && relImgY <= 1){
                         lookupTable3DToImage[(x + y * LOOKUP_TABLE_SIZE) * 2] = relImgX;
@@ -254,17 +769,16 @@ public:
             }
         }
 
-        k4a_float2_t p;
-        k4a_float3_t ray;
-
-        DFToCS = new float[640 * 576 * 2];
-
-        for (unsigned int y = 0, idx = 0; y < 576; y++)
+        #pragma omp parallel for
+        for (int y = 0; y < depthHeight; y++)
         {
+            k4a_float2_t p;
+            k4a_float3_t ray;
             p.xy.y = (float)y;
 
-            for (unsigned int x = 0; x < 640; x++, idx++)
+            for (int x = 0; x < depthWidth; x++)
             {
+                int idx = y * depthWidth + x;
                 p.xy.x = (float)x;
 
                 int valid;
@@ -279,99 +793,406 @@ public:
                 }
             }
         }
+
+        CalibrationLookupCache::save(calibrationHash, LOOKUP_TABLE_SIZE, depthWidth, depthHeight, lookupTable3DToImage, DFToCS);
     }
 
-    std::shared_ptr<OrganizedPointCloud> generatePointCloudFromCapture(k4a_capture_t& capture){
-        k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
-        k4a_image_t color_image = k4a_capture_get_color_image(capture);
+    /**
+     * Registers the given BGRA color image (or the color index image, if color
+     * indices are used) to the given depth image. Uses the CPU registration if
+     * possible, else the k4a transformation.
+     */
+    bool registerColorImage(k4a_transformation_t trafo_handle, k4a_image_t depth_image, k4a_image_t color_image, Vec4b* registeredColors){
+        k4a_image_t source_image = useColorIndices ? colorIndexImage : color_image;
+
+        int sourceWidth = k4a_image_get_width_pixels(source_image);
+        int sourceHeight = k4a_image_get_height_pixels(source_image);
+
+        if(registration->isValid() && k4a_image_get_stride_bytes(source_image) == sourceWidth * 4
+            && k4a_image_get_stride_bytes(depth_image) == k4a_image_get_width_pixels(depth_image) * int(sizeof(uint16_t))){
+            if(registration->registerColors((const uint16_t*) k4a_image_get_buffer(depth_image), (const Vec4b*) k4a_image_get_buffer(source_image), sourceWidth, sourceHeight, registeredColors, *bufferPool))
+                return true;
+        }
+
+        int width = k4a_image_get_width_pixels(depth_image);
+        int height = k4a_image_get_height_pixels(depth_image);
 
         k4a_image_t transformed_color_image;
+        k4a_image_create_from_buffer(K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4, (uint8_t*) registeredColors, width * height * sizeof(Vec4b), nullptr, nullptr, &transformed_color_image);
+        k4a_result_t result = k4a_transformation_color_image_to_depth_camera(trafo_handle, depth_image, source_image, transformed_color_image);
+        k4a_image_release(transformed_color_image);
+
+        return result == K4A_RESULT_SUCCEEDED;
+    }
+
+    /**
+     * Decodes the color image of a capture (if not converted by the playback) and
+     * registers it to the depth image into the colors of the given point cloud.
+     */
+    bool registerCaptureColors(k4a_image_t depth_image, k4a_image_t color_image, k4a_transformation_t trafo_handle, int frameID, OrganizedPointCloud& pc){
+        int highres_width = k4a_image_get_width_pixels(color_image);
+        int highres_height = k4a_image_get_height_pixels(color_image);
+
+        // Decode MJPEG frames (if not converted by the playback), at a reduced resolution
+        // if the high resolution texture isn't required:
+        k4a_image_t bgra_image = color_image;
+        Vec4b* decodedColors = nullptr;
+        size_t decodedSize = 0;
+        int decodeScale = 1;
+
+        if(k4a_image_get_format(color_image) == K4A_IMAGE_FORMAT_COLOR_MJPG){
+            decodeScale = getColorDecodeScale();
+            int decodedWidth = getScaledJPEGSize(highres_width, decodeScale);
+            int decodedHeight = getScaledJPEGSize(highres_height, decodeScale);
+            decodedSize = size_t(decodedWidth) * decodedHeight * sizeof(Vec4b);
+            decodedColors = (Vec4b*) bufferPool->acquire(decodedSize);
+
+            if(!decodeJPEGToBGRA(k4a_image_get_buffer(color_image), k4a_image_get_size(color_image), (uint8_t*) decodedColors, highres_width, highres_height, decodeScale)){
+                std::cerr << "Corrupt color image in frame " << frameID << std::endl;
+                bufferPool->release(decodedColors, decodedSize);
+                return false;
+            }
+
+            k4a_image_create_from_buffer(K4A_IMAGE_FORMAT_COLOR_BGRA32, decodedWidth, decodedHeight, decodedWidth * 4, (uint8_t*) decodedColors, decodedSize, nullptr, nullptr, &bgra_image);
+        }
+
+        pc.colors = bufferPool->acquire<Vec4b>(size_t(pc.width) * pc.height);
+
+        // Register the colors directly into the pooled color buffer:
+        bool registered = registerColorImage(trafo_handle, depth_image, bgra_image, pc.colors);
+
+        // Create highres texture (keeping the decoded colors instead of copying them):
+        if(registered && highres_width == 2048 && highres_height == 1536 && useColorIndices && decodeScale == 1){
+            pc.highResWidth = highres_width;
+            pc.highResHeight = highres_height;
+
+            if(decodedColors != nullptr){
+                pc.highResColors = decodedColors;
+                decodedColors = nullptr;
+            } else {
+                pc.highResColors = bufferPool->acquire<Vec4b>(highres_width * highres_height);
+                std::memcpy(pc.highResColors, k4a_image_get_buffer(color_image), highres_width * highres_height * sizeof(Vec4b));
+            }
+        }
+
+        if(bgra_image != color_image)
+            k4a_image_release(bgra_image);
+        bufferPool->release(decodedColors, decodedSize);
+
+        if(!registered)
+            std::cout << "A color image could not be transformed to the depth image." << std::endl;
+
+        return registered;
+    }
 
-        if (depth_image != nullptr && color_image != nullptr) {
+    /**
+     * Generates the point cloud of the given capture by registering the color image
+     * to the depth image using the given transformation handle. In depth-only mode,
+     * the color image isn't touched. The capture is not released.
+     */
+    std::shared_ptr<OrganizedPointCloud> generatePointCloudFromCapture(k4a_capture_t& capture, k4a_transformation_t trafo_handle, int frameID){
+        k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+        k4a_image_t color_image = depthOnly ? nullptr : k4a_capture_get_color_image(capture);
+
+        std::shared_ptr<OrganizedPointCloud> pc;
+
+        if (depth_image != nullptr && (color_image != nullptr || depthOnly)) {
             int width = k4a_image_get_width_pixels(depth_image);
             int height = k4a_image_get_height_pixels(depth_image);
 
-            std::shared_ptr<OrganizedPointCloud> pc = std::make_shared<OrganizedPointCloud>(width, height);
+            pc = std::make_shared<OrganizedPointCloud>(width, height);
+            pc->bufferPool = bufferPool;
 
-            int highres_width = k4a_image_get_width_pixels(color_image);
-            int highres_height = k4a_image_get_height_pixels(color_image);
+            if(color_image == nullptr || registerCaptureColors(depth_image, color_image, trafo_handle, frameID, *pc)){
+                pc->depth = bufferPool->acquire<uint16_t>(width * height);
+                pc->modelMatrix = transformation * depthToColorTransform;
+                pc->lookupImageTo3D = DFToCS;
+                pc->lookup3DToImage = lookupTable3DToImage;
+                pc->lookup3DToImageSize = LOOKUP_TABLE_SIZE;
+                pc->frameID = frameID;
 
-            // Create highres texture:
-            if(highres_width == 2048 && highres_height == 1536 && useColorIndices){
-                uint8_t* buffer = k4a_image_get_buffer(color_image);
-
-                pc->highResColors = new Vec4b[highres_width * highres_height];
-                pc->highResWidth = highres_width;
-                pc->highResHeight = highres_height;
-                std::memcpy(pc->highResColors, buffer, highres_width * highres_height * sizeof(Vec4b));
+                uint16_t* pcdata = (uint16_t*)(void*)k4a_image_get_buffer(depth_image);
+                std::memcpy(pc->depth, pcdata, width * height * sizeof(uint16_t));
+            } else {
+                pc = nullptr;
             }
+        }
 
-            k4a_image_create(K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4 * sizeof(uint8_t), &transformed_color_image);
-            if (k4a_transformation_color_image_to_depth_camera(transformation_handle, depth_image, useColorIndices ? colorIndexImage : color_image, transformed_color_image) != K4A_RESULT_SUCCEEDED)
-            {
-                std::cout << "A color image could not be transformed to the depth image." << std::endl;
+        if(depth_image != nullptr)
+            k4a_image_release(depth_image);
+        if(color_image != nullptr)
+            k4a_image_release(color_image);
 
-                k4a_image_release(depth_image);
-                k4a_image_release(transformed_color_image);
-                k4a_image_release(color_image);
+        return pc;
+    }
+
+private:
+    /**
+     * Reads the given frame using the given handles. If 'seek' is false, the frame is
+     * expected to be the next capture of the playback handle (no seeking required).
+     */
+    std::shared_ptr<OrganizedPointCloud> readFrame(k4a_playback_t handle, k4a_transformation_t trafo_handle, int frame, bool seek = true){
+        uint64_t timestampUsec = uint64_t(allTimestamps[frame] * 1000000 + 0.5);
+
+        if(seek && k4a_playback_seek_timestamp(handle, timestampUsec, K4A_PLAYBACK_SEEK_BEGIN) != K4A_RESULT_SUCCEEDED)
+            return nullptr;
+
+        k4a_capture_t capture = NULL;
+        while (k4a_playback_get_next_capture(handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED) {
+            k4a_image_t depth_image = k4a_capture_get_depth_image(capture);
+            if(depth_image == NULL){
                 k4a_capture_release(capture);
-                return nullptr;
+                continue;
             }
 
-            pc->depth = new uint16_t[width * height];
-            pc->colors = new Vec4b[width * height];
-            pc->modelMatrix = transformation * depthToColorTransform;
-            pc->lookupImageTo3D = DFToCS;
-            pc->lookup3DToImage = lookupTable3DToImage;
-            pc->lookup3DToImageSize = LOOKUP_TABLE_SIZE;
-            pc->frameID = currentFrame;
-            pc->width = width;
-            pc->height = height;
-
-            uint16_t* pcdata = (uint16_t*)(void*)k4a_image_get_buffer(depth_image);
-            uint8_t* bgradata = k4a_image_get_buffer(transformed_color_image);
-            std::memcpy(pc->colors, bgradata, width * height * sizeof(int));
-            std::memcpy(pc->depth, pcdata, width * height * sizeof(uint16_t));
-
+            uint64_t captureTimestampUsec = k4a_image_get_device_timestamp_usec(depth_image);
             k4a_image_release(depth_image);
-            k4a_image_release(transformed_color_image);
-            k4a_image_release(color_image);
+
+            // Seeking is not frame-accurate, so skip captures before the frame:
+            if(captureTimestampUsec + 100 < timestampUsec){
+                k4a_capture_release(capture);
+                continue;
+            }
+
+            std::shared_ptr<OrganizedPointCloud> pc = generatePointCloudFromCapture(capture, trafo_handle, frame);
+            k4a_capture_release(capture);
             return pc;
         }
 
         return nullptr;
     }
 
-    std::shared_ptr<OrganizedPointCloud> syncImage(double timeStamp){
-        double specificTimestep = 0.f;
-        for(int i=0; i < allTimestamps.size(); ++i){
-            if(timeStamp - 0.0166f < allTimestamps[i]){
-                specificTimestep = allTimestamps[i];
-                currentFrame = i;
-                break;
+    /**
+     * Decodes the frames ahead of the playhead until the prefetch ring is full.
+     */
+    void prefetchLoop(PrefetchWorker* worker){
+        int lastDecodedFrame = -2;
+
+        while(true){
+            int frame;
+            unsigned long long generation;
+            {
+                std::unique_lock<std::mutex> lock(prefetchMutex);
+                prefetchCondition.wait(lock, [this](){
+                    return stopPrefetching || (int(prefetchRing.size() + prefetchInFlightFrames.size()) < prefetchDepth && prefetchNextFrame < int(totalFrameCount));
+                });
+
+                if(stopPrefetching)
+                    return;
+
+                frame = prefetchNextFrame++;
+                generation = prefetchGeneration;
+                prefetchInFlightFrames.insert(frame);
+            }
+
+            std::shared_ptr<OrganizedPointCloud> pc;
+            if(useBuffer){
+                pc = decodeCompressedFrame(frame, worker->transformation_handle);
+            } else {
+                // Consecutive frames are read without seeking:
+                pc = readFrame(worker->playback_handle, worker->transformation_handle, frame, frame != lastDecodedFrame + 1);
+                lastDecodedFrame = pc != nullptr ? frame : -2;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(prefetchMutex);
+                if(generation == prefetchGeneration && pc != nullptr)
+                    prefetchRing[frame] = pc;
+                prefetchInFlightFrames.erase(frame);
             }
+            prefetchCondition.notify_all();
         }
+    }
 
-        if(useBuffer){
-            if(currentFrame >= 0 && currentFrame < preloadedBuffer.size())
-                return preloadedBuffer[currentFrame];
+    /**
+     * Returns the given frame from the prefetch ring (or nullptr on a miss) and
+     * moves the prefetch window to the frames after it.
+     */
+    std::shared_ptr<OrganizedPointCloud> takePrefetchedFrame(int frame){
+        if(!prefetchRunning)
+            return nullptr;
+
+        std::unique_lock<std::mutex> lock(prefetchMutex);
+
+        // If the frame is currently decoded, waiting is cheaper than decoding it again:
+        unsigned long long generation = prefetchGeneration;
+        prefetchCondition.wait(lock, [&](){
+            return prefetchInFlightFrames.count(frame) == 0 || generation != prefetchGeneration;
+        });
+
+        // Drop frames which are behind the playhead:
+        prefetchRing.erase(prefetchRing.begin(), prefetchRing.lower_bound(frame));
+
+        std::shared_ptr<OrganizedPointCloud> pc;
+        auto it = prefetchRing.find(frame);
+        if(it != prefetchRing.end()){
+            pc = it->second;
+            prefetchRing.erase(it);
+            ++prefetchHits;
         } else {
-            // Seek to timestamp and load:
-            k4a_result_t seek_result = k4a_playback_seek_timestamp(playback_handle, uint64_t(specificTimestep * 1000000), K4A_PLAYBACK_SEEK_BEGIN);
-            if (seek_result != K4A_RESULT_SUCCEEDED)
-            {
-                return nullptr;
+            ++prefetchMisses;
+
+            // Playhead jumped (seek, step, frame skipping) out of the prefetched
+            // window, so restart behind it:
+            if(frame >= prefetchNextFrame || frame + prefetchDepth + 1 < prefetchNextFrame){
+                prefetchRing.clear();
+                prefetchNextFrame = frame + 1;
+                ++prefetchGeneration;
             }
+        }
 
-            // Read capture:
-            k4a_capture_t capture = NULL;
-            if (k4a_playback_get_next_capture(playback_handle, &capture) == K4A_STREAM_RESULT_SUCCEEDED) {
-                std::shared_ptr<OrganizedPointCloud> pc = generatePointCloudFromCapture(capture);
-                k4a_capture_release(capture);
-                return pc;
+        lock.unlock();
+        prefetchCondition.notify_all();
+        return pc;
+    }
+
+public:
+    /**
+     * Sets the number of frames which are decoded ahead of the playhead (0 disables
+     * prefetching). Starts the prefetch workers on first use.
+     */
+    void setPrefetchDepth(int depth){
+        if(!successfullyOpened)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex);
+            prefetchDepth = std::max(depth, 0);
+            while(int(prefetchRing.size()) > prefetchDepth)
+                prefetchRing.erase(std::prev(prefetchRing.end()));
+
+            // Frames dropped from the back have to be decoded again:
+            prefetchNextFrame = prefetchRing.empty() ? std::max(lastServedFrame + 1, 0) : prefetchRing.rbegin()->first + 1;
+            ++prefetchGeneration;
+        }
+        prefetchCondition.notify_all();
+
+        reservePointCloudBuffers(POOLED_POINT_CLOUDS + prefetchDepth + BUFFERED_DECODE_THREADS);
+
+        // Scratch buffers for the decoded full resolution colors:
+        if(useBuffer && !depthOnly){
+            size_t colorSize = size_t(calibration.color_camera_calibration.resolution_width) * calibration.color_camera_calibration.resolution_height * sizeof(Vec4b);
+            bufferPool->reserve(colorSize, BUFFERED_DECODE_THREADS + 1);
+        }
+
+        if(prefetchDepth > 0 && prefetchWorkers.empty()){
+            int workerCount = useBuffer ? BUFFERED_DECODE_THREADS : 1;
+
+            for(int i = 0; i < workerCount; ++i){
+                std::unique_ptr<PrefetchWorker> worker = std::make_unique<PrefetchWorker>();
+
+                if(!useBuffer){
+                    if (k4a_playback_open(recordingPath.c_str(), &worker->playback_handle) != K4A_RESULT_SUCCEEDED)
+                    {
+                        std::cerr << "Failed to open recording for prefetching\n";
+                        break;
+                    }
+                    if(usesColorConversion())
+                        k4a_playback_set_color_conversion(worker->playback_handle, K4A_IMAGE_FORMAT_COLOR_BGRA32);
+                }
+
+                worker->transformation_handle = k4a_transformation_create(&calibration);
+                worker->thread = std::thread(&AzureKinectMKVStream::prefetchLoop, this, worker.get());
+                prefetchWorkers.push_back(std::move(worker));
             }
-            return nullptr;
+
+            prefetchRunning = !prefetchWorkers.empty();
         }
-        return nullptr;
+    }
+
+    /**
+     * Discards all prefetched frames and restarts prefetching at the frame of the
+     * given timestamp (e.g. after seeking).
+     */
+    void invalidatePrefetch(double timeStamp){
+        int frame = findSynchronizedFrame(allTimestamps, timeStamp, 0.0166);
+
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex);
+            prefetchRing.clear();
+            prefetchNextFrame = frame;
+            ++prefetchGeneration;
+        }
+        prefetchCondition.notify_all();
+    }
+
+    unsigned long long getPrefetchHits(){
+        return prefetchHits;
+    }
+
+    unsigned long long getPrefetchMisses(){
+        return prefetchMisses;
+    }
+
+    BufferPool& getBufferPool(){
+        return *bufferPool;
+    }
+
+    /** Time in ms to decode a compressed frame (buffered mode) */
+    float getDecodeTime(){
+        return decodeTime;
+    }
+
+    /** Ratio of the uncompressed to the compressed size of the loaded frames */
+    float getCompressionRatio(){
+        size_t compressed = loadedCompressedBytes;
+        return compressed > 0 ? float(double(loadedUncompressedBytes) / compressed) : 0.f;
+    }
+
+    /** Frame cache of the buffered mode (or nullptr in streamed mode) */
+    CompressedFrameCache* getFrameCache(){
+        return frameCache.get();
+    }
+
+    /** Sets the RAM budget of the frame cache (buffered mode) */
+    void setCacheBudget(size_t bytes){
+        cacheBudgetBytes = bytes;
+        if(frameCache != nullptr)
+            frameCache->setBudget(bytes);
+        loaderCondition.notify_all();
+    }
+
+    /**
+     * Returns the first frame which is not older than the tolerance (by default
+     * one half frame at 30 Hz) before the given timestamp (see
+     * findSynchronizedFrame, the FrameAssembler matches the frames the same way).
+     */
+    std::shared_ptr<OrganizedPointCloud> syncImage(double timeStamp, double tolerance = 0.0166){
+        int frame = findSynchronizedFrame(allTimestamps, timeStamp, tolerance);
+
+        if(frame < int(allTimestamps.size()))
+            currentFrame = frame;
+        else
+            frame = currentFrame;
+
+        if(useBuffer && playheadFrame != frame){
+            playheadFrame = frame;
+            loaderCondition.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex);
+            if(frame == lastServedFrame && lastServedPointCloud != nullptr)
+                return lastServedPointCloud;
+        }
+
+        std::shared_ptr<OrganizedPointCloud> pc = takePrefetchedFrame(frame);
+
+        // Not prefetched, so decode it now:
+        if(pc == nullptr){
+            if(useBuffer)
+                pc = decodeCompressedFrame(frame, transformation_handle);
+            else
+                pc = readFrame(playback_handle, transformation_handle, frame);
+        }
+
+        // The point cloud is served again as long as the frame doesn't change:
+        if(pc != nullptr)
+            pc->isWritable = false;
+
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        lastServedFrame = frame;
+        lastServedPointCloud = pc;
+        return pc;
     }
 };
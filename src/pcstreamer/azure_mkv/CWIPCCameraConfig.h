@@ -0,0 +1,55 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+
+#include <nlohmann/json.hpp>
+
+#include "src/util/math/Mat4.h"
+
+/**
+ * A camera entry of the 'cameraconfig.json' of the CWIPC-SXR dataset.
+ */
+struct CWIPCCamera {
+    /** Absolute path to the .mkv recording of this camera */
+    std::string recordingPath;
+
+    /** Transformation from color camera space into world space */
+    Mat4f transformation;
+};
+
+/**
+ * Parses the cameras of the 'cameraconfig.json' of the CWIPC-SXR dataset.
+ */
+inline std::vector<CWIPCCamera> loadCWIPCCameraConfig(std::string cameraConfigPath){
+    std::string rootPath = std::filesystem::path(cameraConfigPath).parent_path().string() + "/";
+
+    std::ifstream f(cameraConfigPath);
+    nlohmann::json jfile = nlohmann::json::parse(f);
+
+    std::vector<CWIPCCamera> cameras;
+
+    for(const nlohmann::json& jcamera : jfile["camera"]){
+        CWIPCCamera camera;
+        camera.recordingPath = rootPath + jcamera["filename"].get<std::string>();
+
+        float rawMat[16];
+        int index = 0;
+        for (const auto& row : jcamera["trafo"]) {
+            for (float value : row) {
+                int rowMajorIdx = index++;
+                int colMajorIdx = (rowMajorIdx % 4) * 4 + (rowMajorIdx / 4);
+                rawMat[colMajorIdx] = value;
+            }
+        }
+
+        camera.transformation = Mat4f(rawMat);
+        cameras.push_back(camera);
+    }
+
+    return cameras;
+}
@@ -0,0 +1,136 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+#include <k4a/k4a.h>
+
+#include "src/util/Hash.h"
+
+#define CALIBRATION_LOOKUP_MAGIC "MKVLUT01"
+#define CALIBRATION_LOOKUP_VERSION 1
+
+/**
+ * Persistent cache of the lookup tables which are derived from the calibration
+ * of an Azure Kinect (see AzureKinectMKVStream::createLookupTables), so that
+ * they don't have to be computed by the k4a SDK on every open.
+ *
+ * The tables are keyed by the hash of the k4a_calibration_t and stored in the
+ * user's cache directory (not next to the recording), so recordings of the same
+ * device share them.
+ */
+struct CalibrationLookupCache {
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t lookupTableSize;
+        uint64_t calibrationHash;
+        uint32_t depthWidth;
+        uint32_t depthHeight;
+    };
+
+    static uint64_t hashCalibration(const k4a_calibration_t& calibration){
+        return hashFNV1a(&calibration, sizeof(k4a_calibration_t));
+    }
+
+    /**
+     * Returns the cache directory ($XDG_CACHE_HOME, ~/.cache or %LOCALAPPDATA%
+     * + '/BlendPCR', falling back to the temporary directory).
+     */
+    static std::filesystem::path cacheDirectory(){
+        std::error_code error;
+
+        if(const char* xdgCache = std::getenv("XDG_CACHE_HOME"))
+            return std::filesystem::path(xdgCache) / "BlendPCR";
+        if(const char* localAppData = std::getenv("LOCALAPPDATA"))
+            return std::filesystem::path(localAppData) / "BlendPCR";
+        if(const char* home = std::getenv("HOME"))
+            return std::filesystem::path(home) / ".cache" / "BlendPCR";
+
+        return std::filesystem::temp_directory_path(error) / "BlendPCR";
+    }
+
+    static std::filesystem::path cachePathOf(uint64_t calibrationHash){
+        char name[64];
+        std::snprintf(name, sizeof(name), "lut_%016llx.bin", (unsigned long long) calibrationHash);
+        return cacheDirectory() / name;
+    }
+
+    /**
+     * Loads the tables of the calibration with the given hash into the given
+     * arrays (of lookupTableSize² * 2 and depthWidth * depthHeight * 2 floats).
+     * Returns false if they are not cached.
+     */
+    static bool load(uint64_t calibrationHash, unsigned int lookupTableSize, unsigned int depthWidth, unsigned int depthHeight, float* lookup3DToImage, float* lookupImageTo3D){
+        std::ifstream file(cachePathOf(calibrationHash), std::ios::binary);
+        if(!file.is_open())
+            return false;
+
+        Header header;
+        if(!file.read((char*) &header, sizeof(header)))
+            return false;
+
+        if(std::memcmp(header.magic, CALIBRATION_LOOKUP_MAGIC, 8) != 0 || header.version != CALIBRATION_LOOKUP_VERSION
+            || header.calibrationHash != calibrationHash || header.lookupTableSize != lookupTableSize
+            || header.depthWidth != depthWidth || header.depthHeight != depthHeight)
+            return false;
+
+        return file.read((char*) lookup3DToImage, std::streamsize(size_t(lookupTableSize) * lookupTableSize * 2 * sizeof(float)))
+            && file.read((char*) lookupImageTo3D, std::streamsize(size_t(depthWidth) * depthHeight * 2 * sizeof(float)));
+    }
+
+    /**
+     * Writes the tables into the cache. Failing to write is not an error, the
+     * tables are just computed again on the next open.
+     */
+    static void save(uint64_t calibrationHash, unsigned int lookupTableSize, unsigned int depthWidth, unsigned int depthHeight, const float* lookup3DToImage, const float* lookupImageTo3D){
+        std::error_code error;
+        std::filesystem::path cachePath = cachePathOf(calibrationHash);
+        std::filesystem::create_directories(cachePath.parent_path(), error);
+
+        // Write into a temporary file first, so that streams which are opened at the
+        // same time never read a truncated file:
+        std::filesystem::path tempPath = cachePath;
+        tempPath += ".tmp" + std::to_string(uintptr_t(lookup3DToImage));
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()){
+                std::cerr << "Could not write lookup table cache: " << cachePath.string() << std::endl;
+                return;
+            }
+
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, CALIBRATION_LOOKUP_MAGIC, 8);
+            header.version = CALIBRATION_LOOKUP_VERSION;
+            header.lookupTableSize = lookupTableSize;
+            header.calibrationHash = calibrationHash;
+            header.depthWidth = depthWidth;
+            header.depthHeight = depthHeight;
+
+            file.write((const char*) &header, sizeof(header));
+            file.write((const char*) lookup3DToImage, std::streamsize(size_t(lookupTableSize) * lookupTableSize * 2 * sizeof(float)));
+            file.write((const char*) lookupImageTo3D, std::streamsize(size_t(depthWidth) * depthHeight * 2 * sizeof(float)));
+
+            if(!file.good()){
+                std::cerr << "Could not write lookup table cache: " << cachePath.string() << std::endl;
+                file.close();
+                std::filesystem::remove(tempPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, cachePath, error);
+        if(error)
+            std::filesystem::remove(tempPath, error);
+    }
+};
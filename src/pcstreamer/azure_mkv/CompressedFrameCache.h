@@ -0,0 +1,167 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include <k4a/k4a.h>
+
+/**
+ * A frame of the buffered mode, which is kept compressed in RAM: the depth image
+ * is RVL coded (lossless) and the color image is kept as recorded (MJPEG).
+ */
+struct AzureKinectCompressedFrame {
+    std::vector<uint8_t> depth;
+    std::vector<uint8_t> color;
+
+    /** Format of 'color', either K4A_IMAGE_FORMAT_COLOR_MJPG or K4A_IMAGE_FORMAT_COLOR_BGRA32 */
+    k4a_image_format_t colorFormat = K4A_IMAGE_FORMAT_COLOR_MJPG;
+    int colorWidth = 0;
+    int colorHeight = 0;
+
+    size_t size() const {
+        return depth.size() + color.size();
+    }
+};
+
+/**
+ * Least-recently-used cache of compressed frames with a budget in bytes.
+ *
+ * Frames are handed out as shared pointers, so evicting a frame while it is
+ * decoded is safe. Eviction never removes frames for which the given
+ * predicate returns true (e.g. the frames around the playhead).
+ */
+class CompressedFrameCache {
+    struct Entry {
+        std::shared_ptr<const AzureKinectCompressedFrame> frame;
+        std::list<int>::iterator lruPosition;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<int, Entry> entries;
+
+    /** Frame indices, least recently used first */
+    std::list<int> lru;
+
+    size_t budgetBytes;
+    size_t residentBytes = 0;
+
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    unsigned long long evictions = 0;
+
+public:
+    CompressedFrameCache(size_t budgetBytes)
+        : budgetBytes(budgetBytes){}
+
+    /**
+     * Returns the frame (and marks it as recently used) or nullptr if it is not
+     * resident. Counts hits and misses.
+     */
+    std::shared_ptr<const AzureKinectCompressedFrame> get(int frameID){
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = entries.find(frameID);
+        if(it == entries.end()){
+            ++misses;
+            return nullptr;
+        }
+
+        ++hits;
+        lru.splice(lru.end(), lru, it->second.lruPosition);
+        return it->second.frame;
+    }
+
+    /**
+     * Returns whether the frame is resident (without affecting statistics or
+     * the LRU order).
+     */
+    bool contains(int frameID){
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.count(frameID) > 0;
+    }
+
+    /**
+     * Returns the size of the frame in bytes or 0 if it is not resident.
+     */
+    size_t sizeOf(int frameID){
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(frameID);
+        return it != entries.end() ? it->second.frame->size() : 0;
+    }
+
+    /**
+     * Inserts a frame (as most recently used).
+     */
+    void put(int frameID, std::shared_ptr<const AzureKinectCompressedFrame> frame){
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = entries.find(frameID);
+        if(it != entries.end()){
+            residentBytes -= it->second.frame->size();
+            lru.erase(it->second.lruPosition);
+            entries.erase(it);
+        }
+
+        lru.push_back(frameID);
+        entries[frameID] = Entry{frame, std::prev(lru.end())};
+        residentBytes += frame->size();
+    }
+
+    /**
+     * Evicts least recently used frames which are not protected until 'freeBytes'
+     * are available within the budget. Returns false if this is not possible.
+     */
+    bool makeRoom(size_t freeBytes, std::function<bool(int)> isProtected){
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = lru.begin();
+        while(residentBytes + freeBytes > budgetBytes && it != lru.end()){
+            if(isProtected(*it)){
+                ++it;
+                continue;
+            }
+
+            auto entry = entries.find(*it);
+            residentBytes -= entry->second.frame->size();
+            entries.erase(entry);
+            it = lru.erase(it);
+            ++evictions;
+        }
+
+        return residentBytes + freeBytes <= budgetBytes;
+    }
+
+    void setBudget(size_t bytes){
+        std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = bytes;
+    }
+
+    size_t getBudget(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return budgetBytes;
+    }
+
+    size_t getResidentBytes(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return residentBytes;
+    }
+
+    unsigned int getResidentFrameCount(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return (unsigned int) entries.size();
+    }
+
+    void getStatistics(unsigned long long& hitCount, unsigned long long& missCount, unsigned long long& evictionCount){
+        std::lock_guard<std::mutex> lock(mutex);
+        hitCount = hits;
+        missCount = misses;
+        evictionCount = evictions;
+    }
+};
@@ -0,0 +1,342 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <iostream>
+#include <new>
+
+#include <k4a/k4a.h>
+
+#include "src/util/math/Vec4.h"
+#include "src/util/BufferPool.h"
+#include "src/util/simd/SIMD.h"
+
+/** Rows of the depth image which are processed by a thread at once */
+#define REGISTRATION_TILE_ROWS 16
+
+/** The occlusion z-buffer has 1/REGISTRATION_ZBUFFER_DOWNSCALE of the color resolution */
+#define REGISTRATION_ZBUFFER_DOWNSCALE 4
+
+/** Depth pixels which are further behind the z-buffer are occluded (relative to the depth, plus 10 mm) */
+#define REGISTRATION_OCCLUSION_TOLERANCE 0.02f
+
+/**
+ * Registers the color image to the depth image (like
+ * k4a_transformation_color_image_to_depth_camera), but without allocations,
+ * vectorized (see SIMD.h) and multi-threaded (OpenMP):
+ *
+ *  1. Every depth pixel is unprojected with its cached ray (lookupImageTo3D),
+ *     transformed into the color camera and projected with the Brown-Conrady
+ *     distortion model of the color camera. The nearest depth is stored in
+ *     a z-buffer of reduced resolution.
+ *  2. For every depth pixel which is not occluded in the color camera, the
+ *     color is sampled bilinearly. Other pixels are set to zero.
+ *
+ * The calibration is constant, so everything except the images is computed
+ * once per camera. Multiple threads can register frames at the same time.
+ */
+class DepthColorRegistration {
+    unsigned int depthWidth = 0;
+    unsigned int depthHeight = 0;
+
+    /** De-interleaved rays (x/z, y/z) of the depth pixels (NaN if invalid) */
+    std::vector<float> rayX;
+    std::vector<float> rayY;
+
+    /** Depth camera -> color camera (in millimeters, row-major) */
+    float rotation[9];
+    float translation[3];
+
+    /** Intrinsics of the color camera */
+    float fx, fy, cx, cy;
+    float k1, k2, k3, k4, k5, k6;
+    float p1, p2, codx, cody;
+    float maxRadiusSquared;
+
+    /** The tangential terms differ between the Brown-Conrady and the Rational 6KT model */
+    float tangentialFactor;
+
+    unsigned int colorWidth = 0;
+    unsigned int colorHeight = 0;
+
+    bool valid = false;
+
+    std::atomic<float> registrationTime{0.f};
+
+    /**
+     * Projection into the color image, which may be decoded at a reduced
+     * resolution (1 / scale, see decodeJPEGToBGRA).
+     */
+    struct ImageProjection {
+        float fx, fy, cx, cy;
+        unsigned int width, height;
+    };
+
+    /**
+     * Projects simd::Width depth pixels starting at the given index into the
+     * color image (u is -1 if the pixel has no valid projection).
+     */
+    inline void project(const ImageProjection& image, const uint16_t* depth, const float* raysX, const float* raysY, float* u, float* v, float* z) const {
+        using namespace simd;
+
+        Float d = loadDepth(depth);
+        Float x = load(raysX) * d;
+        Float y = load(raysY) * d;
+
+        Float X = x * rotation[0] + y * rotation[1] + d * rotation[2] + translation[0];
+        Float Y = x * rotation[3] + y * rotation[4] + d * rotation[5] + translation[1];
+        Float Z = x * rotation[6] + y * rotation[7] + d * rotation[8] + translation[2];
+
+        Float invZ = Float(1.f) / Z;
+        Float xp = X * invZ - codx;
+        Float yp = Y * invZ - cody;
+
+        Float xp2 = xp * xp;
+        Float yp2 = yp * yp;
+        Float xyp = xp * yp;
+        Float rs = xp2 + yp2;
+        Float rss = rs * rs;
+        Float rsc = rss * rs;
+
+        Float a = Float(1.f) + rs * k1 + rss * k2 + rsc * k3;
+        Float b = Float(1.f) + rs * k4 + rss * k5 + rsc * k6;
+        Float radial = a / b;
+
+        Float xpd = xp * radial + (rs + xp2 * 2.f) * p2 + xyp * (tangentialFactor * p1);
+        Float ypd = yp * radial + (rs + yp2 * 2.f) * p1 + xyp * (tangentialFactor * p2);
+
+        Float uu = (xpd + codx) * image.fx + image.cx;
+        Float vv = (ypd + cody) * image.fy + image.cy;
+
+        // Written as conjunction of ordered comparisons, so NaN rays are invalid:
+        Mask isValid = (d > Float(0.f)) & (Z > Float(0.f)) & (rs <= Float(maxRadiusSquared))
+            & (uu >= Float(0.f)) & (uu < Float(float(image.width - 1)))
+            & (vv >= Float(0.f)) & (vv < Float(float(image.height - 1)));
+
+        store(u, select(isValid, uu, Float(-1.f)));
+        store(v, vv);
+        store(z, Z);
+    }
+
+    /**
+     * Projects the pixels [start, end) (tail which isn't a multiple of the
+     * vector width is padded).
+     */
+    void projectRange(const ImageProjection& image, const uint16_t* depth, size_t start, size_t end, float* u, float* v, float* z) const {
+        size_t i = start;
+        for(; i + simd::Width <= end; i += simd::Width)
+            project(image, depth + i, &rayX[i], &rayY[i], u + i, v + i, z + i);
+
+        if(i < end){
+            uint16_t paddedDepth[simd::Width] = {0};
+            float paddedRayX[simd::Width] = {0}, paddedRayY[simd::Width] = {0};
+            float paddedU[simd::Width], paddedV[simd::Width], paddedZ[simd::Width];
+
+            for(size_t j = i; j < end; ++j){
+                paddedDepth[j - i] = depth[j];
+                paddedRayX[j - i] = rayX[j];
+                paddedRayY[j - i] = rayY[j];
+            }
+
+            project(image, paddedDepth, paddedRayX, paddedRayY, paddedU, paddedV, paddedZ);
+
+            for(size_t j = i; j < end; ++j){
+                u[j] = paddedU[j - i];
+                v[j] = paddedV[j - i];
+                z[j] = paddedZ[j - i];
+            }
+        }
+    }
+
+    static void storeMin(std::atomic<uint16_t>& cell, uint16_t value){
+        uint16_t current = cell.load(std::memory_order_relaxed);
+        while(value < current && !cell.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    }
+
+    /** Interpolates the four 8 bit channels of two pixels (weight in [0, 256]) */
+    static uint32_t lerpChannels(uint32_t a, uint32_t b, uint32_t weight){
+        // Two channels at once in the 16 bit halves of a 32 bit integer:
+        uint32_t evenChannels = ((a & 0x00FF00FF) * (256 - weight) + (b & 0x00FF00FF) * weight) >> 8;
+        uint32_t oddChannels = (((a >> 8) & 0x00FF00FF) * (256 - weight) + ((b >> 8) & 0x00FF00FF) * weight) >> 8;
+        return (evenChannels & 0x00FF00FF) | ((oddChannels & 0x00FF00FF) << 8);
+    }
+
+    static Vec4b sampleBilinear(const Vec4b* image, unsigned int width, float u, float v){
+        int x0 = int(u);
+        int y0 = int(v);
+        uint32_t wx = uint32_t((u - x0) * 256.f + 0.5f);
+        uint32_t wy = uint32_t((v - y0) * 256.f + 0.5f);
+
+        const uint32_t* top = (const uint32_t*) (image + size_t(y0) * width + x0);
+        const uint32_t* bottom = top + width;
+
+        uint32_t result = lerpChannels(lerpChannels(top[0], top[1], wx), lerpChannels(bottom[0], bottom[1], wx), wy);
+
+        return Vec4b(uint8_t(result), uint8_t(result >> 8), uint8_t(result >> 16), uint8_t(result >> 24));
+    }
+
+public:
+    /**
+     * Creates the registration of the given calibration. lookupImageTo3D
+     * contains the rays (x/z, y/z) of the depth pixels (NaN if invalid).
+     */
+    DepthColorRegistration(const k4a_calibration_t& calibration, const float* lookupImageTo3D){
+        const k4a_calibration_camera_t& depthCamera = calibration.depth_camera_calibration;
+        const k4a_calibration_camera_t& colorCamera = calibration.color_camera_calibration;
+
+        if(colorCamera.intrinsics.type == K4A_CALIBRATION_LENS_DISTORTION_MODEL_BROWN_CONRADY){
+            tangentialFactor = 2.f;
+        } else if(colorCamera.intrinsics.type == K4A_CALIBRATION_LENS_DISTORTION_MODEL_RATIONAL_6KT){
+            tangentialFactor = 1.f;
+        } else {
+            std::cerr << "Unsupported distortion model of the color camera, using the k4a transformation." << std::endl;
+            return;
+        }
+
+        depthWidth = depthCamera.resolution_width;
+        depthHeight = depthCamera.resolution_height;
+        colorWidth = colorCamera.resolution_width;
+        colorHeight = colorCamera.resolution_height;
+
+        if(depthWidth == 0 || depthHeight == 0 || colorWidth < 2 || colorHeight < 2)
+            return;
+
+        size_t pixelCount = size_t(depthWidth) * depthHeight;
+        rayX.resize(pixelCount);
+        rayY.resize(pixelCount);
+        for(size_t i = 0; i < pixelCount; ++i){
+            rayX[i] = lookupImageTo3D[i * 2];
+            rayY[i] = lookupImageTo3D[i * 2 + 1];
+        }
+
+        const k4a_calibration_extrinsics_t& extrinsics = calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_COLOR];
+        std::copy(extrinsics.rotation, extrinsics.rotation + 9, rotation);
+        std::copy(extrinsics.translation, extrinsics.translation + 3, translation);
+
+        const auto& params = colorCamera.intrinsics.parameters.param;
+        fx = params.fx; fy = params.fy;
+        cx = params.cx; cy = params.cy;
+        k1 = params.k1; k2 = params.k2; k3 = params.k3;
+        k4 = params.k4; k5 = params.k5; k6 = params.k6;
+        p1 = params.p1; p2 = params.p2;
+        codx = params.codx; cody = params.cody;
+
+        float maxRadius = params.metric_radius > 0.f ? params.metric_radius : colorCamera.metric_radius;
+        maxRadiusSquared = maxRadius > 0.f ? maxRadius * maxRadius : std::numeric_limits<float>::max();
+
+        valid = true;
+    }
+
+    bool isValid(){
+        return valid;
+    }
+
+    /**
+     * Writes the colors of the depth pixels into 'registeredColors' (zero if
+     * the pixel isn't visible in the color camera). The color image must have
+     * the resolution of the calibration or be reduced by a factor of 2, 4 or 8
+     * (rounded up, like decodeJPEGToBGRA). Scratch buffers are taken from the
+     * given pool.
+     */
+    bool registerColors(const uint16_t* depth, const Vec4b* colors, unsigned int width, unsigned int height, Vec4b* registeredColors, BufferPool& pool){
+        if(!valid || width == 0 || height == 0)
+            return false;
+
+        unsigned int scale = (colorWidth + width / 2) / width;
+        if((scale != 1 && scale != 2 && scale != 4 && scale != 8)
+            || width != (colorWidth + scale - 1) / scale || height != (colorHeight + scale - 1) / scale)
+            return false;
+
+        // A pixel of the reduced image covers 'scale' pixels (centers at integer coordinates):
+        ImageProjection image;
+        image.fx = fx / scale;
+        image.fy = fy / scale;
+        image.cx = (cx + 0.5f) / scale - 0.5f;
+        image.cy = (cy + 0.5f) / scale - 0.5f;
+        image.width = width;
+        image.height = height;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        size_t pixelCount = size_t(depthWidth) * depthHeight;
+        float* u = pool.acquire<float>(pixelCount);
+        float* v = pool.acquire<float>(pixelCount);
+        float* z = pool.acquire<float>(pixelCount);
+
+        unsigned int zBufferWidth = (colorWidth + REGISTRATION_ZBUFFER_DOWNSCALE - 1) / REGISTRATION_ZBUFFER_DOWNSCALE;
+        unsigned int zBufferHeight = (colorHeight + REGISTRATION_ZBUFFER_DOWNSCALE - 1) / REGISTRATION_ZBUFFER_DOWNSCALE;
+        size_t zBufferSize = size_t(zBufferWidth) * zBufferHeight;
+        std::atomic<uint16_t>* zBuffer = (std::atomic<uint16_t>*) pool.acquire(zBufferSize * sizeof(std::atomic<uint16_t>));
+
+        const float zBufferScale = float(scale) / REGISTRATION_ZBUFFER_DOWNSCALE;
+        int tileCount = int((depthHeight + REGISTRATION_TILE_ROWS - 1) / REGISTRATION_TILE_ROWS);
+
+        #pragma omp parallel
+        {
+            #pragma omp for schedule(static)
+            for(long long i = 0; i < (long long) zBufferSize; ++i)
+                new (&zBuffer[i]) std::atomic<uint16_t>(0xffff);
+
+            // Project all depth pixels & splat them into the z-buffer:
+            #pragma omp for schedule(dynamic)
+            for(int tile = 0; tile < tileCount; ++tile){
+                size_t start = size_t(tile) * REGISTRATION_TILE_ROWS * depthWidth;
+                size_t end = std::min(start + size_t(REGISTRATION_TILE_ROWS) * depthWidth, pixelCount);
+                projectRange(image, depth, start, end, u, v, z);
+
+                for(size_t i = start; i < end; ++i){
+                    if(u[i] < 0.f)
+                        continue;
+
+                    // A cell covers about four depth pixels, so splatting each pixel into
+                    // its cell leaves no holes on (not too oblique) surfaces:
+                    size_t cell = size_t(v[i] * zBufferScale) * zBufferWidth + size_t(u[i] * zBufferScale);
+                    storeMin(zBuffer[cell], uint16_t(std::min(z[i], 65535.f)));
+                }
+            }
+
+            // Sample the colors of the visible pixels:
+            #pragma omp for schedule(dynamic)
+            for(int tile = 0; tile < tileCount; ++tile){
+                size_t start = size_t(tile) * REGISTRATION_TILE_ROWS * depthWidth;
+                size_t end = std::min(start + size_t(REGISTRATION_TILE_ROWS) * depthWidth, pixelCount);
+
+                for(size_t i = start; i < end; ++i){
+                    if(u[i] < 0.f){
+                        registeredColors[i] = Vec4b(0, 0, 0, 0);
+                        continue;
+                    }
+
+                    float nearest = zBuffer[size_t(v[i] * zBufferScale) * zBufferWidth + size_t(u[i] * zBufferScale)].load(std::memory_order_relaxed);
+                    if(z[i] > nearest * (1.f + REGISTRATION_OCCLUSION_TOLERANCE) + 10.f){
+                        registeredColors[i] = Vec4b(0, 0, 0, 0);
+                        continue;
+                    }
+
+                    registeredColors[i] = sampleBilinear(colors, width, u[i], v[i]);
+                }
+            }
+        }
+
+        pool.release(u, pixelCount * sizeof(float));
+        pool.release(v, pixelCount * sizeof(float));
+        pool.release(z, pixelCount * sizeof(float));
+        pool.release(zBuffer, zBufferSize * sizeof(std::atomic<uint16_t>));
+
+        float duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count() * 0.001f;
+        registrationTime = duration * 0.1f + registrationTime * 0.9f;
+        return true;
+    }
+
+    /**
+     * Returns the time to register a frame in milliseconds.
+     */
+    float getRegistrationTime(){
+        return registrationTime;
+    }
+};
@@ -0,0 +1,109 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "src/util/Hash.h"
+
+#define MKV_INDEX_MAGIC "MKVIDX01"
+#define MKV_INDEX_VERSION 1
+
+/**
+ * Persistent frame index of an .mkv recording, which is stored next to the
+ * recording ('<recording>.mkv.index') on first open, so that later opens do
+ * not have to walk through all captures of the recording anymore.
+ *
+ * The index maps the frame number to the device timestamp (in usec) of the
+ * depth image of the frame. The Azure Kinect SDK neither exposes cluster nor
+ * byte offsets of captures, so seeking is still done by timestamp.
+ *
+ * The index is only used if its fingerprint (see hashFileFingerprint) matches
+ * the recording, so a modified or replaced recording is re-indexed.
+ */
+struct MKVRecordingIndex {
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t recordingHash;
+        uint64_t frameCount;
+    };
+
+    /** Device timestamps of the depth images in usec */
+    std::vector<uint64_t> timestampsUsec;
+
+    static std::string indexPathOf(std::string recordingPath){
+        return recordingPath + ".index";
+    }
+
+    /**
+     * Loads the index of the given recording. Returns false if there is no index
+     * or if it does not belong to the recording (anymore).
+     */
+    bool load(std::string recordingPath, uint64_t recordingHash){
+        std::ifstream file(indexPathOf(recordingPath), std::ios::binary);
+        if(!file.is_open())
+            return false;
+
+        Header header;
+        if(!file.read((char*) &header, sizeof(header)))
+            return false;
+
+        if(std::memcmp(header.magic, MKV_INDEX_MAGIC, 8) != 0 || header.version != MKV_INDEX_VERSION || header.recordingHash != recordingHash || header.frameCount == 0)
+            return false;
+
+        timestampsUsec.resize(size_t(header.frameCount));
+        if(!file.read((char*) timestampsUsec.data(), std::streamsize(timestampsUsec.size() * sizeof(uint64_t)))){
+            timestampsUsec.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Writes the index next to the recording. Failing to write (e.g. read-only
+     * dataset folders) is not an error, the recording is just indexed again on
+     * the next open.
+     */
+    void save(std::string recordingPath, uint64_t recordingHash){
+        std::string indexPath = indexPathOf(recordingPath);
+
+        // Write into a temporary file first, so that an aborted write never leaves
+        // a truncated index behind:
+        std::string tempPath = indexPath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()){
+                std::cerr << "Could not write recording index: " << indexPath << std::endl;
+                return;
+            }
+
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, MKV_INDEX_MAGIC, 8);
+            header.version = MKV_INDEX_VERSION;
+            header.recordingHash = recordingHash;
+            header.frameCount = timestampsUsec.size();
+
+            file.write((const char*) &header, sizeof(header));
+            file.write((const char*) timestampsUsec.data(), std::streamsize(timestampsUsec.size() * sizeof(uint64_t)));
+
+            if(!file.good()){
+                std::cerr << "Could not write recording index: " << indexPath << std::endl;
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, indexPath, error);
+        if(error)
+            std::filesystem::remove(tempPath, error);
+    }
+};
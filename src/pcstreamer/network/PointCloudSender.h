@@ -0,0 +1,159 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <iostream>
+
+#include "src/util/OrganizedPointCloud.h"
+#include "src/util/net/TCPSocket.h"
+#include "src/pcstreamer/network/PointCloudStreamProtocol.h"
+
+/**
+ * Sends the point clouds of a streamer to a NetworkStreamer (see
+ * PointCloudStreamProtocol.h). Only the cameras [firstCameraID, firstCameraID
+ * + cameraCount) are sent, so multiple senders can provide different cameras
+ * of the same setup.
+ *
+ * The images are sent directly from the point cloud buffers (no copy). If the
+ * connection is lost, the sender reconnects on the next frame.
+ */
+class PointCloudSender {
+    std::string host;
+    int port;
+    unsigned int firstCameraID;
+    unsigned int cameraCount;
+
+    std::unique_ptr<TCPSocket> socket;
+    std::chrono::steady_clock::time_point lastConnectAttempt;
+
+    /** Frame IDs of the source repeat when it loops, so loops are counted */
+    int64_t loopCount = 0;
+    int lastSourceFrameID = -1;
+
+    unsigned long long sentFrames = 0;
+    unsigned long long sentBytes = 0;
+
+    bool connect(const std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds){
+        auto now = std::chrono::steady_clock::now();
+        if(now - lastConnectAttempt < std::chrono::seconds(1))
+            return false;
+        lastConnectAttempt = now;
+
+        socket = TCPSocket::connect(host, port);
+        if(socket == nullptr)
+            return false;
+
+        socket->configure(32 * 1024 * 1024);
+
+        const OrganizedPointCloud& first = *pointClouds[firstCameraID];
+
+        PointCloudStreamHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, POINT_CLOUD_STREAM_MAGIC, 8);
+        header.totalCameraCount = (uint32_t) pointClouds.size();
+        header.firstCameraID = firstCameraID;
+        header.cameraCount = cameraCount;
+        header.width = first.width;
+        header.height = first.height;
+        header.lookup3DToImageSize = first.lookup3DToImageSize;
+
+        bool success = socket->sendAll(&header, sizeof(header));
+
+        for(unsigned int i = firstCameraID; i < firstCameraID + cameraCount && success; ++i){
+            const OrganizedPointCloud& pc = *pointClouds[i];
+
+            PointCloudStreamCamera camera;
+            std::memcpy(camera.modelMatrix, pc.modelMatrix.data, sizeof(camera.modelMatrix));
+
+            success = socket->sendAll(&camera, sizeof(camera))
+                && socket->sendAll(pc.lookupImageTo3D, size_t(pc.width) * pc.height * 2 * sizeof(float))
+                && socket->sendAll(pc.lookup3DToImage, size_t(pc.lookup3DToImageSize) * pc.lookup3DToImageSize * 2 * sizeof(float));
+        }
+
+        if(!success){
+            socket = nullptr;
+            return false;
+        }
+
+        std::cout << "Connected to " << host << ":" << port << "." << std::endl;
+        return true;
+    }
+
+public:
+    /**
+     * If cameraCount is 0, all cameras from firstCameraID on are sent.
+     */
+    PointCloudSender(std::string host, int port = POINT_CLOUD_STREAM_DEFAULT_PORT, unsigned int firstCameraID = 0, unsigned int cameraCount = 0)
+        : host(host)
+        , port(port)
+        , firstCameraID(firstCameraID)
+        , cameraCount(cameraCount)
+    {}
+
+    /**
+     * Sends one frame (the point clouds of all cameras of the setup). Returns
+     * false if not connected.
+     */
+    bool send(const std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds){
+        if(pointClouds.empty() || firstCameraID >= pointClouds.size())
+            return false;
+
+        if(cameraCount == 0 || firstCameraID + cameraCount > pointClouds.size())
+            cameraCount = (unsigned int) pointClouds.size() - firstCameraID;
+
+        // The frame ID of camera 0 is used for all cameras, so that multiple
+        // senders replaying the same recording use the same frame IDs:
+        int sourceFrameID = pointClouds[0]->frameID;
+        if(sourceFrameID < lastSourceFrameID)
+            ++loopCount;
+        lastSourceFrameID = sourceFrameID;
+        int64_t frameID = (loopCount << 32) | uint32_t(sourceFrameID);
+
+        if(socket == nullptr && !connect(pointClouds))
+            return false;
+
+        for(unsigned int i = firstCameraID; i < firstCameraID + cameraCount; ++i){
+            const OrganizedPointCloud& pc = *pointClouds[i];
+
+            PointCloudStreamFrame frame;
+            frame.magic = POINT_CLOUD_STREAM_FRAME_MAGIC;
+            frame.cameraID = i;
+            frame.frameID = frameID;
+            frame.sendTime = getPointCloudStreamTime();
+            frame.timestamp = pc.timestamp;
+            frame.depthSize = uint32_t(size_t(pc.width) * pc.height * sizeof(uint16_t));
+            frame.colorSize = pc.colors != nullptr ? uint32_t(size_t(pc.width) * pc.height * sizeof(Vec4b)) : 0;
+
+            bool success = socket->sendAll(&frame, sizeof(frame))
+                && socket->sendAll(pc.depth, frame.depthSize)
+                && (frame.colorSize == 0 || socket->sendAll(pc.colors, frame.colorSize));
+
+            if(!success){
+                std::cerr << "Connection to " << host << ":" << port << " lost." << std::endl;
+                socket = nullptr;
+                return false;
+            }
+
+            sentBytes += sizeof(frame) + frame.depthSize + frame.colorSize;
+        }
+
+        ++sentFrames;
+        return true;
+    }
+
+    bool isConnected(){
+        return socket != nullptr;
+    }
+
+    unsigned long long getSentFrames(){
+        return sentFrames;
+    }
+
+    unsigned long long getSentBytes(){
+        return sentBytes;
+    }
+};
@@ -0,0 +1,76 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Wire format for streaming organized point clouds over TCP (see
+ * NetworkStreamer and PointCloudSender).
+ *
+ * Every sender (e.g. one per capture node) connects to the receiver and sends
+ * the cameras [firstCameraID, firstCameraID + cameraCount) of a setup with
+ * totalCameraCount cameras:
+ *
+ *   [PointCloudStreamHeader]
+ *   [PointCloudStreamCamera][lookupImageTo3D][lookup3DToImage]   (per camera)
+ *   [PointCloudStreamFrame][depth][color]                        (per camera and frame)
+ *
+ * Depth is width * height uint16_t (in mm), color is width * height BGRA (or
+ * missing if colorSize is 0). All values are little endian.
+ */
+
+#define POINT_CLOUD_STREAM_MAGIC "OPCSTR02"
+#define POINT_CLOUD_STREAM_FRAME_MAGIC 0x4d415246u // "FRAM"
+#define POINT_CLOUD_STREAM_DEFAULT_PORT 7300
+
+struct PointCloudStreamHeader {
+    char magic[8];
+
+    uint32_t totalCameraCount;
+    uint32_t firstCameraID;
+    uint32_t cameraCount;
+
+    /** Resolution of the (registered) depth and color images */
+    uint32_t width;
+    uint32_t height;
+
+    uint32_t lookup3DToImageSize;
+};
+
+struct PointCloudStreamCamera {
+    /** Transforms the point cloud positions from camera space into world space */
+    float modelMatrix[16];
+};
+
+struct PointCloudStreamFrame {
+    uint32_t magic;
+    uint32_t cameraID;
+
+    /** Frames of all cameras with the same frameID are assembled to one frame */
+    int64_t frameID;
+
+    /** Time of sending in microseconds (see getPointCloudStreamTime()) */
+    int64_t sendTime;
+
+    /** Device timestamp of the capture in seconds (see OrganizedPointCloud::timestamp, -1 if unknown) */
+    double timestamp;
+
+    uint32_t depthSize;
+    uint32_t colorSize;
+};
+
+static_assert(std::is_trivially_copyable<PointCloudStreamHeader>::value, "Header must be trivially copyable");
+static_assert(sizeof(PointCloudStreamHeader) == 32, "Unexpected padding in PointCloudStreamHeader");
+static_assert(sizeof(PointCloudStreamFrame) == 40, "Unexpected padding in PointCloudStreamFrame");
+
+/**
+ * Monotonic time in microseconds which is used to measure the end-to-end
+ * latency. It is shared between processes on the same machine only, so the
+ * latency is only meaningful when sender and receiver run on the same host.
+ */
+inline int64_t getPointCloudStreamTime(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
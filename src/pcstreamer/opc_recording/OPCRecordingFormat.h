@@ -0,0 +1,99 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Native on-disk format for organized point cloud recordings (*.opcr).
+ *
+ * The file stores already registered depth (uint16_t, in mm) and color (BGRA)
+ * images of every camera and frame, so that replaying a recording does not
+ * require decoding or color-to-depth registration anymore. All chunks are page
+ * aligned, which allows to memory-map the file and to hand out the images
+ * directly as OrganizedPointCloud views.
+ *
+ * Layout:
+ *   [OPCRecordingFileHeader]                     (at offset 0, padded to one page)
+ *   [lookupImageTo3D / lookup3DToImage chunks]   (per camera)
+ *   [depth chunk][color chunk] ...               (per camera and frame)
+ *   [OPCRecordingFrameEntry[frameCount]]         (per camera)
+ *   [OPCRecordingCameraHeader[cameraCount]]      (at cameraTableOffset)
+ */
+
+#define OPC_RECORDING_MAGIC "OPCREC01"
+#define OPC_RECORDING_VERSION 1
+#define OPC_RECORDING_PAGE_SIZE 4096
+
+/**
+ * Calibration of one RGB-D camera. The intrinsic parameters are stored in the
+ * order of the Azure Kinect SDK (cx, cy, fx, fy, k1, k2, k3, k4, k5, k6, codx,
+ * cody, p2, p1, metric_radius) using the Brown-Conrady (rational 6KT) model.
+ */
+struct OPCRecordingCalibration {
+    float depthIntrinsics[15];
+    int32_t depthWidth;
+    int32_t depthHeight;
+
+    float colorIntrinsics[15];
+    int32_t colorWidth;
+    int32_t colorHeight;
+
+    /** Extrinsics from depth to color camera (row-major rotation, translation in mm) */
+    float depthToColorRotation[9];
+    float depthToColorTranslation[3];
+};
+
+struct OPCRecordingCameraHeader {
+    /** Transforms the point cloud positions from camera space into world space */
+    float modelMatrix[16];
+
+    OPCRecordingCalibration calibration;
+
+    uint32_t frameCount;
+    uint32_t reserved;
+
+    /** Offset to width * height * 2 floats */
+    uint64_t lookupImageTo3DOffset;
+
+    /** Offset to lookup3DToImageSize * lookup3DToImageSize * 2 floats */
+    uint64_t lookup3DToImageOffset;
+
+    /** Offset to frameCount entries of OPCRecordingFrameEntry */
+    uint64_t frameTableOffset;
+};
+
+struct OPCRecordingFrameEntry {
+    /** Device timestamp in seconds */
+    double timestamp;
+
+    /** Offset to width * height uint16_t depth values */
+    uint64_t depthOffset;
+
+    /** Offset to width * height BGRA colors (0 if the frame has no colors) */
+    uint64_t colorOffset;
+
+    uint64_t reserved;
+};
+
+struct OPCRecordingFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t cameraCount;
+
+    /** Resolution of the (registered) depth and color images */
+    uint32_t width;
+    uint32_t height;
+
+    uint32_t lookup3DToImageSize;
+    uint32_t pageSize;
+
+    /** Offset to cameraCount entries of OPCRecordingCameraHeader */
+    uint64_t cameraTableOffset;
+};
+
+static_assert(std::is_trivially_copyable<OPCRecordingFileHeader>::value, "Header must be trivially copyable");
+static_assert(sizeof(OPCRecordingFileHeader) == 40, "Unexpected padding in OPCRecordingFileHeader");
+static_assert(sizeof(OPCRecordingFrameEntry) == 32, "Unexpected padding in OPCRecordingFrameEntry");
+static_assert(sizeof(OPCRecordingCameraHeader) % 8 == 0, "Unexpected padding in OPCRecordingCameraHeader");
@@ -0,0 +1,132 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "src/util/math/Mat4.h"
+#include "src/pcstreamer/opc_recording/OPCRecordingFormat.h"
+
+/**
+ * Writes an organized point cloud recording (*.opcr, see OPCRecordingFormat.h).
+ *
+ * Usage: setCamera(...) for every camera, then addFrame(...) for every frame
+ * of every camera (in the order of their timestamps) and finally finish().
+ */
+class OPCRecordingWriter {
+    std::ofstream file;
+
+    OPCRecordingFileHeader header;
+    std::vector<OPCRecordingCameraHeader> cameras;
+    std::vector<std::vector<OPCRecordingFrameEntry>> frameTables;
+
+    bool finished = false;
+
+    /**
+     * Appends a chunk at the next page aligned offset and returns the offset.
+     */
+    uint64_t writeChunk(const void* data, uint64_t size){
+        uint64_t offset = uint64_t(file.tellp());
+        uint64_t padding = (OPC_RECORDING_PAGE_SIZE - offset % OPC_RECORDING_PAGE_SIZE) % OPC_RECORDING_PAGE_SIZE;
+
+        static const char zeros[OPC_RECORDING_PAGE_SIZE] = {0};
+        file.write(zeros, std::streamsize(padding));
+        file.write((const char*) data, std::streamsize(size));
+
+        return offset + padding;
+    }
+
+public:
+    OPCRecordingWriter(std::string path, unsigned int cameraCount, unsigned int width, unsigned int height, unsigned int lookup3DToImageSize)
+        : file(path, std::ios::binary | std::ios::trunc)
+        , cameras(cameraCount)
+        , frameTables(cameraCount)
+    {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, OPC_RECORDING_MAGIC, 8);
+        header.version = OPC_RECORDING_VERSION;
+        header.cameraCount = cameraCount;
+        header.width = width;
+        header.height = height;
+        header.lookup3DToImageSize = lookup3DToImageSize;
+        header.pageSize = OPC_RECORDING_PAGE_SIZE;
+
+        for(OPCRecordingCameraHeader& camera : cameras)
+            std::memset(&camera, 0, sizeof(camera));
+
+        if(!file.is_open()){
+            std::cerr << "Failed to open recording for writing: " << path << std::endl;
+            return;
+        }
+
+        // Reserve the first page for the file header (written in finish()):
+        writeChunk(&header, sizeof(header));
+    }
+
+    ~OPCRecordingWriter(){
+        finish();
+    }
+
+    bool isValid(){
+        return file.is_open() && file.good();
+    }
+
+    /**
+     * Sets the static data of a camera. The lookup tables are copied into the file
+     * immediately.
+     */
+    void setCamera(unsigned int cameraID, const Mat4f& modelMatrix, const OPCRecordingCalibration& calibration, const float* lookupImageTo3D, const float* lookup3DToImage){
+        OPCRecordingCameraHeader& camera = cameras[cameraID];
+
+        std::memcpy(camera.modelMatrix, modelMatrix.data, sizeof(camera.modelMatrix));
+        camera.calibration = calibration;
+
+        camera.lookupImageTo3DOffset = writeChunk(lookupImageTo3D, uint64_t(header.width) * header.height * 2 * sizeof(float));
+        camera.lookup3DToImageOffset = writeChunk(lookup3DToImage, uint64_t(header.lookup3DToImageSize) * header.lookup3DToImageSize * 2 * sizeof(float));
+    }
+
+    /**
+     * Appends a frame of the given camera. Colors are in BGRA and can be null.
+     */
+    void addFrame(unsigned int cameraID, double timestamp, const uint16_t* depth, const void* colors){
+        OPCRecordingFrameEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+
+        uint64_t pixelCount = uint64_t(header.width) * header.height;
+
+        entry.timestamp = timestamp;
+        entry.depthOffset = writeChunk(depth, pixelCount * sizeof(uint16_t));
+        if(colors != nullptr)
+            entry.colorOffset = writeChunk(colors, pixelCount * 4);
+
+        frameTables[cameraID].push_back(entry);
+    }
+
+    /**
+     * Writes the frame tables, the camera table and the file header.
+     */
+    void finish(){
+        if(finished || !file.is_open())
+            return;
+        finished = true;
+
+        for(unsigned int cameraID = 0; cameraID < cameras.size(); ++cameraID){
+            std::vector<OPCRecordingFrameEntry>& frames = frameTables[cameraID];
+            cameras[cameraID].frameCount = uint32_t(frames.size());
+            cameras[cameraID].frameTableOffset = writeChunk(frames.data(), frames.size() * sizeof(OPCRecordingFrameEntry));
+        }
+
+        header.cameraTableOffset = writeChunk(cameras.data(), cameras.size() * sizeof(OPCRecordingCameraHeader));
+
+        // Pad the file to full pages, so that every chunk can be mapped completely:
+        writeChunk(nullptr, 0);
+
+        file.seekp(0);
+        file.write((const char*) &header, sizeof(header));
+        file.close();
+    }
+};
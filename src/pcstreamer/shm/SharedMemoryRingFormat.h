@@ -0,0 +1,130 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Layout of the shared memory ring which is used to hand over organized point
+ * clouds from a capture process on the same host (SharedMemoryRingProducer) to
+ * one or multiple consumers (SharedMemoryStreamer) without copying.
+ *
+ *   [SharedMemoryRingHeader]                            (padded to one page)
+ *   [SharedMemoryRingCamera[cameraCount]]               (padded to one page)
+ *   [lookupImageTo3D][lookup3DToImage]                  (per camera, page aligned)
+ *   [slot 0][slot 1]...[slot slotCount - 1]            (slotSize bytes each)
+ *
+ * Every slot holds one frame of all cameras:
+ *
+ *   [SharedMemoryRingSlot]                              (padded to one page)
+ *   [depth camera 0]...[depth camera n-1]               (page aligned)
+ *   [color camera 0]...[color camera n-1]               (page aligned)
+ *
+ * Synchronization (single producer, multiple consumers, lock-free):
+ *  - slot.state is 0 (empty), odd (being written) or 2 * sequence (published).
+ *  - A consumer increments slot.readerCount and then checks that the slot still
+ *    holds the expected sequence (else it backs off). It decrements readerCount
+ *    when it doesn't need the frame anymore.
+ *  - The producer marks a slot as being written and then checks that
+ *    readerCount is zero (else it restores the state and tries the next slot).
+ *    Both use sequentially consistent operations, so either the consumer sees
+ *    the odd state or the producer sees the reader: slots in use are never
+ *    overwritten.
+ *  - header.latest contains (sequence << 16) | slot of the newest frame.
+ */
+
+#define SHARED_MEMORY_RING_MAGIC "OPCSHM01"
+#define SHARED_MEMORY_RING_VERSION 1
+#define SHARED_MEMORY_RING_PAGE_SIZE 4096
+#define SHARED_MEMORY_RING_MAX_CAMERAS 32
+#define SHARED_MEMORY_RING_DEFAULT_NAME "blendpcr"
+
+struct SharedMemoryRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotCount;
+
+    uint32_t cameraCount;
+
+    /** Resolution of the (registered) depth and color images */
+    uint32_t width;
+    uint32_t height;
+    uint32_t lookup3DToImageSize;
+
+    uint64_t slotSize;
+    uint64_t slotsOffset;
+
+    /** Random ID of the producer instance, changes when the ring is recreated */
+    uint64_t sessionID;
+
+    /** (sequence << 16) | slot of the newest published frame (0 if none) */
+    std::atomic<uint64_t> latest;
+
+    /** Number of frames the producer dropped since all slots were in use */
+    std::atomic<uint64_t> droppedFrames;
+};
+
+struct SharedMemoryRingCamera {
+    /** Transforms the point cloud positions from camera space into world space */
+    float modelMatrix[16];
+
+    /** Offset to width * height * 2 floats */
+    uint64_t lookupImageTo3DOffset;
+
+    /** Offset to lookup3DToImageSize * lookup3DToImageSize * 2 floats */
+    uint64_t lookup3DToImageOffset;
+};
+
+struct SharedMemoryRingSlotCamera {
+    /** Device timestamp in seconds */
+    double timestamp;
+
+    /** Frame ID of the camera (e.g. in its recording) */
+    int32_t frameID;
+
+    /** 0 if the color image is not valid */
+    uint32_t hasColors;
+};
+
+struct SharedMemoryRingSlot {
+    std::atomic<uint64_t> state;
+    std::atomic<uint32_t> readerCount;
+    uint32_t reserved;
+
+    int64_t frameID;
+
+    /** Time of publishing in microseconds (see getSharedMemoryRingTime()) */
+    int64_t publishTime;
+
+    SharedMemoryRingSlotCamera cameras[SHARED_MEMORY_RING_MAX_CAMERAS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory ring requires lock-free 64 bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared memory ring requires lock-free 32 bit atomics");
+static_assert(sizeof(SharedMemoryRingHeader) <= SHARED_MEMORY_RING_PAGE_SIZE, "Header must fit into one page");
+static_assert(sizeof(SharedMemoryRingSlot) <= SHARED_MEMORY_RING_PAGE_SIZE, "Slot header must fit into one page");
+static_assert(sizeof(SharedMemoryRingCamera) * SHARED_MEMORY_RING_MAX_CAMERAS <= SHARED_MEMORY_RING_PAGE_SIZE, "Camera table must fit into one page");
+
+inline uint64_t alignToSharedMemoryPage(uint64_t offset){
+    return (offset + SHARED_MEMORY_RING_PAGE_SIZE - 1) / SHARED_MEMORY_RING_PAGE_SIZE * SHARED_MEMORY_RING_PAGE_SIZE;
+}
+
+/** Offset of the depth image of the given camera within a slot */
+inline uint64_t getSharedMemoryRingDepthOffset(const SharedMemoryRingHeader& header, unsigned int cameraID){
+    return SHARED_MEMORY_RING_PAGE_SIZE + cameraID * alignToSharedMemoryPage(uint64_t(header.width) * header.height * sizeof(uint16_t));
+}
+
+/** Offset of the color image of the given camera within a slot */
+inline uint64_t getSharedMemoryRingColorOffset(const SharedMemoryRingHeader& header, unsigned int cameraID){
+    return getSharedMemoryRingDepthOffset(header, header.cameraCount) + cameraID * alignToSharedMemoryPage(uint64_t(header.width) * header.height * 4);
+}
+
+/**
+ * Monotonic time in microseconds, shared between the processes on the same
+ * host, which is used to measure the handoff latency.
+ */
+inline int64_t getSharedMemoryRingTime(){
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,200 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <new>
+#include <random>
+#include <cstring>
+
+#include "src/util/OrganizedPointCloud.h"
+#include "src/util/SharedMemory.h"
+#include "src/pcstreamer/shm/SharedMemoryRingFormat.h"
+
+/**
+ * Producer side of the shared memory ring (see SharedMemoryRingFormat.h),
+ * which can be used by capture processes on the same host as BlendPCR.
+ *
+ * Usage: setCamera(...) for every camera, then for every frame either
+ * beginFrame(), write the images into getDepth(...) / getColors(...) (e.g.
+ * directly by the capture SDK) and publishFrame(), or just publish(pointClouds).
+ */
+class SharedMemoryRingProducer {
+    std::shared_ptr<SharedMemory> memory;
+    SharedMemoryRingHeader* header = nullptr;
+
+    uint64_t sequence = 0;
+    unsigned int nextSlot = 0;
+
+    /** Slot which is currently written (or -1) */
+    int writingSlot = -1;
+
+    SharedMemoryRingSlot* getSlot(unsigned int slotID){
+        return (SharedMemoryRingSlot*)(memory->data() + header->slotsOffset + slotID * header->slotSize);
+    }
+
+    SharedMemoryRingCamera* getCameras(){
+        return (SharedMemoryRingCamera*)(memory->data() + SHARED_MEMORY_RING_PAGE_SIZE);
+    }
+
+public:
+    /**
+     * Creates the ring with the given name. More slots allow consumers to hold
+     * more frames (e.g. one in the filter and one in the renderer) without
+     * making the producer drop frames.
+     */
+    SharedMemoryRingProducer(std::string name, unsigned int cameraCount, unsigned int width, unsigned int height, unsigned int lookup3DToImageSize, unsigned int slotCount = 6){
+        if(cameraCount == 0 || cameraCount > SHARED_MEMORY_RING_MAX_CAMERAS || slotCount == 0 || slotCount > 0xffff){
+            std::cerr << "Unsupported shared memory ring configuration." << std::endl;
+            return;
+        }
+
+        uint64_t lookupsSize = alignToSharedMemoryPage(uint64_t(width) * height * 2 * sizeof(float))
+            + alignToSharedMemoryPage(uint64_t(lookup3DToImageSize) * lookup3DToImageSize * 2 * sizeof(float));
+
+        SharedMemoryRingHeader layout;
+        layout.cameraCount = cameraCount;
+        layout.width = width;
+        layout.height = height;
+
+        uint64_t slotsOffset = 2 * SHARED_MEMORY_RING_PAGE_SIZE + cameraCount * lookupsSize;
+        uint64_t slotSize = getSharedMemoryRingColorOffset(layout, cameraCount);
+
+        memory = SharedMemory::create(name, slotsOffset + slotCount * slotSize);
+        if(memory == nullptr)
+            return;
+
+        // The memory of a new shared memory object is zero initialized:
+        header = new (memory->data()) SharedMemoryRingHeader();
+        std::memcpy(header->magic, SHARED_MEMORY_RING_MAGIC, 8);
+        header->version = SHARED_MEMORY_RING_VERSION;
+        header->slotCount = slotCount;
+        header->cameraCount = cameraCount;
+        header->width = width;
+        header->height = height;
+        header->lookup3DToImageSize = lookup3DToImageSize;
+        header->slotSize = slotSize;
+        header->slotsOffset = slotsOffset;
+        header->sessionID = std::random_device()() | (uint64_t(std::random_device()()) << 32);
+        header->latest.store(0);
+        header->droppedFrames.store(0);
+
+        for(unsigned int i = 0; i < cameraCount; ++i){
+            SharedMemoryRingCamera& camera = getCameras()[i];
+            camera.lookupImageTo3DOffset = 2 * SHARED_MEMORY_RING_PAGE_SIZE + i * lookupsSize;
+            camera.lookup3DToImageOffset = camera.lookupImageTo3DOffset + alignToSharedMemoryPage(uint64_t(width) * height * 2 * sizeof(float));
+        }
+
+        for(unsigned int i = 0; i < slotCount; ++i)
+            new (getSlot(i)) SharedMemoryRingSlot();
+    }
+
+    bool isValid(){
+        return header != nullptr;
+    }
+
+    /**
+     * Sets the model matrix and lookup tables of a camera. Must be called before
+     * the first frame is published.
+     */
+    void setCamera(unsigned int cameraID, const Mat4f& modelMatrix, const float* lookupImageTo3D, const float* lookup3DToImage){
+        SharedMemoryRingCamera& camera = getCameras()[cameraID];
+        std::memcpy(camera.modelMatrix, modelMatrix.data, sizeof(camera.modelMatrix));
+        std::memcpy(memory->data() + camera.lookupImageTo3DOffset, lookupImageTo3D, size_t(header->width) * header->height * 2 * sizeof(float));
+        std::memcpy(memory->data() + camera.lookup3DToImageOffset, lookup3DToImage, size_t(header->lookup3DToImageSize) * header->lookup3DToImageSize * 2 * sizeof(float));
+    }
+
+    /**
+     * Reserves a slot which is not used by any consumer. Returns false if all
+     * slots are in use (the frame has to be dropped).
+     */
+    bool beginFrame(){
+        for(unsigned int i = 0; i < header->slotCount; ++i){
+            unsigned int slotID = (nextSlot + i) % header->slotCount;
+            SharedMemoryRingSlot* slot = getSlot(slotID);
+
+            uint64_t state = slot->state.load();
+            slot->state.store(state | 1);
+
+            if(slot->readerCount.load() == 0){
+                writingSlot = int(slotID);
+                nextSlot = (slotID + 1) % header->slotCount;
+                return true;
+            }
+
+            slot->state.store(state);
+        }
+
+        header->droppedFrames.fetch_add(1);
+        return false;
+    }
+
+    /** Depth image of the given camera in the slot reserved by beginFrame() */
+    uint16_t* getDepth(unsigned int cameraID){
+        return (uint16_t*)((uint8_t*) getSlot(writingSlot) + getSharedMemoryRingDepthOffset(*header, cameraID));
+    }
+
+    /** BGRA color image of the given camera in the slot reserved by beginFrame() */
+    Vec4b* getColors(unsigned int cameraID){
+        return (Vec4b*)((uint8_t*) getSlot(writingSlot) + getSharedMemoryRingColorOffset(*header, cameraID));
+    }
+
+    /** Metadata of the given camera in the slot reserved by beginFrame() */
+    SharedMemoryRingSlotCamera& getSlotCamera(unsigned int cameraID){
+        return getSlot(writingSlot)->cameras[cameraID];
+    }
+
+    /**
+     * Makes the frame written since beginFrame() available to the consumers.
+     */
+    void publishFrame(int64_t frameID){
+        SharedMemoryRingSlot* slot = getSlot(writingSlot);
+        slot->frameID = frameID;
+        slot->publishTime = getSharedMemoryRingTime();
+
+        ++sequence;
+        slot->state.store(sequence * 2, std::memory_order_release);
+        header->latest.store((sequence << 16) | uint64_t(writingSlot), std::memory_order_release);
+        writingSlot = -1;
+    }
+
+    /**
+     * Copies the point clouds of all cameras into a free slot and publishes it.
+     * The cameras are set from the point clouds on the first call. Returns false
+     * if the frame was dropped.
+     */
+    bool publish(const std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds, int64_t frameID){
+        if(!isValid() || pointClouds.size() != header->cameraCount)
+            return false;
+
+        if(sequence == 0){
+            for(unsigned int i = 0; i < pointClouds.size(); ++i)
+                setCamera(i, pointClouds[i]->modelMatrix, pointClouds[i]->lookupImageTo3D, pointClouds[i]->lookup3DToImage);
+        }
+
+        if(!beginFrame())
+            return false;
+
+        size_t pixelCount = size_t(header->width) * header->height;
+        for(unsigned int i = 0; i < pointClouds.size(); ++i){
+            const OrganizedPointCloud& pc = *pointClouds[i];
+            std::memcpy(getDepth(i), pc.depth, pixelCount * sizeof(uint16_t));
+            if(pc.colors != nullptr)
+                std::memcpy(getColors(i), pc.colors, pixelCount * sizeof(Vec4b));
+
+            SharedMemoryRingSlotCamera& camera = getSlotCamera(i);
+            camera.timestamp = pc.timestamp;
+            camera.frameID = pc.frameID;
+            camera.hasColors = pc.colors != nullptr ? 1 : 0;
+        }
+
+        publishFrame(frameID);
+        return true;
+    }
+
+    uint64_t getDroppedFrames(){
+        return header->droppedFrames.load();
+    }
+};
@@ -0,0 +1,179 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/math/Vec4.h"
+
+/**
+ * A small animated analytic scene (y-up, in meters) which can be raycasted:
+ * a checkerboard floor, a rotating box in the center and two spheres orbiting
+ * around it (one of them bouncing).
+ *
+ * The scene only depends on the time, so the same time always results in the
+ * same images.
+ */
+class SyntheticScene {
+public:
+    /** Duration after which the animation repeats (in seconds) */
+    static constexpr float PERIOD = 12.f;
+
+private:
+    struct Sphere {
+        float x, y, z, radius;
+        Vec4b color;
+    };
+
+    std::vector<Sphere> spheres;
+
+    float boxCenter[3] = {0.f, 0.5f, 0.f};
+    float boxHalfExtent[3] = {0.25f, 0.5f, 0.25f};
+    float boxSin = 0.f;
+    float boxCos = 1.f;
+
+    /** Radius of the floor disk */
+    float floorRadius = 4.f;
+
+    /** Normalized direction towards the light */
+    float light[3] = {0.27f, 0.91f, 0.32f};
+
+    static Vec4b shade(Vec4b color, float nx, float ny, float nz, const float* light){
+        float intensity = 0.35f + 0.65f * std::max(0.f, nx * light[0] + ny * light[1] + nz * light[2]);
+        return Vec4b(uint8_t(color.x * intensity), uint8_t(color.y * intensity), uint8_t(color.z * intensity), 255);
+    }
+
+    bool raycastSphere(const Sphere& sphere, const float* o, const float* d, float& t, float* n) const {
+        float ox = o[0] - sphere.x, oy = o[1] - sphere.y, oz = o[2] - sphere.z;
+        float a = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        float b = ox * d[0] + oy * d[1] + oz * d[2];
+        float c = ox * ox + oy * oy + oz * oz - sphere.radius * sphere.radius;
+
+        float discriminant = b * b - a * c;
+        if(discriminant < 0.f)
+            return false;
+
+        float hit = (-b - std::sqrt(discriminant)) / a;
+        if(hit <= 0.f || hit >= t)
+            return false;
+
+        t = hit;
+        n[0] = (ox + d[0] * hit) / sphere.radius;
+        n[1] = (oy + d[1] * hit) / sphere.radius;
+        n[2] = (oz + d[2] * hit) / sphere.radius;
+        return true;
+    }
+
+    bool raycastBox(const float* o, const float* d, float& t, float* n) const {
+        // Transform the ray into the (y-rotated) local space of the box:
+        float ox = o[0] - boxCenter[0], oy = o[1] - boxCenter[1], oz = o[2] - boxCenter[2];
+        float lo[3] = {boxCos * ox - boxSin * oz, oy, boxSin * ox + boxCos * oz};
+        float ld[3] = {boxCos * d[0] - boxSin * d[2], d[1], boxSin * d[0] + boxCos * d[2]};
+
+        float tNear = 0.f, tFar = t;
+        int nearAxis = -1;
+        float nearSign = 0.f;
+
+        for(int axis = 0; axis < 3; ++axis){
+            if(std::abs(ld[axis]) < 1e-8f){
+                if(std::abs(lo[axis]) > boxHalfExtent[axis])
+                    return false;
+                continue;
+            }
+
+            float t0 = (-boxHalfExtent[axis] - lo[axis]) / ld[axis];
+            float t1 = (boxHalfExtent[axis] - lo[axis]) / ld[axis];
+            float sign = -1.f;
+            if(t0 > t1){
+                std::swap(t0, t1);
+                sign = 1.f;
+            }
+
+            if(t0 > tNear){
+                tNear = t0;
+                nearAxis = axis;
+                nearSign = sign;
+            }
+            tFar = std::min(tFar, t1);
+
+            if(tNear > tFar)
+                return false;
+        }
+
+        // Ray starts inside of the box:
+        if(nearAxis < 0)
+            return false;
+
+        float ln[3] = {0.f, 0.f, 0.f};
+        ln[nearAxis] = nearSign;
+
+        t = tNear;
+        n[0] = boxCos * ln[0] + boxSin * ln[2];
+        n[1] = ln[1];
+        n[2] = -boxSin * ln[0] + boxCos * ln[2];
+        return true;
+    }
+
+public:
+    SyntheticScene(){
+        update(0.f);
+    }
+
+    /**
+     * Moves the objects to their position at the given time (in seconds).
+     */
+    void update(float time){
+        float phase = 2.f * float(M_PI) * std::fmod(time, PERIOD) / PERIOD;
+
+        float boxAngle = phase;
+        boxSin = std::sin(boxAngle);
+        boxCos = std::cos(boxAngle);
+
+        // Colors are stored as BGRA (like the camera images):
+        spheres = {
+            {1.0f * std::cos(phase), 0.9f + 0.2f * std::sin(2.f * phase), 1.0f * std::sin(phase), 0.3f, Vec4b(60, 60, 220, 255)},
+            {0.65f * std::cos(-2.f * phase), 0.2f + 0.8f * std::abs(std::sin(3.f * phase)), 0.65f * std::sin(-2.f * phase), 0.2f, Vec4b(220, 120, 40, 255)}
+        };
+    }
+
+    /**
+     * Casts a ray from origin o into direction d (not necessarily normalized).
+     * Returns false if nothing was hit, else returns the ray parameter t (so the
+     * hit position is o + t * d) and the shaded BGRA color of the hit.
+     */
+    bool raycast(const float* o, const float* d, float& t, Vec4b& color) const {
+        t = 1e30f;
+        float n[3];
+        bool hit = false;
+
+        for(const Sphere& sphere : spheres){
+            if(raycastSphere(sphere, o, d, t, n)){
+                color = shade(sphere.color, n[0], n[1], n[2], light);
+                hit = true;
+            }
+        }
+
+        if(raycastBox(o, d, t, n)){
+            color = shade(Vec4b(90, 200, 90, 255), n[0], n[1], n[2], light);
+            hit = true;
+        }
+
+        // Floor (y = 0):
+        if(d[1] < 0.f){
+            float floorT = -o[1] / d[1];
+            float x = o[0] + floorT * d[0];
+            float z = o[2] + floorT * d[2];
+
+            if(floorT > 0.f && floorT < t && x * x + z * z < floorRadius * floorRadius){
+                t = floorT;
+                bool checker = (int(std::floor(x * 2.f)) + int(std::floor(z * 2.f))) & 1;
+                color = shade(checker ? Vec4b(200, 200, 200, 255) : Vec4b(110, 110, 110, 255), 0.f, 1.f, 0.f, light);
+                hit = true;
+            }
+        }
+
+        return hit;
+    }
+};
@@ -0,0 +1,312 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+/**
+ * Tests the vectorized CPU filters (Clipping, Spatial Hole Filler, Erosion,
+ * including their shortcuts like the depth intervals of the clipping or the
+ * certainly kept points of the erosion) against straightforward scalar
+ * implementations of their definitions, on frames of the synthetic scene with
+ * different resolutions, depth noise and filter intensities.
+ *
+ * Distances are compared in double precision, so only pixels whose distances
+ * are (almost) exactly at a threshold may differ.
+ *
+ * Returns 0 if all tests passed.
+ */
+
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcfilter/FilterExecutor.h"
+#include "src/pcfilter/ClippingFilter.h"
+#include "src/pcfilter/SpatialHoleFiller.h"
+#include "src/pcfilter/ErosionFilter.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <mutex>
+#include <condition_variable>
+
+static int failureCount = 0;
+
+static void check(bool condition, const std::string& message){
+    if(!condition){
+        std::cerr << "FAILED: " << message << std::endl;
+        ++failureCount;
+    }
+}
+
+/** Relative tolerance of the distances at the thresholds */
+static const double thresholdTolerance = 1e-4;
+
+/** Owned copy of the images of a camera */
+struct CameraImages {
+    std::vector<uint16_t> depth;
+    std::vector<Vec4b> colors;
+};
+
+/** Applies the filter to copies of the inputs and returns the outputs */
+static std::vector<CameraImages> applyFilter(std::shared_ptr<Filter> filter, std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds, const std::vector<CameraImages>& inputs){
+    for(size_t i = 0; i < pointClouds.size(); ++i){
+        std::copy(inputs[i].depth.begin(), inputs[i].depth.end(), pointClouds[i]->depth);
+        std::copy(inputs[i].colors.begin(), inputs[i].colors.end(), pointClouds[i]->colors);
+    }
+
+    FilterExecutor executor;
+    std::vector<std::shared_ptr<Filter>> filters = {filter};
+    executor.apply(filters, pointClouds);
+
+    std::vector<CameraImages> outputs;
+    for(std::shared_ptr<OrganizedPointCloud>& pc : pointClouds){
+        size_t pixelCount = size_t(pc->width) * pc->height;
+        outputs.push_back({std::vector<uint16_t>(pc->depth, pc->depth + pixelCount), std::vector<Vec4b>(pc->colors, pc->colors + pixelCount)});
+    }
+    return outputs;
+}
+
+/** Ray of the pixel (false if it's invalid) */
+static bool getRay(const OrganizedPointCloud& pc, size_t i, double& rayX, double& rayY){
+    rayX = pc.lookupImageTo3D[i * 2];
+    rayY = pc.lookupImageTo3D[i * 2 + 1];
+    return !std::isnan(rayX) && !std::isnan(rayY);
+}
+
+static void testClipping(const OrganizedPointCloud& pc, const CameraImages& input, const CameraImages& output, const ClippingFilter& filter, const std::string& name){
+    const float* m = pc.modelMatrix.data;
+    const double minimum[3] = {filter.clipMin.x, filter.clipMin.y, filter.clipMin.z};
+    const double maximum[3] = {filter.clipMax.x, filter.clipMax.y, filter.clipMax.z};
+
+    size_t wrongPixels = 0;
+    size_t removedPixels = 0;
+    for(size_t i = 0; i < input.depth.size(); ++i){
+        double rayX, rayY;
+        double z = input.depth[i];
+        bool isValid = z > 0.0 && getRay(pc, i, rayX, rayY);
+
+        // World space in meters, with a margin at the borders of the box:
+        bool isInside = isValid;
+        bool isOutside = !isValid;
+        for(int r = 0; r < 3 && isValid; ++r){
+            double world = (m[r] * rayX * z + m[4 + r] * rayY * z + m[8 + r] * z) * 0.001 + m[12 + r];
+            double margin = thresholdTolerance * (std::abs(world) + 1.0);
+            isInside = isInside && world >= minimum[r] + margin && world <= maximum[r] - margin;
+            isOutside = isOutside || world < minimum[r] - margin || world > maximum[r] + margin;
+        }
+
+        uint16_t depth = output.depth[i];
+        bool isWrong = (depth != input.depth[i] && depth != 0) || (isInside && depth == 0) || (isOutside && depth != 0);
+        wrongPixels += isWrong ? 1 : 0;
+        removedPixels += isValid && depth == 0 ? 1 : 0;
+    }
+
+    check(removedPixels > 0, name + ": the clipping didn't remove any point");
+    check(wrongPixels == 0, name + ": the clipping is wrong at " + std::to_string(wrongPixels) + " pixels");
+}
+
+static void testHoleFilling(const OrganizedPointCloud& pc, const CameraImages& input, const CameraImages& output, const SpatialHoleFiller& filter, const std::string& name){
+    int width = int(pc.width);
+    int height = int(pc.height);
+    int radius = filter.intensity;
+
+    size_t wrongPixels = 0;
+    size_t filledPixels = 0;
+    for(int y = 0; y < height; ++y){
+        for(int x = 0; x < width; ++x){
+            size_t p = size_t(y) * width + x;
+            double rayX, rayY;
+            bool isFillable = input.depth[p] < DEPTH_FILTER_MIN_DEPTH && getRay(pc, p, rayX, rayY);
+
+            int neighbors = 0;
+            int validNeighbors = 0;
+            double sumDistance = 0.0;
+            int sumColor[3] = {0, 0, 0};
+
+            for(int dY = -radius; dY <= radius && isFillable; ++dY){
+                for(int dX = -(radius - std::abs(dY)); dX <= radius - std::abs(dY); ++dX){
+                    int qX = x + dX;
+                    int qY = y + dY;
+                    if(qX < 0 || qX >= width || qY < 0 || qY >= height)
+                        continue;
+
+                    ++neighbors;
+                    size_t q = size_t(qY) * width + qX;
+                    double qRayX, qRayY;
+                    if(input.depth[q] < DEPTH_FILTER_MIN_DEPTH || !getRay(pc, q, qRayX, qRayY))
+                        continue;
+
+                    ++validNeighbors;
+                    sumDistance += input.depth[q] * std::sqrt(qRayX * qRayX + qRayY * qRayY + 1.0);
+                    sumColor[0] += input.colors[q].x;
+                    sumColor[1] += input.colors[q].y;
+                    sumColor[2] += input.colors[q].z;
+                }
+            }
+
+            const Vec4b& color = output.colors[p];
+            bool isFilled = isFillable && validNeighbors >= std::max(filter.requiredValidNeighborRatio * neighbors, 1.f);
+            bool isWrong;
+
+            if(isFilled){
+                double depth = sumDistance / (validNeighbors * std::sqrt(rayX * rayX + rayY * rayY + 1.0)) + 0.5;
+                isWrong = std::abs(double(output.depth[p]) - std::floor(std::min(depth, 65535.0))) > 1.0
+                    || color.x != sumColor[0] / validNeighbors || color.y != sumColor[1] / validNeighbors
+                    || color.z != sumColor[2] / validNeighbors || color.w != 255;
+                ++filledPixels;
+            } else {
+                const Vec4b& inputColor = input.colors[p];
+                isWrong = output.depth[p] != input.depth[p]
+                    || color.x != inputColor.x || color.y != inputColor.y || color.z != inputColor.z || color.w != inputColor.w;
+            }
+
+            wrongPixels += isWrong ? 1 : 0;
+        }
+    }
+
+    check(filledPixels > 0, name + ": the hole filler didn't fill any pixel");
+    check(wrongPixels == 0, name + ": the hole filling is wrong at " + std::to_string(wrongPixels) + " pixels");
+}
+
+static void testErosion(const OrganizedPointCloud& pc, const CameraImages& input, const CameraImages& output, const ErosionFilter& filter, const std::string& name){
+    int width = int(pc.width);
+    int height = int(pc.height);
+    int radius = filter.intensity;
+
+    size_t wrongPixels = 0;
+    size_t removedPixels = 0;
+    for(int y = 0; y < height; ++y){
+        for(int x = 0; x < width; ++x){
+            size_t p = size_t(y) * width + x;
+            double rayX, rayY;
+            double z = input.depth[p];
+            if(z == 0.0){
+                wrongPixels += output.depth[p] != 0 ? 1 : 0;
+                continue;
+            }
+
+            // The kernel removes points with an invalid ray, since none of their neighbors is close:
+            if(!getRay(pc, p, rayX, rayY))
+                rayX = rayY = 0.0;
+
+            double maxDistance = double(filter.distanceThresholdPerMeter) * z;
+            int neighbors = 0;
+            int certainlyClose = 0;
+            int possiblyClose = 0;
+
+            for(int dY = -radius; dY <= radius; ++dY){
+                for(int dX = -radius; dX <= radius; ++dX){
+                    int qX = x + dX;
+                    int qY = y + dY;
+                    if(qX < 0 || qX >= width || qY < 0 || qY >= height)
+                        continue;
+
+                    ++neighbors;
+                    size_t q = size_t(qY) * width + qX;
+                    double qRayX, qRayY;
+                    double qZ = input.depth[q];
+                    if(qZ < DEPTH_FILTER_MIN_DEPTH || !getRay(pc, q, qRayX, qRayY))
+                        continue;
+
+                    double diffX = qRayX * qZ - rayX * z;
+                    double diffY = qRayY * qZ - rayY * z;
+                    double squaredDistance = diffX * diffX + diffY * diffY + (qZ - z) * (qZ - z);
+
+                    certainlyClose += squaredDistance <= maxDistance * maxDistance * (1.0 - thresholdTolerance) ? 1 : 0;
+                    possiblyClose += squaredDistance <= maxDistance * maxDistance * (1.0 + thresholdTolerance) ? 1 : 0;
+                }
+            }
+
+            uint16_t depth = output.depth[p];
+            bool isWrong = (depth != input.depth[p] && depth != 0)
+                || (certainlyClose >= 0.5 * neighbors && depth == 0)
+                || (possiblyClose < 0.5 * neighbors && depth != 0);
+
+            wrongPixels += isWrong ? 1 : 0;
+            removedPixels += depth == 0 ? 1 : 0;
+
+            // The erosion doesn't change the colors:
+            const Vec4b& a = input.colors[p];
+            const Vec4b& b = output.colors[p];
+            wrongPixels += a.x != b.x || a.y != b.y || a.z != b.z || a.w != b.w ? 1 : 0;
+        }
+    }
+
+    check(removedPixels > 0, name + ": the erosion didn't remove any point");
+    check(wrongPixels == 0, name + ": the erosion is wrong at " + std::to_string(wrongPixels) + " pixels");
+}
+
+static void testFilters(const SyntheticCameraConfig& config, int intensity, const std::string& name){
+    std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
+    std::mutex mutex;
+    std::condition_variable frameReceived;
+
+    // The streamer owns the lookup tables, so it's kept until the end:
+    SyntheticStreamer streamer(config);
+    streamer.frameRate = 0.f;
+    streamer.setCallback([&](std::vector<std::shared_ptr<OrganizedPointCloud>> frame){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(pointClouds.empty())
+            pointClouds = frame;
+        frameReceived.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        frameReceived.wait(lock, [&](){ return !pointClouds.empty(); });
+    }
+    streamer.setPlaying(false);
+
+    // Single missing pixels (like the ones of real depth sensors), so that there are holes to fill on the surfaces:
+    std::vector<CameraImages> inputs;
+    for(std::shared_ptr<OrganizedPointCloud>& pc : pointClouds){
+        size_t pixelCount = size_t(pc->width) * pc->height;
+        inputs.push_back({std::vector<uint16_t>(pc->depth, pc->depth + pixelCount), std::vector<Vec4b>(pc->colors, pc->colors + pixelCount)});
+
+        for(size_t i = 0; i < pixelCount; i += 37)
+            inputs.back().depth[i] = 0;
+    }
+
+    // A box which cuts through the scene:
+    std::shared_ptr<ClippingFilter> clipping = std::make_shared<ClippingFilter>();
+    clipping->clipMin = Vec4f(-0.5f, 0.3f, -0.6f, 0.f);
+    clipping->clipMax = Vec4f(0.7f, 1.6f, 0.8f, 0.f);
+
+    std::shared_ptr<SpatialHoleFiller> holeFiller = std::make_shared<SpatialHoleFiller>();
+    holeFiller->intensity = intensity;
+
+    std::shared_ptr<ErosionFilter> erosion = std::make_shared<ErosionFilter>();
+    erosion->intensity = intensity;
+
+    std::vector<CameraImages> clipped = applyFilter(clipping, pointClouds, inputs);
+    std::vector<CameraImages> filled = applyFilter(holeFiller, pointClouds, inputs);
+    std::vector<CameraImages> eroded = applyFilter(erosion, pointClouds, inputs);
+
+    for(size_t i = 0; i < pointClouds.size(); ++i){
+        std::string cameraName = name + ", camera " + std::to_string(i);
+        testClipping(*pointClouds[i], inputs[i], clipped[i], *clipping, cameraName);
+        testHoleFilling(*pointClouds[i], inputs[i], filled[i], *holeFiller, cameraName);
+        testErosion(*pointClouds[i], inputs[i], eroded[i], *erosion, cameraName);
+    }
+}
+
+int main(){
+    SyntheticCameraConfig config;
+    config.cameraCount = 2;
+
+    testFilters(config, 2, "640x576");
+
+    // Noisy surfaces, of which the erosion can't decide all points by its shortcut:
+    config.depthNoise = 40.f;
+    testFilters(config, 1, "640x576, noise 40, intensity 1");
+    testFilters(config, 3, "640x576, noise 40, intensity 3");
+
+    // Neither the width nor the height is a multiple of the strip height or the SIMD width:
+    config.depthNoise = 10.f;
+    config.width = 317;
+    config.height = 203;
+    testFilters(config, 2, "317x203, noise 10");
+
+    if(failureCount == 0)
+        std::cout << "All CPU filter tests passed." << std::endl;
+
+    return failureCount == 0 ? 0 : 1;
+}
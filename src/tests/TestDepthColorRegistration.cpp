@@ -0,0 +1,217 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+/**
+ * Registers the color image of a frame of a CWIPC-SXR recording (.mkv) to its
+ * depth image with k4a_transformation_color_image_to_depth_camera and with
+ * DepthColorRegistration, compares the registered colors per pixel and
+ * measures the time of both.
+ *
+ * Fails if the colors of more than maxColorMismatch of the pixels which are
+ * valid in both images differ by more than colorTolerance (per channel), or if
+ * more than maxValidityMismatch of the depth pixels are valid in only one of
+ * the images (e.g. a different occlusion handling at depth edges).
+ *
+ * Usage: BlendPCR-test-registration <recording.mkv> [frame] [iterations]
+ *
+ * Returns 0 if the registrations match.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include <k4a/k4a.h>
+#include <k4arecord/playback.h>
+
+#include "src/pcstreamer/azure_mkv/DepthColorRegistration.h"
+
+static const int colorTolerance = 16;
+static const double maxColorMismatch = 0.01;
+static const double maxValidityMismatch = 0.02;
+
+/** Returns the first capture with a depth and a color image at or after the given frame (nullptr if none) */
+static k4a_capture_t readCapture(k4a_playback_t playback, int frame){
+    k4a_capture_t capture = nullptr;
+    for(int f = 0; k4a_playback_get_next_capture(playback, &capture) == K4A_STREAM_RESULT_SUCCEEDED; ++f){
+        k4a_image_t depth = k4a_capture_get_depth_image(capture);
+        k4a_image_t color = k4a_capture_get_color_image(capture);
+        bool isComplete = depth != nullptr && color != nullptr;
+
+        if(depth != nullptr)
+            k4a_image_release(depth);
+        if(color != nullptr)
+            k4a_image_release(color);
+
+        if(f >= frame && isComplete)
+            return capture;
+
+        k4a_capture_release(capture);
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        std::cerr << "Usage: " << argv[0] << " <recording.mkv> [frame] [iterations]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    int frame = argc > 2 ? std::max(std::stoi(argv[2]), 0) : 30;
+    int iterations = argc > 3 ? std::max(std::stoi(argv[3]), 1) : 20;
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](Clock::time_point start, Clock::time_point end){
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    };
+
+    k4a_playback_t playback;
+    k4a_calibration_t calibration;
+    if(k4a_playback_open(path.c_str(), &playback) != K4A_RESULT_SUCCEEDED){
+        std::cerr << "Could not open the recording: " << path << std::endl;
+        return 1;
+    }
+
+    // Let the SDK decode the color images, so both registrations get the same BGRA image:
+    if(k4a_playback_get_calibration(playback, &calibration) != K4A_RESULT_SUCCEEDED
+        || k4a_playback_set_color_conversion(playback, K4A_IMAGE_FORMAT_COLOR_BGRA32) != K4A_RESULT_SUCCEEDED){
+        std::cerr << "Could not read the calibration of the recording." << std::endl;
+        k4a_playback_close(playback);
+        return 1;
+    }
+
+    k4a_capture_t capture = readCapture(playback, frame);
+    if(capture == nullptr){
+        std::cerr << "The recording has no frame with depth and color at or after frame " << frame << "." << std::endl;
+        k4a_playback_close(playback);
+        return 1;
+    }
+
+    k4a_image_t depthImage = k4a_capture_get_depth_image(capture);
+    k4a_image_t colorImage = k4a_capture_get_color_image(capture);
+
+    int width = k4a_image_get_width_pixels(depthImage);
+    int height = k4a_image_get_height_pixels(depthImage);
+    int colorWidth = k4a_image_get_width_pixels(colorImage);
+    int colorHeight = k4a_image_get_height_pixels(colorImage);
+    size_t pixelCount = size_t(width) * height;
+
+    // Rays of the depth pixels, like AzureKinectMKVStream computes them:
+    std::vector<float> lookupImageTo3D(pixelCount * 2);
+    for(int y = 0; y < height; ++y){
+        for(int x = 0; x < width; ++x){
+            size_t idx = size_t(y) * width + x;
+            k4a_float2_t p;
+            k4a_float3_t ray;
+            p.xy.x = (float) x;
+            p.xy.y = (float) y;
+
+            int valid;
+            k4a_calibration_2d_to_3d(&calibration, &p, 1.f, K4A_CALIBRATION_TYPE_DEPTH, K4A_CALIBRATION_TYPE_DEPTH, &ray, &valid);
+            lookupImageTo3D[idx * 2] = valid ? ray.xyz.x : nanf("");
+            lookupImageTo3D[idx * 2 + 1] = valid ? ray.xyz.y : nanf("");
+        }
+    }
+
+    // Registration by the SDK:
+    std::vector<Vec4b> k4aColors(pixelCount);
+    k4a_transformation_t transformation = k4a_transformation_create(&calibration);
+    k4a_image_t k4aImage;
+    k4a_image_create_from_buffer(K4A_IMAGE_FORMAT_COLOR_BGRA32, width, height, width * 4, (uint8_t*) k4aColors.data(), pixelCount * sizeof(Vec4b), nullptr, nullptr, &k4aImage);
+
+    bool k4aRegistered = true;
+    auto startTime = Clock::now();
+    for(int i = 0; i < iterations; ++i)
+        k4aRegistered &= k4a_transformation_color_image_to_depth_camera(transformation, depthImage, colorImage, k4aImage) == K4A_RESULT_SUCCEEDED;
+    float k4aTime = milliseconds(startTime, Clock::now()) / iterations;
+
+    // Registration on the CPU (the first call fills the pool):
+    std::vector<Vec4b> cpuColors(pixelCount);
+    BufferPool pool;
+    DepthColorRegistration registration(calibration, lookupImageTo3D.data());
+
+    const uint16_t* depth = (const uint16_t*) k4a_image_get_buffer(depthImage);
+    const Vec4b* colors = (const Vec4b*) k4a_image_get_buffer(colorImage);
+    bool cpuRegistered = registration.registerColors(depth, colors, colorWidth, colorHeight, cpuColors.data(), pool);
+
+    startTime = Clock::now();
+    for(int i = 0; i < iterations && cpuRegistered; ++i)
+        cpuRegistered &= registration.registerColors(depth, colors, colorWidth, colorHeight, cpuColors.data(), pool);
+    float cpuTime = milliseconds(startTime, Clock::now()) / iterations;
+
+    k4a_image_release(k4aImage);
+    k4a_transformation_destroy(transformation);
+
+    int result = 0;
+    if(!k4aRegistered || !cpuRegistered){
+        std::cerr << "FAILED: the " << (k4aRegistered ? "CPU registration" : "k4a transformation") << " failed." << std::endl;
+        result = 1;
+    } else {
+        // Compare the colors of the depth pixels (a pixel is invalid if it is zero):
+        size_t depthPixels = 0, bothValid = 0, validityMismatches = 0, colorMismatches = 0;
+        double differenceSum = 0.0;
+        int maxDifference = 0;
+
+        for(size_t i = 0; i < pixelCount; ++i){
+            if(depth[i] == 0)
+                continue;
+            ++depthPixels;
+
+            const uint8_t* a = (const uint8_t*) &k4aColors[i];
+            const uint8_t* b = (const uint8_t*) &cpuColors[i];
+            bool isValidA = a[0] != 0 || a[1] != 0 || a[2] != 0 || a[3] != 0;
+            bool isValidB = b[0] != 0 || b[1] != 0 || b[2] != 0 || b[3] != 0;
+
+            if(isValidA != isValidB){
+                ++validityMismatches;
+                continue;
+            }
+            if(!isValidA)
+                continue;
+
+            int difference = 0;
+            for(int c = 0; c < 3; ++c)
+                difference = std::max(difference, std::abs(int(a[c]) - int(b[c])));
+
+            ++bothValid;
+            differenceSum += difference;
+            maxDifference = std::max(maxDifference, difference);
+            colorMismatches += difference > colorTolerance ? 1 : 0;
+        }
+
+        double validityMismatch = depthPixels > 0 ? double(validityMismatches) / depthPixels : 0.0;
+        double colorMismatch = bothValid > 0 ? double(colorMismatches) / bothValid : 1.0;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "Recording: " << path << " (depth " << width << " x " << height << ", color " << colorWidth << " x " << colorHeight << ")" << std::endl
+                  << "k4a transformation: " << k4aTime << " ms / frame" << std::endl
+                  << "DepthColorRegistration: " << cpuTime << " ms / frame (" << std::setprecision(2) << k4aTime / std::max(cpuTime, 1e-6f) << "x)" << std::endl
+                  << "Pixels valid in both: " << bothValid << " of " << depthPixels << " depth pixels, valid in only one: " << validityMismatch * 100.0 << " %" << std::endl
+                  << "Color difference: " << (bothValid > 0 ? differenceSum / bothValid : 0.0) << " mean, " << maxDifference << " max, "
+                  << colorMismatch * 100.0 << " % above " << colorTolerance << std::endl;
+
+        if(colorMismatch > maxColorMismatch){
+            std::cerr << "FAILED: the colors of " << colorMismatch * 100.0 << " % of the pixels differ by more than " << colorTolerance << "." << std::endl;
+            result = 1;
+        }
+        if(validityMismatch > maxValidityMismatch){
+            std::cerr << "FAILED: " << validityMismatch * 100.0 << " % of the depth pixels are valid in only one registration." << std::endl;
+            result = 1;
+        }
+    }
+
+    k4a_image_release(depthImage);
+    k4a_image_release(colorImage);
+    k4a_capture_release(capture);
+    k4a_playback_close(playback);
+
+    if(result == 0)
+        std::cout << "The registrations match." << std::endl;
+
+    return result;
+}
@@ -0,0 +1,116 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+/**
+ * Tests that the FrameAssembler accepts the frames which the streams select
+ * for a timestamp (see findSynchronizedFrame), also if the timestamps of the
+ * cameras are offset against each other, so that no camera is considered late.
+ *
+ * Returns 0 if all tests passed.
+ */
+
+#include "src/pcstreamer/FrameAssembler.h"
+
+#include <iostream>
+#include <string>
+
+static int failureCount = 0;
+
+static void check(bool condition, const std::string& message){
+    if(!condition){
+        std::cerr << "FAILED: " << message << std::endl;
+        ++failureCount;
+    }
+}
+
+/** Timestamps of a camera at 30 Hz, starting at the given offset (without the dropped frame, if >= 0) */
+static std::vector<double> cameraTimestamps(double offset, int frameCount, int droppedFrame = -1){
+    std::vector<double> timestamps;
+    for(int f = 0; f < frameCount; ++f){
+        if(f != droppedFrame)
+            timestamps.push_back(1.0 + offset + f / 30.0);
+    }
+    return timestamps;
+}
+
+/**
+ * Plays back the cameras like the AzureKinectMKVStreamer: for every frame of
+ * camera 0, every camera selects its frame like AzureKinectMKVStream::syncImage
+ * and pushes it, then the frame is assembled. Returns the number of complete
+ * frames.
+ */
+static int playBack(const std::vector<std::vector<double>>& cameras, const std::string& name){
+    double tolerance = 0.0166;
+    FrameAssembler assembler((unsigned int) cameras.size(), tolerance);
+
+    int completeCount = 0;
+    int mismatchCount = 0;
+    for(double timestamp : cameras[0]){
+        std::vector<std::shared_ptr<OrganizedPointCloud>> served(cameras.size());
+
+        for(size_t i = 0; i < cameras.size(); ++i){
+            int frame = findSynchronizedFrame(cameras[i], timestamp, tolerance);
+            if(frame >= int(cameras[i].size()))
+                continue;
+
+            served[i] = std::make_shared<OrganizedPointCloud>(1, 1);
+            served[i]->frameID = frame;
+            assembler.push((unsigned int) i, cameras[i][frame], served[i]);
+        }
+
+        // All frames are pushed, so the frame must be assembled without waiting for the deadline:
+        bool complete;
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = assembler.assemble(timestamp, std::chrono::steady_clock::now(), complete);
+
+        bool isServed = pointClouds.size() == cameras.size();
+        for(size_t i = 0; i < cameras.size() && isServed; ++i)
+            isServed = served[i] == nullptr || pointClouds[i] == served[i];
+
+        mismatchCount += isServed ? 0 : 1;
+        completeCount += complete ? 1 : 0;
+    }
+
+    check(mismatchCount == 0, name + ": " + std::to_string(mismatchCount) + " assembled frames don't consist of the served frames");
+    return completeCount;
+}
+
+int main(){
+    const int frameCount = 60;
+
+    // Offsets of the second camera, also more than the tolerance (up to half a frame):
+    for(double offset : {0.0, 0.005, -0.012, 0.0167, -0.0167, 0.025}){
+        std::string name = "offset " + std::to_string(offset * 1000.0) + " ms";
+        int completeCount = playBack({cameraTimestamps(0.0, frameCount), cameraTimestamps(offset, frameCount + 1)}, name);
+        check(completeCount == frameCount, name + ": " + std::to_string(frameCount - completeCount) + " of " + std::to_string(frameCount) + " frames are incomplete");
+    }
+
+    // A dropped frame of the second camera is replaced by its next frame:
+    {
+        std::string name = "dropped frame";
+        int completeCount = playBack({cameraTimestamps(0.0, frameCount), cameraTimestamps(0.008, frameCount + 1, 20)}, name);
+        check(completeCount == frameCount, name + ": " + std::to_string(frameCount - completeCount) + " of " + std::to_string(frameCount) + " frames are incomplete");
+    }
+
+    // A camera which delivers nothing is late, its last frame is reused:
+    {
+        FrameAssembler assembler(2, 0.0166, LateCameraPolicy::ReuseLastFrame);
+        std::shared_ptr<OrganizedPointCloud> first[2] = {std::make_shared<OrganizedPointCloud>(1, 1), std::make_shared<OrganizedPointCloud>(1, 1)};
+        std::shared_ptr<OrganizedPointCloud> second = std::make_shared<OrganizedPointCloud>(1, 1);
+
+        bool complete;
+        assembler.push(0, 1.0, first[0]);
+        assembler.push(1, 1.01, first[1]);
+        assembler.assemble(1.0, std::chrono::steady_clock::now(), complete);
+        check(complete, "late camera: the first frame is incomplete");
+
+        assembler.push(0, 1.0 + 1.0 / 30.0, second);
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = assembler.assemble(1.0 + 1.0 / 30.0, std::chrono::steady_clock::now() + std::chrono::milliseconds(10), complete);
+        check(!complete, "late camera: the second frame is complete");
+        check(pointClouds[0] == second && pointClouds[1] == first[1], "late camera: the last frame of the late camera isn't reused");
+    }
+
+    if(failureCount == 0)
+        std::cout << "All FrameAssembler tests passed." << std::endl;
+
+    return failureCount == 0 ? 0 : 1;
+}
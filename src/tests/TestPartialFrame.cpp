@@ -0,0 +1,144 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+/**
+ * Tests frames in which cameras are missing end to end: the FrameAssembler
+ * emits frames with inactive cameras (nullptr, LateCameraPolicy::MarkInactive)
+ * after the deadline, which are filtered (with the temporal filter) and rendered by every renderer in a headless OpenGL context (see
+ * HeadlessContext), like the GUI does.
+ *
+ * Returns 0 if all tests passed.
+ */
+
+#include "src/util/gl/HeadlessContext.h"
+
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcstreamer/FrameAssembler.h"
+#include "src/pcfilter/FilterExecutor.h"
+#include "src/pcfilter/ClippingFilter.h"
+#include "src/pcfilter/SpatialHoleFiller.h"
+#include "src/pcfilter/ErosionFilter.h"
+#include "src/pcfilter/TemporalDenoisingFilter.h"
+#include "src/pcrenderer/Renderer.h"
+#include "src/pcrenderer/BlendPCR.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+static int failureCount = 0;
+
+static void check(bool condition, const std::string& message){
+    if(!condition){
+        std::cerr << "FAILED: " << message << std::endl;
+        ++failureCount;
+    }
+}
+
+int main(){
+    const unsigned int cameraCount = 3;
+
+    HeadlessContext context;
+    context.resize(160, 120);
+
+    // Frames of the synthetic scene (the streamer owns the lookup tables, so it's kept until the end):
+    SyntheticCameraConfig config;
+    config.cameraCount = cameraCount;
+
+    std::vector<std::vector<std::shared_ptr<OrganizedPointCloud>>> frames;
+    std::mutex mutex;
+    std::condition_variable frameReceived;
+
+    SyntheticStreamer streamer(config);
+    streamer.frameRate = 0.f;
+    streamer.setCallback([&](std::vector<std::shared_ptr<OrganizedPointCloud>> frame){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(frames.size() < 4)
+            frames.push_back(frame);
+        frameReceived.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        frameReceived.wait(lock, [&](){ return frames.size() >= 4; });
+    }
+    streamer.setPlaying(false);
+
+    // Camera 2 is missing in the first frame, camera 0 in the second, all in the third,
+    // and no camera in the last one:
+    std::vector<std::vector<bool>> delivered = {{true, true, false}, {false, true, true}, {true, true, true}, {false, false, false}};
+
+    FrameAssembler assembler(cameraCount, 0.0166, LateCameraPolicy::MarkInactive);
+    std::vector<std::vector<std::shared_ptr<OrganizedPointCloud>>> assembled;
+
+    for(size_t f = 0; f < frames.size(); ++f){
+        double timestamp = 1.0 + f / 30.0;
+        for(unsigned int i = 0; i < cameraCount; ++i){
+            if(delivered[f][i])
+                assembler.push(i, timestamp, frames[f][i]);
+        }
+
+        // The deadline has passed, so the missing cameras are late:
+        bool complete;
+        std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds = assembler.assemble(timestamp, std::chrono::steady_clock::now(), complete);
+
+        check(pointClouds.size() == cameraCount, "frame " + std::to_string(f) + ": the frame has " + std::to_string(pointClouds.size()) + " cameras");
+        check(complete == (f == 2), "frame " + std::to_string(f) + ": the frame is " + (complete ? "complete" : "incomplete"));
+        for(unsigned int i = 0; i < cameraCount && i < pointClouds.size(); ++i)
+            check((pointClouds[i] != nullptr) == delivered[f][i], "frame " + std::to_string(f) + ": camera " + std::to_string(i) + " is " + (delivered[f][i] ? "missing" : "not inactive"));
+
+        assembled.push_back(pointClouds);
+    }
+
+    // Filter the frames (the missing cameras must stay missing):
+    std::vector<std::shared_ptr<Filter>> filters = {
+        std::make_shared<ClippingFilter>(),
+        std::make_shared<SpatialHoleFiller>(),
+        std::make_shared<ErosionFilter>(),
+        std::make_shared<TemporalDenoisingFilter>()
+    };
+
+    FilterExecutor executor;
+    for(size_t f = 0; f < assembled.size(); ++f){
+        executor.apply(filters, assembled[f]);
+
+        for(unsigned int i = 0; i < cameraCount; ++i)
+            check((assembled[f][i] != nullptr) == delivered[f][i], "filtered frame " + std::to_string(f) + ": camera " + std::to_string(i) + " changed its presence");
+    }
+
+    // Render the frames with every renderer:
+    Mat4f projection = Mat4f::perspectiveTransformation(160.f / 120.f, 75.f);
+    Mat4f view = Mat4f::translation(0.f, 0.f, -1.3f) * Mat4f::translation(0.f, -1.1f, 0.f);
+
+    for(unsigned int type = 0; type < Renderer::availableAlgorithmNum; ++type){
+        std::string name = Renderer::availableAlgorithmNames[type];
+        std::shared_ptr<Renderer> renderer = Renderer::constructAlgorithmInstance(type);
+        if(renderer == nullptr)
+            continue;
+
+        if(std::shared_ptr<BlendPCR> blendPCR = std::dynamic_pointer_cast<BlendPCR>(renderer)){
+            blendPCR->result_width = 160;
+            blendPCR->result_height = 120;
+        }
+
+        for(size_t f = 0; f < assembled.size(); ++f){
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, 160, 120);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            renderer->integratePointClouds(assembled[f]);
+            renderer->render(projection, view);
+
+            glFinish();
+            GLenum error = glGetError();
+            check(error == GL_NO_ERROR, name + ", frame " + std::to_string(f) + ": OpenGL error " + std::to_string(error));
+        }
+    }
+
+    if(failureCount == 0)
+        std::cout << "All partial frame tests passed." << std::endl;
+
+    return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+/**
+ * Tests that the fused CPU filter chain (Clipping, Spatial Hole Filler,
+ * Erosion, see StencilChain) produces exactly the same depth and colors as the
+ * same filters applied one after another by FilterExecutor, on frames of the synthetic scene
+ * with different resolutions (also ones which aren't a multiple of the strip
+ * height) and filter intensities.
+ *
+ * Returns 0 if all tests passed.
+ */
+
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcfilter/FilterExecutor.h"
+#include "src/pcfilter/ClippingFilter.h"
+#include "src/pcfilter/SpatialHoleFiller.h"
+#include "src/pcfilter/ErosionFilter.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+static int failureCount = 0;
+
+static void check(bool condition, const std::string& message){
+    if(!condition){
+        std::cerr << "FAILED: " << message << std::endl;
+        ++failureCount;
+    }
+}
+
+/** Owned copy of the images of a camera */
+struct CameraImages {
+    std::vector<uint16_t> depth;
+    std::vector<Vec4b> colors;
+};
+
+/**
+ * Filters a frame of the synthetic scene with the given configuration
+ * unfused and fused (a few times, so the reused buffers are tested as well)
+ * and checks that the outputs are identical.
+ */
+static void testFusion(const SyntheticCameraConfig& config, int intensity, const std::string& name){
+    std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
+    std::mutex mutex;
+    std::condition_variable frameReceived;
+
+    // The streamer owns the lookup tables, so it's kept until the end:
+    SyntheticStreamer streamer(config);
+    streamer.frameRate = 0.f;
+    streamer.setCallback([&](std::vector<std::shared_ptr<OrganizedPointCloud>> frame){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(pointClouds.empty())
+            pointClouds = frame;
+        frameReceived.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        frameReceived.wait(lock, [&](){ return !pointClouds.empty(); });
+    }
+    streamer.setPlaying(false);
+
+    size_t pixelCount = size_t(config.width) * config.height;
+    std::vector<CameraImages> inputs(pointClouds.size());
+    for(size_t i = 0; i < pointClouds.size(); ++i){
+        inputs[i].depth.assign(pointClouds[i]->depth, pointClouds[i]->depth + pixelCount);
+        inputs[i].colors.assign(pointClouds[i]->colors, pointClouds[i]->colors + pixelCount);
+    }
+
+    std::shared_ptr<SpatialHoleFiller> holeFiller = std::make_shared<SpatialHoleFiller>();
+    std::shared_ptr<ErosionFilter> erosion = std::make_shared<ErosionFilter>();
+    holeFiller->intensity = intensity;
+    erosion->intensity = intensity;
+    std::vector<std::shared_ptr<Filter>> filters = {std::make_shared<ClippingFilter>(), holeFiller, erosion};
+
+    std::vector<StencilFilter*> stencilFilters;
+    for(std::shared_ptr<Filter>& filter : filters)
+        stencilFilters.push_back(static_cast<StencilFilter*>(filter.get()));
+
+    FilterExecutor executor;
+    StencilChain stencilChain;
+    std::vector<std::vector<CameraImages>> outputs(2);
+
+    for(int mode = 0; mode < 2; ++mode){
+
+        for(int repetition = 0; repetition < 2; ++repetition){
+            for(size_t i = 0; i < pointClouds.size(); ++i){
+                std::copy(inputs[i].depth.begin(), inputs[i].depth.end(), pointClouds[i]->depth);
+                std::copy(inputs[i].colors.begin(), inputs[i].colors.end(), pointClouds[i]->colors);
+            }
+            if(mode == 0){
+                executor.apply(filters, pointClouds);
+            } else {
+                for(unsigned int cameraID = 0; cameraID < pointClouds.size(); ++cameraID)
+                    stencilChain.apply(stencilFilters, *pointClouds[cameraID], cameraID);
+            }
+        }
+
+        for(std::shared_ptr<OrganizedPointCloud>& pc : pointClouds)
+            outputs[mode].push_back({std::vector<uint16_t>(pc->depth, pc->depth + pixelCount), std::vector<Vec4b>(pc->colors, pc->colors + pixelCount)});
+    }
+
+    size_t changedPixels = 0;
+    size_t differentPixels = 0;
+    for(size_t i = 0; i < pointClouds.size(); ++i){
+        for(size_t p = 0; p < pixelCount; ++p){
+            const Vec4b& a = outputs[0][i].colors[p];
+            const Vec4b& b = outputs[1][i].colors[p];
+            bool isEqual = outputs[0][i].depth[p] == outputs[1][i].depth[p] && a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+
+            differentPixels += isEqual ? 0 : 1;
+            changedPixels += outputs[0][i].depth[p] != inputs[i].depth[p] ? 1 : 0;
+        }
+    }
+
+    // Otherwise the comparison wouldn't test anything:
+    check(changedPixels > 0, name + ": the filters didn't change any pixel");
+    check(differentPixels == 0, name + ": " + std::to_string(differentPixels) + " pixels differ between the fused and the unfused filters");
+}
+
+int main(){
+    SyntheticCameraConfig config;
+    config.cameraCount = 2;
+
+    testFusion(config, 2, "640x576");
+    testFusion(config, 1, "640x576, intensity 1");
+    testFusion(config, 3, "640x576, intensity 3");
+
+    // Neither the width nor the height is a multiple of the strip height or the SIMD width:
+    config.width = 317;
+    config.height = 203;
+    testFusion(config, 2, "317x203");
+
+    config.cameraCount = 1;
+    config.width = 64;
+    config.height = 5;
+    testFusion(config, 3, "64x5");
+
+    if(failureCount == 0)
+        std::cout << "All stencil fusion tests passed." << std::endl;
+
+    return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+/**
+ * Tests DepthColorRegistration without a recording: a synthetic calibration
+ * (pinhole depth camera, Brown-Conrady color camera which is rotated and
+ * shifted against it) looks at a plane of constant depth. The color image is
+ * a gradient whose red and green channels are the pixel coordinates, so the
+ * registered color of a depth pixel tells where it was sampled. That position
+ * is compared with the projection of the depth pixel computed analytically (in
+ * double precision), for the full and the reduced color resolutions.
+ *
+ * Returns 0 if all tests passed.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include <k4a/k4a.h>
+
+#include "src/pcstreamer/azure_mkv/DepthColorRegistration.h"
+
+static int failureCount = 0;
+
+static void check(bool condition, const std::string& message){
+    if(!condition){
+        std::cerr << "FAILED: " << message << std::endl;
+        ++failureCount;
+    }
+}
+
+/** The registered gradient may differ by this much from the projected position (in color pixels) */
+static const double positionTolerance = 1.0;
+
+/** Pixels which project closer than this to the border of the color image aren't checked for validity */
+static const double borderMargin = 0.01;
+
+/** Depth camera with square pixels (rays x/z = (x - cx) / f) */
+static const unsigned int depthWidth = 160;
+static const unsigned int depthHeight = 120;
+static const double depthFocalLength = 120.0;
+
+/** Returns a calibration of a depth and a color camera with the given distortion of the color camera */
+static k4a_calibration_t createCalibration(float k1, float k2, float p1, float p2){
+    k4a_calibration_t calibration = {};
+
+    calibration.depth_camera_calibration.resolution_width = depthWidth;
+    calibration.depth_camera_calibration.resolution_height = depthHeight;
+
+    k4a_calibration_camera_t& color = calibration.color_camera_calibration;
+    color.resolution_width = 256;
+    color.resolution_height = 192;
+    color.intrinsics.type = K4A_CALIBRATION_LENS_DISTORTION_MODEL_BROWN_CONRADY;
+    color.intrinsics.parameter_count = 14;
+    color.intrinsics.parameters.param.fx = 200.f;
+    color.intrinsics.parameters.param.fy = 205.f;
+    color.intrinsics.parameters.param.cx = 127.5f;
+    color.intrinsics.parameters.param.cy = 95.f;
+    color.intrinsics.parameters.param.k1 = k1;
+    color.intrinsics.parameters.param.k2 = k2;
+    color.intrinsics.parameters.param.p1 = p1;
+    color.intrinsics.parameters.param.p2 = p2;
+    color.metric_radius = 1.7f;
+
+    // Rotated by 3 degrees around the y axis and shifted by 32 mm (like the color camera of a Kinect):
+    float angle = 3.f * 3.14159265f / 180.f;
+    k4a_calibration_extrinsics_t& extrinsics = calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_COLOR];
+    float rotation[9] = {std::cos(angle), 0.f, std::sin(angle), 0.f, 1.f, 0.f, -std::sin(angle), 0.f, std::cos(angle)};
+    std::copy(rotation, rotation + 9, extrinsics.rotation);
+    extrinsics.translation[0] = -32.f;
+    extrinsics.translation[1] = -2.f;
+    extrinsics.translation[2] = 4.f;
+
+    return calibration;
+}
+
+/**
+ * Projects the point of the depth pixel at the given depth (in millimeters)
+ * into the color image reduced by the scale (see registerColors). Returns
+ * false if it isn't in front of the color camera or outside of its radius.
+ */
+static bool projectAnalytically(const k4a_calibration_t& calibration, double rayX, double rayY, double depth, unsigned int scale, double& u, double& v){
+    const k4a_calibration_extrinsics_t& extrinsics = calibration.extrinsics[K4A_CALIBRATION_TYPE_DEPTH][K4A_CALIBRATION_TYPE_COLOR];
+    const auto& params = calibration.color_camera_calibration.intrinsics.parameters.param;
+    const float* r = extrinsics.rotation;
+    const float* t = extrinsics.translation;
+
+    double p[3] = {rayX * depth, rayY * depth, depth};
+    double X = r[0] * p[0] + r[1] * p[1] + r[2] * p[2] + t[0];
+    double Y = r[3] * p[0] + r[4] * p[1] + r[5] * p[2] + t[1];
+    double Z = r[6] * p[0] + r[7] * p[1] + r[8] * p[2] + t[2];
+    if(Z <= 0.0)
+        return false;
+
+    // Brown-Conrady: radial distortion of the normalized coordinates plus the tangential terms:
+    double x = X / Z;
+    double y = Y / Z;
+    double r2 = x * x + y * y;
+    if(r2 > double(calibration.color_camera_calibration.metric_radius) * calibration.color_camera_calibration.metric_radius)
+        return false;
+
+    double radial = 1.0 + params.k1 * r2 + params.k2 * r2 * r2;
+    double xd = x * radial + 2.0 * params.p1 * x * y + params.p2 * (r2 + 2.0 * x * x);
+    double yd = y * radial + 2.0 * params.p2 * x * y + params.p1 * (r2 + 2.0 * y * y);
+
+    // Pixel centers are at integer coordinates, also in the reduced image:
+    u = ((xd * params.fx + params.cx) + 0.5) / scale - 0.5;
+    v = ((yd * params.fy + params.cy) + 0.5) / scale - 0.5;
+    return true;
+}
+
+/**
+ * Registers the gradient image with the given calibration and reduction of
+ * the color image and compares every depth pixel with its analytic projection.
+ */
+static void testRegistration(const k4a_calibration_t& calibration, unsigned int scale, const std::string& name){
+    size_t pixelCount = size_t(depthWidth) * depthHeight;
+
+    std::vector<float> lookupImageTo3D(pixelCount * 2);
+    for(unsigned int y = 0; y < depthHeight; ++y){
+        for(unsigned int x = 0; x < depthWidth; ++x){
+            size_t i = size_t(y) * depthWidth + x;
+            lookupImageTo3D[i * 2] = float((x - (depthWidth - 1) * 0.5) / depthFocalLength);
+            lookupImageTo3D[i * 2 + 1] = float((y - (depthHeight - 1) * 0.5) / depthFocalLength);
+        }
+    }
+
+    // Plane of constant depth (the top left corner has no depth):
+    const uint16_t planeDepth = 1500;
+    std::vector<uint16_t> depth(pixelCount, planeDepth);
+    for(unsigned int y = 0; y < 8; ++y)
+        std::fill(depth.begin() + size_t(y) * depthWidth, depth.begin() + size_t(y) * depthWidth + 8, uint16_t(0));
+
+    // The red and green channels are the coordinates in the full resolution image:
+    unsigned int colorWidth = (calibration.color_camera_calibration.resolution_width + scale - 1) / scale;
+    unsigned int colorHeight = (calibration.color_camera_calibration.resolution_height + scale - 1) / scale;
+    std::vector<Vec4b> colors(size_t(colorWidth) * colorHeight);
+    for(unsigned int y = 0; y < colorHeight; ++y){
+        for(unsigned int x = 0; x < colorWidth; ++x)
+            colors[size_t(y) * colorWidth + x] = Vec4b(uint8_t(x * scale), uint8_t(y * scale), 0, 255);
+    }
+
+    DepthColorRegistration registration(calibration, lookupImageTo3D.data());
+    check(registration.isValid(), name + ": the calibration is invalid");
+
+    BufferPool pool;
+    std::vector<Vec4b> registeredColors(pixelCount);
+    bool isRegistered = registration.registerColors(depth.data(), colors.data(), colorWidth, colorHeight, registeredColors.data(), pool);
+    check(isRegistered, name + ": the registration failed");
+    if(!isRegistered)
+        return;
+
+    size_t validPixels = 0, invalidPixels = 0, validityMismatches = 0, positionMismatches = 0;
+    for(size_t i = 0; i < pixelCount; ++i){
+        const Vec4b& color = registeredColors[i];
+        bool isValid = color.x != 0 || color.y != 0 || color.z != 0 || color.w != 0;
+
+        double u, v;
+        bool isProjected = depth[i] != 0 && projectAnalytically(calibration, lookupImageTo3D[i * 2], lookupImageTo3D[i * 2 + 1], depth[i], scale, u, v);
+        bool isInside = isProjected && u >= 0.0 && u < colorWidth - 1.0 && v >= 0.0 && v < colorHeight - 1.0;
+        bool isAtBorder = isProjected && (std::abs(u) < borderMargin || std::abs(u - (colorWidth - 1.0)) < borderMargin
+                                           || std::abs(v) < borderMargin || std::abs(v - (colorHeight - 1.0)) < borderMargin);
+
+        if(isAtBorder)
+            continue;
+
+        if(isValid != isInside){
+            ++validityMismatches;
+            continue;
+        }
+
+        if(!isInside){
+            ++invalidPixels;
+            continue;
+        }
+
+        ++validPixels;
+        double error = std::max(std::abs(color.x - u * scale), std::abs(color.y - v * scale)) / scale;
+        positionMismatches += error > positionTolerance ? 1 : 0;
+    }
+
+    // Otherwise the comparison wouldn't test anything:
+    check(validPixels > pixelCount / 2, name + ": only " + std::to_string(validPixels) + " pixels are visible in the color camera");
+    check(invalidPixels > 0, name + ": all pixels are visible in the color camera");
+
+    check(validityMismatches == 0, name + ": " + std::to_string(validityMismatches) + " pixels are valid in only one of the registrations");
+    check(positionMismatches == 0, name + ": " + std::to_string(positionMismatches) + " pixels are sampled at the wrong position");
+}
+
+int main(){
+    k4a_calibration_t pinhole = createCalibration(0.f, 0.f, 0.f, 0.f);
+    testRegistration(pinhole, 1, "pinhole");
+    testRegistration(pinhole, 2, "pinhole, color image reduced by 2");
+
+    k4a_calibration_t distorted = createCalibration(0.08f, -0.03f, 0.002f, -0.001f);
+    testRegistration(distorted, 1, "Brown-Conrady");
+    testRegistration(distorted, 2, "Brown-Conrady, color image reduced by 2");
+    testRegistration(distorted, 4, "Brown-Conrady, color image reduced by 4");
+
+    if(failureCount == 0)
+        std::cout << "All synthetic registration tests passed." << std::endl;
+
+    return failureCount == 0 ? 0 : 1;
+}
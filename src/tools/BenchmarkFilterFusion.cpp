@@ -0,0 +1,174 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcfilter/StencilFilter.h"
+#include "src/pcfilter/ClippingFilter.h"
+#include "src/pcfilter/SpatialHoleFiller.h"
+#include "src/pcfilter/ErosionFilter.h"
+
+/** Owned copy of the images of a camera (the synthetic images belong to a buffer pool) */
+struct CameraImages {
+    std::vector<uint16_t> depth;
+    std::vector<Vec4b> colors;
+};
+
+/**
+ * Returns the bytes per pixel which a pass of StencilChain reads and writes
+ * from and to the full resolution images: the input and the output (the rows
+ * in between filters of the pass stay in the cache). The per camera tables
+ * (e.g. the rays) are read in both modes and therefore not counted.
+ */
+static size_t passBytesPerPixel(const std::vector<StencilFilter*>& filters){
+    bool writesColors = false;
+    for(StencilFilter* filter : filters)
+        writesColors = writesColors || filter->modifiesColors();
+
+    size_t imageBytes = sizeof(uint16_t) + (writesColors ? sizeof(Vec4b) : 0);
+    return 2 * imageBytes;
+}
+
+/**
+ * Compares the fused CPU filter chain (Clipping, Spatial Hole Filler, Erosion,
+ * see StencilChain) with the same filters applied one after another, like
+ * FilterExecutor does, on frames of the synthetic scene (7 cameras with
+ * 640x576 pixels by default, one after another on the threads of OpenMP).
+ * Reports the time per frame and per camera frame (the target is below 1 ms),
+ * the image memory traffic, the time to check whether the rays of a camera
+ * changed and whether the outputs are identical.
+ *
+ * Usage: BlendPCR-filterbench [frames] [cameras]
+ */
+int main(int argc, char** argv){
+    int frameCount = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 50;
+
+    SyntheticCameraConfig config;
+    if(argc > 2)
+        config.cameraCount = (unsigned int) std::max(std::stoi(argv[2]), 1);
+
+    // Grab one frame of the synthetic scene (the streamer owns the lookup tables):
+    std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds;
+    std::mutex mutex;
+    std::condition_variable frameReceived;
+
+    SyntheticStreamer streamer(config);
+    streamer.frameRate = 0.f;
+    streamer.setCallback([&](std::vector<std::shared_ptr<OrganizedPointCloud>> frame){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(pointClouds.empty())
+            pointClouds = frame;
+        frameReceived.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        frameReceived.wait(lock, [&](){ return !pointClouds.empty(); });
+    }
+    streamer.setPlaying(false);
+
+    size_t pixelCount = size_t(config.width) * config.height;
+    std::vector<CameraImages> inputs(pointClouds.size());
+    for(size_t i = 0; i < pointClouds.size(); ++i){
+        inputs[i].depth.assign(pointClouds[i]->depth, pointClouds[i]->depth + pixelCount);
+        inputs[i].colors.assign(pointClouds[i]->colors, pointClouds[i]->colors + pixelCount);
+    }
+
+    std::vector<std::shared_ptr<Filter>> filters = {
+        std::make_shared<ClippingFilter>(),
+        std::make_shared<SpatialHoleFiller>(),
+        std::make_shared<ErosionFilter>()
+    };
+
+    std::vector<StencilFilter*> stencilFilters;
+    for(std::shared_ptr<Filter>& filter : filters)
+        stencilFilters.push_back(static_cast<StencilFilter*>(filter.get()));
+
+    StencilChain stencilChain;
+    std::vector<std::vector<CameraImages>> outputs(2);
+
+    int threadCount = 1;
+    #ifdef _OPENMP
+    threadCount = omp_get_max_threads();
+    #endif
+
+    std::cout << pointClouds.size() << " cameras, " << config.width << "x" << config.height << ", " << frameCount << " frames, "
+              << threadCount << " threads, SIMD width " << simd::Width << std::endl;
+
+    for(int mode = 0; mode < 2; ++mode){
+        bool isFused = mode == 1;
+
+        float totalTime = 0.f;
+        for(int frame = 0; frame < frameCount + 1; ++frame){
+            for(size_t i = 0; i < pointClouds.size(); ++i){
+                std::copy(inputs[i].depth.begin(), inputs[i].depth.end(), pointClouds[i]->depth);
+                std::copy(inputs[i].colors.begin(), inputs[i].colors.end(), pointClouds[i]->colors);
+            }
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for(unsigned int cameraID = 0; cameraID < pointClouds.size(); ++cameraID){
+                if(isFused){
+                    stencilChain.apply(stencilFilters, *pointClouds[cameraID], cameraID);
+                } else {
+                    for(StencilFilter* filter : stencilFilters)
+                        stencilChain.apply({filter}, *pointClouds[cameraID], cameraID);
+                }
+            }
+
+            // The first frame allocates the buffers:
+            if(frame > 0)
+                totalTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        }
+
+        for(std::shared_ptr<OrganizedPointCloud>& pc : pointClouds)
+            outputs[mode].push_back({std::vector<uint16_t>(pc->depth, pc->depth + pixelCount), std::vector<Vec4b>(pc->colors, pc->colors + pixelCount)});
+
+        size_t bytesPerPixel = 0;
+        if(isFused){
+            bytesPerPixel = passBytesPerPixel(stencilFilters);
+        } else {
+            for(StencilFilter* filter : stencilFilters)
+                bytesPerPixel += passBytesPerPixel({filter});
+        }
+
+        float frameTime = totalTime / frameCount;
+        double frameBytes = double(bytesPerPixel) * pixelCount * pointClouds.size();
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << (isFused ? "Fused:   " : "Unfused: ") << frameTime << " ms per frame ("
+                  << frameTime / pointClouds.size() << " ms per camera frame), "
+                  << std::setprecision(1) << frameBytes / 1e6 << " MB image traffic per frame ("
+                  << frameBytes / (frameTime * 1e6) << " GB/s)" << std::endl;
+    }
+
+    // The filters check every frame whether the rays of a camera changed (see DepthRays):
+    DepthRays rays;
+    rays.update(pointClouds[0]->lookupImageTo3D, config.width, config.height);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for(int frame = 0; frame < frameCount; ++frame)
+        rays.update(pointClouds[0]->lookupImageTo3D, config.width, config.height);
+    float raysCheckTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count() / frameCount;
+    std::cout << std::fixed << std::setprecision(4) << "Rays check: " << raysCheckTime << " ms per camera frame and filter" << std::endl;
+
+    bool isIdentical = true;
+    for(size_t i = 0; i < pointClouds.size(); ++i){
+        isIdentical = isIdentical && outputs[0][i].depth == outputs[1][i].depth;
+        for(size_t p = 0; p < pixelCount; ++p){
+            const Vec4b& a = outputs[0][i].colors[p];
+            const Vec4b& b = outputs[1][i].colors[p];
+            isIdentical = isIdentical && a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+        }
+    }
+
+    std::cout << "Outputs " << (isIdentical ? "identical" : "DIFFERENT") << std::endl;
+    return isIdentical ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include "src/pcstreamer/azure_mkv/AzureKinectMKVStream.h"
+
+/**
+ * Measures the buffered mode of the CWIPC-SXR playback on one recording
+ * (camera): the size of the compressed frames in the cache compared to the
+ * uncompressed point clouds, the time to load and to decode a frame, and how
+ * many frames of the given number of cameras at 30 Hz fit into the cache
+ * budget compressed and uncompressed.
+ *
+ * Usage: BlendPCR-cachebench <recording.mkv> [frames] [cameras] [budget in MB]
+ */
+int main(int argc, char** argv){
+    if(argc < 2){
+        std::cerr << "Usage: " << argv[0] << " <recording.mkv> [frames] [cameras] [budget in MB]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    int frameCount = argc > 2 ? std::max(std::stoi(argv[2]), 2) : 60;
+    int cameraCount = argc > 3 ? std::max(std::stoi(argv[3]), 1) : 7;
+
+    // Default of the GUI (Streamer::BufferedCacheBudgetMB):
+    size_t budgetMB = argc > 4 ? size_t(std::max(std::stoi(argv[4]), 1)) : 4096;
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](Clock::time_point start, Clock::time_point end){
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    };
+
+    // The cache of the measured stream holds all measured frames:
+    bool useColorIndices = false;
+    AzureKinectMKVStream stream(path, Mat4f(), useColorIndices, true, size_t(4096) * 1024 * 1024);
+    CompressedFrameCache* cache = stream.getFrameCache();
+    if(stream.getTotalFrameCount() < 2 || cache == nullptr){
+        std::cerr << "Could not open the recording: " << path << std::endl;
+        return 1;
+    }
+    frameCount = std::min(frameCount, stream.getTotalFrameCount());
+
+    // Wait until the loader has cached the frames, so that only decoding is measured below:
+    auto loadStartTime = Clock::now();
+    for(int frameID = 0; frameID < frameCount; ++frameID){
+        while(cache->sizeOf(frameID) == 0){
+            if(Clock::now() - loadStartTime > std::chrono::seconds(120)){
+                std::cerr << "The frames were not loaded into the cache within 120 s." << std::endl;
+                return 1;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    float loadTime = milliseconds(loadStartTime, Clock::now()) / frameCount;
+
+    size_t compressedBytes = 0;
+    for(int frameID = 0; frameID < frameCount; ++frameID)
+        compressedBytes += cache->sizeOf(frameID);
+
+    // Decode the frames like the playback does (RVL, MJPEG and registration); the first one allocates the buffers:
+    std::vector<float> decodeTimes;
+    size_t uncompressedFrameBytes = 0;
+    for(int frameID = 0; frameID < frameCount; ++frameID){
+        auto startTime = Clock::now();
+        std::shared_ptr<OrganizedPointCloud> pc = stream.readImage(frameID);
+        float decodeTime = milliseconds(startTime, Clock::now());
+
+        if(pc == nullptr){
+            std::cerr << "Frame " << frameID << " could not be decoded." << std::endl;
+            return 1;
+        }
+
+        uncompressedFrameBytes = size_t(pc->width) * pc->height * (sizeof(uint16_t) + (pc->colors != nullptr ? sizeof(Vec4b) : 0));
+        if(frameID > 0)
+            decodeTimes.push_back(decodeTime);
+    }
+
+    std::sort(decodeTimes.begin(), decodeTimes.end());
+    float meanDecodeTime = 0.f;
+    for(float decodeTime : decodeTimes)
+        meanDecodeTime += decodeTime / decodeTimes.size();
+    float p95DecodeTime = decodeTimes[std::min(decodeTimes.size() - 1, decodeTimes.size() * 95 / 100)];
+
+    double compressedFrameBytes = double(compressedBytes) / frameCount;
+    double compressionRatio = uncompressedFrameBytes / compressedFrameBytes;
+
+    // Frames per camera which fit into the budget, if all cameras share it:
+    double budgetBytes = double(budgetMB) * 1024 * 1024;
+    double uncompressedFrames = std::floor(budgetBytes / (double(uncompressedFrameBytes) * cameraCount));
+    double compressedFrames = std::floor(budgetBytes / (compressedFrameBytes * cameraCount));
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Recording: " << path << " (" << frameCount << " frames measured)" << std::endl
+              << "Frame size: " << compressedFrameBytes / 1e6 << " MB compressed, " << uncompressedFrameBytes / 1e6 << " MB uncompressed ("
+              << std::setprecision(2) << compressionRatio << "x)" << std::endl
+              << "Load: " << loadTime << " ms / frame (reading and RVL coding by the loader thread)" << std::endl
+              << "Decode: " << meanDecodeTime << " ms / frame (p95: " << p95DecodeTime << " ms, RVL, MJPEG and registration)" << std::endl
+              << std::endl
+              << "Cache budget of " << budgetMB << " MB for " << cameraCount << " cameras at 30 Hz:" << std::endl
+              << std::setprecision(1)
+              << "  Uncompressed: " << uncompressedFrames << " frames per camera (" << uncompressedFrames / 30.0 << " s)" << std::endl
+              << "  Compressed:   " << compressedFrames << " frames per camera (" << compressedFrames / 30.0 << " s, "
+              << std::setprecision(2) << (uncompressedFrames > 0 ? compressedFrames / uncompressedFrames : 0.0) << "x as many)" << std::endl
+              << "  Decoding " << cameraCount << " x 30 frames / s takes " << meanDecodeTime * 30.f * cameraCount / 1000.f << " cores" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,508 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+#include "src/util/gl/HeadlessContext.h"
+
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+#include "src/util/math/Mat4.h"
+#include "src/util/simd/SIMD.h"
+
+#include "src/pcstreamer/Streamer.h"
+#include "src/pcstreamer/SyntheticStreamer.h"
+
+#include "src/pcrenderer/Renderer.h"
+#include "src/pcrenderer/SplatRenderer.h"
+#include "src/pcrenderer/SimpleMeshRenderer.h"
+#include "src/pcrenderer/BlendPCR.h"
+
+#include "src/pcfilter/Filter.h"
+#include "src/pcfilter/FilterExecutor.h"
+
+using json = nlohmann::ordered_json;
+using Frame = std::vector<std::shared_ptr<OrganizedPointCloud>>;
+
+/**
+ * Receives the frames of a streamer one by one: the streamer thread waits in
+ * the callback until the previous frame was taken, so no frame is dropped and
+ * every run processes the same sequence of frames.
+ */
+class FrameHandoff {
+    std::mutex mutex;
+    std::condition_variable changed;
+    Frame frame;
+    bool hasFrame = false;
+    bool isClosed = false;
+
+public:
+    void put(Frame newFrame){
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&](){ return !hasFrame || isClosed; });
+        if(isClosed)
+            return;
+
+        frame = std::move(newFrame);
+        hasFrame = true;
+        changed.notify_all();
+    }
+
+    /** Returns the next frame (empty if none arrived within the timeout) */
+    Frame take(std::chrono::milliseconds timeout){
+        std::unique_lock<std::mutex> lock(mutex);
+        if(!changed.wait_for(lock, timeout, [&](){ return hasFrame; }))
+            return {};
+
+        hasFrame = false;
+        changed.notify_all();
+        return std::move(frame);
+    }
+
+    /** Releases the streamer thread (before the streamer is destroyed) */
+    void close(){
+        std::lock_guard<std::mutex> lock(mutex);
+        isClosed = true;
+        frame.clear();
+        changed.notify_all();
+    }
+};
+
+/** Collects the samples of a stage or pass in milliseconds */
+struct Samples {
+    std::vector<float> values;
+
+    /** Returns mean, p50, p95, p99, min and max (percentiles by nearest rank) */
+    json toJson() const {
+        json result;
+        result["samples"] = values.size();
+        if(values.empty())
+            return result;
+
+        std::vector<float> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        auto percentile = [&](float p){
+            size_t rank = size_t(std::ceil(p * sorted.size()));
+            return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+        };
+
+        double sum = 0.0;
+        for(float value : sorted)
+            sum += value;
+
+        result["mean"] = sum / sorted.size();
+        result["p50"] = percentile(0.50f);
+        result["p95"] = percentile(0.95f);
+        result["p99"] = percentile(0.99f);
+        result["min"] = sorted.front();
+        result["max"] = sorted.back();
+        return result;
+    }
+};
+
+/**
+ * Returns the value of a camera path parameter at t (0 = first frame, 1 =
+ * last frame): either a constant or keyframes which are distributed evenly
+ * over the run and interpolated linearly.
+ */
+static float pathValue(const json& parameter, float t){
+    if(!parameter.is_array())
+        return parameter.get<float>();
+
+    if(parameter.size() == 1)
+        return parameter[0].get<float>();
+
+    float position = std::clamp(t, 0.f, 1.f) * (parameter.size() - 1);
+    size_t index = std::min(size_t(position), parameter.size() - 2);
+    float f = position - index;
+    return parameter[index].get<float>() * (1.f - f) + parameter[index + 1].get<float>() * f;
+}
+
+/** Returns the index of the name in the list, or the number itself if it's an index */
+static int indexOf(const json& value, const char* const* names, unsigned int count){
+    if(value.is_number_integer())
+        return value.get<int>();
+
+    std::string name = value.get<std::string>();
+    for(unsigned int i = 0; i < count; ++i){
+        if(name == names[i])
+            return int(i);
+    }
+    return -1;
+}
+
+/** Creates the filter with the given name (nullptr if unknown) */
+static std::shared_ptr<Filter> createFilter(const std::string& name){
+    for(FilterFactory* factory : FilterFactory::availableFilterFactories){
+        std::shared_ptr<Filter> filter = factory->createInstance();
+        if(factory->getDisplayName() == name || filter->getName() == name)
+            return filter;
+    }
+    return nullptr;
+}
+
+/** Public parameters of a renderer which can be set by the run configuration */
+struct RendererParameters {
+    std::map<std::string, bool*> bools;
+    std::map<std::string, int*> ints;
+    std::map<std::string, float*> floats;
+    std::map<std::string, Vec4f*> vectors;
+
+    RendererParameters(Renderer& renderer){
+        if(BlendPCR* blendPCR = dynamic_cast<BlendPCR*>(&renderer)){
+            bools = {
+                {"useReimplementedFilters", &blendPCR->useReimplementedFilters},
+                {"shouldClip", &blendPCR->shouldClip},
+                {"useColorIndices", &blendPCR->useColorIndices},
+                {"useTemporalFilter", &blendPCR->useTemporalFilter},
+                {"usePartialUpdates", &blendPCR->usePartialUpdates}
+            };
+            ints = {{"stride", &blendPCR->stride}};
+            floats = {
+                {"implicitH", &blendPCR->implicitH},
+                {"kernelRadius", &blendPCR->kernelRadius},
+                {"kernelSpread", &blendPCR->kernelSpread},
+                {"temporalMeasurementNoise", &blendPCR->temporalMeasurementNoise},
+                {"temporalProcessNoise", &blendPCR->temporalProcessNoise},
+                {"temporalResetThreshold", &blendPCR->temporalResetThreshold}
+            };
+            vectors = {{"clipMin", &blendPCR->clipMin}, {"clipMax", &blendPCR->clipMax}};
+        } else if(SplatRenderer* splatRenderer = dynamic_cast<SplatRenderer*>(&renderer)){
+            bools = {{"discardBlackPixels", &splatRenderer->discardBlackPixels}};
+            floats = {{"pointSize", &splatRenderer->pointSize}};
+        } else if(SimpleMeshRenderer* meshRenderer = dynamic_cast<SimpleMeshRenderer*>(&renderer)){
+            bools = {{"discardBlackPixels", &meshRenderer->discardBlackPixels}};
+            floats = {{"maxEdgeLength", &meshRenderer->maxEdgeLength}};
+        }
+    }
+
+    /** Sets the parameter (returns false if the renderer has no such parameter) */
+    bool set(const std::string& name, const json& value){
+        if(bools.count(name)){
+            *bools[name] = value.get<bool>();
+        } else if(ints.count(name)){
+            *ints[name] = value.get<int>();
+        } else if(floats.count(name)){
+            *floats[name] = value.get<float>();
+        } else if(vectors.count(name)){
+            Vec4f& vector = *vectors[name];
+            vector.x = value.at(0).get<float>();
+            vector.y = value.at(1).get<float>();
+            vector.z = value.at(2).get<float>();
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * Runs the benchmark which is described by the configuration and returns its
+ * report (throws std::runtime_error if the configuration is invalid).
+ */
+static json runBenchmark(HeadlessContext& context, const json& run){
+    int width = run.value("width", 1920);
+    int height = run.value("height", 1080);
+    int frameCount = std::max(run.value("frames", 300), 1);
+    int warmupCount = std::max(run.value("warmup", 30), 0);
+
+    // Streamer:
+    int streamerType = indexOf(run.value("streamer", json("Synthetic Scene (Benchmark)")), Streamer::availableStreamerNames, Streamer::availableStreamerNum);
+    if(streamerType <= 0 || streamerType >= int(Streamer::availableStreamerNum))
+        throw std::runtime_error("Unknown streamer: " + run.value("streamer", json()).dump());
+
+    std::string path = run.value("path", std::string());
+    if(Streamer::requiresPath(streamerType) && path.empty())
+        throw std::runtime_error(std::string(Streamer::availableStreamerNames[streamerType]) + " requires a path.");
+
+    static const int defaultCameraCount = Streamer::SyntheticCameraCount;
+    Streamer::SyntheticCameraCount = run.value("cameras", defaultCameraCount);
+
+    // Renderer (needs the context for its shaders):
+    context.resize(width, height);
+
+    int rendererType = indexOf(run.value("renderer", json("BlendPCR")), Renderer::availableAlgorithmNames, Renderer::availableAlgorithmNum);
+    if(rendererType < 0 || rendererType >= int(Renderer::availableAlgorithmNum))
+        throw std::runtime_error("Unknown renderer: " + run.value("renderer", json()).dump());
+
+    std::shared_ptr<Renderer> renderer = Renderer::constructAlgorithmInstance(rendererType);
+    if(std::shared_ptr<BlendPCR> blendPCR = std::dynamic_pointer_cast<BlendPCR>(renderer)){
+        blendPCR->result_width = width;
+        blendPCR->result_height = height;
+    }
+
+    RendererParameters parameters(*renderer);
+    json parameterValues = run.value("parameters", json::object());
+    for(auto& parameter : parameterValues.items()){
+        if(!parameters.set(parameter.key(), parameter.value()))
+            throw std::runtime_error(std::string(Renderer::availableAlgorithmNames[rendererType]) + " has no parameter " + parameter.key() + ".");
+    }
+    renderer->setPassProfiling(true);
+
+    // Filters:
+    std::vector<std::shared_ptr<Filter>> filters;
+    for(const json& name : run.value("filters", json::array())){
+        std::shared_ptr<Filter> filter = createFilter(name.get<std::string>());
+        if(filter == nullptr)
+            throw std::runtime_error("Unknown filter: " + name.dump());
+        filters.push_back(filter);
+    }
+
+    FilterExecutor filterExecutor;
+
+    // Camera path (angles in degrees, defaults like the initial view of the GUI):
+    json camera = run.value("camera", json::object());
+    json yaw = camera.value("yaw", json(-28.8f));
+    json pitch = camera.value("pitch", json(-11.46f));
+    json distance = camera.value("distance", json(1.3f));
+    json target = camera.value("target", json::array({0.f, 1.1f, 0.f}));
+    float fov = camera.value("fov", 75.f);
+
+    Mat4f projection = Mat4f::perspectiveTransformation(float(width) / height, fov);
+
+    // Start the streamer (every frame is passed to the benchmark):
+    FrameHandoff handoff;
+    std::shared_ptr<Streamer> streamer = Streamer::constructStreamerInstance(streamerType, path);
+    if(streamer == nullptr)
+        throw std::runtime_error("Could not create the streamer.");
+
+    if(std::shared_ptr<FileStreamer> fileStreamer = std::dynamic_pointer_cast<FileStreamer>(streamer)){
+        fileStreamer->loop = true;
+        fileStreamer->allowFrameSkipping = false;
+        fileStreamer->setPlaybackRate(run.value("playbackRate", 1.f));
+    }
+    if(std::shared_ptr<SyntheticStreamer> syntheticStreamer = std::dynamic_pointer_cast<SyntheticStreamer>(streamer))
+        syntheticStreamer->frameRate = run.value("frameRate", 0.f);
+
+    streamer->setCallback([&handoff](Frame frame){
+        handoff.put(std::move(frame));
+    });
+
+    auto timeout = std::chrono::milliseconds(int(run.value("timeout", 30.f) * 1000.f));
+
+    GLuint timestampQueries[2];
+    glGenQueries(2, timestampQueries);
+
+    std::map<std::string, Samples> stages;
+    std::map<std::string, Samples> cpuPasses, gpuPasses;
+    std::vector<std::string> passOrder;
+    size_t cameraCount = 0;
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](Clock::time_point start, Clock::time_point end){
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    };
+
+    Clock::time_point measureStartTime;
+    Clock::time_point measureEndTime;
+    std::string error;
+
+    for(int frameID = 0; frameID < warmupCount + frameCount; ++frameID){
+        bool isMeasured = frameID >= warmupCount;
+        if(frameID == warmupCount)
+            measureStartTime = Clock::now();
+
+        auto startTime = Clock::now();
+
+        Frame frame = handoff.take(timeout);
+        if(frame.empty()){
+            error = "No frame received from the streamer within the timeout.";
+            break;
+        }
+        cameraCount = frame.size();
+        auto receivedTime = Clock::now();
+
+        filterExecutor.apply(filters, frame);
+        auto filteredTime = Clock::now();
+
+        renderer->integratePointClouds(frame);
+        auto integratedTime = Clock::now();
+
+        // Camera of this frame on the path:
+        float t = warmupCount + frameCount > 1 ? float(frameID) / (warmupCount + frameCount - 1) : 0.f;
+        float viewPositionX = pathValue(yaw, t) * float(M_PI / 180.0);
+        float viewPositionY = pathValue(pitch, t) * float(M_PI / 180.0);
+        Mat4f rotationMat({std::cos(viewPositionX), -std::sin(viewPositionY) * -std::sin(viewPositionX), std::cos(viewPositionY) * -std::sin(viewPositionX), 0, 0, std::cos(viewPositionY), std::sin(viewPositionY), 0, std::sin(viewPositionX), -std::sin(viewPositionY) * std::cos(viewPositionX), std::cos(viewPositionY) * std::cos(viewPositionX), 0, 0,0,0,1});
+        Mat4f view = Mat4f::translation(0, 0, pathValue(distance, t)) * rotationMat * Mat4f::translation(-pathValue(target[0], t), -pathValue(target[1], t), -pathValue(target[2], t));
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width, height);
+        glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDisable(GL_CULL_FACE);
+
+        glQueryCounter(timestampQueries[0], GL_TIMESTAMP);
+        renderer->render(projection, view);
+        glQueryCounter(timestampQueries[1], GL_TIMESTAMP);
+        auto submittedTime = Clock::now();
+
+        // Like the GUI, every frame is finished before the next one starts:
+        glFinish();
+        auto finishedTime = Clock::now();
+
+        GLuint64 timestamps[2];
+        glGetQueryObjectui64v(timestampQueries[0], GL_QUERY_RESULT, &timestamps[0]);
+        glGetQueryObjectui64v(timestampQueries[1], GL_QUERY_RESULT, &timestamps[1]);
+
+        // The frame is finished, so this doesn't wait (passes of multiple screens are summed):
+        std::map<std::string, PassTime> passes;
+        for(const PassTime& pass : renderer->collectPassTimes(true)){
+            auto it = passes.find(pass.name);
+            if(it == passes.end()){
+                passes[pass.name] = pass;
+                if(std::find(passOrder.begin(), passOrder.end(), pass.name) == passOrder.end())
+                    passOrder.push_back(pass.name);
+            } else {
+                it->second.cpuTime += pass.cpuTime;
+                if(pass.gpuTime >= 0.f)
+                    it->second.gpuTime += pass.gpuTime;
+            }
+        }
+
+        if(!isMeasured)
+            continue;
+
+        stages["Stream"].values.push_back(milliseconds(startTime, receivedTime));
+        stages["Filter"].values.push_back(milliseconds(receivedTime, filteredTime));
+        stages["Integrate"].values.push_back(milliseconds(filteredTime, integratedTime));
+        stages["Render (CPU)"].values.push_back(milliseconds(integratedTime, submittedTime));
+        stages["Render (GPU)"].values.push_back((timestamps[1] - timestamps[0]) * 1.0e-6f);
+        stages["Render"].values.push_back(milliseconds(integratedTime, finishedTime));
+        stages["Frame"].values.push_back(milliseconds(startTime, finishedTime));
+
+        for(auto& pass : passes){
+            cpuPasses[pass.first].values.push_back(pass.second.cpuTime);
+            if(pass.second.gpuTime >= 0.f)
+                gpuPasses[pass.first].values.push_back(pass.second.gpuTime);
+        }
+
+        measureEndTime = finishedTime;
+    }
+
+    // Release the streamer thread and the frames before the streamer is destroyed:
+    handoff.close();
+    renderer = nullptr;
+    streamer = nullptr;
+    glDeleteQueries(2, timestampQueries);
+
+    json report;
+    report["name"] = run.value("name", std::string(Renderer::availableAlgorithmNames[rendererType]));
+    report["configuration"] = run;
+    report["streamer"] = Streamer::availableStreamerNames[streamerType];
+    report["renderer"] = Renderer::availableAlgorithmNames[rendererType];
+    report["cameras"] = cameraCount;
+    report["resolution"] = {width, height};
+    report["filterWorkers"] = filterExecutor.getWorkerCount();
+    if(!error.empty())
+        report["error"] = error;
+
+    size_t measuredFrames = stages["Frame"].values.size();
+    float measuredTime = measuredFrames > 0 ? milliseconds(measureStartTime, measureEndTime) / 1000.f : 0.f;
+    report["frames"] = measuredFrames;
+    report["warmupFrames"] = warmupCount;
+    report["duration"] = measuredTime;
+    report["throughput"] = measuredTime > 0.f ? measuredFrames / measuredTime : 0.f;
+
+    json stageReport;
+    for(const char* name : {"Stream", "Filter", "Integrate", "Render (CPU)", "Render (GPU)", "Render", "Frame"})
+        stageReport[name] = stages[name].toJson();
+    report["stages"] = stageReport;
+
+    json passReport = json::object();
+    for(const std::string& name : passOrder){
+        json pass;
+        pass["cpu"] = cpuPasses[name].toJson();
+        if(gpuPasses.count(name))
+            pass["gpu"] = gpuPasses[name].toJson();
+        passReport[name] = pass;
+    }
+    report["passes"] = passReport;
+
+    return report;
+}
+
+/**
+ * Benchmarks the whole pipeline (streamer -> filters -> renderer) without a
+ * window, e.g. on a CI machine with Mesa llvmpipe. The runs are described by
+ * a JSON file (see data/benchmark/default.json): the streamer, the renderer
+ * and its parameters, the filters, the resolution, the number of frames and a
+ * camera path. Every frame of the streamer is processed (the streamer waits
+ * for the benchmark), so the runs are reproducible with the synthetic scene
+ * and with recordings.
+ *
+ * The report contains mean, p50, p95 and p99 of the stages and of the passes
+ * of the renderer (CPU and GPU time) in milliseconds and the throughput in
+ * frames per second of every run.
+ *
+ * Usage: BlendPCR-bench [config.json] [report.json (default: benchmark_report.json)]
+ */
+int main(int argc, char** argv){
+    json config = {{"runs", json::array({json::object()})}};
+    if(argc > 1){
+        std::ifstream file(argv[1]);
+        if(!file){
+            std::cerr << "Could not open " << argv[1] << std::endl;
+            return 1;
+        }
+
+        try {
+            config = json::parse(file);
+        } catch(const json::exception& e){
+            std::cerr << "Invalid configuration: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    json report;
+    bool hasFailed = false;
+
+    try {
+        HeadlessContext context;
+
+        report["gl"] = {
+            {"vendor", (const char*) glGetString(GL_VENDOR)},
+            {"renderer", (const char*) glGetString(GL_RENDERER)},
+            {"version", (const char*) glGetString(GL_VERSION)}
+        };
+        report["simdWidth"] = simd::Width;
+        report["runs"] = json::array();
+
+        for(const json& run : config.value("runs", json::array())){
+            std::cerr << "Running " << run.value("name", run.dump()) << "..." << std::endl;
+
+            json runReport = runBenchmark(context, run);
+            hasFailed = hasFailed || runReport.contains("error");
+
+            std::cerr << "  " << runReport["frames"] << " frames, " << runReport["throughput"].get<float>() << " fps, frame p50 "
+                      << runReport["stages"]["Frame"].value("p50", 0.f) << " ms, p99 " << runReport["stages"]["Frame"].value("p99", 0.f) << " ms" << std::endl;
+
+            report["runs"].push_back(runReport);
+        }
+    } catch(const std::exception& e){
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Written into a file, since the renderers print to the console:
+    std::string reportPath = argc > 2 ? argv[2] : "benchmark_report.json";
+    std::ofstream file(reportPath);
+    file << report.dump(4) << std::endl;
+    if(!file){
+        std::cerr << "Could not write " << reportPath << std::endl;
+        return 1;
+    }
+    std::cerr << "Report written to " << reportPath << std::endl;
+
+    return hasFailed ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+#include <iostream>
+
+#include "src/pcstreamer/azure_mkv/AzureKinectMKVConverter.h"
+
+/**
+ * Converts a CWIPC-SXR dataset into an organized point cloud recording (*.opcr),
+ * which can be replayed by BlendPCR without the Azure Kinect SDK.
+ *
+ * Usage: BlendPCR-convert <path/to/cameraconfig.json> <output.opcr>
+ */
+int main(int argc, char** argv){
+    if(argc != 3){
+        std::cerr << "Usage: " << argv[0] << " <path/to/cameraconfig.json> <output.opcr>" << std::endl;
+        return 1;
+    }
+
+    if(!AzureKinectMKVConverter::convert(argv[1], argv[2])){
+        std::cerr << "Conversion failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Written " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include "src/pcstreamer/OPCRecordingStreamer.h"
+#include "src/pcstreamer/SyntheticStreamer.h"
+#include "src/pcstreamer/network/PointCloudSender.h"
+#include "src/pcstreamer/shm/SharedMemoryRingProducer.h"
+
+/**
+ * Replays an organized point cloud recording (*.opcr) or the synthetic scene
+ * in realtime and sends it to BlendPCR ("Network Receiver" source mode), or
+ * publishes it into a shared memory ring if the host is "shm:<name>" ("Shared
+ * Memory Receiver" source mode).
+ *
+ * Usage: BlendPCR-sender <recording.opcr | synthetic[:cameras]> [host | shm:name] [port] [firstCamera] [cameraCount]
+ */
+int main(int argc, char** argv){
+    if(argc < 2 || argc > 6){
+        std::cerr << "Usage: " << argv[0] << " <recording.opcr | synthetic[:cameras]> [host | shm:name] [port] [firstCamera] [cameraCount]" << std::endl;
+        return 1;
+    }
+
+    std::string source = argv[1];
+    std::string host = argc > 2 ? argv[2] : "127.0.0.1";
+    int port = argc > 3 ? std::stoi(argv[3]) : POINT_CLOUD_STREAM_DEFAULT_PORT;
+    unsigned int firstCamera = argc > 4 ? (unsigned int) std::stoi(argv[4]) : 0;
+    unsigned int cameraCount = argc > 5 ? (unsigned int) std::stoi(argv[5]) : 0;
+
+    // Publish into a shared memory ring instead of sending over TCP:
+    std::string sharedMemoryName = host.rfind("shm:", 0) == 0 ? host.substr(4) : "";
+
+    PointCloudSender sender(host, port, firstCamera, cameraCount);
+    std::shared_ptr<SharedMemoryRingProducer> producer;
+    std::atomic<unsigned long long> publishedFrames{0};
+    int64_t frameCount = 0;
+
+    std::shared_ptr<FileStreamer> streamer;
+    if(source.rfind("synthetic", 0) == 0){
+        SyntheticCameraConfig config;
+        if(source.size() > 10 && source[9] == ':')
+            config.cameraCount = (unsigned int) std::stoi(source.substr(10));
+        streamer = std::make_shared<SyntheticStreamer>(config);
+    } else {
+        std::shared_ptr<OPCRecordingStreamer> recordingStreamer = std::make_shared<OPCRecordingStreamer>(source);
+        if(recordingStreamer->getTotalTime() <= 0.f){
+            std::cerr << "Failed to open " << source << std::endl;
+            return 1;
+        }
+
+        // Replay in realtime:
+        recordingStreamer->allowFrameSkipping = true;
+        streamer = recordingStreamer;
+    }
+
+    streamer->loop = true;
+    streamer->setCallback([&](std::vector<std::shared_ptr<OrganizedPointCloud>> pointClouds){
+        // Inactive cameras of partial frames can't be transmitted:
+        for(std::shared_ptr<OrganizedPointCloud>& pc : pointClouds){
+            if(pc == nullptr)
+                return;
+        }
+
+        if(sharedMemoryName.empty()){
+            sender.send(pointClouds);
+            return;
+        }
+
+        if(pointClouds.empty())
+            return;
+
+        // The ring is created from the first frame, since it defines the layout:
+        if(producer == nullptr){
+            const OrganizedPointCloud& pc = *pointClouds[0];
+            producer = std::make_shared<SharedMemoryRingProducer>(sharedMemoryName, (unsigned int) pointClouds.size(), pc.width, pc.height, pc.lookup3DToImageSize);
+        }
+
+        if(producer->publish(pointClouds, ++frameCount))
+            ++publishedFrames;
+    });
+
+    if(sharedMemoryName.empty())
+        std::cout << "Sending to " << host << ":" << port << " (stop with Ctrl+C)..." << std::endl;
+    else
+        std::cout << "Publishing into shared memory ring '" << sharedMemoryName << "' (stop with Ctrl+C)..." << std::endl;
+
+    unsigned long long lastFrames = 0, lastBytes = 0;
+    while(true){
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        if(!sharedMemoryName.empty()){
+            unsigned long long frames = publishedFrames;
+            std::cout << (frames - lastFrames) << " fps | " << (producer != nullptr && producer->isValid() ? producer->getDroppedFrames() : 0) << " dropped" << std::endl;
+            lastFrames = frames;
+            continue;
+        }
+
+        unsigned long long frames = sender.getSentFrames();
+        unsigned long long bytes = sender.getSentBytes();
+        if(sender.isConnected())
+            std::cout << (frames - lastFrames) << " fps | " << (bytes - lastBytes) / (1024 * 1024) << " MB/s" << std::endl;
+
+        lastFrames = frames;
+        lastBytes = bytes;
+    }
+
+    return 0;
+}
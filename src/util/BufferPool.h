@@ -0,0 +1,109 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <map>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+
+/**
+ * A pool of recycled memory buffers, grouped by their size in bytes.
+ *
+ * Streamers acquire the depth & color buffers of their point clouds from the
+ * pool and the point cloud returns them on destruction (see
+ * OrganizedPointCloud::bufferPool), so in steady state playback no heap
+ * allocations (and no page faults) are required for the images anymore.
+ *
+ * The pool must be held by a shared_ptr by every point cloud using it, since
+ * point clouds can outlive their streamer (e.g. in the renderer).
+ */
+class BufferPool {
+    std::mutex mutex;
+    std::map<size_t, std::vector<uint8_t*>> freeBuffers;
+
+    std::atomic<unsigned long long> missCount{0};
+    std::atomic<size_t> allocatedBytes{0};
+
+    uint8_t* allocate(size_t size){
+        uint8_t* buffer = new uint8_t[size];
+
+        // Touch all pages, so that the first use doesn't cause page faults:
+        std::memset(buffer, 0, size);
+
+        allocatedBytes += size;
+        return buffer;
+    }
+
+public:
+    BufferPool() = default;
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    ~BufferPool(){
+        for(auto& entry : freeBuffers)
+            for(uint8_t* buffer : entry.second)
+                delete[] buffer;
+    }
+
+    /**
+     * Ensures that at least 'count' buffers of the given size are available
+     * without allocation.
+     */
+    void reserve(size_t size, unsigned int count){
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<uint8_t*>& buffers = freeBuffers[size];
+        while(buffers.size() < count)
+            buffers.push_back(allocate(size));
+    }
+
+    /**
+     * Returns a buffer of the given size. If no buffer is available, a new one is
+     * allocated (counted as a miss).
+     */
+    uint8_t* acquire(size_t size){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<uint8_t*>& buffers = freeBuffers[size];
+            if(!buffers.empty()){
+                uint8_t* buffer = buffers.back();
+                buffers.pop_back();
+                return buffer;
+            }
+        }
+
+        ++missCount;
+        return allocate(size);
+    }
+
+    /**
+     * Returns a buffer for 'count' elements of type T.
+     */
+    template<typename T>
+    T* acquire(size_t count){
+        return (T*) acquire(count * sizeof(T));
+    }
+
+    /**
+     * Gives a buffer acquired by acquire(size) back to the pool.
+     */
+    void release(void* buffer, size_t size){
+        if(buffer == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers[size].push_back((uint8_t*) buffer);
+    }
+
+    /** Number of acquire(...) calls which had to allocate */
+    unsigned long long getMissCount(){
+        return missCount;
+    }
+
+    /** Total bytes allocated by this pool (in use or free) */
+    size_t getAllocatedBytes(){
+        return allocatedBytes;
+    }
+};
@@ -0,0 +1,126 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/** A rectangle of pixels (e.g. for partial uploads or scissoring) */
+struct TileRect {
+    unsigned int x, y, width, height;
+};
+
+/**
+ * Marks which tiles (tileSize x tileSize pixels, row major) of an image changed
+ * (see TileChangeDetector).
+ *
+ * A mask without tiles is unknown, i.e. the whole image has to be treated as
+ * changed. This is the state of a default constructed mask.
+ */
+struct DirtyTileMask {
+    unsigned int tileSize = 0;
+    unsigned int tilesX = 0;
+    unsigned int tilesY = 0;
+
+    /** 1 if the tile changed (empty if unknown) */
+    std::vector<uint8_t> tiles;
+
+    /** Resets the mask to the given image size with all tiles unchanged */
+    void reset(unsigned int width, unsigned int height, unsigned int size){
+        tileSize = size;
+        tilesX = (width + size - 1) / size;
+        tilesY = (height + size - 1) / size;
+        tiles.assign(size_t(tilesX) * tilesY, 0);
+    }
+
+    void setAllDirty(){
+        tiles.clear();
+    }
+
+    bool isAllDirty() const {
+        return tiles.empty();
+    }
+
+    bool isDirty(unsigned int tileX, unsigned int tileY) const {
+        return tiles.empty() || tiles[size_t(tileY) * tilesX + tileX] != 0;
+    }
+
+    /** Adds the dirty tiles of the other mask (e.g. of a frame which wasn't processed) */
+    void merge(const DirtyTileMask& other){
+        if(isAllDirty())
+            return;
+
+        if(other.isAllDirty() || other.tileSize != tileSize || other.tilesX != tilesX || other.tilesY != tilesY){
+            setAllDirty();
+            return;
+        }
+
+        for(size_t i = 0; i < tiles.size(); ++i)
+            tiles[i] |= other.tiles[i];
+    }
+
+    /** Fraction of the tiles which changed (1 if unknown) */
+    float getDirtyFraction() const {
+        if(tiles.empty())
+            return 1.f;
+
+        return float(std::count(tiles.begin(), tiles.end(), uint8_t(1))) / float(tiles.size());
+    }
+
+    /**
+     * Returns the rectangles which cover the dirty tiles of an image of the given
+     * size, extended by 'halo' pixels (rounded up to whole tiles). Horizontally
+     * adjacent tiles are merged, as well as equal runs of consecutive tile rows.
+     */
+    std::vector<TileRect> getDirtyRects(unsigned int width, unsigned int height, unsigned int halo = 0) const {
+        if(tiles.empty())
+            return { TileRect{0, 0, width, height} };
+
+        // Dilate the mask by the halo:
+        int haloTiles = int((halo + tileSize - 1) / tileSize);
+        std::vector<uint8_t> dilated(tiles.size(), 0);
+        for(int y = 0; y < int(tilesY); ++y){
+            for(int x = 0; x < int(tilesX); ++x){
+                if(!tiles[size_t(y) * tilesX + x])
+                    continue;
+
+                for(int dy = std::max(y - haloTiles, 0); dy <= std::min(y + haloTiles, int(tilesY) - 1); ++dy)
+                    for(int dx = std::max(x - haloTiles, 0); dx <= std::min(x + haloTiles, int(tilesX) - 1); ++dx)
+                        dilated[size_t(dy) * tilesX + dx] = 1;
+            }
+        }
+
+        // Runs of dirty tiles per row (in tiles), extending the runs of the row above:
+        std::vector<TileRect> runs;
+        for(unsigned int y = 0; y < tilesY; ++y){
+            for(unsigned int x = 0; x < tilesX; ++x){
+                if(!dilated[size_t(y) * tilesX + x])
+                    continue;
+
+                unsigned int start = x;
+                while(x + 1 < tilesX && dilated[size_t(y) * tilesX + x + 1])
+                    ++x;
+
+                auto above = std::find_if(runs.begin(), runs.end(), [&](const TileRect& run){
+                    return run.x == start && run.width == x + 1 - start && run.y + run.height == y;
+                });
+
+                if(above != runs.end())
+                    ++above->height;
+                else
+                    runs.push_back(TileRect{start, y, x + 1 - start, 1});
+            }
+        }
+
+        // Tiles -> pixels (clipped at the image border):
+        for(TileRect& run : runs){
+            run.x *= tileSize;
+            run.y *= tileSize;
+            run.width = std::min(run.width * tileSize, width - run.x);
+            run.height = std::min(run.height * tileSize, height - run.y);
+        }
+
+        return runs;
+    }
+};
@@ -0,0 +1,69 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+
+/**
+ * 64 bit FNV-1a hash of the given bytes. The hash of a previous call can be
+ * passed as 'hash' to continue hashing.
+ */
+inline uint64_t hashFNV1a(const void* data, uint64_t size, uint64_t hash = 14695981039346656037ull){
+    const uint8_t* bytes = (const uint8_t*) data;
+    for(uint64_t i = 0; i < size; ++i){
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Fast fingerprint of a large buffer which only changes as a whole (e.g. a
+ * lookup table of a calibration): hashes the size and 'sampleCount' evenly
+ * spaced samples of 'sampleSize' bytes (including the first and the last).
+ */
+inline uint64_t hashBufferFingerprint(const void* data, uint64_t size, uint64_t sampleCount = 1024, uint64_t sampleSize = 8){
+    uint64_t hash = hashFNV1a(&size, sizeof(size));
+    if(sampleCount < 2 || size <= sampleCount * sampleSize)
+        return hashFNV1a(data, size, hash);
+
+    const uint8_t* bytes = (const uint8_t*) data;
+    uint64_t stride = (size - sampleSize) / (sampleCount - 1);
+    for(uint64_t i = 0; i < sampleCount; ++i)
+        hash = hashFNV1a(bytes + i * stride, sampleSize, hash);
+    return hash;
+}
+
+/**
+ * Fast fingerprint of a (potentially huge) file: hashes the file size as well as
+ * the first and last 'sampleSize' bytes. Returns 0 if the file cannot be read.
+ */
+inline uint64_t hashFileFingerprint(std::string path, uint64_t sampleSize = 1024 * 1024){
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    if(error)
+        return 0;
+
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open())
+        return 0;
+
+    uint64_t hash = hashFNV1a(&fileSize, sizeof(fileSize));
+
+    std::vector<char> buffer(size_t(std::min(sampleSize, fileSize)));
+
+    file.read(buffer.data(), std::streamsize(buffer.size()));
+    hash = hashFNV1a(buffer.data(), uint64_t(file.gcount()), hash);
+
+    file.clear();
+    file.seekg(std::streamoff(fileSize - buffer.size()));
+    file.read(buffer.data(), std::streamsize(buffer.size()));
+    hash = hashFNV1a(buffer.data(), uint64_t(file.gcount()), hash);
+
+    return hash;
+}
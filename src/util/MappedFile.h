@@ -0,0 +1,136 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps a whole file read-only into the address space of the process.
+ *
+ * The pages are shared with the page cache, so no copy is made at all. Writing
+ * to the mapping crashes, so point clouds which point into it must not be
+ * modified (see OrganizedPointCloud::isWritable).
+ */
+class MappedFile {
+    uint8_t* mappedData = nullptr;
+    uint64_t mappedSize = 0;
+
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile(std::string path){
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if(fileHandle == INVALID_HANDLE_VALUE){
+            std::cerr << "Failed to open file for mapping: " << path << std::endl;
+            return;
+        }
+
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0){
+            std::cerr << "Failed to get size of file: " << path << std::endl;
+            return;
+        }
+
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mappingHandle == nullptr){
+            std::cerr << "Failed to create file mapping: " << path << std::endl;
+            return;
+        }
+
+        mappedData = (uint8_t*) MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if(mappedData != nullptr)
+            mappedSize = uint64_t(fileSize.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0){
+            std::cerr << "Failed to open file for mapping: " << path << std::endl;
+            return;
+        }
+
+        struct stat fileStat;
+        if(fstat(fd, &fileStat) != 0 || fileStat.st_size == 0){
+            std::cerr << "Failed to get size of file: " << path << std::endl;
+            close(fd);
+            return;
+        }
+
+        void* data = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+        // The mapping stays valid after the file descriptor is closed:
+        close(fd);
+
+        if(data == MAP_FAILED){
+            std::cerr << "Failed to map file: " << path << std::endl;
+            return;
+        }
+
+        mappedData = (uint8_t*) data;
+        mappedSize = uint64_t(fileStat.st_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile(){
+#ifdef _WIN32
+        if(mappedData != nullptr)
+            UnmapViewOfFile(mappedData);
+        if(mappingHandle != nullptr)
+            CloseHandle(mappingHandle);
+        if(fileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(fileHandle);
+#else
+        if(mappedData != nullptr)
+            munmap(mappedData, size_t(mappedSize));
+#endif
+    }
+
+    bool isValid() const {
+        return mappedData != nullptr;
+    }
+
+    const uint8_t* data() const {
+        return mappedData;
+    }
+
+    uint64_t size() const {
+        return mappedSize;
+    }
+
+    /**
+     * Hints the operating system that the given range will be accessed soon,
+     * so that it can be read ahead asynchronously (no-op on Windows).
+     */
+    void prefetch(uint64_t offset, uint64_t length) const {
+#ifndef _WIN32
+        if(mappedData == nullptr || offset >= mappedSize)
+            return;
+
+        // madvise requires a page aligned start address:
+        uint64_t pageSize = uint64_t(sysconf(_SC_PAGESIZE));
+        uint64_t alignedOffset = offset - offset % pageSize;
+        uint64_t alignedLength = std::min(length + (offset - alignedOffset), mappedSize - alignedOffset);
+        madvise(mappedData + alignedOffset, size_t(alignedLength), MADV_WILLNEED);
+#endif
+    }
+};
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <string>
 
 struct float2 {float x, y;};
 struct float3 {float x, y, z;};
@@ -14,6 +16,8 @@ struct uchar4 {unsigned char x, y, z, w;};
 #include "src/util/gl/primitive/TexCoord.h"
 
 #include "src/util/opc/OPCAttachment.h"
+#include "src/util/BufferPool.h"
+#include "src/util/DirtyTileMask.h"
 
 // Include OpenGL3.3 Core functions:
 #include <glad/glad.h>
@@ -88,7 +92,59 @@ public:
      */
     std::map<std::string, std::shared_ptr<OPCAttachment>> attachments;
 
+    /**
+     * Tiles which changed since the previous frame of the same camera (see
+     * TileChangeDetector). Unknown (i.e. everything changed) by default.
+     */
+    DirtyTileMask dirtyTiles;
+
+    /**
+     * If set, depth, colors and highResColors are not owned by this point cloud but
+     * point into memory which is kept alive by this handle (e.g. a memory-mapped
+     * recording), so they are not deleted on destruction.
+     */
+    std::shared_ptr<void> memoryOwner;
+
+    /**
+     * If set, depth, colors and highResColors were acquired from this pool and are
+     * given back to it on destruction instead of being deleted.
+     */
+    std::shared_ptr<BufferPool> bufferPool;
+
+    /**
+     * False if depth and colors must not be modified, since they point into
+     * read-only or shared memory (e.g. a memory-mapped recording) or the streamer
+     * hands out the same point cloud again (e.g. while paused). Filters are then
+     * applied to a copy (see FilterExecutor).
+     */
+    bool isWritable = true;
+
+    /**
+     * The point cloud this one was copied from (if it is a copy). The copy shares
+     * its highResColors and lookup tables, so they are not deleted on destruction.
+     */
+    std::shared_ptr<const OrganizedPointCloud> source;
+
     ~OrganizedPointCloud(){
+        if(source != nullptr)
+            highResColors = nullptr;
+
+        if(memoryOwner != nullptr){
+            depth = nullptr;
+            colors = nullptr;
+            highResColors = nullptr;
+        }
+
+        if(bufferPool != nullptr){
+            bufferPool->release(depth, size_t(width) * height * sizeof(uint16_t));
+            bufferPool->release(colors, size_t(width) * height * sizeof(Vec4b));
+            bufferPool->release(highResColors, size_t(highResWidth) * highResHeight * sizeof(Vec4b));
+
+            depth = nullptr;
+            colors = nullptr;
+            highResColors = nullptr;
+        }
+
         if(depth != nullptr){
             delete[] depth;
             depth = nullptr;
@@ -0,0 +1,293 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+
+/** What a stage does with a new item if its queue is full */
+enum class OverflowPolicy {
+    /** The producer waits until there is space in the queue */
+    Block = 0,
+
+    /** The oldest queued item is dropped */
+    DropOldest = 1,
+
+    /** The new item is dropped */
+    DropNewest = 2
+};
+
+/** On which thread a stage processes its items */
+enum class StageThread {
+    /** The stage has its own thread and a queue in front of it */
+    Dedicated = 0,
+
+    /**
+     * The stage runs directly after the previous stage on its thread (or on
+     * the thread calling push(...), if it is the first stage) without a queue
+     */
+    Inline = 1
+};
+
+/** Statistics of a pipeline stage (see Pipeline::getStatistics) */
+struct StageStatistics {
+    std::string name;
+
+    /** Moving average of the time to process one item in milliseconds */
+    float serviceTime = 0.f;
+
+    size_t queueDepth = 0;
+    size_t queueCapacity = 0;
+
+    unsigned long long processed = 0;
+    unsigned long long dropped = 0;
+};
+
+/**
+ * A linear pipeline of stages which process items (e.g. multi-camera frames)
+ * one after another. Stages with a dedicated thread work concurrently on
+ * different items, e.g. frame N+1 is filtered while frame N is integrated.
+ *
+ * Every dedicated stage has a bounded queue with an overflow policy, so a slow
+ * stage either slows down the previous ones (Block) or makes the pipeline skip
+ * items (DropOldest, DropNewest). Items are processed in order.
+ *
+ * A stage returns false to discard the item (it's then not passed on). Stages
+ * are added before start() and the pipeline is stopped on destruction. State
+ * which a stage reads while processing an item is changed by other threads
+ * through runExclusive(...).
+ */
+template<typename T>
+class Pipeline {
+    struct Stage {
+        std::string name;
+        std::function<bool(T&)> process;
+        StageThread thread;
+        OverflowPolicy policy;
+        size_t capacity;
+
+        std::deque<T> queue;
+        std::thread worker;
+
+        /** Held while the stage processes an item (see runExclusive) */
+        std::mutex processMutex;
+
+        float serviceTime = 0.f;
+        unsigned long long processed = 0;
+        unsigned long long dropped = 0;
+    };
+
+    std::vector<std::unique_ptr<Stage>> stages;
+
+    /** Guards the queues and statistics of all stages */
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+
+    bool isRunning = false;
+    bool shouldStop = false;
+
+    /**
+     * Processes the item by the stage with the given index and all following
+     * inline stages, then enqueues it into the next dedicated stage.
+     */
+    void processFrom(size_t stageIndex, T item){
+        for(size_t i = stageIndex; i < stages.size(); ++i){
+            Stage& stage = *stages[i];
+            if(i != stageIndex && stage.thread == StageThread::Dedicated){
+                enqueue(i, std::move(item));
+                return;
+            }
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            bool keep;
+            {
+                std::lock_guard<std::mutex> processLock(stage.processMutex);
+                keep = stage.process(item);
+            }
+            float duration = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stage.serviceTime = stage.processed == 0 ? duration : duration * 0.1f + stage.serviceTime * 0.9f;
+                ++stage.processed;
+            }
+
+            if(!keep)
+                return;
+        }
+    }
+
+    /** Adds the item to the queue of the (dedicated) stage with the given index */
+    void enqueue(size_t stageIndex, T item){
+        Stage& stage = *stages[stageIndex];
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if(stage.queue.size() >= stage.capacity){
+                if(stage.policy == OverflowPolicy::DropNewest){
+                    ++stage.dropped;
+                    return;
+                }
+
+                if(stage.policy == OverflowPolicy::DropOldest){
+                    stage.queue.pop_front();
+                    ++stage.dropped;
+                } else {
+                    queueChanged.wait(lock, [&](){ return shouldStop || stage.queue.size() < stage.capacity; });
+                    if(shouldStop)
+                        return;
+                }
+            }
+
+            stage.queue.push_back(std::move(item));
+        }
+
+        queueChanged.notify_all();
+    }
+
+    void workerLoop(size_t stageIndex){
+        Stage& stage = *stages[stageIndex];
+
+        while(true){
+            T item;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                queueChanged.wait(lock, [&](){ return shouldStop || !stage.queue.empty(); });
+                if(shouldStop)
+                    return;
+
+                item = std::move(stage.queue.front());
+                stage.queue.pop_front();
+            }
+
+            // Producers waiting for space (OverflowPolicy::Block):
+            queueChanged.notify_all();
+
+            processFrom(stageIndex, std::move(item));
+        }
+    }
+
+public:
+    Pipeline() = default;
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    ~Pipeline(){
+        stop();
+    }
+
+    /**
+     * Appends a stage. The capacity and policy are only used by dedicated
+     * stages (inline stages have no queue).
+     */
+    void addStage(std::string name, std::function<bool(T&)> process, StageThread thread = StageThread::Dedicated, size_t capacity = 1, OverflowPolicy policy = OverflowPolicy::DropOldest){
+        if(isRunning)
+            return;
+
+        std::unique_ptr<Stage> stage = std::make_unique<Stage>();
+        stage->name = name;
+        stage->process = process;
+        stage->thread = thread;
+        stage->capacity = std::max(capacity, size_t(1));
+        stage->policy = policy;
+        stages.push_back(std::move(stage));
+    }
+
+    /** Starts the threads of the dedicated stages */
+    void start(){
+        if(isRunning)
+            return;
+
+        shouldStop = false;
+        isRunning = true;
+
+        for(size_t i = 0; i < stages.size(); ++i){
+            if(stages[i]->thread == StageThread::Dedicated)
+                stages[i]->worker = std::thread(&Pipeline::workerLoop, this, i);
+        }
+    }
+
+    /**
+     * Stops all threads (items which are still queued are discarded) and wakes
+     * producers which are blocked in push(...).
+     */
+    void stop(){
+        if(!isRunning)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shouldStop = true;
+        }
+        queueChanged.notify_all();
+
+        for(std::unique_ptr<Stage>& stage : stages){
+            if(stage->worker.joinable())
+                stage->worker.join();
+            stage->queue.clear();
+        }
+
+        isRunning = false;
+    }
+
+    /**
+     * Passes a new item into the first stage. Inline stages at the front are
+     * processed on the calling thread. Depending on the overflow policy of the
+     * first dedicated stage, this may block.
+     */
+    void push(T item){
+        if(!isRunning || stages.empty())
+            return;
+
+        if(stages[0]->thread == StageThread::Dedicated)
+            enqueue(0, std::move(item));
+        else
+            processFrom(0, std::move(item));
+    }
+
+    /**
+     * Calls the function while the stage with the given name doesn't process
+     * an item (waits for the current item), e.g. to change the filters or the
+     * renderer the stage uses. Returns false if there's no such stage.
+     */
+    bool runExclusive(const std::string& name, const std::function<void()>& function){
+        for(std::unique_ptr<Stage>& stage : stages){
+            if(stage->name != name)
+                continue;
+
+            std::lock_guard<std::mutex> processLock(stage->processMutex);
+            function();
+            return true;
+        }
+
+        return false;
+    }
+
+    std::vector<StageStatistics> getStatistics(){
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<StageStatistics> statistics;
+        for(std::unique_ptr<Stage>& stage : stages){
+            StageStatistics stageStatistics;
+            stageStatistics.name = stage->name;
+            stageStatistics.serviceTime = stage->serviceTime;
+            stageStatistics.queueDepth = stage->queue.size();
+            stageStatistics.queueCapacity = stage->thread == StageThread::Dedicated ? stage->capacity : 0;
+            stageStatistics.processed = stage->processed;
+            stageStatistics.dropped = stage->dropped;
+            statistics.push_back(stageStatistics);
+        }
+
+        return statistics;
+    }
+};
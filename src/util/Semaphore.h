@@ -24,21 +24,21 @@ public:
 
     void acquire() {
         std::unique_lock<decltype(mutex)> lock(mutex);
-        if (!count)
+        while (!count)
             condition.wait(lock);
         --count;
     }
 
     void acquireAll() {
         std::unique_lock<decltype(mutex)> lock(mutex);
-        if (!count)
+        while (!count)
             condition.wait(lock);
         count = 0;
     }
 
     void wait(){
         std::unique_lock<decltype(mutex)> lock(mutex);
-        if (!count)
+        while (!count)
             condition.wait(lock);
     }
 
@@ -0,0 +1,228 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A named shared memory object which is mapped (shared) into the address space
+ * of the process, so that multiple processes on the same host can exchange
+ * data without copying it through the kernel.
+ *
+ * The creator maps it read & write. Others can open it read-only and map only
+ * the ranges they have to write (e.g. synchronization fields) as separate
+ * writable views (see mapWritable).
+ *
+ * The creator owns the name: it is removed when the creating instance is
+ * destroyed (processes which opened it keep their mapping).
+ */
+class SharedMemory {
+    uint8_t* mappedData = nullptr;
+    uint64_t mappedSize = 0;
+    std::string name;
+    bool isOwner = false;
+
+    /** Writable views of opened read-only objects (see mapWritable) */
+    std::vector<std::pair<uint8_t*, uint64_t>> writableViews;
+
+#ifdef _WIN32
+    HANDLE mappingHandle = nullptr;
+#else
+    /** Kept open for the writable views */
+    int fileDescriptor = -1;
+#endif
+
+    SharedMemory() = default;
+
+    /** Name of the object in the namespace of the OS */
+    static std::string systemName(std::string name){
+#ifdef _WIN32
+        return "Local\\" + name;
+#else
+        return "/" + name;
+#endif
+    }
+
+public:
+    /**
+     * Creates (or replaces) the shared memory object with the given name and
+     * size. Returns nullptr on failure.
+     */
+    static std::shared_ptr<SharedMemory> create(std::string name, uint64_t size){
+        std::shared_ptr<SharedMemory> memory(new SharedMemory());
+        memory->name = name;
+#ifdef _WIN32
+        memory->mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD(size >> 32), DWORD(size & 0xffffffff), systemName(name).c_str());
+        if(memory->mappingHandle == nullptr){
+            std::cerr << "Failed to create shared memory: " << name << std::endl;
+            return nullptr;
+        }
+
+        memory->mappedData = (uint8_t*) MapViewOfFile(memory->mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+#else
+        // Replace an object of a previous (crashed) run, since its size may differ:
+        shm_unlink(systemName(name).c_str());
+
+        int fd = shm_open(systemName(name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fd < 0){
+            std::cerr << "Failed to create shared memory: " << name << std::endl;
+            return nullptr;
+        }
+
+        if(ftruncate(fd, off_t(size)) != 0){
+            std::cerr << "Failed to resize shared memory: " << name << std::endl;
+            close(fd);
+            shm_unlink(systemName(name).c_str());
+            return nullptr;
+        }
+
+        void* data = mmap(nullptr, size_t(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if(data != MAP_FAILED)
+            memory->mappedData = (uint8_t*) data;
+#endif
+        if(memory->mappedData == nullptr){
+            std::cerr << "Failed to map shared memory: " << name << std::endl;
+            return nullptr;
+        }
+
+        memory->mappedSize = size;
+        memory->isOwner = true;
+        return memory;
+    }
+
+    /**
+     * Opens the existing shared memory object with the given name. Returns
+     * nullptr if it doesn't exist. If readOnly is set, data() is mapped
+     * read-only (writing to it crashes).
+     */
+    static std::shared_ptr<SharedMemory> open(std::string name, bool readOnly = false){
+        std::shared_ptr<SharedMemory> memory(new SharedMemory());
+        memory->name = name;
+#ifdef _WIN32
+        memory->mappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName(name).c_str());
+        if(memory->mappingHandle == nullptr)
+            return nullptr;
+
+        memory->mappedData = (uint8_t*) MapViewOfFile(memory->mappingHandle, readOnly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if(memory->mappedData == nullptr)
+            return nullptr;
+
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(memory->mappedData, &info, sizeof(info));
+        memory->mappedSize = uint64_t(info.RegionSize);
+#else
+        int fd = shm_open(systemName(name).c_str(), O_RDWR, 0600);
+        if(fd < 0)
+            return nullptr;
+
+        struct stat memoryStat;
+        if(fstat(fd, &memoryStat) != 0 || memoryStat.st_size == 0){
+            close(fd);
+            return nullptr;
+        }
+
+        void* data = mmap(nullptr, size_t(memoryStat.st_size), readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(data == MAP_FAILED){
+            close(fd);
+            return nullptr;
+        }
+
+        // The mapping stays valid after the file descriptor is closed:
+        if(readOnly)
+            memory->fileDescriptor = fd;
+        else
+            close(fd);
+
+        memory->mappedData = (uint8_t*) data;
+        memory->mappedSize = uint64_t(memoryStat.st_size);
+#endif
+        return memory;
+    }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    ~SharedMemory(){
+#ifdef _WIN32
+        for(auto& view : writableViews)
+            UnmapViewOfFile(view.first);
+        if(mappedData != nullptr)
+            UnmapViewOfFile(mappedData);
+        if(mappingHandle != nullptr)
+            CloseHandle(mappingHandle);
+#else
+        for(auto& view : writableViews)
+            munmap(view.first, size_t(view.second));
+        if(mappedData != nullptr)
+            munmap(mappedData, size_t(mappedSize));
+        if(fileDescriptor >= 0)
+            close(fileDescriptor);
+        if(isOwner)
+            shm_unlink(systemName(name).c_str());
+#endif
+    }
+
+    uint8_t* data() const {
+        return mappedData;
+    }
+
+    uint64_t size() const {
+        return mappedSize;
+    }
+
+    /**
+     * Maps the given range of an object which was opened read-only as separate
+     * writable view (valid as long as this instance exists). Returns a pointer
+     * to the range within the view or nullptr on failure.
+     */
+    uint8_t* mapWritable(uint64_t offset, uint64_t length){
+        if(offset + length > mappedSize)
+            return nullptr;
+
+#ifdef _WIN32
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        uint64_t granularity = uint64_t(systemInfo.dwAllocationGranularity);
+#else
+        uint64_t granularity = uint64_t(sysconf(_SC_PAGESIZE));
+#endif
+        // Views have to start at a multiple of the granularity:
+        uint64_t alignedOffset = offset - offset % granularity;
+        uint64_t alignedLength = length + (offset - alignedOffset);
+
+#ifdef _WIN32
+        uint8_t* view = (uint8_t*) MapViewOfFile(mappingHandle, FILE_MAP_WRITE, DWORD(alignedOffset >> 32), DWORD(alignedOffset & 0xffffffff), SIZE_T(alignedLength));
+        if(view == nullptr)
+            return nullptr;
+#else
+        if(fileDescriptor < 0)
+            return nullptr;
+
+        void* data = mmap(nullptr, size_t(alignedLength), PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, off_t(alignedOffset));
+        if(data == MAP_FAILED)
+            return nullptr;
+
+        uint8_t* view = (uint8_t*) data;
+#endif
+        writableViews.push_back({view, alignedLength});
+        return view + (offset - alignedOffset);
+    }
+};
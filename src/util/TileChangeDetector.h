@@ -0,0 +1,204 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include "src/util/OrganizedPointCloud.h"
+#include "src/util/DirtyTileMask.h"
+#include "src/util/simd/SIMD.h"
+
+#define TILE_CHANGE_DEFAULT_TILE_SIZE 32
+
+/**
+ * Detects which tiles of the depth and color images of every camera changed
+ * since the previous frame, so that renderers only have to upload and process
+ * those (see OrganizedPointCloud::dirtyTiles).
+ *
+ * A tile changed if at least one depth value differs by more than the tolerance
+ * (absolute in millimeters plus relative to the depth, since the noise of ToF
+ * sensors grows with the distance) or one color channel by more than the color
+ * tolerance.
+ *
+ * The comparison is not done against the previous frame, but against a copy of
+ * the last content which was detected as changed. Otherwise slow changes below
+ * the tolerance would never be detected, while the renderer keeps an outdated
+ * tile.
+ */
+class TileChangeDetector {
+    struct CameraReference {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        bool hasColors = false;
+        std::vector<uint16_t> depth;
+        std::vector<Vec4b> colors;
+    };
+
+    std::vector<CameraReference> references;
+
+    /** Fraction of the tiles which changed in the last frame (per camera) */
+    std::vector<float> dirtyFractions;
+
+    /** Returns true if a depth value in the given tile changed */
+    bool hasDepthChanged(const uint16_t* current, const uint16_t* reference, unsigned int width, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) const {
+        const simd::Float absolute(depthTolerance);
+        const simd::Float relative(relativeDepthTolerance);
+
+        for(unsigned int y = y0; y < y1; ++y){
+            const uint16_t* currentRow = current + size_t(y) * width;
+            const uint16_t* referenceRow = reference + size_t(y) * width;
+
+            unsigned int x = x0;
+            for(; x + simd::Width <= x1; x += simd::Width){
+                simd::Float currentDepth = simd::loadDepth(currentRow + x);
+                simd::Float referenceDepth = simd::loadDepth(referenceRow + x);
+                simd::Float tolerance = simd::max(absolute, currentDepth * relative);
+
+                if(simd::any(simd::abs(currentDepth - referenceDepth) > tolerance))
+                    return true;
+            }
+
+            for(; x < x1; ++x){
+                float currentDepth = currentRow[x];
+                if(std::abs(currentDepth - float(referenceRow[x])) > std::max(depthTolerance, currentDepth * relativeDepthTolerance))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    /** Returns true if a color channel in the given tile changed */
+    bool hasColorChanged(const Vec4b* current, const Vec4b* reference, unsigned int width, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) const {
+        for(unsigned int y = y0; y < y1; ++y){
+            const uint8_t* currentRow = (const uint8_t*) (current + size_t(y) * width + x0);
+            const uint8_t* referenceRow = (const uint8_t*) (reference + size_t(y) * width + x0);
+            unsigned int channels = (x1 - x0) * 4;
+
+            int maxDifference = 0;
+            #pragma omp simd reduction(max:maxDifference)
+            for(unsigned int c = 0; c < channels; ++c)
+                maxDifference = std::max(maxDifference, std::abs(int(currentRow[c]) - int(referenceRow[c])));
+
+            if(maxDifference > colorTolerance)
+                return true;
+        }
+
+        return false;
+    }
+
+    /** Copies the given tile of the point cloud into the reference */
+    static void updateReference(CameraReference& reference, const OrganizedPointCloud& pc, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1){
+        for(unsigned int y = y0; y < y1; ++y){
+            size_t offset = size_t(y) * pc.width + x0;
+            std::memcpy(reference.depth.data() + offset, pc.depth + offset, (x1 - x0) * sizeof(uint16_t));
+
+            if(reference.hasColors)
+                std::memcpy(reference.colors.data() + offset, pc.colors + offset, (x1 - x0) * sizeof(Vec4b));
+        }
+    }
+
+public:
+    /** Width and height of a tile in pixels */
+    unsigned int tileSize = TILE_CHANGE_DEFAULT_TILE_SIZE;
+
+    /** Depth differences up to this value (in millimeters) are noise */
+    float depthTolerance = 8.f;
+
+    /** Depth differences up to this fraction of the depth are noise (if larger than depthTolerance) */
+    float relativeDepthTolerance = 0.005f;
+
+    /** Color differences up to this value (per channel, 0-255) are noise */
+    int colorTolerance = 12;
+
+    /**
+     * Detects the changed tiles of all point clouds (index = camera ID) and
+     * stores them in their dirtyTiles. Point clouds which are nullptr are
+     * skipped. If the resolution or the presence of colors of a camera changed,
+     * all its tiles are dirty.
+     */
+    void detect(const std::vector<std::shared_ptr<OrganizedPointCloud>>& pointClouds){
+        if(references.size() < pointClouds.size()){
+            references.resize(pointClouds.size());
+            dirtyFractions.resize(pointClouds.size(), 1.f);
+        }
+
+        // Tile rows of all cameras which have to be compared:
+        struct TileRow { unsigned int cameraID, tileY; };
+        std::vector<TileRow> tileRows;
+
+        for(unsigned int cameraID = 0; cameraID < pointClouds.size(); ++cameraID){
+            OrganizedPointCloud* pc = pointClouds[cameraID].get();
+            if(pc == nullptr || pc->depth == nullptr)
+                continue;
+
+            CameraReference& reference = references[cameraID];
+            bool hasColors = pc->colors != nullptr;
+            size_t pixelCount = size_t(pc->width) * pc->height;
+
+            pc->dirtyTiles.reset(pc->width, pc->height, tileSize);
+
+            if(reference.width != pc->width || reference.height != pc->height || reference.hasColors != hasColors){
+                reference.width = pc->width;
+                reference.height = pc->height;
+                reference.hasColors = hasColors;
+                reference.depth.assign(pc->depth, pc->depth + pixelCount);
+
+                if(hasColors)
+                    reference.colors.assign(pc->colors, pc->colors + pixelCount);
+                else
+                    reference.colors.clear();
+
+                pc->dirtyTiles.setAllDirty();
+                continue;
+            }
+
+            for(unsigned int tileY = 0; tileY < pc->dirtyTiles.tilesY; ++tileY)
+                tileRows.push_back(TileRow{cameraID, tileY});
+        }
+
+        #pragma omp parallel for schedule(dynamic)
+        for(int i = 0; i < int(tileRows.size()); ++i){
+            unsigned int cameraID = tileRows[i].cameraID;
+            OrganizedPointCloud& pc = *pointClouds[cameraID];
+            CameraReference& reference = references[cameraID];
+            DirtyTileMask& mask = pc.dirtyTiles;
+
+            unsigned int y0 = tileRows[i].tileY * tileSize;
+            unsigned int y1 = std::min(y0 + tileSize, pc.height);
+
+            for(unsigned int tileX = 0; tileX < mask.tilesX; ++tileX){
+                unsigned int x0 = tileX * tileSize;
+                unsigned int x1 = std::min(x0 + tileSize, pc.width);
+
+                bool changed = hasDepthChanged(pc.depth, reference.depth.data(), pc.width, x0, y0, x1, y1)
+                    || (reference.hasColors && hasColorChanged(pc.colors, reference.colors.data(), pc.width, x0, y0, x1, y1));
+
+                if(changed){
+                    mask.tiles[size_t(tileRows[i].tileY) * mask.tilesX + tileX] = 1;
+                    updateReference(reference, pc, x0, y0, x1, y1);
+                }
+            }
+        }
+
+        for(unsigned int cameraID = 0; cameraID < pointClouds.size(); ++cameraID){
+            if(pointClouds[cameraID] != nullptr && pointClouds[cameraID]->depth != nullptr)
+                dirtyFractions[cameraID] = pointClouds[cameraID]->dirtyTiles.getDirtyFraction();
+        }
+    }
+
+    /** Forgets the previous frames, so all tiles of the next frame are dirty */
+    void reset(){
+        references.clear();
+        dirtyFractions.clear();
+    }
+
+    /** Returns the fraction of the tiles which changed in the last frame per camera */
+    std::vector<float> getDirtyFractions() const {
+        return dirtyFractions;
+    }
+};
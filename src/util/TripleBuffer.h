@@ -0,0 +1,131 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * A latest-value mailbox between one producer and one consumer thread (triple
+ * buffering).
+ *
+ * The producer writes into its own back slot and publishes it by exchanging it
+ * with the middle slot; the consumer takes the middle slot by exchanging it with
+ * its own front slot. Both exchanges are a single atomic operation, so the
+ * producer never waits for the consumer, and the consumer always gets the newest
+ * completely written value (never a torn one). Values which are overwritten
+ * before the consumer took them are counted as dropped.
+ *
+ * Only waking a waiting consumer (see waitRead) locks a mutex, which is never
+ * held while values are copied.
+ */
+template<typename T>
+class TripleBuffer {
+    static constexpr uint8_t INDEX_MASK = 3;
+    static constexpr uint8_t FRESH_BIT = 4;
+
+    T slots[3];
+
+    /** Index of the middle slot, FRESH_BIT if it holds a value the consumer didn't take yet */
+    std::atomic<uint8_t> middle{1};
+
+    /** Slot which is written by the producer (only accessed by the producer) */
+    uint8_t back = 0;
+
+    /** Slot which is read by the consumer (only accessed by the consumer) */
+    uint8_t front = 2;
+
+    std::atomic<unsigned long long> publishedCount{0};
+    std::atomic<unsigned long long> droppedCount{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool> interrupted{false};
+
+public:
+    /**
+     * Publishes a new value (producer thread only). Never blocks on the
+     * consumer.
+     */
+    void write(T value){
+        slots[back] = std::move(value);
+
+        uint8_t previous = middle.exchange(uint8_t(back | FRESH_BIT), std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+
+        if(previous & FRESH_BIT)
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        publishedCount.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_one();
+    }
+
+    /** Returns true if a value was published which the consumer didn't take yet */
+    bool hasNewValue() const {
+        return (middle.load(std::memory_order_acquire) & FRESH_BIT) != 0;
+    }
+
+    /**
+     * Takes the newest value if there is one which wasn't taken yet (consumer
+     * thread only). Returns false otherwise.
+     */
+    bool tryRead(T& value){
+        if(!hasNewValue())
+            return false;
+
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+        value = slots[front];
+        return true;
+    }
+
+    /**
+     * Returns the newest value, even if it was already taken before (consumer
+     * thread only). The reference is valid until the next read by the consumer.
+     */
+    const T& readLatest(){
+        if(hasNewValue()){
+            uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+            front = previous & INDEX_MASK;
+        }
+        return slots[front];
+    }
+
+    /**
+     * Waits until a new value is available (or the timeout passed or interrupt()
+     * was called) and takes it (consumer thread only). Returns false if there was
+     * no new value.
+     */
+    bool waitRead(T& value, std::chrono::milliseconds timeout = std::chrono::milliseconds(100)){
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, timeout, [this](){ return hasNewValue() || interrupted.load(); });
+        }
+        return tryRead(value);
+    }
+
+    /** Wakes the waiting consumer for good (e.g. on shutdown) */
+    void interrupt(){
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            interrupted = true;
+        }
+        wakeCondition.notify_all();
+    }
+
+    /** Number of values which were published */
+    unsigned long long getPublishedCount() const {
+        return publishedCount.load(std::memory_order_relaxed);
+    }
+
+    /** Number of values which were overwritten before the consumer took them */
+    unsigned long long getDroppedCount() const {
+        return droppedCount.load(std::memory_order_relaxed);
+    }
+};
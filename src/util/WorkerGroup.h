@@ -0,0 +1,115 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+/**
+ * A fixed group of persistent worker threads. Every call of run(...) executes
+ * job(i) on worker i for all workers concurrently and returns when all workers
+ * have finished (barrier).
+ *
+ * This avoids creating threads per frame, and since worker i always executes
+ * job i, per-worker resources (like a playback handle of a camera) are always
+ * used by the same thread.
+ */
+class WorkerGroup {
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+
+    std::function<void(int)> currentJob;
+
+    /** Incremented for every run(...) / post(...), so workers detect new jobs */
+    unsigned long long generation = 0;
+
+    /** Generation of the job run(...) waits for (jobs of post(...) aren't counted) */
+    unsigned long long awaitedGeneration = 0;
+    unsigned int pendingWorkers = 0;
+    bool shouldStop = false;
+
+    void workerLoop(int workerID){
+        unsigned long long lastGeneration = 0;
+
+        while(true){
+            std::function<void(int)> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startCondition.wait(lock, [&](){ return shouldStop || generation != lastGeneration; });
+                if(shouldStop)
+                    return;
+
+                lastGeneration = generation;
+                job = currentJob;
+            }
+
+            job(workerID);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(lastGeneration == awaitedGeneration && --pendingWorkers == 0)
+                    doneCondition.notify_all();
+            }
+        }
+    }
+
+public:
+    WorkerGroup(unsigned int workerCount){
+        for(unsigned int i = 0; i < workerCount; ++i)
+            workers.emplace_back(&WorkerGroup::workerLoop, this, int(i));
+    }
+
+    ~WorkerGroup(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shouldStop = true;
+        }
+        startCondition.notify_all();
+
+        for(std::thread& worker : workers)
+            worker.join();
+    }
+
+    WorkerGroup(const WorkerGroup&) = delete;
+    WorkerGroup& operator=(const WorkerGroup&) = delete;
+
+    unsigned int size() const {
+        return (unsigned int) workers.size();
+    }
+
+    /**
+     * Executes job(i) on every worker i and blocks until all jobs are finished.
+     * Must not be called concurrently.
+     */
+    void run(std::function<void(int)> job){
+        if(workers.empty())
+            return;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        currentJob = job;
+        pendingWorkers = (unsigned int) workers.size();
+        awaitedGeneration = ++generation;
+        startCondition.notify_all();
+
+        doneCondition.wait(lock, [&](){ return pendingWorkers == 0; });
+    }
+
+    /**
+     * Executes job(i) on every worker i without waiting for the jobs. A worker
+     * which is still busy with a previous job only executes the newest job when
+     * it is done, so a slow worker skips jobs instead of delaying the others.
+     * Must not be called concurrently to run(...).
+     */
+    void post(std::function<void(int)> job){
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = job;
+        ++generation;
+        startCondition.notify_all();
+    }
+};
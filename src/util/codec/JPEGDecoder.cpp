@@ -0,0 +1,174 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+
+#include "src/util/codec/JPEGDecoder.h"
+
+#include <algorithm>
+
+// Also used by Texture2D:
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#ifdef USE_LIBJPEG
+
+#include <cstdio>
+#include <csetjmp>
+#include <vector>
+#include <jpeglib.h>
+
+namespace {
+    /** Returns from jpeg_... calls on errors (instead of exiting the process) */
+    struct JPEGErrorManager {
+        jpeg_error_mgr manager;
+        jmp_buf jump;
+    };
+
+    void onJPEGError(j_common_ptr info){
+        longjmp(((JPEGErrorManager*) info->err)->jump, 1);
+    }
+
+    void onJPEGMessage(j_common_ptr){
+        // Warnings are counted (and handled) by decodeJPEGToBGRA
+    }
+}
+
+bool decodeJPEGToBGRA(const uint8_t* data, size_t size, uint8_t* output, int width, int height, int scale){
+    if(scale != 1 && scale != 2 && scale != 4 && scale != 8)
+        return false;
+
+    jpeg_decompress_struct info;
+    JPEGErrorManager error;
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = onJPEGError;
+    error.manager.output_message = onJPEGMessage;
+
+    // Only variables which aren't modified after setjmp are used afterwards:
+    if(setjmp(error.jump)){
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, (unsigned char*) data, (unsigned long) size);
+
+    if(jpeg_read_header(&info, TRUE) != JPEG_HEADER_OK || int(info.image_width) != width || int(info.image_height) != height){
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+
+    // Downscale in the DCT domain:
+    info.scale_num = 1;
+    info.scale_denom = scale;
+
+#ifdef JCS_EXTENSIONS
+    info.out_color_space = JCS_EXT_BGRA;
+#else
+    info.out_color_space = JCS_RGB;
+#endif
+
+    jpeg_start_decompress(&info);
+
+    int outputWidth = getScaledJPEGSize(width, scale);
+    if(int(info.output_width) != outputWidth || int(info.output_height) != getScaledJPEGSize(height, scale)){
+        jpeg_abort_decompress(&info);
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+
+#ifdef JCS_EXTENSIONS
+    while(info.output_scanline < info.output_height){
+        JSAMPROW row = output + size_t(info.output_scanline) * outputWidth * 4;
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+#else
+    std::vector<uint8_t> rgb(size_t(outputWidth) * 3);
+    while(info.output_scanline < info.output_height){
+        uint8_t* bgra = output + size_t(info.output_scanline) * outputWidth * 4;
+        JSAMPROW row = rgb.data();
+        jpeg_read_scanlines(&info, &row, 1);
+
+        for(int x = 0; x < outputWidth; ++x){
+            bgra[x * 4 + 0] = rgb[x * 3 + 2];
+            bgra[x * 4 + 1] = rgb[x * 3 + 1];
+            bgra[x * 4 + 2] = rgb[x * 3 + 0];
+            bgra[x * 4 + 3] = 255;
+        }
+    }
+#endif
+
+    jpeg_finish_decompress(&info);
+
+    // Treat corrupt data (e.g. truncated frames) like stb_image does:
+    bool valid = error.manager.num_warnings == 0;
+    jpeg_destroy_decompress(&info);
+    return valid;
+}
+
+bool isReducedJPEGDecodingFast(){
+    return true;
+}
+
+#else
+
+bool decodeJPEGToBGRA(const uint8_t* data, size_t size, uint8_t* output, int width, int height, int scale){
+    if(scale != 1 && scale != 2 && scale != 4 && scale != 8)
+        return false;
+
+    int decodedWidth, decodedHeight, channels;
+    uint8_t* rgba = stbi_load_from_memory(data, int(size), &decodedWidth, &decodedHeight, &channels, 4);
+    if(rgba == nullptr)
+        return false;
+
+    if(decodedWidth != width || decodedHeight != height){
+        stbi_image_free(rgba);
+        return false;
+    }
+
+    // RGBA -> BGRA (averaging scale x scale pixels, if the resolution is reduced):
+    int outputWidth = getScaledJPEGSize(width, scale);
+    int outputHeight = getScaledJPEGSize(height, scale);
+
+    if(scale == 1){
+        size_t pixelCount = size_t(width) * height;
+
+        #pragma omp simd
+        for(size_t i = 0; i < pixelCount; ++i){
+            output[i * 4 + 0] = rgba[i * 4 + 2];
+            output[i * 4 + 1] = rgba[i * 4 + 1];
+            output[i * 4 + 2] = rgba[i * 4 + 0];
+            output[i * 4 + 3] = 255;
+        }
+    } else {
+        for(int y = 0; y < outputHeight; ++y){
+            for(int x = 0; x < outputWidth; ++x){
+                int sum[3] = {0, 0, 0};
+                int count = 0;
+
+                for(int sy = y * scale; sy < std::min((y + 1) * scale, height); ++sy){
+                    for(int sx = x * scale; sx < std::min((x + 1) * scale, width); ++sx){
+                        const uint8_t* pixel = rgba + (size_t(sy) * width + sx) * 4;
+                        sum[0] += pixel[0];
+                        sum[1] += pixel[1];
+                        sum[2] += pixel[2];
+                        ++count;
+                    }
+                }
+
+                uint8_t* bgra = output + (size_t(y) * outputWidth + x) * 4;
+                bgra[0] = uint8_t(sum[2] / count);
+                bgra[1] = uint8_t(sum[1] / count);
+                bgra[2] = uint8_t(sum[0] / count);
+                bgra[3] = 255;
+            }
+        }
+    }
+
+    stbi_image_free(rgba);
+    return true;
+}
+
+bool isReducedJPEGDecodingFast(){
+    return false;
+}
+
+#endif
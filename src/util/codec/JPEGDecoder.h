@@ -0,0 +1,32 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Decodes a JPEG (e.g. an MJPEG frame of an Azure Kinect recording) into the
+ * given BGRA buffer. Returns false if the data can't be decoded or doesn't have
+ * the expected resolution (width x height).
+ *
+ * If scale is 2, 4 or 8, the image is decoded at the reduced resolution
+ * getScaledJPEGSize(width, scale) x getScaledJPEGSize(height, scale), which
+ * the output buffer must hold. With libjpeg(-turbo) (USE_LIBJPEG), the image
+ * is downscaled while decoding (in the DCT domain), which is much faster than
+ * decoding the full resolution.
+ */
+bool decodeJPEGToBGRA(const uint8_t* data, size_t size, uint8_t* output, int width, int height, int scale = 1);
+
+/**
+ * Returns whether decoding at a reduced resolution is faster than decoding at
+ * the full resolution (i.e. libjpeg is used).
+ */
+bool isReducedJPEGDecodingFast();
+
+/**
+ * Returns the size of a dimension of an image which is decoded at 1 / scale.
+ */
+inline int getScaledJPEGSize(int size, int scale){
+    return (size + scale - 1) / scale;
+}
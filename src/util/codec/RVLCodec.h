@@ -0,0 +1,158 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * Lossless compression of 16 bit depth images using Run-Length Variable-Length
+ * (RVL) coding, see: A. D. Wilson, "Fast Lossless Depth Image Compression",
+ * ISS 2017.
+ *
+ * Runs of zeros (invalid pixels) are run-length encoded and valid pixels are
+ * stored as zigzag encoded deltas to the previous valid pixel. All values are
+ * written as variable-length sequences of 3 bit nibbles (+1 continuation bit),
+ * packed into 32 bit words. Encoding and decoding take about 1 ms for a
+ * 640 x 576 depth image and achieve compression ratios of about 3-4.
+ */
+class RVLCodec {
+    // Encoder / decoder state:
+    std::vector<uint32_t>* outputWords = nullptr;
+    const uint32_t* inputWords = nullptr;
+    const uint32_t* inputWordsEnd = nullptr;
+    uint32_t word = 0;
+    int nibbleCount = 0;
+    bool overrun = false;
+
+    void encodeVLE(uint32_t value){
+        do {
+            uint32_t nibble = value & 0x7;
+            if(value >>= 3)
+                nibble |= 0x8;
+
+            word = (word << 4) | nibble;
+            if(++nibbleCount == 8){
+                outputWords->push_back(word);
+                nibbleCount = 0;
+                word = 0;
+            }
+        } while(value);
+    }
+
+    uint32_t decodeVLE(){
+        uint32_t nibble;
+        uint32_t value = 0;
+        int bits = 29;
+
+        do {
+            if(nibbleCount == 0){
+                if(inputWords == inputWordsEnd || bits < 0){
+                    overrun = true;
+                    return 0;
+                }
+                word = *inputWords++;
+                nibbleCount = 8;
+            }
+
+            nibble = word & 0xf0000000;
+            value |= (nibble << 1) >> bits;
+            word <<= 4;
+            --nibbleCount;
+            bits -= 3;
+        } while(nibble & 0x80000000);
+
+        return value;
+    }
+
+public:
+    /**
+     * Compresses the given depth image into 'output' (which is overwritten).
+     */
+    void compress(const uint16_t* input, size_t pixelCount, std::vector<uint8_t>& output){
+        std::vector<uint32_t> words;
+        words.reserve(pixelCount / 4);
+
+        outputWords = &words;
+        word = 0;
+        nibbleCount = 0;
+
+        const uint16_t* end = input + pixelCount;
+        int previous = 0;
+
+        while(input != end){
+            uint32_t zeros = 0;
+            for(; input != end && *input == 0; ++input)
+                ++zeros;
+            encodeVLE(zeros);
+
+            uint32_t nonzeros = 0;
+            for(const uint16_t* p = input; p != end && *p != 0; ++p)
+                ++nonzeros;
+            encodeVLE(nonzeros);
+
+            for(uint32_t i = 0; i < nonzeros; ++i){
+                int current = *input++;
+                int delta = current - previous;
+                encodeVLE(uint32_t((delta << 1) ^ (delta >> 31)));
+                previous = current;
+            }
+        }
+
+        if(nibbleCount > 0)
+            words.push_back(word << (4 * (8 - nibbleCount)));
+
+        outputWords = nullptr;
+
+        output.resize(words.size() * sizeof(uint32_t));
+        std::memcpy(output.data(), words.data(), output.size());
+    }
+
+    /**
+     * Decompresses data created by compress(...) into 'output', which must hold
+     * 'pixelCount' values. Returns false if the data is corrupt.
+     */
+    bool decompress(const uint8_t* input, size_t size, uint16_t* output, size_t pixelCount){
+        if(size % sizeof(uint32_t) != 0)
+            return false;
+
+        inputWords = (const uint32_t*) input;
+        inputWordsEnd = inputWords + size / sizeof(uint32_t);
+        word = 0;
+        nibbleCount = 0;
+        overrun = false;
+
+        int previous = 0;
+        size_t remaining = pixelCount;
+
+        while(remaining > 0){
+            uint32_t zeros = decodeVLE();
+            if(overrun || zeros > remaining)
+                return false;
+
+            std::memset(output, 0, zeros * sizeof(uint16_t));
+            output += zeros;
+            remaining -= zeros;
+
+            uint32_t nonzeros = decodeVLE();
+            if(overrun || nonzeros > remaining)
+                return false;
+
+            remaining -= nonzeros;
+            for(uint32_t i = 0; i < nonzeros; ++i){
+                uint32_t positive = decodeVLE();
+                int delta = int(positive >> 1) ^ -int(positive & 1);
+                int current = previous + delta;
+                *output++ = uint16_t(current);
+                previous = current;
+            }
+
+            if(overrun)
+                return false;
+        }
+
+        return true;
+    }
+};
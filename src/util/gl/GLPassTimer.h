@@ -0,0 +1,148 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <chrono>
+
+/** Measured time of a render pass (see GLPassTimer) */
+struct PassTime {
+    std::string name;
+
+    /** Time between begin and end on the CPU in milliseconds */
+    float cpuTime = 0.f;
+
+    /** Time the GPU needed for the commands of the pass in milliseconds (-1 = not measured) */
+    float gpuTime = -1.f;
+};
+
+/**
+ * Measures the CPU and GPU time of render passes without stalling the
+ * pipeline: the GPU time is measured by timer queries whose results are
+ * fetched by collect(...) once they are available (usually one or two frames
+ * later), instead of waiting for the GPU after every pass.
+ *
+ * GPU passes must not be nested (only one GL_TIME_ELAPSED query can be active).
+ */
+class GLPassTimer {
+    struct PendingPass {
+        PassTime time;
+        GLuint query = 0;
+    };
+
+    /** Passes whose query results aren't available yet (in order) */
+    std::deque<PendingPass> pendingPasses;
+
+    /** Passes which are measured completely */
+    std::vector<PassTime> finishedPasses;
+
+    /** Queries which can be reused */
+    std::vector<GLuint> freeQueries;
+
+    std::map<std::string, std::chrono::high_resolution_clock::time_point> startTimes;
+    std::map<std::string, GLuint> activeQueries;
+
+public:
+    /** If false, begin(...) and end(...) do nothing */
+    bool enabled = false;
+
+    ~GLPassTimer(){
+        // Nothing to delete if GL was never loaded:
+        if(glDeleteQueries == nullptr)
+            return;
+
+        for(PendingPass& pending : pendingPasses){
+            if(pending.query != 0)
+                freeQueries.push_back(pending.query);
+        }
+        for(auto& active : activeQueries)
+            freeQueries.push_back(active.second);
+
+        if(!freeQueries.empty())
+            glDeleteQueries(GLsizei(freeQueries.size()), freeQueries.data());
+    }
+
+    /** Starts measuring the pass (and its GPU time, if gpu is true) */
+    void begin(const std::string& name, bool gpu = false){
+        if(!enabled)
+            return;
+
+        startTimes[name] = std::chrono::high_resolution_clock::now();
+
+        if(gpu){
+            GLuint query;
+            if(freeQueries.empty()){
+                glGenQueries(1, &query);
+            } else {
+                query = freeQueries.back();
+                freeQueries.pop_back();
+            }
+
+            activeQueries[name] = query;
+            glBeginQuery(GL_TIME_ELAPSED, query);
+        }
+    }
+
+    /** Stops measuring the pass (which was started by begin(...) with the same parameters) */
+    void end(const std::string& name, bool gpu = false){
+        auto startTime = startTimes.find(name);
+        if(!enabled || startTime == startTimes.end())
+            return;
+
+        PendingPass pass;
+        pass.time.name = name;
+        pass.time.cpuTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime->second).count();
+        startTimes.erase(startTime);
+
+        auto query = activeQueries.find(name);
+        if(gpu && query != activeQueries.end()){
+            glEndQuery(GL_TIME_ELAPSED);
+            pass.query = query->second;
+            activeQueries.erase(query);
+            pendingPasses.push_back(pass);
+        } else if(pendingPasses.empty()){
+            finishedPasses.push_back(pass.time);
+        } else {
+            // Keep the order of the passes:
+            pendingPasses.push_back(pass);
+        }
+    }
+
+    /**
+     * Returns the passes which were measured completely since the last call
+     * (in the order they ended). If wait is true, it waits for the GPU to
+     * finish all pending queries (e.g. at the end of a benchmark).
+     */
+    std::vector<PassTime> collect(bool wait = false){
+        while(!pendingPasses.empty()){
+            PendingPass& pending = pendingPasses.front();
+
+            if(pending.query != 0){
+                GLint isAvailable = 0;
+                if(!wait)
+                    glGetQueryObjectiv(pending.query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+                // The queries finish in order, so the later ones aren't available either:
+                if(!wait && !isAvailable)
+                    break;
+
+                GLuint64 timeElapsed;
+                glGetQueryObjectui64v(pending.query, GL_QUERY_RESULT, &timeElapsed);
+                pending.time.gpuTime = timeElapsed * 1.0e-6f;
+                freeQueries.push_back(pending.query);
+            }
+
+            finishedPasses.push_back(pending.time);
+            pendingPasses.pop_front();
+        }
+
+        std::vector<PassTime> result;
+        result.swap(finishedPasses);
+        return result;
+    }
+};
@@ -0,0 +1,90 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+// The EGL headers shouldn't pull in X11 (no window is created):
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <glad/glad.h>
+
+#include <string>
+#include <stdexcept>
+
+/**
+ * OpenGL 3.3 core context without a window (EGL). The default framebuffer is
+ * an offscreen pbuffer of the benchmarked resolution (the renderers draw their
+ * result into framebuffer 0). Uses the surfaceless platform of Mesa if
+ * available, so it runs without a display server (e.g. llvmpipe on CI).
+ */
+class HeadlessContext {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLConfig config = nullptr;
+    EGLContext context = EGL_NO_CONTEXT;
+    EGLSurface surface = EGL_NO_SURFACE;
+
+public:
+    /** Creates the context (throws std::runtime_error if not possible) */
+    HeadlessContext(){
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if(getPlatformDisplay != nullptr)
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if(display == EGL_NO_DISPLAY)
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+            throw std::runtime_error("Could not initialize EGL.");
+
+        eglBindAPI(EGL_OPENGL_API);
+
+        EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE
+        };
+        EGLint configCount = 0;
+        if(!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+            throw std::runtime_error("No EGL config with an OpenGL pbuffer available.");
+
+        EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+        if(context == EGL_NO_CONTEXT)
+            throw std::runtime_error("Could not create an OpenGL 3.3 core context.");
+
+        resize(64, 64);
+
+        if(!gladLoadGLLoader((GLADloadproc) eglGetProcAddress))
+            throw std::runtime_error("Failed to initialize GLAD.");
+    }
+
+    ~HeadlessContext(){
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if(surface != EGL_NO_SURFACE)
+            eglDestroySurface(display, surface);
+        if(context != EGL_NO_CONTEXT)
+            eglDestroyContext(display, context);
+        eglTerminate(display);
+    }
+
+    /** Replaces the default framebuffer by one of the given size */
+    void resize(int width, int height){
+        EGLint surfaceAttributes[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+        EGLSurface newSurface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        if(newSurface == EGL_NO_SURFACE)
+            throw std::runtime_error("Could not create a pbuffer of " + std::to_string(width) + "x" + std::to_string(height) + " pixels.");
+
+        eglMakeCurrent(display, newSurface, newSurface, context);
+        if(surface != EGL_NO_SURFACE)
+            eglDestroySurface(display, surface);
+        surface = newSurface;
+    }
+};
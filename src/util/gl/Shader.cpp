@@ -10,8 +10,9 @@
 // Include OpenGL3.3 Core functions:
 #include <glad/glad.h>
 
-Shader::Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShaderPath)
-    : numOfCopies(new int(1)){
+Shader::Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShaderPath, std::map<std::string, std::string> defines)
+    : defines(defines)
+    , numOfCopies(new int(1)){
 
     createShaderProgram(vertexShaderPath, fragmentShaderPath, geometryShaderPath);
 }
@@ -25,6 +26,7 @@ Shader::Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std
  */
 Shader::Shader(const Shader& shader){
     shaderProgram = shader.shaderProgram;
+    defines = shader.defines;
     numOfCopies = shader.numOfCopies;
     initialized = shader.initialized;
     uniformLocationMap = shader.uniformLocationMap;
@@ -59,6 +61,7 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
     std::ifstream ifs(vertexShaderPath);
     std::string vertexShaderSourceString(std::istreambuf_iterator<char>{ifs}, {});
     processIncludes(vertexShaderSourceString);
+    injectDefines(vertexShaderSourceString);
     const char* vertexShaderSource = vertexShaderSourceString.c_str();
     ifs.close();
 
@@ -68,6 +71,7 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
     ifs = std::ifstream(fragmentShaderPath);
     std::string fragmentShaderSourceString(std::istreambuf_iterator<char>{ifs}, {});
     processIncludes(fragmentShaderSourceString);
+    injectDefines(fragmentShaderSourceString);
     const char* fragmentShaderSource = fragmentShaderSourceString.c_str();
     ifs.close();
 
@@ -115,6 +119,7 @@ void Shader::createShaderProgram(std::string vertexShaderPath, std::string fragm
         ifs = std::ifstream(geometryShaderPath);
         std::string geometryShaderSourceString(std::istreambuf_iterator<char>{ifs}, {});
         processIncludes(geometryShaderSourceString);
+        injectDefines(geometryShaderSourceString);
         const char* geometryShaderSource = geometryShaderSourceString.c_str();
         ifs.close();
 
@@ -192,6 +197,25 @@ void Shader::processIncludes(std::string& sourceCode) {
     }
 }
 
+void Shader::injectDefines(std::string& sourceCode) {
+    if(defines.empty())
+        return;
+
+    std::string defineLines;
+    for(const auto& define : defines)
+        defineLines += "#define " + define.first + " " + define.second + "\n";
+
+    // The #version directive must stay the first statement:
+    size_t insertPosition = 0;
+    size_t versionPosition = sourceCode.find("#version");
+    if(versionPosition != std::string::npos){
+        size_t lineEnd = sourceCode.find('\n', versionPosition);
+        insertPosition = lineEnd == std::string::npos ? sourceCode.size() : lineEnd + 1;
+    }
+
+    sourceCode.insert(insertPosition, defineLines);
+}
+
 void Shader::hotReloadCheck() {
     // Check all shader files for changes:
     for (ShaderFile& shaderFile : shaderFiles) {
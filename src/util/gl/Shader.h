@@ -13,6 +13,7 @@
 // Include string:
 #include <string>
 #include <unordered_map>
+#include <map>
 
 // Include Mat4f (and Vec4f):
 #include <util/math/Mat4.h>
@@ -35,6 +36,9 @@ private:
 
     std::vector<ShaderFile> shaderFiles;
 
+    /** Preprocessor definitions which are injected into all stages */
+    std::map<std::string, std::string> defines;
+
     /**
      * Checks if any of the files have been changed and should be reloaded.
      */
@@ -50,6 +54,11 @@ private:
      */
     void processIncludes(std::string& sourceCode);
 
+    /**
+     * Inserts the defines (#define name value) after the #version line.
+     */
+    void injectDefines(std::string& sourceCode);
+
 public:
     /** Stores the ID of the shader program on the GPU */
     unsigned int shaderProgram;
@@ -87,8 +96,12 @@ public:
      * In recent OpenGL versions, it is also possible to compile shaders
      * before hand (so they don't have to be compiled every time you
      * start a game, but that's another topic ;-)).
+     *
+     * The given defines are injected into the source code of all shaders,
+     * so that variants of a shader (e.g. for a number of cameras) can be
+     * compiled from the same files.
      */
-    Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShader = "");
+    Shader(std::string vertexShaderPath, std::string fragmentShaderPath, std::string geometryShader = "", std::map<std::string, std::string> defines = {});
 
     /**
      * Explicit copy constructor for reference counting (for correct
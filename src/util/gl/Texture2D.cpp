@@ -6,7 +6,7 @@
 // Include OpenGL3.3 Core functions:
 #include <glad/glad.h>
 
-#define STB_IMAGE_IMPLEMENTATION
+// Implementation of stb_image is compiled in JPEGDecoder.cpp:
 #include "stb_image.h"
 
 Texture2D::Texture2D():numOfCopies(new int(1)){}
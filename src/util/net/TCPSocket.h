@@ -0,0 +1,255 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET SocketHandle;
+#define INVALID_SOCKET_HANDLE INVALID_SOCKET
+#else
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET_HANDLE -1
+#endif
+
+/**
+ * A connected TCP socket (blocking), which sends and receives whole buffers.
+ */
+class TCPSocket {
+    SocketHandle handle = INVALID_SOCKET_HANDLE;
+
+    static void closeHandle(SocketHandle socketHandle){
+#ifdef _WIN32
+        closesocket(socketHandle);
+#else
+        ::close(socketHandle);
+#endif
+    }
+
+public:
+    /**
+     * Initializes the socket library (only required on Windows, can be called
+     * multiple times).
+     */
+    static bool initialize(){
+#ifdef _WIN32
+        static bool initialized = false;
+        if(!initialized){
+            WSADATA data;
+            initialized = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }
+        return initialized;
+#else
+        return true;
+#endif
+    }
+
+    TCPSocket(SocketHandle handle)
+        : handle(handle){}
+
+    TCPSocket(const TCPSocket&) = delete;
+    TCPSocket& operator=(const TCPSocket&) = delete;
+
+    ~TCPSocket(){
+        close();
+    }
+
+    /**
+     * Connects to the given host and port. Returns nullptr on failure.
+     */
+    static std::unique_ptr<TCPSocket> connect(std::string host, int port){
+        initialize();
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addresses = nullptr;
+        if(getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+            return nullptr;
+
+        std::unique_ptr<TCPSocket> result;
+        for(addrinfo* address = addresses; address != nullptr && result == nullptr; address = address->ai_next){
+            SocketHandle socketHandle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if(socketHandle == INVALID_SOCKET_HANDLE)
+                continue;
+
+            if(::connect(socketHandle, address->ai_addr, (int) address->ai_addrlen) == 0){
+                result = std::make_unique<TCPSocket>(socketHandle);
+            } else {
+                closeHandle(socketHandle);
+            }
+        }
+
+        freeaddrinfo(addresses);
+        return result;
+    }
+
+    /**
+     * Disables Nagle's algorithm and sets the kernel send and receive buffer
+     * sizes (large buffers are required for full camera images).
+     */
+    void configure(int bufferSize){
+        int noDelay = 1;
+        setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, (const char*) &noDelay, sizeof(noDelay));
+        setsockopt(handle, SOL_SOCKET, SO_SNDBUF, (const char*) &bufferSize, sizeof(bufferSize));
+        setsockopt(handle, SOL_SOCKET, SO_RCVBUF, (const char*) &bufferSize, sizeof(bufferSize));
+    }
+
+    /**
+     * Sends all bytes. Returns false if the connection was closed.
+     */
+    bool sendAll(const void* data, size_t size){
+        const char* bytes = (const char*) data;
+        while(size > 0){
+            int chunk = (int) std::min<size_t>(size, 1 << 30);
+#ifdef _WIN32
+            int sent = ::send(handle, bytes, chunk, 0);
+#else
+            int sent = (int) ::send(handle, bytes, chunk, MSG_NOSIGNAL);
+#endif
+            if(sent <= 0)
+                return false;
+
+            bytes += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    /**
+     * Receives exactly 'size' bytes directly into 'data'. Returns false if the
+     * connection was closed before.
+     */
+    bool receiveAll(void* data, size_t size){
+        char* bytes = (char*) data;
+        while(size > 0){
+            int chunk = (int) std::min<size_t>(size, 1 << 30);
+            int received = (int) ::recv(handle, bytes, chunk, MSG_WAITALL);
+            if(received <= 0)
+                return false;
+
+            bytes += received;
+            size -= received;
+        }
+        return true;
+    }
+
+    /**
+     * Aborts blocking send / receive calls of other threads.
+     */
+    void shutdown(){
+        if(handle != INVALID_SOCKET_HANDLE){
+#ifdef _WIN32
+            ::shutdown(handle, SD_BOTH);
+#else
+            ::shutdown(handle, SHUT_RDWR);
+#endif
+        }
+    }
+
+    void close(){
+        if(handle != INVALID_SOCKET_HANDLE){
+            closeHandle(handle);
+            handle = INVALID_SOCKET_HANDLE;
+        }
+    }
+};
+
+/**
+ * Listens for TCP connections on a port (all interfaces).
+ */
+class TCPListener {
+    SocketHandle handle = INVALID_SOCKET_HANDLE;
+
+public:
+    TCPListener(int port){
+        TCPSocket::initialize();
+
+        handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if(handle == INVALID_SOCKET_HANDLE){
+            std::cerr << "Failed to create socket." << std::endl;
+            return;
+        }
+
+        int reuse = 1;
+        setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, (const char*) &reuse, sizeof(reuse));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(uint16_t(port));
+
+        if(bind(handle, (sockaddr*) &address, sizeof(address)) != 0 || listen(handle, 16) != 0){
+            std::cerr << "Failed to listen on port " << port << "." << std::endl;
+            close();
+        }
+    }
+
+    TCPListener(const TCPListener&) = delete;
+    TCPListener& operator=(const TCPListener&) = delete;
+
+    ~TCPListener(){
+        close();
+    }
+
+    bool isValid(){
+        return handle != INVALID_SOCKET_HANDLE;
+    }
+
+    /**
+     * Waits up to 'timeoutMs' milliseconds for a new connection. Returns nullptr
+     * if there was none.
+     */
+    std::unique_ptr<TCPSocket> accept(int timeoutMs){
+        if(!isValid())
+            return nullptr;
+
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(handle, &readSet);
+
+        timeval timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+        if(select(int(handle) + 1, &readSet, nullptr, nullptr, &timeout) <= 0)
+            return nullptr;
+
+        SocketHandle socketHandle = ::accept(handle, nullptr, nullptr);
+        if(socketHandle == INVALID_SOCKET_HANDLE)
+            return nullptr;
+
+        return std::make_unique<TCPSocket>(socketHandle);
+    }
+
+    void close(){
+        if(handle != INVALID_SOCKET_HANDLE){
+#ifdef _WIN32
+            closesocket(handle);
+#else
+            ::close(handle);
+#endif
+            handle = INVALID_SOCKET_HANDLE;
+        }
+    }
+};
@@ -0,0 +1,204 @@
+// © 2025, CGVR (https://cgvr.informatik.uni-bremen.de/),
+// Author: Andre Mühlenbrock (muehlenb@uni-bremen.de)
+#pragma once
+
+#include <cstdint>
+
+/**
+ * A minimal wrapper around the float vector instructions of the target CPU, so
+ * that CPU kernels can be written once for all platforms:
+ *
+ *  - AVX2 (8 lanes), if compiled with AVX2 support (see USE_AVX2 in CMake)
+ *  - SSE2 (4 lanes), which is always available on x86-64
+ *  - NEON (4 lanes) on ARM
+ *  - Scalar fallback (1 lane) otherwise
+ *
+ * All comparisons are ordered, so comparisons involving NaN are false.
+ */
+
+#if defined(__AVX2__)
+#define SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_NEON
+#include <arm_neon.h>
+#else
+#define SIMD_SCALAR
+#endif
+
+namespace simd {
+
+#if defined(SIMD_AVX2)
+
+constexpr unsigned int Width = 8;
+constexpr const char* Name = "AVX2";
+
+struct Mask { __m256 v; };
+struct Float {
+    __m256 v;
+    Float() = default;
+    Float(__m256 v) : v(v) {}
+    Float(float f) : v(_mm256_set1_ps(f)) {}
+};
+
+inline Float load(const float* p){ return _mm256_loadu_ps(p); }
+inline void store(float* p, Float a){ _mm256_storeu_ps(p, a.v); }
+inline Float loadDepth(const uint16_t* p){ return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) p))); }
+
+inline Float operator+(Float a, Float b){ return _mm256_add_ps(a.v, b.v); }
+inline Float operator-(Float a, Float b){ return _mm256_sub_ps(a.v, b.v); }
+inline Float operator*(Float a, Float b){ return _mm256_mul_ps(a.v, b.v); }
+inline Float operator/(Float a, Float b){ return _mm256_div_ps(a.v, b.v); }
+
+inline Mask operator<(Float a, Float b){ return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline Mask operator<=(Float a, Float b){ return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+inline Mask operator>(Float a, Float b){ return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+inline Mask operator>=(Float a, Float b){ return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline Mask operator&(Mask a, Mask b){ return {_mm256_and_ps(a.v, b.v)}; }
+inline Mask operator|(Mask a, Mask b){ return {_mm256_or_ps(a.v, b.v)}; }
+
+inline Float abs(Float a){ return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v); }
+inline Float max(Float a, Float b){ return _mm256_max_ps(a.v, b.v); }
+inline Float min(Float a, Float b){ return _mm256_min_ps(a.v, b.v); }
+
+/** Returns true if the mask is set in any lane */
+inline bool any(Mask m){ return _mm256_movemask_ps(m.v) != 0; }
+
+/** Returns a where the mask is set, else b */
+inline Float select(Mask m, Float a, Float b){ return _mm256_blendv_ps(b.v, a.v, m.v); }
+
+#elif defined(SIMD_SSE2)
+
+constexpr unsigned int Width = 4;
+constexpr const char* Name = "SSE2";
+
+struct Mask { __m128 v; };
+struct Float {
+    __m128 v;
+    Float() = default;
+    Float(__m128 v) : v(v) {}
+    Float(float f) : v(_mm_set1_ps(f)) {}
+};
+
+inline Float load(const float* p){ return _mm_loadu_ps(p); }
+inline void store(float* p, Float a){ _mm_storeu_ps(p, a.v); }
+inline Float loadDepth(const uint16_t* p){ return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*) p), _mm_setzero_si128())); }
+
+inline Float operator+(Float a, Float b){ return _mm_add_ps(a.v, b.v); }
+inline Float operator-(Float a, Float b){ return _mm_sub_ps(a.v, b.v); }
+inline Float operator*(Float a, Float b){ return _mm_mul_ps(a.v, b.v); }
+inline Float operator/(Float a, Float b){ return _mm_div_ps(a.v, b.v); }
+
+inline Mask operator<(Float a, Float b){ return {_mm_cmplt_ps(a.v, b.v)}; }
+inline Mask operator<=(Float a, Float b){ return {_mm_cmple_ps(a.v, b.v)}; }
+inline Mask operator>(Float a, Float b){ return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline Mask operator>=(Float a, Float b){ return {_mm_cmpge_ps(a.v, b.v)}; }
+inline Mask operator&(Mask a, Mask b){ return {_mm_and_ps(a.v, b.v)}; }
+inline Mask operator|(Mask a, Mask b){ return {_mm_or_ps(a.v, b.v)}; }
+
+inline Float abs(Float a){ return _mm_andnot_ps(_mm_set1_ps(-0.f), a.v); }
+inline Float max(Float a, Float b){ return _mm_max_ps(a.v, b.v); }
+inline Float min(Float a, Float b){ return _mm_min_ps(a.v, b.v); }
+
+/** Returns true if the mask is set in any lane */
+inline bool any(Mask m){ return _mm_movemask_ps(m.v) != 0; }
+
+/** Returns a where the mask is set, else b */
+inline Float select(Mask m, Float a, Float b){ return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)); }
+
+#elif defined(SIMD_NEON)
+
+constexpr unsigned int Width = 4;
+constexpr const char* Name = "NEON";
+
+struct Mask { uint32x4_t v; };
+struct Float {
+    float32x4_t v;
+    Float() = default;
+    Float(float32x4_t v) : v(v) {}
+    Float(float f) : v(vdupq_n_f32(f)) {}
+};
+
+inline Float load(const float* p){ return vld1q_f32(p); }
+inline void store(float* p, Float a){ vst1q_f32(p, a.v); }
+inline Float loadDepth(const uint16_t* p){ return vcvtq_f32_u32(vmovl_u16(vld1_u16(p))); }
+
+inline Float operator+(Float a, Float b){ return vaddq_f32(a.v, b.v); }
+inline Float operator-(Float a, Float b){ return vsubq_f32(a.v, b.v); }
+inline Float operator*(Float a, Float b){ return vmulq_f32(a.v, b.v); }
+inline Float operator/(Float a, Float b){
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vdivq_f32(a.v, b.v);
+#else
+    // Reciprocal estimate with two Newton-Raphson steps:
+    float32x4_t r = vrecpeq_f32(b.v);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    return vmulq_f32(a.v, r);
+#endif
+}
+
+inline Mask operator<(Float a, Float b){ return {vcltq_f32(a.v, b.v)}; }
+inline Mask operator<=(Float a, Float b){ return {vcleq_f32(a.v, b.v)}; }
+inline Mask operator>(Float a, Float b){ return {vcgtq_f32(a.v, b.v)}; }
+inline Mask operator>=(Float a, Float b){ return {vcgeq_f32(a.v, b.v)}; }
+inline Mask operator&(Mask a, Mask b){ return {vandq_u32(a.v, b.v)}; }
+inline Mask operator|(Mask a, Mask b){ return {vorrq_u32(a.v, b.v)}; }
+
+inline Float abs(Float a){ return vabsq_f32(a.v); }
+inline Float max(Float a, Float b){ return vmaxq_f32(a.v, b.v); }
+inline Float min(Float a, Float b){ return vminq_f32(a.v, b.v); }
+
+/** Returns true if the mask is set in any lane */
+inline bool any(Mask m){
+    uint32x2_t folded = vorr_u32(vget_low_u32(m.v), vget_high_u32(m.v));
+    return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+}
+
+/** Returns a where the mask is set, else b */
+inline Float select(Mask m, Float a, Float b){ return vbslq_f32(m.v, a.v, b.v); }
+
+#else
+
+constexpr unsigned int Width = 1;
+constexpr const char* Name = "Scalar";
+
+struct Mask { bool v; };
+struct Float {
+    float v;
+    Float() = default;
+    Float(float f) : v(f) {}
+};
+
+inline Float load(const float* p){ return *p; }
+inline void store(float* p, Float a){ *p = a.v; }
+inline Float loadDepth(const uint16_t* p){ return float(*p); }
+
+inline Float operator+(Float a, Float b){ return a.v + b.v; }
+inline Float operator-(Float a, Float b){ return a.v - b.v; }
+inline Float operator*(Float a, Float b){ return a.v * b.v; }
+inline Float operator/(Float a, Float b){ return a.v / b.v; }
+
+inline Mask operator<(Float a, Float b){ return {a.v < b.v}; }
+inline Mask operator<=(Float a, Float b){ return {a.v <= b.v}; }
+inline Mask operator>(Float a, Float b){ return {a.v > b.v}; }
+inline Mask operator>=(Float a, Float b){ return {a.v >= b.v}; }
+inline Mask operator&(Mask a, Mask b){ return {a.v && b.v}; }
+inline Mask operator|(Mask a, Mask b){ return {a.v || b.v}; }
+
+inline Float abs(Float a){ return a.v < 0.f ? -a.v : a.v; }
+inline Float max(Float a, Float b){ return a.v > b.v ? a.v : b.v; }
+inline Float min(Float a, Float b){ return a.v < b.v ? a.v : b.v; }
+
+/** Returns true if the mask is set in any lane */
+inline bool any(Mask m){ return m.v; }
+
+/** Returns a where the mask is set, else b */
+inline Float select(Mask m, Float a, Float b){ return m.v ? a : b; }
+
+#endif
+
+}